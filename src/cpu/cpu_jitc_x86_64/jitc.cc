@@ -33,7 +33,60 @@
 #include "ppc_mmu.h"
 #include "ppc_tools.h"
 
-static TranslationCacheFragment *jitcAllocFragment(JITC &jitc);
+static TranslationCacheFragment *jitcAllocFragment(JITC &jitc, ClientPage *cp);
+
+/*
+ *	Contiguous native code for client address pc starts at start
+ */
+static inline void jitcPerfMapBegin(JITC &jitc, NativeAddress start, uint32 pc)
+{
+	if (gJITCPerfMap) {
+		jitc.perfMapStart = start;
+		jitc.perfMapPC = pc;
+	}
+}
+
+/*
+ *	Announces the code emitted since jitcPerfMapBegin()
+ */
+static inline void jitcPerfMapEnd(JITC &jitc, NativeAddress end)
+{
+	if (gJITCPerfMap && end > jitc.perfMapStart) {
+		jitcPerfMapAdd(jitc.perfMapPC, jitc.perfMapStart, end);
+	}
+}
+
+/*
+ *	Returns size bytes of zeroed memory from the arena
+ */
+static void *jitcArenaAllocBytes(JITC &jitc, size_t size)
+{
+	size = (size + 15) & ~15;
+	if (size > jitc.arenaLeft) {
+		size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+		JITCArenaBlock *block = ppc_malloc(sizeof (JITCArenaBlock) + blockSize);
+		block->prev = jitc.arenaBlocks;
+		jitc.arenaBlocks = block;
+		byte *mem = (byte*)(block + 1);
+		if (size >= ARENA_BLOCK_SIZE) {
+			// big tables get a block of their own
+			memset(mem, 0, size);
+			return mem;
+		}
+		jitc.arenaFree = mem;
+		jitc.arenaLeft = blockSize;
+	}
+	byte *mem = jitc.arenaFree;
+	jitc.arenaFree += size;
+	jitc.arenaLeft -= size;
+	memset(mem, 0, size);
+	return mem;
+}
+
+template <typename T> static inline T *jitcArenaAlloc(JITC &jitc, size_t count = 1)
+{
+	return (T*)jitcArenaAllocBytes(jitc, count * sizeof (T));
+}
 
 /*
  *	Intern
@@ -46,7 +99,7 @@ static bool jitcEmitNextFragment(JITC &jitc)
 	TranslationCacheFragment *tcf_old = jitc.currentPage->tcf_current;
 	NativeAddress tcp_old = jitc.currentPage->tcp;
 	// alloc new
-	jitc.currentPage->tcf_current = jitcAllocFragment(jitc);
+	jitc.currentPage->tcf_current = jitcAllocFragment(jitc, jitc.currentPage);
 	jitc.currentPage->tcf_current->prev = tcf_old;
 	if (uint64(jitc.currentPage->tcf_current->base - jitc.currentPage->tcp) < 20) {
 		// next Fragment directly follows
@@ -59,6 +112,9 @@ static bool jitcEmitNextFragment(JITC &jitc)
 		// FIXME: use 0xeb if possible
 		tcp_old[0] = 0xe9;
 		*((uint32 *)&tcp_old[1]) = jitc.currentPage->tcp - (tcp_old+5);
+		jitcPerfMapEnd(jitc, tcp_old+5);
+		jitcPerfMapBegin(jitc, jitc.currentPage->tcp,
+			jitc.currentPage->baseaddress + jitc.pc);
 		return true;
 	}
 }
@@ -68,7 +124,6 @@ static bool jitcEmitNextFragment(JITC &jitc)
  */
 void JITC::emit1(byte b)
 {
-	jitcDebugLogEmit(*this, &b, 1);
 	/*
 	 *	We always have to leave at least 5 bytes in the fragment
 	 *	to issue a final JMP
@@ -76,6 +131,8 @@ void JITC::emit1(byte b)
 	if (currentPage->bytesLeft <= 5) {
 		jitcEmitNextFragment(*this);
 	}
+	jitcTraceNative(*this, &b, 1);
+	code_bytes++;
 	*(currentPage->tcp++) = b;
 	currentPage->bytesLeft--;
 }
@@ -85,10 +142,11 @@ void JITC::emit1(byte b)
  */
 void JITC::emit(byte *instr, uint size)
 {
-	jitcDebugLogEmit(*this, instr, size);
 	if (int(currentPage->bytesLeft) - int(size) < 5) {
 		jitcEmitNextFragment(*this);
 	}
+	jitcTraceNative(*this, instr, size);
+	code_bytes += size;
 	memcpy(currentPage->tcp, instr, size);
 	currentPage->tcp += size;
 	currentPage->bytesLeft -= size;
@@ -175,6 +233,8 @@ static ClientPage *jitcTouchClientPage(JITC &jitc, ClientPage *cp)
 	return cp;
 }
 
+#define U32(dest) (*(uint32 *)(void *)(dest))
+
 /*
  *	Puts fragments into the freeFragmentsList
  */
@@ -188,19 +248,149 @@ static void jitcDestroyFragments(JITC &jitc, TranslationCacheFragment *tcf)
 		TranslationCacheFragment *next = tcf->prev;
 		tcf->prev = jitc.freeFragmentsList;
 		jitc.freeFragmentsList = tcf;
+		jitc.fragments_freed++;
 		tcf = next;
 	}
 }
 
+/*
+ *	A link is alive if its source page hasn't been retranslated
+ *	since and the site still points into cp
+ */
+static inline bool jitcLinkAlive(ClientPageLink *link, ClientPage *cp)
+{
+	return link->source->generation == link->sourceGeneration
+		&& U32(link->site - LINK_PHYS_OFS) == cp->baseaddress;
+}
+
+static inline void jitcFreeLink(JITC &jitc, ClientPageLink *link)
+{
+	link->next = jitc.freeLinks;
+	jitc.freeLinks = link;
+}
+
+#define LINK_CHUNK 256
+
+static ClientPageLink *jitcAllocLink(JITC &jitc)
+{
+	if (!jitc.freeLinks) {
+		ClientPageLink *links = jitcArenaAlloc<ClientPageLink>(jitc, LINK_CHUNK);
+		for (int i=0; i < LINK_CHUNK; i++) {
+			jitcFreeLink(jitc, &links[i]);
+		}
+	}
+	ClientPageLink *link = jitc.freeLinks;
+	jitc.freeLinks = link->next;
+	return link;
+}
+
+/*
+ *	Unpatches all branches into cp, they will
+ *	go through ppc_new_pc_link_asm again
+ */
+static void jitcUnlinkClientPage(JITC &jitc, ClientPage *cp)
+{
+	ClientPageLink *link = cp->incomingLinks;
+	while (link) {
+		ClientPageLink *next = link->next;
+		if (jitcLinkAlive(link, cp)) {
+			U32(link->site - LINK_PHYS_OFS) = LINK_UNLINKED;
+		}
+		jitcFreeLink(jitc, link);
+		link = next;
+	}
+	cp->incomingLinks = NULL;
+}
+
+/*
+ *	Removes all entries pointing into the page at baseaddr
+ *	from the target cache and the return stack
+ */
+static void jitcInvalidateBranchTargets(JITC &jitc, uint32 baseaddr)
+{
+	for (int i=0; i < TARGET_CACHE_ENTRIES; i++) {
+		if (jitc.targetCache[i].phys == baseaddr) {
+			jitc.targetCache[i].ea = BRANCH_TARGET_INVALID;
+		}
+	}
+	for (int i=0; i < RETURN_STACK_ENTRIES; i++) {
+		if (jitc.returnStack[i].phys == baseaddr) {
+			jitc.returnStack[i].ea = BRANCH_TARGET_INVALID;
+		}
+	}
+}
+
+#define ENTRYPOINT_CHUNK_ALLOC 256
+
+static EntrypointChunk *jitcAllocEntrypointChunk(JITC &jitc)
+{
+	if (!jitc.freeEntrypointChunks) {
+		EntrypointChunk *chunks = jitcArenaAlloc<EntrypointChunk>(jitc, ENTRYPOINT_CHUNK_ALLOC);
+		for (int i=0; i < ENTRYPOINT_CHUNK_ALLOC; i++) {
+			chunks[i].next = jitc.freeEntrypointChunks;
+			jitc.freeEntrypointChunks = &chunks[i];
+		}
+	}
+	EntrypointChunk *chunk = jitc.freeEntrypointChunks;
+	jitc.freeEntrypointChunks = chunk->next;
+	memset(chunk, 0, sizeof *chunk);
+	return chunk;
+}
+
+/*
+ *	Moves all entrypoint chunks of cp into the freeEntrypointChunks list
+ */
+static void jitcDestroyEntrypoints(JITC &jitc, ClientPage *cp)
+{
+	for (int i=0; i < ENTRYPOINT_CHUNKS; i++) {
+		EntrypointChunk *chunk = cp->entrypoints[i];
+		if (chunk) {
+			chunk->next = jitc.freeEntrypointChunks;
+			jitc.freeEntrypointChunks = chunk;
+			cp->entrypoints[i] = NULL;
+		}
+	}
+}
+
+/*
+ *	Moves all tier counters of cp into the freeTierCounters list
+ */
+static void jitcDestroyTierCounters(JITC &jitc, ClientPage *cp)
+{
+	JITCTierCounter *c = cp->tierCounters;
+	while (c) {
+		JITCTierCounter *next = c->next;
+		c->next = jitc.freeTierCounters;
+		jitc.freeTierCounters = c;
+		c = next;
+	}
+	cp->tierCounters = NULL;
+}
+
+/*
+ *	Throws away the translation of ClientPage
+ */
+static void jitcDestroyTranslation(JITC &jitc, ClientPage *cp)
+{
+	cp->generation++;
+	jitcUnlinkClientPage(jitc, cp);
+	jitcInvalidateBranchTargets(jitc, cp->baseaddress);
+	jitcDestroyFragments(jitc, cp->tcf_current);
+	jitcDestroyEntrypoints(jitc, cp);
+	jitcDestroyTierCounters(jitc, cp);
+	cp->tcf_current = NULL;
+	cp->referenced = false;
+	jitc.codeLines[(cp->baseaddress >> 12)*2] = 0;
+	jitc.codeLines[(cp->baseaddress >> 12)*2+1] = 0;
+}
+
 /*
  *	Unmaps ClientPage and destroys fragments
  */
 static void jitcDestroyClientPage(JITC &jitc, ClientPage *cp)
 {
 	// assert(cp->tcf_current)
-	jitcDestroyFragments(jitc, cp->tcf_current);
-	memset(cp->entrypoints, 0, sizeof cp->entrypoints);
-	cp->tcf_current = NULL;
+	jitcDestroyTranslation(jitc, cp);
 	jitcUnmapClientPage(jitc, cp);
 }
 
@@ -251,6 +441,87 @@ extern "C" void jitcDestroyAndFreeClientPage(JITC &jitc, ClientPage *cp)
 	jitcFreeClientPage(jitc, cp);
 }
 
+extern PPC_CPU_State *gCPU;
+
+/*
+ *	Called before a store of size bytes to the physical address pa
+ *	(the part beyond the page of pa is ignored).
+ *	Throws away the translation of the page if the store hits
+ *	a line containing translated instructions. The store may come
+ *	from that very page, so code_destroyed is set and the caller
+ *	must leave the block right after the store without linking
+ *	(see ppc_opc_gen_check_code_destroyed()).
+ *
+ *	Returns true if the page (still) contains translated code,
+ *	in which case stores to it must not bypass this check.
+ */
+extern "C" bool jitcCheckCodeWrite(JITC &jitc, uint32 pa, uint size)
+{
+	uint64 *lines = &jitc.codeLines[(pa >> 12)*2];
+	if (!(lines[0] | lines[1])) return false;
+	uint32 first = (pa & 0xfff) >> 5;
+	uint32 last = ((pa & 0xfff) + size - 1) >> 5;
+	if (last > 127) last = 127;
+	for (uint32 l = first; l <= last; l++) {
+		if (lines[l >> 6] & (1ULL << (l & 63))) {
+			jitcDestroyAndFreeClientPage(jitc, jitc.clientPages[pa >> 12]);
+			gCPU->code_destroyed = true;
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ *	Called from the heartbeat when an exception is taken with
+ *	addr being the return address into translated code, i.e.
+ *	every decrementer or external interrupt samples which page
+ *	is running. Direct branches don't go through jitcNewPC, so
+ *	this is the only way to see that such code is still hot.
+ */
+extern "C" void jitcSampleNativeAddress(JITC &jitc, NativeAddress addr)
+{
+	uint64 ofs = addr - jitc.translationCache;
+	if (ofs >= jitc.translationCacheSize) return;
+	ClientPage *cp = jitc.fragments[ofs / FRAGMENT_SIZE].owner;
+	if (cp && cp->tcf_current) {
+		cp->referenced = true;
+		jitc.hot_samples++;
+	}
+}
+
+/*
+ *	Returns the page which should be evicted next.
+ *	Referenced pages at the LRU end are cleared and touched instead
+ *	(at most EVICTION_SECOND_CHANCES of them), keep is never returned
+ *	unless it is the only page.
+ */
+static ClientPage *jitcSelectVictim(JITC &jitc, ClientPage *keep)
+{
+	ClientPage *cp = jitc.LRUpage;
+	for (int i=0; i < EVICTION_SECOND_CHANCES; i++) {
+		if (!cp->referenced && cp != keep) break;
+		cp->referenced = false;
+		jitcTouchClientPage(jitc, cp);
+		jitc.second_chances++;
+		cp = jitc.LRUpage;
+	}
+	if (cp == keep && cp->moreRU) cp = cp->moreRU;
+	return cp;
+}
+
+/*
+ *	Called from translated code if FPSCR selects a rounding mode or
+ *	exceptions the native FPU code doesn't handle.
+ *	Throws away the translation of the page, which is then
+ *	retranslated with interpreted floating point instructions.
+ */
+extern "C" void jitcPreciseFloatClientPage(JITC &jitc, ClientPage *cp)
+{
+	jitcDestroyTranslation(jitc, cp);
+	cp->preciseFloat = true;
+}
+
 /*
  *	Destroys and touches ClientPage
  */
@@ -273,21 +544,23 @@ static TranslationCacheFragment *jitcGetFragment(JITC &jitc)
 }
 
 /*
- *	Returns free fragment
+ *	Returns free fragment for cp
  *	May destroy a page to make new free fragments
  */
-static TranslationCacheFragment *jitcAllocFragment(JITC &jitc)
+static TranslationCacheFragment *jitcAllocFragment(JITC &jitc, ClientPage *cp)
 {
 	if (!jitc.freeFragmentsList) {
 		/*
 		 *	There are no free fragments
-		 *	-> must free a ClientPage
+		 *	-> must free a ClientPage (but not cp)
 		 */
 		jitc.destroy_write--;	// destroy and free will increase this
 		jitc.destroy_ootc++;
-		jitcDestroyAndFreeClientPage(jitc, jitc.LRUpage);
+		jitcDestroyAndFreeClientPage(jitc, jitcSelectVictim(jitc, cp));
 	}
-	return jitcGetFragment(jitc);
+	TranslationCacheFragment *tcf = jitcGetFragment(jitc);
+	tcf->owner = cp;
+	return tcf;
 }
 
 /*
@@ -312,15 +585,15 @@ static ClientPage *jitcCreateClientPage(JITC &jitc, uint32 baseaddr)
 		}
 		cp->moreRU = NULL;
 	} else {
-		cp = jitc.LRUpage;
+		cp = jitcSelectVictim(jitc, NULL);
 		jitcDestroyAndTouchClientPage(jitc, cp);
 		// destroy some more
-		if (jitc.LRUpage) jitcDestroyAndTouchClientPage(jitc, jitc.LRUpage);
-		if (jitc.LRUpage) jitcDestroyAndTouchClientPage(jitc, jitc.LRUpage);
-		if (jitc.LRUpage) jitcDestroyAndTouchClientPage(jitc, jitc.LRUpage);
-		if (jitc.LRUpage) jitcDestroyAndTouchClientPage(jitc, jitc.LRUpage);
+		for (int i=0; i < 4; i++) {
+			jitcDestroyAndTouchClientPage(jitc, jitcSelectVictim(jitc, cp));
+		}
 	}
 	jitcMapClientPage(jitc, baseaddr, cp);
+	cp->preciseFloat = false;
 	return cp;
 }
 
@@ -338,14 +611,18 @@ static ClientPage *jitcGetOrCreateClientPage(JITC &jitc, uint32 baseaddr)
 	}
 }
 
-static inline void jitcCreateEntrypoint(ClientPage *cp, uint32 ofs)
+static inline void jitcCreateEntrypoint(JITC &jitc, ClientPage *cp, uint32 ofs)
 {
-	cp->entrypoints[ofs >> 2] = cp->tcp;
+	EntrypointChunk *&chunk = cp->entrypoints[(ofs >> 2) / ENTRYPOINT_CHUNK_SIZE];
+	if (!chunk) chunk = jitcAllocEntrypointChunk(jitc);
+	chunk->entry[(ofs >> 2) % ENTRYPOINT_CHUNK_SIZE] = jitc.asmHERE();
 }
 
 static inline NativeAddress jitcGetEntrypoint(ClientPage *cp, uint32 ofs)
 {
-	return cp->entrypoints[ofs >> 2];
+	EntrypointChunk *chunk = cp->entrypoints[(ofs >> 2) / ENTRYPOINT_CHUNK_SIZE];
+	if (!chunk) return NULL;
+	return chunk->entry[(ofs >> 2) % ENTRYPOINT_CHUNK_SIZE];
 }
 
 extern uint64 jitcCompileTicks;
@@ -354,20 +631,225 @@ extern uint64 jitcRunTicksStart;
 
 extern JITC *gJITC;
 
-#define U32(dest) (*(uint32 *)(void *)(dest))
+/*
+ *	inc qword ptr [counter]
+ */
+static void jitcEmitProfileIncrement(JITC &jitc, uint64 *counter)
+{
+	byte instr[8] = {0x48, 0xff, 0x04, 0x25};
+	U32(instr + 4) = uint32(uint64(counter));
+	jitc.emit(instr, sizeof instr);
+}
+
+/*
+ *	Starts a new profiled block at the current position
+ *	(which must be an entrypoint). Flags are clobbered.
+ */
+static void jitcProfileBlock(JITC &jitc, uint32 pc)
+{
+	JITCProfileChunk *chunk = jitc.profileChunks;
+	if (!chunk || chunk->used == PROFILE_CHUNK_BLOCKS) {
+		chunk = (JITCProfileChunk *)sys_malloc32(sizeof *chunk);
+		if (!chunk) {
+			jitc.currentProfile = NULL;
+			return;
+		}
+		chunk->prev = jitc.profileChunks;
+		chunk->used = 0;
+		jitc.profileChunks = chunk;
+	}
+	JITCBlockProfile *p = &chunk->blocks[chunk->used++];
+	memset(p, 0, sizeof *p);
+	p->pc = pc;
+	jitc.currentProfile = p;
+	jitcEmitProfileIncrement(jitc, &p->count);
+}
+
+/*
+ *	Classifies a client instruction for the instruction mix
+ */
+static JITCProfileClass jitcProfileClass(uint32 opc)
+{
+	switch (PPC_OPC_MAIN(opc)) {
+	case 4:
+		return profileVector;
+	case 16: case 18: case 19:
+		return profileBranch;
+	case 32: case 33: case 34: case 35: case 40: case 41: case 42: case 43:
+	case 46: case 48: case 49: case 50: case 51:
+		return profileLoad;
+	case 36: case 37: case 38: case 39: case 44: case 45: case 47:
+	case 52: case 53: case 54: case 55:
+		return profileStore;
+	case 59: case 63:
+		return profileFloat;
+	case 31:
+		switch (PPC_OPC_EXT(opc)) {
+		case 20: case 23: case 55: case 87: case 119: case 279: case 311:
+		case 343: case 375: case 533: case 534: case 597: case 790:
+		case 535: case 567: case 599: case 631:
+			return profileLoad;
+		case 150: case 151: case 183: case 215: case 247: case 407: case 439:
+		case 661: case 662: case 725: case 918:
+		case 663: case 695: case 727: case 759: case 983:
+			return profileStore;
+		case 6: case 7: case 38: case 39: case 71: case 103: case 359:
+			return profileVector;	// lvsl, lvx, ...
+		case 135: case 167: case 199: case 231: case 487:
+			return profileVector;	// stvx, ...
+		}
+	}
+	return profileInteger;
+}
+
+/*
+ *	Counts an exit of the current block,
+ *	must be emitted where flags are dead
+ */
+void jitcProfileExit(JITC &jitc, bool chained)
+{
+	JITCBlockProfile *p = jitc.currentProfile;
+	if (p) {
+		jitcEmitProfileIncrement(jitc, chained ? &p->chained : &p->dispatched);
+	}
+}
+
+/*
+ *	Remembers that the current instruction is interpreted
+ */
+void jitcProfileInterpreted(JITC &jitc)
+{
+	JITCBlockProfile *p = jitc.currentProfile;
+	if (p) {
+		p->interpreted++;
+		JITCInterpretedSite *site = jitcArenaAlloc<JITCInterpretedSite>(jitc);
+		site->block = p;
+		site->opc = jitc.current_opc;
+		site->next = jitc.interpretedSites;
+		jitc.interpretedSites = site;
+	}
+}
+
+/*
+ *	Emits the counter of a backward branch to ofs,
+ *	must be emitted where flags and registers are dead
+ */
+void jitcEmitTierCounter(JITC &jitc, uint32 ofs)
+{
+	JITCTierCounter *c = jitc.freeTierCounters;
+	if (c) {
+		jitc.freeTierCounters = c->next;
+	} else {
+		JITCTierCounterChunk *chunk = jitc.tierCounterChunks;
+		if (!chunk || chunk->used == TIER_CHUNK_COUNTERS) {
+			chunk = (JITCTierCounterChunk *)sys_malloc32(sizeof *chunk);
+			if (!chunk) return;
+			chunk->prev = jitc.tierCounterChunks;
+			chunk->used = 0;
+			jitc.tierCounterChunks = chunk;
+		}
+		c = &chunk->counters[chunk->used++];
+	}
+	c->next = jitc.currentPage->tierCounters;
+	jitc.currentPage->tierCounters = c;
+	c->count = jitc.superblockThreshold;
+	c->ofs = ofs;
+	c->page = jitc.currentPage;
+	c->generation = jitc.currentPage->generation;
+
+	// sub dword ptr [count], 1
+	byte instr[8] = {0x83, 0x2c, 0x25};
+	U32(instr + 3) = uint32(uint64(&c->count));
+	instr[7] = 1;
+	jitc.emit(instr, sizeof instr);
+	NativeAddress skip = jitc.asmJxxFixup(X86_NZ);
+	jitc.asmMOV32_NoFlags(RAX, uint32(uint64(c)));
+	jitc.asmCALL((NativeAddress)ppc_tier_up_asm);
+	jitc.asmResolveFixup(skip, jitc.asmHERE());
+}
+
+/*
+ *	Called for an unconditional branch to ofs while translating
+ *	a superblock. Returns true if the translation should continue
+ *	at ofs instead of translating the branch.
+ */
+bool jitcSuperblockFollow(JITC &jitc, uint32 ofs)
+{
+	if (ofs >= 4096 || jitc.superblockBranches == SUPERBLOCK_MAX_BRANCHES
+	 || (jitc.superblockVisited[ofs >> 8] & (1ULL << ((ofs >> 2) & 63)))) {
+		return false;
+	}
+	jitc.superblockBranches++;
+	jitc.followPC = ofs;
+	return true;
+}
+
+/*
+ *	Client registers which a superblock keeps in fixed native
+ *	registers from one iteration of its loop to the next.
+ *	Mostly callee saved ones, since these survive the helpers.
+ */
+static const struct {
+	PPC_Register creg;
+	NativeReg nreg;
+} gPinnedRegisters[] = {
+	{PPC_CTR,	R15},
+	{PPC_GPR(3),	R14},
+	{PPC_GPR(4),	R13},
+	{PPC_GPR(5),	RBP},
+	{PPC_GPR(1),	R12},
+	{PPC_LR,	RBX},
+};
+
+/*
+ *	Emits the branch of a superblock to its own head: unless an
+ *	exception is pending, the pinned registers which aren't in
+ *	place anymore are reloaded and the loop continues behind the
+ *	preload. Otherwise it falls through to the normal branch.
+ *
+ *	Must be emitted where the client state is flushed, but before
+ *	anything clobbers mapped registers. Doesn't change mappings.
+ */
+void jitcEmitSuperblockLoop(JITC &jitc)
+{
+	jitc.asmTEST32(curCPU(exception_pending), 1);
+	NativeAddress pending = jitc.asmJxxFixup(X86_NZ);
+	NativeAddress deadline = NULL;
+	if (gTSCTimebase) {
+		// the heartbeat of the normal branch raises it
+		jitc.asmSimple(X86_RDTSC);
+		jitc.asmShift64(X86_SHL, RDX, 32);
+		jitc.asmALU64(X86_OR, RAX, RDX);
+		jitc.asmALU64(X86_CMP, RAX, curCPU(dec_deadline));
+		deadline = jitc.asmJxxFixup(X86_AE);
+	}
+	for (uint i=0; i < sizeof gPinnedRegisters / sizeof gPinnedRegisters[0]; i++) {
+		PPC_Register creg = gPinnedRegisters[i].creg;
+		NativeReg nreg = gPinnedRegisters[i].nreg;
+		if (jitc.getClientRegisterMapping(creg) != nreg) {
+			jitc.asmALU32(X86_MOV, nreg, curCPUreg(creg));
+		}
+	}
+	jitcProfileExit(jitc, true);
+	jitc.asmJMP(jitc.superblockLoop);
+	jitc.asmResolveFixup(pending, jitc.asmHERE());
+	if (deadline) jitc.asmResolveFixup(deadline, jitc.asmHERE());
+}
+
 static NativeAddress jitcNewEntrypoint(JITC &jitc, ClientPage *cp, uint32 baseaddr, uint32 ofs)
 {
 /*
 	jitcRunTicks += jitcDebugGetTicks() - jitcRunTicksStart;
 	uint64 jitcCompileStartTicks = jitcDebugGetTicks();
 */
-	jitcDebugLogAdd("=== jitcNewEntrypoint: %08x Beginning jitc ===\n", baseaddr+ofs);
+	jitcTraceEntrypoint(baseaddr+ofs);
 	jitc.currentPage = cp;
 	
 	jitcEmitAlign(jitc, jitc.hostCPUCaps.loop_align);
 
 	NativeAddress entry = cp->tcp;
-	jitcCreateEntrypoint(cp, ofs);
+	jitcCreateEntrypoint(jitc, cp, ofs);
+	jitcPerfMapBegin(jitc, entry, baseaddr+ofs);
 
 	byte *physpage;
 	ppc_direct_physical_memory_handle(baseaddr, physpage);
@@ -377,14 +859,34 @@ static NativeAddress jitcNewEntrypoint(JITC &jitc, ClientPage *cp, uint32 basead
 	jitc.checkedPriviledge = false;
 	jitc.checkedFloat = false;
 	jitc.checkedVector = false;
+
+	if (jitc.superblock) {
+		for (uint i=0; i < sizeof gPinnedRegisters / sizeof gPinnedRegisters[0]; i++) {
+			jitc.getClientRegister(gPinnedRegisters[i].creg,
+				NATIVE_REG | gPinnedRegisters[i].nreg);
+		}
+		jitc.superblockHead = ofs;
+		jitc.superblockLoop = jitc.asmHERE();
+	}
+	jitc.currentProfile = NULL;
+	if (jitc.profiling) jitcProfileBlock(jitc, baseaddr+ofs);
 	
 	// now we've setup jitc and can start the real compilation
 
 	byte instr[8] = {0x48, 0x3b, 0x3c, 0x25};
 	U32(instr + 4) = uint32(uint64(&gJITC));
+	uint64 *lines = &jitc.codeLines[(baseaddr >> 12)*2];
 	while (1) {
+		lines[ofs >> 11] |= 1ULL << ((ofs >> 5) & 63);
+		if (jitc.superblock) {
+			jitc.superblockVisited[ofs >> 8] |= 1ULL << ((ofs >> 2) & 63);
+		}
 		jitc.current_opc = ppc_word_from_BE(*(uint32 *)&physpage[ofs]);
-		jitcDebugLogNewInstruction(jitc);
+		jitcTraceInstruction(jitc);
+		if (jitc.currentProfile) {
+			jitc.currentProfile->insns++;
+			jitc.currentProfile->mix[jitcProfileClass(jitc.current_opc)]++;
+		}
 		
 //		jitc.clobberAll();
 //		jitc.clobberCarryAndFlags();
@@ -411,8 +913,16 @@ static NativeAddress jitcNewEntrypoint(JITC &jitc, ClientPage *cp, uint32 basead
 			jitc.checkedFloat = false;
 			jitc.checkedVector = false;
 			if (ofs+4 < 4096) {
-				jitcCreateEntrypoint(cp, ofs+4);
+				jitcCreateEntrypoint(jitc, cp, ofs+4);
+				if (jitc.profiling) jitcProfileBlock(jitc, baseaddr+ofs+4);
 			}
+		} else if (flow == flowFollow) {
+			/*
+			 *	Superblock: the branch emitted nothing and
+			 *	all mappings stay valid at its target
+			 */
+			ofs = jitc.pc = jitc.followPC;
+			continue;
 		} else {
 			/* flowEndBlockUnreachable */
 			break;
@@ -431,6 +941,8 @@ static NativeAddress jitcNewEntrypoint(JITC &jitc, ClientPage *cp, uint32 basead
 		}
 		jitc.pc += 4;
 	}
+	jitcPerfMapEnd(jitc, cp->tcp);
+	jitc.currentProfile = NULL;
 /*
 	jitcRunTicksStart = jitcDebugGetTicks();
 	jitcCompileTicks += jitcDebugGetTicks() - jitcCompileStartTicks;	
@@ -438,11 +950,50 @@ static NativeAddress jitcNewEntrypoint(JITC &jitc, ClientPage *cp, uint32 basead
 	return entry;
 }
 
+/*
+ *	Called from ppc_tier_up_asm when the counter of a backward
+ *	branch runs out. Translates the branch target again as a
+ *	superblock and makes it the entrypoint. The old code jumps
+ *	to the superblock, so existing links, patched branches and
+ *	target cache entries reach it as well.
+ *
+ *	This runs on the cpu thread: the translation cache and the
+ *	register allocator of the JITC aren't shareable, and hot
+ *	targets are few, so this costs little.
+ */
+extern "C" void jitcTierUp(JITC &jitc, JITCTierCounter *counter)
+{
+	// never fire again
+	counter->count = 0x7fffffff;
+	ClientPage *cp = counter->page;
+	if (cp->generation != counter->generation) {
+		// page has been destroyed while its code is still running
+		return;
+	}
+	NativeAddress old = jitcGetEntrypoint(cp, counter->ofs);
+
+	jitc.superblock = true;
+	jitc.superblockBranches = 0;
+	memset(jitc.superblockVisited, 0, sizeof jitc.superblockVisited);
+	NativeAddress entry = jitcNewEntrypoint(jitc, cp, cp->baseaddress, counter->ofs);
+	jitc.superblock = false;
+	jitc.superblocks++;
+
+	if (old) {
+		// there are always at least 5 bytes at an entrypoint
+		old[0] = 0xe9;
+		U32(old + 1) = entry - (old + 5);
+	}
+}
+
 extern "C" NativeAddress jitcStartTranslation(JITC &jitc, ClientPage *cp, uint32 baseaddr, uint32 ofs)
 {
-	cp->tcf_current = jitcAllocFragment(jitc);
+	jitc.translations++;
+	cp->tcf_current = jitcAllocFragment(jitc, cp);
 	cp->tcp = cp->tcf_current->base;
 	cp->bytesLeft = FRAGMENT_SIZE;
+	// from now on stores to the page have to be checked
+	ppc_mmu_protect_code_page(*gCPU, baseaddr);
 	
 	return jitcNewEntrypoint(jitc, cp, baseaddr, ofs);
 }
@@ -472,6 +1023,59 @@ extern "C" NativeAddress jitcNewPC(JITC &jitc, uint32 entry)
 	}
 }
 
+/*
+ *	Called from ppc_new_pc_link_asm, i.e. a branch to another page
+ *	which isn't linked (or whose code TLB check failed).
+ *	Like jitcNewPC, but additionally patches the branch at site
+ *	to jump directly to the translated code (see ppc_opc_gen_set_pc_far)
+ */
+extern "C" NativeAddress jitcNewPCLink(JITC &jitc, uint32 entry, NativeAddress site)
+{
+	ClientPage *source = *(ClientPage **)site;
+	uint32 sourceGeneration = source->generation;
+	NativeAddress dest = jitcNewPC(jitc, entry);
+	if (source->generation != sourceGeneration) {
+		// source has been destroyed while translating
+		return dest;
+	}
+	ClientPage *cp = jitc.clientPages[entry >> 12];
+	ClientPageLink **p = &cp->incomingLinks;
+	while (*p) {
+		ClientPageLink *link = *p;
+		if (link->site == site || !jitcLinkAlive(link, cp)) {
+			*p = link->next;
+			jitcFreeLink(jitc, link);
+		} else {
+			p = &link->next;
+		}
+	}
+	ClientPageLink *link = jitcAllocLink(jitc);
+	link->site = site;
+	link->source = source;
+	link->sourceGeneration = sourceGeneration;
+	link->next = cp->incomingLinks;
+	cp->incomingLinks = link;
+
+	U32(site - LINK_JMP_OFS) = dest - (site - 10);
+	U32(site - LINK_PHYS_OFS) = cp->baseaddress;
+	return dest;
+}
+
+/*
+ *	Called from ppc_new_pc_cached_asm if the target cache missed.
+ *	Like jitcNewPC, but additionally enters the result into the
+ *	target cache under the effective address ea
+ */
+extern "C" NativeAddress jitcNewPCCached(JITC &jitc, uint32 entry, uint32 ea)
+{
+	NativeAddress dest = jitcNewPC(jitc, entry);
+	BranchTargetCacheEntry &e = jitc.targetCache[(ea >> 2) & (TARGET_CACHE_ENTRIES-1)];
+	e.ea = ea;
+	e.phys = entry & 0xfffff000;
+	e.native = dest;
+	return dest;
+}
+
 extern "C" void jitc_error_msr_unsupported_bits(uint32 a)
 {
 	ht_printf("JITC msr Error: %08x\n", a);
@@ -527,48 +1131,52 @@ bool JITC::init(uint maxClientPages, uint32 tcSize)
 	ht_printf("translation cache: %p\n", translationCache);
 	
 	if (!translationCache) return false;
+	translationCacheSize = tcSize;
 	int maxPages = gMemorySize / 4096;
-	clientPages = ppc_malloc(maxPages * sizeof (ClientPage *));
-	memset(clientPages, 0, maxPages * sizeof (ClientPage *));
+	// everything below is zeroed by the arena
+	clientPages = jitcArenaAlloc<ClientPage *>(*this, maxPages);
+	codeLines = jitcArenaAlloc<uint64>(*this, maxPages * 2);
 
 	// allocate fragments
-	TranslationCacheFragment *tcf = ppc_malloc(sizeof (TranslationCacheFragment));
-	freeFragmentsList = tcf;
-	tcf->base = translationCache;
-	for (uint32 addr=FRAGMENT_SIZE; addr < tcSize; addr += FRAGMENT_SIZE) {
-		tcf->prev = ppc_malloc(sizeof (TranslationCacheFragment));
-		tcf = tcf->prev;
-		tcf->base = translationCache + addr;
+	uint32 fragmentCount = tcSize / FRAGMENT_SIZE;
+	fragments = jitcArenaAlloc<TranslationCacheFragment>(*this, fragmentCount);
+	for (uint32 i=0; i < fragmentCount; i++) {
+		fragments[i].base = translationCache + i * FRAGMENT_SIZE;
+		fragments[i].prev = i+1 < fragmentCount ? &fragments[i+1] : NULL;
 	}
-	tcf->prev = NULL;
+	freeFragmentsList = fragments;
 	
-	// allocate client pages
-	ClientPage *cp = ppc_malloc(sizeof (ClientPage));
-	memset(cp->entrypoints, 0, sizeof cp->entrypoints);
-	cp->tcf_current = NULL; // not translated yet
-	cp->lessRU = NULL;
-	LRUpage = NULL;
-	freeClientPages = cp;
-	for (uint i=1; i < maxClientPages; i++) {
-		cp->moreRU = ppc_malloc(sizeof (ClientPage));
-		cp->moreRU->lessRU = cp;
-		cp = cp->moreRU;
-		
-		memset(cp->entrypoints, 0, sizeof cp->entrypoints);
-		cp->tcf_current = NULL; // not translated yet
+	// allocate branch target caches
+	targetCache = jitcArenaAlloc<BranchTargetCacheEntry>(*this, TARGET_CACHE_ENTRIES);
+	for (int i=0; i < TARGET_CACHE_ENTRIES; i++) {
+		targetCache[i].ea = BRANCH_TARGET_INVALID;
 	}
-	cp->moreRU = NULL;
+	returnStack = jitcArenaAlloc<BranchTargetCacheEntry>(*this, RETURN_STACK_ENTRIES);
+	for (int i=0; i < RETURN_STACK_ENTRIES; i++) {
+		returnStack[i].ea = BRANCH_TARGET_INVALID;
+	}
+	returnStackTop = 0;
+
+	// allocate client pages (not translated yet)
+	ClientPage *pages = jitcArenaAlloc<ClientPage>(*this, maxClientPages);
+	for (uint i=0; i < maxClientPages; i++) {
+		pages[i].lessRU = i ? &pages[i-1] : NULL;
+		pages[i].moreRU = i+1 < maxClientPages ? &pages[i+1] : NULL;
+	}
+	freeClientPages = pages;
+	LRUpage = NULL;
 	MRUpage = NULL;
 	
 	// initialize native registers
-	NativeRegType *nr = ppc_malloc(sizeof (NativeRegType));
+	NativeRegType *regs = jitcArenaAlloc<NativeRegType>(*this, 16);
+	NativeRegType *nr = regs++;
 	nr->reg = RAX;
 	nr->lessRU = NULL;
 	LRUreg = nr;
 	nativeRegsList[RAX] = nr;
 	for (NativeReg reg = RCX; reg <= R15; reg=(NativeReg)(reg+1)) {
 		if (reg != RSP) {
-			nr->moreRU = ppc_malloc(sizeof (NativeRegType));
+			nr->moreRU = regs++;
 			nr->moreRU->lessRU = nr;
 			nr = nr->moreRU;
 			nr->reg = reg;
@@ -623,7 +1231,7 @@ bool JITC::init(uint maxClientPages, uint32 tcSize)
 	}
 	memset(nativeRegState, rsUnused, sizeof nativeRegState);
 
-	memset(n2cVectorReg, PPC_REG_NO, sizeof n2cVectorReg);
+	memset(n2cVectorReg, PPC_VECTREG_NO, sizeof n2cVectorReg);
 	memset(c2nVectorReg, VECTREG_NO, sizeof c2nVectorReg);
 	memset(nativeVectorRegState, rsUnused, sizeof nativeVectorRegState);
 
@@ -641,4 +1249,14 @@ bool JITC::init(uint maxClientPages, uint32 tcSize)
 void JITC::done()
 {
 	if (translationCache) sys_free_read_write_execute(translationCache);
+	while (tierCounterChunks) {
+		JITCTierCounterChunk *prev = tierCounterChunks->prev;
+		sys_free32(tierCounterChunks, sizeof *tierCounterChunks);
+		tierCounterChunks = prev;
+	}
+	while (arenaBlocks) {
+		JITCArenaBlock *prev = arenaBlocks->prev;
+		free(arenaBlocks);
+		arenaBlocks = prev;
+	}
 }
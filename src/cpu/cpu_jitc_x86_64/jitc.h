@@ -76,6 +76,9 @@ enum NativeVectorReg {
  */
 #define FRAGMENT_SIZE 512
 
+struct ClientPage;
+struct JITCTierCounter;
+
 /*
  *	Used to describe a fragment of translated client code
  *	If fragment is empty/invalid it isn't assigned to a
@@ -95,6 +98,80 @@ struct TranslationCacheFragment {
 	 *	Else this points to the next entry in the list of free fragments.
 	 */
 	TranslationCacheFragment *prev;
+	/*
+	 *	The page this fragment was last assigned to
+	 *	(see jitcSampleNativeAddress)
+	 */
+	ClientPage *owner;
+};
+
+/*
+ *	Used to cache the translated code of indirect branch targets
+ *	(see ppc_new_pc_cached_asm and ppc_new_pc_return_asm).
+ *	Also used for the entries of the return stack.
+ */
+struct BranchTargetCacheEntry {
+	/*
+	 *	Effective client address.
+	 *	Entry is invalid if the lower 2 bits are set
+	 */
+	uint32 ea;
+	/*
+	 *	Physical page of ea at the time the entry was made
+	 */
+	uint32 phys;
+	NativeAddress native;
+};
+
+#define TARGET_CACHE_ENTRIES	1024
+#define RETURN_STACK_ENTRIES	32
+#define BRANCH_TARGET_INVALID	1
+
+/*
+ *	Used to describe a direct branch from translated code
+ *	of one client page into another one (see ppc_opc_gen_set_pc_far)
+ */
+struct ClientPageLink {
+	/*
+	 *	Return address of the call to ppc_new_pc_link_asm,
+	 *	the patchable code lies before it
+	 */
+	NativeAddress site;
+	/*
+	 *	The page containing site. The link is stale if
+	 *	source->generation != sourceGeneration
+	 */
+	ClientPage *source;
+	uint32 sourceGeneration;
+	/*
+	 *	Next link into the same page or next free link
+	 */
+	ClientPageLink *next;
+};
+
+/*
+ *	Positions of the patchable fields relative to site
+ */
+#define LINK_PHYS_OFS	40	// imm32 of "mov ecx, phys"
+#define LINK_JMP_OFS	14	// rel32 of "jmp target" (relative to site-10)
+#define LINK_UNLINKED	0xffffffff
+
+/*
+ *	The entrypoints of a page are kept in a two-level table.
+ *	A chunk covers ENTRYPOINT_CHUNK_SIZE instructions and is
+ *	only allocated if one of them is an entrypoint.
+ */
+#define ENTRYPOINT_CHUNK_SIZE	32
+#define ENTRYPOINT_CHUNKS	(1024 / ENTRYPOINT_CHUNK_SIZE)
+
+struct EntrypointChunk {
+	union {
+		NativeAddress entry[ENTRYPOINT_CHUNK_SIZE];
+		/*
+		 *	Next entry in the list of free chunks
+		 */
+		EntrypointChunk *next;
+	};
 };
 
 /*
@@ -104,12 +181,13 @@ struct ClientPage {
 	/*
 	 *	This is used to translate client page addresses 
 	 *	into host addresses. Address isn't (yet) an entrypoint 
-	 *	or not yet translated if entrypoints[page_offset] == 0
+	 *	or not yet translated if the chunk of page_offset is NULL
+	 *	or its entry for page_offset is 0 (see jitcGetEntrypoint)
 	 *
 	 *	Note that a client page has 4096 bytes, but there are only
 	 *	1024 possible entries per page.
 	 */
-	NativeAddress entrypoints[1024];
+	EntrypointChunk *entrypoints[ENTRYPOINT_CHUNKS];
 
 	/*
 	 *	The fragment which has space left
@@ -125,8 +203,145 @@ struct ClientPage {
 	uint bytesLeft;		// Remaining bytes in current fragment
 	NativeAddress tcp;	// Translation cache pointer
 
+	/*
+	 *	Set if FPSCR asked for a rounding mode or exceptions
+	 *	while code of this page was running. All floating point
+	 *	instructions of this page are then interpreted.
+	 */
+	bool preciseFloat;
+
+	/*
+	 *	Incremented whenever the translation is thrown away
+	 */
+	uint32 generation;
+
+	/*
+	 *	Branches of other pages which jump directly into this page.
+	 *	They are unpatched when the translation is thrown away.
+	 */
+	ClientPageLink *incomingLinks;
+
+	/*
+	 *	Counters emitted into the translation (see jitcEmitTierCounter())
+	 */
+	JITCTierCounter *tierCounters;
+
 	ClientPage *moreRU;	// points to a page which was used more recently
 	ClientPage *lessRU;	// points to a page which was used less recently
+
+	/*
+	 *	Set if translated code of this page was found running
+	 *	(see jitcSampleNativeAddress). Such a page gets a second
+	 *	chance before it is evicted.
+	 */
+	bool referenced;
+};
+
+/*
+ *	Number of referenced pages which are spared per eviction
+ */
+#define EVICTION_SECOND_CHANCES	16
+
+/*
+ *	Instruction mix of a profiled block (see jitcProfileClass())
+ */
+enum JITCProfileClass {
+	profileInteger,		// integer, condition register and system instructions
+	profileLoad,
+	profileStore,
+	profileBranch,
+	profileFloat,
+	profileVector,
+	PROFILE_CLASSES
+};
+
+/*
+ *	Execution counters of a translated block (see jitcProfileBlock()).
+ *	A block starts at an entrypoint and ends at the next one.
+ */
+struct JITCBlockProfile {
+	uint64 count;		// times the block was entered
+	uint64 dispatched;	// exits through ppc_new_pc*_asm
+	uint64 chained;		// exits through a direct or linked jump
+	uint32 pc;		// physical client address
+	uint16 insns;		// client instructions
+	uint16 interpreted;	// client instructions done by ppc_opc_gen_interpret
+	uint16 mix[PROFILE_CLASSES];	// client instructions by JITCProfileClass
+	uint16 pad[2];
+};
+
+/*
+ *	The counters are incremented with absolute addressing,
+ *	so they are allocated in chunks within the lower 2 GiB
+ */
+#define PROFILE_CHUNK_BLOCKS	10922
+
+struct JITCProfileChunk {
+	JITCProfileChunk *prev;
+	uint32 used;
+	uint32 pad[5];
+	JITCBlockProfile blocks[PROFILE_CHUNK_BLOCKS];
+};
+
+/*
+ *	An interpreted instruction of a profiled block
+ */
+struct JITCInterpretedSite {
+	JITCBlockProfile *block;
+	uint32 opc;
+	JITCInterpretedSite *next;
+};
+
+/*
+ *	Counter of a backward branch within a page (see jitcEmitTierCounter()).
+ *	When it runs out, the code at the branch target is translated
+ *	again as a superblock (see jitcTierUp()).
+ *	It belongs to the translation of page and is recycled with it.
+ */
+struct JITCTierCounter {
+	uint32 count;
+	uint32 ofs;		// page offset of the branch target
+	ClientPage *page;
+	uint32 generation;	// of page when the counter was emitted
+	uint32 pad;
+	JITCTierCounter *next;	// of page or in freeTierCounters
+};
+
+/*
+ *	Like the profile counters these are decremented with
+ *	absolute addressing
+ */
+#define TIER_CHUNK_COUNTERS	4095
+
+struct JITCTierCounterChunk {
+	JITCTierCounterChunk *prev;
+	uint32 used;
+	uint32 pad[3];
+	JITCTierCounter counters[TIER_CHUNK_COUNTERS];
+};
+
+/*
+ *	A superblock follows at most this many unconditional branches
+ */
+#define SUPERBLOCK_MAX_BRANCHES	16
+
+/*
+ *	Header of a block of the JITC arena
+ */
+struct JITCArenaBlock {
+	JITCArenaBlock *prev;
+	uint64 pad;
+};
+
+#define ARENA_BLOCK_SIZE	(1024*1024)
+
+/*
+ *	What the x86 flags mean when they are mapped to a CR field
+ */
+enum JITCFlagsType {
+	flagsResult,		// S and Z of a result, cr0 only (see ppc_flush_flags_asm)
+	flagsCmpSigned,		// of a "cmp a, b": L, G and Z
+	flagsCmpUnsigned,	// of a "cmp a, b": B, A and Z
 };
 
 struct NativeRegType {
@@ -159,6 +374,15 @@ struct X86CPUCaps {
 	bool sse3;
 	bool ssse3;
 	bool sse4;
+	bool popcnt;
+	bool lzcnt;
+	bool movbe;
+	bool bmi1;
+	bool bmi2;
+	bool avx;	// includes OS support
+	bool avx2;
+	bool fma;
+	bool invariant_tsc;
 	uint loop_align;
 };
 
@@ -205,6 +429,7 @@ enum X86SimpleOpc {
 	X86_POPF = 0x9d,
 	X86_RET = 0xc3,
 	X86_STC = 0xf9,
+	X86_RDTSC = 0x310f,
 };
 
 enum X86FlagTest {
@@ -262,6 +487,11 @@ enum X86BitSearch {
 	X86_BSR  = 0xbd,
 };
 
+enum X86VFMAopc {
+	X86_VFMADD213SD = 0xa9,
+	X86_VFMSUB213SD = 0xab,
+};
+
 enum X86ALUPSopc {
 	X86_ANDPS  = 0x54,
 	X86_ANDNPS = 0x55,
@@ -270,7 +500,7 @@ enum X86ALUPSopc {
 	X86_MOVAPS = 0x28,
 	X86_MOVUPS = 0x10,
 	X86_ADDPS = 0x58,
-	X86_DIVPS = 0x53,
+	X86_DIVPS = 0x5E,
 	X86_MAXPS = 0x5F,
 	X86_MINPS = 0x5D,
 	X86_MULPS = 0x59,
@@ -280,6 +510,7 @@ enum X86ALUPSopc {
 	X86_SUBPS = 0x5C,
 	X86_UNPCKLPS = 0x14,
 	X86_UNPCKHPS = 0x15,
+	X86_CVTDQ2PS = 0x5B,
 };
 
 enum X86PALUopc {
@@ -316,6 +547,37 @@ enum X86PALUopc {
 	X86_PADD    = 0xFC,
 };
 
+enum X86PShiftOpc {
+	X86_PSRLW  = 0x7102,	// immediate forms: opcode << 8 | modrm.reg
+	X86_PSRAW  = 0x7104,
+	X86_PSLLW  = 0x7106,
+	X86_PSRLD  = 0x7202,
+	X86_PSRAD  = 0x7204,
+	X86_PSLLD  = 0x7206,
+	X86_PSRLQ  = 0x7302,
+	X86_PSRLDQ = 0x7303,
+	X86_PSLLQ  = 0x7306,
+	X86_PSLLDQ = 0x7307,
+};
+
+enum X86CMPPSPredicate {
+	X86_CMPEQPS = 0,
+	X86_CMPLTPS = 1,
+	X86_CMPLEPS = 2,
+	X86_CMPORDPS = 7,
+};
+
+enum X86ALUSDopc {
+	X86_ADDSD = 0x58,
+	X86_MULSD = 0x59,
+	X86_SUBSD = 0x5C,
+	X86_DIVSD = 0x5E,
+	X86_MINSD = 0x5D,
+	X86_MAXSD = 0x5F,
+	X86_SQRTSD = 0x51,
+	X86_CVTSD2SS = 0x5A,
+};
+
 #define PALUB(op)	((X86PALUopc)((op) | 0x00))
 #define PALUW(op)	((X86PALUopc)((op) | 0x01))
 #define PALUD(op)	((X86PALUopc)((op) | 0x02))
@@ -340,6 +602,28 @@ struct JITC {
 	 */
 	ClientPage **clientPages;
 
+	/*
+	 *	Target cache for indirect branches (bcctr and
+	 *	everything the return stack can't handle)
+	 */
+	BranchTargetCacheEntry *targetCache;
+
+	/*
+	 *	Return stack, pushed by calls and popped by bclr.
+	 *	returnStackTop indexes the most recent entry.
+	 *	Note that these three are accessed from jitc_tools.S
+	 */
+	BranchTargetCacheEntry *returnStack;
+	uint32 returnStackTop;
+
+	/*
+	 *	For every physical page a 128 bit mask (two qwords) of
+	 *	the 32 byte lines which contain translated instructions.
+	 *	A store to such a line throws the translation away, see
+	 *	jitcCheckCodeWrite(). Also accessed from jitc_mmu.S
+	 */
+	uint64 *codeLines;
+
 	/*
 	 *	If nativeReg[i] is set, it indicates to which client
 	 *	register this native register corrensponds.
@@ -352,6 +636,7 @@ struct JITC {
 	 *
 	 */
 	PPC_CRx nativeFlags;
+	JITCFlagsType nativeFlagsType;
 	RegisterState nativeFlagsState;
 	RegisterState nativeCarryState;
 	
@@ -399,23 +684,99 @@ struct JITC {
 	 *	Can be NULL.
 	 */
 	ClientPage *freeClientPages;
+
+	/*
+	 *	These are the unused ClientPageLinks as a linked list.
+	 *	Can be NULL.
+	 */
+	ClientPageLink *freeLinks;
+
+	/*
+	 *	These are the unused EntrypointChunks as a linked list.
+	 *	Can be NULL.
+	 */
+	EntrypointChunk *freeEntrypointChunks;
+
+	/*
+	 *	All of the above (and most other tables of the JITC) is
+	 *	carved out of the arena (see jitcArenaAlloc). It consists
+	 *	of blocks which are only freed in done().
+	 */
+	JITCArenaBlock *arenaBlocks;
+	byte *arenaFree;
+	uint arenaLeft;
 	
 	/*
 	 *
 	 */
 	byte *translationCache;
+	uint32 translationCacheSize;
+
+	/*
+	 *	All fragments of the translation cache
+	 *	(indexed by (base - translationCache) / FRAGMENT_SIZE)
+	 */
+	TranslationCacheFragment *fragments;
 	
 	/*
 	 *	Capabilities of the host cpu
 	 */
 	X86CPUCaps hostCPUCaps;
 
+	/*
+	 *	Inline loads and stores use the fastmem windows
+	 *	(see ppc_fastmem_init())
+	 */
+	bool fastmem;
+
+	/*
+	 *	Forward stores to following loads of the same client
+	 *	register and drop stores and moves which are overwritten
+	 *	right away (see JITC::loadRegister())
+	 */
+	bool peephole;
+
 	/*
 	 *	Statistics
 	 */
 	uint64	destroy_write;
 	uint64	destroy_oopages;
 	uint64	destroy_ootc;
+	uint64	translations;
+	uint64	fragments_freed;
+	uint64	second_chances;
+	uint64	hot_samples;
+	uint64	code_bytes;
+	uint64	peephole_saved;
+
+	/*
+	 *	Profiling of translated blocks (see jitcProfileBlock()).
+	 *	Only affects code translated while it is set.
+	 */
+	bool profiling;
+	JITCProfileChunk *profileChunks;
+	JITCInterpretedSite *interpretedSites;
+
+	/*
+	 *	Backward branches taken this often retranslate their
+	 *	target as a superblock (0 = never)
+	 */
+	uint32 superblockThreshold;
+	JITCTierCounterChunk *tierCounterChunks;
+	JITCTierCounter *freeTierCounters;
+	uint64 superblocks;
+
+	/*
+	 *	Let loops which only wait sleep (see ppc_cpu_idle_loop())
+	 */
+	bool idleDetect;
+	uint64 idle_sleeps;
+
+	/*
+	 *	Let copy and fill loops run on the host (see ppc_escape_block_loop())
+	 */
+	bool blockLoops;
+	uint64 block_loops;
 	
 	/*********************************************************************
 	 *	Only valid while compiling
@@ -424,6 +785,53 @@ struct JITC {
 	uint32 pc;
 	uint32 current_opc;
 
+	/*
+	 *	Start of the contiguous native code emitted since and
+	 *	the client address it belongs to (see jitcPerfMapAdd())
+	 */
+	NativeAddress perfMapStart;
+	uint32 perfMapPC;
+
+	/*
+	 *	If the last instruction emitted (from lastStoreStart to
+	 *	lastStoreEnd) stored lastStoreReg to the client register
+	 *	lastStoreSlot. Reset by asmHERE().
+	 */
+	NativeAddress lastStoreStart, lastStoreEnd;
+	PPC_Register lastStoreSlot;
+	NativeReg lastStoreReg;
+
+	/*
+	 *	If the last instruction emitted (from lastMoveStart to
+	 *	lastMoveEnd) only moved a register or immediate to
+	 *	lastMoveReg. Reset by asmHERE().
+	 */
+	NativeAddress lastMoveStart, lastMoveEnd;
+	NativeReg lastMoveReg;
+
+	/*
+	 *	Counters of the block being translated or NULL
+	 */
+	JITCBlockProfile *currentProfile;
+
+	/*
+	 *	Set while translating a superblock. Unconditional branches
+	 *	within the page are followed to followPC (see
+	 *	jitcSuperblockFollow()), superblockVisited is a bitmap
+	 *	of the instructions translated so far.
+	 */
+	bool superblock;
+	uint32 followPC;
+	uint superblockBranches;
+	uint64 superblockVisited[1024 / 64];
+
+	/*
+	 *	Page offset of the superblock and the native code after
+	 *	its preloaded registers (see jitcEmitSuperblockLoop())
+	 */
+	uint32 superblockHead;
+	NativeAddress superblockLoop;
+
 	/*
 	 *	If nativeVectorReg[i] is set, it indicates to which client
 	 *	vector register this native vector register corrensponds.
@@ -431,7 +839,7 @@ struct JITC {
 	JitcVectorReg n2cVectorReg[17];
 	NativeVectorReg c2nVectorReg[36];
 
-	RegisterState nativeVectorRegState[9];
+	RegisterState nativeVectorRegState[17];
 
 	/*
 	 *	Only used for the LRU list.
@@ -460,16 +868,20 @@ public:
 	void touchRegister(NativeReg reg);
 	void flushRegister(int options = NATIVE_REGS_ALL);
 	void flushRegisterDirty(int options = NATIVE_REGS_ALL);
+	void reloadRegister();
 	void clobberRegister(int options = NATIVE_REGS_ALL);
 	void getClientCarry();
-	void mapFlagsDirty(PPC_CRx cr = PPC_CR0);
+	void mapFlagsDirty(PPC_CRx cr = PPC_CR0, JITCFlagsType type = flagsResult);
 	void mapCarryDirty();
+	void flushFlagsDirty();
+	void discardFlags();
 	void clobberFlags();
 	void clobberCarry();
 	void clobberCarryAndFlags();
 	void flushCarryAndFlagsDirty(); // ONLY FOR DEBUG! DON'T CALL!
 
 	PPC_CRx getFlagsMapping();
+	JITCFlagsType getFlagsType();
 
 	bool flagsMapped();
 	bool carryMapped();
@@ -494,6 +906,11 @@ private:
 	NativeReg allocFixedRegister(NativeReg reg);
 	void flushSingleRegister(NativeReg reg);
 	void flushSingleRegisterDirty(NativeReg reg);
+	bool lastInsnStores(PPC_Register creg);
+	bool peepholeMayDrop(NativeAddress end);
+	void dropLastInsn(NativeAddress start);
+	void overwriteRegister(NativeReg nreg);
+	void movedRegister(NativeReg nreg, uint64 code_bytes_before);
 	void flushCarry();
 	void flushFlags();
 	
@@ -504,6 +921,9 @@ public:
 
 	NativeAddress asmHERE()
 	{
+		// code may jump here, so the peephole must not look back
+		lastStoreEnd = NULL;
+		lastMoveEnd = NULL;
 		return currentPage->tcp;
 	}
 
@@ -525,9 +945,12 @@ public:
 	void asmALU32(X86ALUopc opc, NativeReg base, int scale, NativeReg index, uint64 disp, NativeReg reg);
 	void asmALU32(X86ALUopc opc, NativeReg base, uint32 disp, uint32 imm);
 	void asmALU32(X86ALUopc1 opc, NativeReg reg);
+	void asmALU64(X86ALUopc1 opc, NativeReg reg);
 	void asmMOV32(NativeReg reg, uint32 imm);
 	void asmMOV32_NoFlags(NativeReg reg, uint32 imm);
 
+	void asmALU16(X86ALUopc opc, NativeReg base, uint32 disp, NativeReg reg);
+
 	void asmALU8(X86ALUopc opc, NativeReg reg1, NativeReg reg2);
 	void asmALU8(X86ALUopc opc, NativeReg base, uint32 disp, uint8 imm);
 	void asmALU8(X86ALUopc opc, NativeReg reg, NativeReg base, uint32 disp);
@@ -546,10 +969,12 @@ public:
 	void asmMOVxx32_8(X86MOVxx opc, NativeReg reg1, NativeReg reg2);
 	void asmMOVxx32_8(X86MOVxx opc, NativeReg reg1, NativeReg base, uint32 disp);
 	void asmMOVxx32_16(X86MOVxx opc, NativeReg reg1, NativeReg reg2);
+	void asmMOVxx32_16(X86MOVxx opc, NativeReg reg1, NativeReg base, uint32 disp);
 	void asmShift16(X86ShiftOpc opc, NativeReg reg, uint imm);
 	void asmShift32(X86ShiftOpc opc, NativeReg reg, uint imm);
 	void asmShift64(X86ShiftOpc opc, NativeReg reg, uint imm);
 	void asmShift32CL(X86ShiftOpc opc, NativeReg reg);
+	void asmSHRD64(NativeReg reg1, NativeReg reg2, uint imm);
 	void asmINC32(NativeReg reg);
 	void asmDEC32(NativeReg reg);
 
@@ -563,6 +988,15 @@ public:
 	void asmBSWAP32(NativeReg reg);
 	void asmBSWAP64(NativeReg reg);
 
+	/*
+	 *	Only if hostCPUCaps says so
+	 */
+	void asmLZCNT32(NativeReg reg1, NativeReg reg2);
+	void asmMOVBE32(NativeReg reg, NativeReg base, uint32 disp);
+	void asmMOVBE32(NativeReg base, uint32 disp, NativeReg reg);
+	void asmANDN32(NativeReg reg1, NativeReg reg2, NativeReg reg3);
+	void asmRORX32(NativeReg reg1, NativeReg reg2, uint imm);
+
 	void asmJMP(NativeAddress to);
 	void asmJxx(X86FlagTest flags, NativeAddress to);
 	NativeAddress asmJMPFixup();
@@ -591,14 +1025,12 @@ private:
 public:
 	void floatRegisterClobberAll() {}
 
-#if 0
 	NativeVectorReg allocVectorRegister(int hint=0);
 	void dirtyVectorRegister(NativeVectorReg nreg);
 	void touchVectorRegister(NativeVectorReg nreg);
 
 	int assertFlushedVectorRegister(JitcVectorReg creg);
 	int assertFlushedVectorRegisters();
-	void showVectorRegisterStatus(JitcVectorReg creg);
 
 	NativeVectorReg mapClientVectorRegisterDirty(JitcVectorReg creg, int hint=0);
 	NativeVectorReg getClientVectorRegister(JitcVectorReg creg, int hint=0);
@@ -606,37 +1038,78 @@ public:
 	NativeVectorReg getClientVectorRegisterMapping(JitcVectorReg creg);
 	NativeVectorReg renameVectorRegisterDirty(NativeVectorReg reg, JitcVectorReg creg, int hint=0);
 
-	void flushVectorRegister(int options=0);
-	void flushVectorRegisterDirty(int options=0);
-	void clobberVectorRegister(int options=0);
-	void trashVectorRegister(int options=0);
-	void dropVectorRegister(int options=0);
+	void flushVectorRegister(int options=JITC_VECTOR_REGS_ALL);
+	void flushVectorRegisterDirty(int options=JITC_VECTOR_REGS_ALL);
+	void reloadVectorRegister();
+	void clobberVectorRegister(int options=JITC_VECTOR_REGS_ALL);
+	void trashVectorRegister(int options=JITC_VECTOR_REGS_ALL);
+	void dropVectorRegister(int options=JITC_VECTOR_REGS_ALL);
 
 	void flushClientVectorRegister(JitcVectorReg creg);
 	void trashClientVectorRegister(JitcVectorReg creg);
 	void clobberClientVectorRegister(JitcVectorReg creg);
 	void dropClientVectorRegister(JitcVectorReg creg);
 
-	void asmMOVAPS(NativeVectorReg reg, const void *disp);
-	void asmMOVAPS(const void *disp, NativeVectorReg reg);
-	void asmMOVUPS(NativeVectorReg reg, const void *disp);
-	void asmMOVUPS(const void *disp, NativeVectorReg reg);
-	void asmMOVSS(NativeVectorReg reg, const void *disp);
-	void asmMOVSS(const void *disp, NativeVectorReg reg);
+	void asmMOVUPS(NativeVectorReg reg, NativeReg base, uint32 disp);
+	void asmMOVUPS(NativeReg base, uint32 disp, NativeVectorReg reg);
 
 	void asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, NativeVectorReg reg2);
-	void asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, modrm_p modrm);
+	void asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, NativeReg base, uint32 disp);
 	void asmPALU(X86PALUopc opc, NativeVectorReg reg1, NativeVectorReg reg2);
-	void asmPALU(X86PALUopc opc, NativeVectorReg reg1, modrm_p modrm);
+	void asmPALU(X86PALUopc opc, NativeVectorReg reg1, NativeReg base, uint32 disp);
+	void asmPShift(X86PShiftOpc opc, NativeVectorReg reg, int imm);
 
 	void asmSHUFPS(NativeVectorReg reg1, NativeVectorReg reg2, int order);
-	void asmSHUFPS(NativeVectorReg reg1, modrm_p modrm, int order);
+	void asmCMPPS(X86CMPPSPredicate pred, NativeVectorReg reg1, NativeVectorReg reg2);
 	void asmPSHUFD(NativeVectorReg reg1, NativeVectorReg reg2, int order);
-	void asmPSHUFD(NativeVectorReg reg1, modrm_p modrm, int order);
-#endif
+	void asmPSHUFLW(NativeVectorReg reg1, NativeVectorReg reg2, int order);
+	void asmPSHUFHW(NativeVectorReg reg1, NativeVectorReg reg2, int order);
+	void asmPSHUFB(NativeVectorReg reg1, NativeVectorReg reg2);
+
+	void asmMOVD(NativeVectorReg reg1, NativeReg reg2);
+	void asmMOVD(NativeReg reg1, NativeVectorReg reg2);
+	void asmPMOVMSKB(NativeReg reg1, NativeVectorReg reg2);
+
+	void asmALUSD(X86ALUSDopc opc, NativeVectorReg reg1, NativeVectorReg reg2);
+	void asmCMPSD(X86CMPPSPredicate pred, NativeVectorReg reg1, NativeVectorReg reg2);
+	void asmUCOMISD(NativeVectorReg reg1, NativeVectorReg reg2);
+	void asmLDMXCSR(NativeReg base, uint32 disp);
+	void asmSTMXCSR(NativeReg base, uint32 disp);
+	void asmCVTSS2SD(NativeVectorReg reg1, NativeVectorReg reg2);
+	void asmCVTSD2SI(NativeReg reg1, NativeVectorReg reg2);
+	void asmCVTTSD2SI(NativeReg reg1, NativeVectorReg reg2);
+	void asmMOVQ(NativeVectorReg reg1, NativeReg reg2);
+	void asmMOVQ(NativeReg reg1, NativeVectorReg reg2);
+	void asmVFMASD(X86VFMAopc opc, NativeVectorReg reg1, NativeVectorReg reg2, NativeVectorReg reg3);
+
+private:
+	void mapVectorRegister(NativeVectorReg nreg, JitcVectorReg creg);
+	void unmapVectorRegister(NativeVectorReg nreg);
+	void undirtyVectorRegister(NativeVectorReg nreg);
+	void loadVectorRegister(NativeVectorReg nreg);
+	void storeVectorRegister(NativeVectorReg nreg);
+	void discardVectorRegister(NativeVectorReg nreg);
+	void dropSingleVectorRegister(NativeVectorReg nreg);
+	void flushSingleVectorRegister(NativeVectorReg nreg);
+	void trashSingleVectorRegister(NativeVectorReg nreg);
+	void clobberSingleVectorRegister(NativeVectorReg nreg);
+	void asmSSE(uint8 prefix, uint opc, int reg1, int reg2, int imm = -1);
+	void asmSSE(uint8 prefix, uint opc, int reg, NativeReg base, uint32 disp);
+	void asmVEX(uint pp, uint map, bool w, uint opc, int reg1, int reg2, int reg3, int imm = -1);
 };
 
 extern "C" void jitcDestroyAndFreeClientPage(JITC &aJITC, ClientPage *cp);
+extern "C" void jitcPreciseFloatClientPage(JITC &aJITC, ClientPage *cp);
+extern "C" bool jitcCheckCodeWrite(JITC &aJITC, uint32 pa, uint size);
+extern "C" void jitcSampleNativeAddress(JITC &aJITC, NativeAddress addr);
+void jitcProfileExit(JITC &aJITC, bool chained);
+void jitcProfileInterpreted(JITC &aJITC);
+void jitcEmitTierCounter(JITC &aJITC, uint32 ofs);
+bool jitcSuperblockFollow(JITC &aJITC, uint32 ofs);
+void jitcEmitSuperblockLoop(JITC &aJITC);
+extern "C" void jitcTierUp(JITC &aJITC, JITCTierCounter *counter);
 extern "C" NativeAddress jitcNewPC(JITC &aJITC, uint32 entry);
+extern "C" NativeAddress jitcNewPCLink(JITC &aJITC, uint32 entry, NativeAddress site);
+extern "C" NativeAddress jitcNewPCCached(JITC &aJITC, uint32 entry, uint32 ea);
 
 #endif
@@ -41,6 +41,9 @@ extern "C" void ppc_read_effective_dword_asm();
 extern "C" void ppc_read_effective_qword_asm();
 extern "C" void ppc_read_effective_qword_sse_asm();
 
+extern "C" void ppc_fastmem_map_read_asm();
+extern "C" void ppc_fastmem_map_write_asm();
+
 extern "C" void ppc_opc_stswi_asm();
 extern "C" void ppc_opc_lswi_asm();
 extern "C" void ppc_opc_icbi_asm();
@@ -50,6 +53,7 @@ extern "C" void ppc_dsi_exception_asm();
 extern "C" void ppc_dsi_exception_special_asm();
 extern "C" void ppc_program_exception_asm();
 extern "C" void ppc_no_fpu_exception_asm();
+extern "C" void ppc_precise_float_asm();
 extern "C" void ppc_no_vec_exception_asm();
 extern "C" void ppc_sc_exception_asm();
 extern "C" void ppc_flush_flags_asm();
@@ -59,18 +63,40 @@ extern "C" void ppc_flush_flags_signed_0_asm();
 extern "C" void ppc_flush_flags_unsigned_even_asm();
 extern "C" void ppc_flush_flags_unsigned_odd_asm();
 extern "C" void ppc_flush_flags_unsigned_0_asm();
+extern "C" void ppc_flush_flags_signed_1_asm();
+extern "C" void ppc_flush_flags_signed_2_asm();
+extern "C" void ppc_flush_flags_signed_3_asm();
+extern "C" void ppc_flush_flags_signed_4_asm();
+extern "C" void ppc_flush_flags_signed_5_asm();
+extern "C" void ppc_flush_flags_signed_6_asm();
+extern "C" void ppc_flush_flags_signed_7_asm();
+extern "C" void ppc_flush_flags_unsigned_1_asm();
+extern "C" void ppc_flush_flags_unsigned_2_asm();
+extern "C" void ppc_flush_flags_unsigned_3_asm();
+extern "C" void ppc_flush_flags_unsigned_4_asm();
+extern "C" void ppc_flush_flags_unsigned_5_asm();
+extern "C" void ppc_flush_flags_unsigned_6_asm();
+extern "C" void ppc_flush_flags_unsigned_7_asm();
 extern "C" void ppc_new_pc_asm();
 extern "C" void ppc_new_pc_rel_asm();
 extern "C" void ppc_new_pc_this_page_asm();
+extern "C" void ppc_new_pc_link_asm();
+extern "C" void ppc_new_pc_link_rel_asm();
+extern "C" void ppc_new_pc_cached_asm();
+extern "C" void ppc_new_pc_return_asm();
+extern "C" void ppc_push_return_asm();
 extern "C" void ppc_heartbeat_ext_asm();
 extern "C" void ppc_heartbeat_ext_rel_asm();
+extern "C" void ppc_tier_up_asm();
 
 
 extern "C" void ppc_set_msr_asm();
 extern "C" void ppc_mmu_tlb_invalidate_all_asm(PPC_CPU_State *cpu);
 extern "C" void ppc_mmu_tlb_invalidate_entry_asm();
+extern "C" void ppc_mmu_tlb_update_asid_asm();
 
 extern "C" void FASTCALL ppc_start_jitc_asm(uint32 newpc, PPC_CPU_State **cpu, uint32 size);
 extern "C" bool FASTCALL ppc_cpuid_asm(uint32 level, void *struc);
+extern "C" uint64 ppc_xgetbv_asm(uint32 xcr);
 
 #endif
@@ -1,7 +1,19 @@
 // as does not have a ~ operator..
 #define ASM_NEG32(a) (0xffffffff-(a))
 
-#define TLB_ENTRIES 32
+// see ppc_cpu.h
+#ifndef TLB_SETS_LOG2
+#define TLB_SETS_LOG2 6
+#endif
+#ifndef TLB_WAYS_LOG2
+#define TLB_WAYS_LOG2 2
+#endif
+#define TLB_SETS (1 << TLB_SETS_LOG2)
+#define TLB_WAYS (1 << TLB_WAYS_LOG2)
+#define TLB_SET_SHIFT (TLB_WAYS_LOG2 + 4)
+#define TLB_SET_MASK ((TLB_SETS-1) << TLB_SET_SHIFT)
+#define TARGET_CACHE_ENTRIES 1024
+#define RETURN_STACK_ENTRIES 32
 
 
 //STRUCT(PPC_CPU_State)
@@ -61,6 +73,7 @@
 #define pagetable_hashmask (pagetable_base+4)
 #define reserve (pagetable_hashmask+4)
 #define have_reservation (reserve+4)
+#define code_destroyed (have_reservation+1)
 
 #define tlb_last (have_reservation + 4)
 #define tlb_pa (tlb_last + 4)
@@ -74,23 +87,43 @@
 #define pc_ofs (x87cw + 4)
 #define current_code_base (pc_ofs + 4)
 
-#define tlb_code_0_eff (current_code_base + 4)
-#define tlb_data_0_eff (tlb_code_0_eff + TLB_ENTRIES*4)
-#define tlb_data_8_eff (tlb_data_0_eff + TLB_ENTRIES*4)
-#define tlb_code_0_phys (tlb_data_8_eff + TLB_ENTRIES*4)
-#define tlb_data_0_phys  (tlb_code_0_phys + TLB_ENTRIES*8)
-#define tlb_data_8_phys (tlb_data_0_phys + TLB_ENTRIES*8)
+#define tlb_code_asid (current_code_base + 8)
+#define tlb_data_asid (tlb_code_asid + 16*8)
+#define tlb_code_0 (tlb_data_asid + 16*8)
+#define tlb_data_0 (tlb_code_0 + TLB_SETS*TLB_WAYS*16)
+#define tlb_data_8 (tlb_data_0 + TLB_SETS*TLB_WAYS*16)
+#define tlb_code_0_hits (tlb_data_8 + TLB_SETS*TLB_WAYS*16)
+#define tlb_data_0_hits (tlb_code_0_hits + 8)
+#define tlb_data_8_hits (tlb_data_0_hits + 8)
+#define tlb_code_0_misses (tlb_data_8_hits + 8)
+#define tlb_data_0_misses (tlb_code_0_misses + 8)
+#define tlb_data_8_misses (tlb_data_0_misses + 8)
+#define fastmem_base (tlb_data_8_misses + 8)
+#define fastmem_window (fastmem_base + 8)
+#define tsc_base (fastmem_window + 3*8)
+#define tsc_mul (tsc_base + 8)
+#define tb_offset (tsc_mul + 8)
+#define dec_offset (tb_offset + 8)
+#define dec_deadline (dec_offset + 8)
 
 //STRUCT(JITC)
 #define clientPages 0
+#define targetCache (clientPages + 8)
+#define returnStack (targetCache + 8)
+#define returnStackTop (returnStack + 8)
+#define codeLines (returnStackTop + 8)
 
 //STRUCT(ClientPage)
 #define entrypoints 0
-#define tcf_current (entrypoints + 1024*8)
+#define tcf_current (entrypoints + 32*8)
 #define baseaddress (tcf_current + 8)
 #define bytesLeft (baseaddress + 4)
 #define tcp (bytesLeft + 4)
-#define moreRU (tcp + 8)
+#define preciseFloat (tcp + 8)
+#define generation (preciseFloat + 4)
+#define incomingLinks (generation + 4)
+#define tierCounters (incomingLinks + 8)
+#define moreRU (tierCounters + 8)
 #define lessRU (moreRU + 8)
 
 #define curCPU(r) rdi+r
@@ -1,6 +1,6 @@
 /*
  *	PearPC
- *	jitc_debug.h
+ *	jitc_debug.cc
  *
  *	Copyright (C) 2004 Sebastian Biallas (sb@biallas.net)
  *
@@ -18,219 +18,394 @@
  *	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <unistd.h>
 
 #include "tools/data.h"
-#include "tools/str.h"
+#include "tools/snprintf.h"
 #include "tools/endianess.h"
-
-#include "debug/x86dis.h"
 #include "debug/ppcdis.h"
-#include "tools/snprintf.h"
+#include "ppc_cpu.h"
+#include "ppc_esc.h"
+#include "ppc_mmu.h"
 #include "jitc.h"
 #include "jitc_asm.h"
 #include "jitc_debug.h"
 
-#ifdef JITC_DEBUG
-
 #include "io/prom/promosi.h"
 
-static FILE *gDebugLog;
-static AVLTree *symbols;
-
-static char *symbol_lookup(CPU_ADDR addr, int *symstrlen, void *context)
-{
-/*	foreach(KeyValue, kv, *symbols, {
-		ht_printf("lookup %y -> %y\n", kv->mKey, kv->mValue);
-	});*/
-	
-	KeyValue tmp(new UInt64(addr.flat64.addr), NULL);
-	
-	ObjHandle oh = symbols->find(&tmp);
-//		return NULL;
-	if (oh != InvObjHandle) {
-		KeyValue *kv = (KeyValue*)symbols->get(oh);
-//		ht_printf("lookup '%y'\n", kv->mValue);
-		if (symstrlen) *symstrlen = ((String *)kv->mValue)->length();
-		return ((String *)kv->mValue)->contentChar();
-	} else {
-//		ht_printf("lookup %08x failed\n", addr.addr32.offset);
-//		if (symstrlen) *symstrlen = 1;
-		return NULL;
+extern JITC *gJITC;
+
+bool gJITCTrace = false;
+
+static byte *gTraceBuffer;
+static uint32 gTraceSize;	// power of 2
+static uint64 gTraceHead;	// bytes written so far
+static uint64 gTraceTail;	// position of the oldest record
+
+/*
+ *	Written into the dump, so that jitctrace can name
+ *	the targets of calls from translated code
+ */
+static const struct {
+	const void *address;
+	const char *name;
+} gTraceSymbols[] = {
+#define SYM(s) { (const void *)&s, #s }
+	SYM(ppc_write_effective_byte_asm),
+	SYM(ppc_write_effective_half_asm),
+	SYM(ppc_write_effective_word_asm),
+	SYM(ppc_write_effective_dword_asm),
+	SYM(ppc_write_effective_qword_asm),
+	SYM(ppc_read_effective_byte_asm),
+	SYM(ppc_read_effective_half_z_asm),
+	SYM(ppc_read_effective_half_s_asm),
+	SYM(ppc_read_effective_word_asm),
+	SYM(ppc_read_effective_dword_asm),
+	SYM(ppc_read_effective_qword_asm),
+	SYM(ppc_fastmem_map_read_asm),
+	SYM(ppc_fastmem_map_write_asm),
+	SYM(ppc_fastmem_invalidate),
+	SYM(ppc_opc_icbi_asm),
+	SYM(ppc_opc_stswi_asm),
+	SYM(ppc_opc_lswi_asm),
+	SYM(ppc_isi_exception_asm),
+	SYM(ppc_dsi_exception_asm),
+	SYM(ppc_dsi_exception_special_asm),
+	SYM(ppc_program_exception_asm),
+	SYM(ppc_no_fpu_exception_asm),
+	SYM(ppc_sc_exception_asm),
+	SYM(ppc_flush_flags_asm),
+	SYM(ppc_new_pc_asm),
+	SYM(ppc_new_pc_rel_asm),
+	SYM(ppc_set_msr_asm),
+	SYM(ppc_mmu_tlb_invalidate_all_asm),
+	SYM(ppc_start_jitc_asm),
+	SYM(ppc_new_pc_this_page_asm),
+	SYM(ppc_new_pc_link_asm),
+	SYM(ppc_new_pc_link_rel_asm),
+	SYM(ppc_new_pc_cached_asm),
+	SYM(ppc_new_pc_return_asm),
+	SYM(ppc_push_return_asm),
+	SYM(ppc_heartbeat_ext_asm),
+	SYM(ppc_heartbeat_ext_rel_asm),
+	SYM(ppc_tier_up_asm),
+	SYM(ppc_mmu_tlb_invalidate_entry_asm),
+	SYM(ppc_mmu_tlb_update_asid_asm),
+	SYM(ppc_flush_flags_signed_0_asm),
+	SYM(ppc_flush_flags_unsigned_0_asm),
+	SYM(ppc_get_cpu_timebase),
+	SYM(ppc_cpu_idle_loop),
+	SYM(ppc_escape_vm),
+	SYM(ppc_escape_block_loop),
+	SYM(call_prom_osi),
+#undef SYM
+};
+
+static void jitcTraceRead(uint64 pos, void *data, uint size)
+{
+	for (uint i=0; i < size; i++) {
+		((byte*)data)[i] = gTraceBuffer[(pos+i) & (gTraceSize-1)];
 	}
 }
 
-inline static void disasmPPC(uint32 code, uint32 ea, char *result)
+static void jitcTraceWrite(const void *data, uint size)
 {
-	PPCDisassembler dis(PPC_MODE_32);
-	CPU_ADDR addr;
-	addr.addr32.offset = ea;
-	addr_sym_func = NULL;
-	byte code_buf[4];
-	createForeignInt(code_buf, code, 4, big_endian);
-	strcpy(result, dis.str(dis.decode(code_buf, 4, addr), 0));
+	for (uint i=0; i < size; i++) {
+		gTraceBuffer[(gTraceHead+i) & (gTraceSize-1)] = ((const byte*)data)[i];
+	}
+	gTraceHead += size;
 }
 
-inline static int disasmX86(const byte *code, uint64 ea, char *result)
+static void jitcTraceAdd(JITCTraceRecord &r, const byte *data = NULL)
 {
-	x86_64dis dis;
-	CPU_ADDR addr;
-	addr.flat64.addr = ea;
-	addr_sym_func = symbol_lookup;
-	dis_insn *ret = dis.decode(code, 15, addr);
-	strcpy(result, dis.str(ret, DIS_STYLE_HEX_NOZEROPAD));
-	return dis.getSize(ret);
+	uint size = sizeof r + r.size;
+	// drop the oldest records until there's room
+	while (gTraceHead + size - gTraceTail > gTraceSize) {
+		JITCTraceRecord old;
+		jitcTraceRead(gTraceTail, &old, sizeof old);
+		gTraceTail += sizeof old + old.size;
+	}
+	jitcTraceWrite(&r, sizeof r);
+	if (r.size) jitcTraceWrite(data, r.size);
+}
+
+void jitcTraceAddEntrypoint(uint32 pc)
+{
+	JITCTraceRecord r;
+	r.pc = pc;
+	r.opc = 0;
+	r.hostOffset = 0;
+	r.size = 0;
+	r.type = JITC_TRACE_ENTRYPOINT;
+	jitcTraceAdd(r);
 }
 
-void jitcDebugLogAdd(const char *fmt, ...)
+void jitcTraceAddInstruction(JITC &jitc)
 {
-	va_list ap;
+	JITCTraceRecord r;
+	r.pc = jitc.currentPage->baseaddress + jitc.pc;
+	r.opc = jitc.current_opc;
+	r.hostOffset = jitc.currentPage->tcp - jitc.translationCache;
+	r.size = 0;
+	r.type = JITC_TRACE_INSN;
+	jitcTraceAdd(r);
+}
 
-	va_start(ap, fmt);
-	ht_vfprintf(gDebugLog, fmt, ap);
-	va_end(ap);
-	fflush(gDebugLog);
+void jitcTraceAddNative(JITC &jitc, const byte *insn, int size)
+{
+	JITCTraceRecord r;
+	r.pc = 0;
+	r.opc = 0;
+	r.hostOffset = jitc.currentPage->tcp - jitc.translationCache;
+	r.size = size;
+	r.type = JITC_TRACE_NATIVE;
+	jitcTraceAdd(r, insn);
 }
 
-void jitcDebugLogNewInstruction(JITC &jitc)
+extern "C" bool jitcTraceEnable(uint size)
 {
-	char str[128];
-	disasmPPC(jitc.current_opc, jitc.pc, str);
-	jitcDebugLogAdd("%08x   %08x  %s\n", jitc.pc, jitc.current_opc, str);
+	if (!size) {
+		gJITCTrace = false;
+		return true;
+	}
+	uint32 bytes = 4096;
+	while (bytes < uint64(size)*1024 && bytes < 0x40000000) bytes <<= 1;
+	if (bytes != gTraceSize) {
+		byte *buf = (byte*)malloc(bytes);
+		if (!buf) return false;
+		free(gTraceBuffer);
+		gTraceBuffer = buf;
+		gTraceSize = bytes;
+		gTraceHead = gTraceTail = 0;
+	}
+	gJITCTrace = true;
+	return true;
 }
 
-void jitcDebugLogEmit(JITC &jitc, const byte *insn, int size)
+extern "C" bool jitcTraceDump(const char *filename)
 {
-	char str[128];
-	int size1 = disasmX86(insn, uint64(jitc.currentPage->tcp), str);
-	if (size != size1) jitcDebugLogAdd(" kaputt! ");
-	jitcDebugLogAdd("  ");
-	jitcDebugLogAdd("%p ", jitc.currentPage->tcp);
-	for (int i=0; i < 15; i++) {
-		if (i < size) {
-			jitcDebugLogAdd("%02x", insn[i]);
-		} else {
-			jitcDebugLogAdd("  ");
-		}
+	if (!gTraceBuffer) return false;
+	FILE *f = fopen(filename, "wb");
+	if (!f) return false;
+	JITCTraceFileHeader h;
+	memcpy(h.magic, JITC_TRACE_MAGIC, sizeof h.magic);
+	h.version = JITC_TRACE_VERSION;
+	h.translationCache = uint64(gJITC->translationCache);
+	h.symbols = sizeof gTraceSymbols / sizeof gTraceSymbols[0];
+	h.size = gTraceHead - gTraceTail;
+	fwrite(&h, sizeof h, 1, f);
+	for (uint i=0; i < h.symbols; i++) {
+		uint64 addr = uint64(gTraceSymbols[i].address);
+		uint32 len = strlen(gTraceSymbols[i].name);
+		fwrite(&addr, sizeof addr, 1, f);
+		fwrite(&len, sizeof len, 1, f);
+		fwrite(gTraceSymbols[i].name, len, 1, f);
 	}
-	jitcDebugLogAdd("  %s\n", str);
-}
-                                                  
-void jitcDebugInit()
-{
-//	gDebugLog = stdout;
-	gDebugLog = fopen("jitc.log", "w");
-	symbols = new AVLTree(true);
-#if 0	
-	for (int i=0; i<32; i++) {
-		String *s = new String();
-		s->assignFormat("r%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.gpr[i]), s));
+	// the records may wrap around the end of the buffer
+	uint32 start = gTraceTail & (gTraceSize-1);
+	uint32 first = gTraceSize - start;
+	if (first > h.size) first = h.size;
+	fwrite(gTraceBuffer + start, first, 1, f);
+	fwrite(gTraceBuffer, h.size - first, 1, f);
+	bool ok = !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+bool gJITCPerfMap = false;
+static FILE *gPerfMap;
+
+bool jitcPerfMapEnable()
+{
+	char name[64];
+	ht_snprintf(name, sizeof name, "/tmp/perf-%d.map", int(getpid()));
+	gPerfMap = fopen(name, "w");
+	if (!gPerfMap) return false;
+	// every line at once, "perf top" reads it while we run (or crash)
+	setvbuf(gPerfMap, NULL, _IOLBF, BUFSIZ);
+	gJITCPerfMap = true;
+	return true;
+}
+
+void jitcPerfMapAdd(uint32 pc, NativeAddress start, NativeAddress end)
+{
+	fprintf(gPerfMap, "%llx %llx ppc_%08x\n", (unsigned long long)start,
+		(unsigned long long)(end - start), pc);
+}
+
+struct ProfiledBlock {
+	JITCBlockProfile *p;
+	uint seq;		// order of translation
+};
+
+/*
+ *	By pc, translations of the same pc in the order they were made
+ */
+static int compareBlockPC(const void *a, const void *b)
+{
+	const ProfiledBlock *ba = (const ProfiledBlock *)a;
+	const ProfiledBlock *bb = (const ProfiledBlock *)b;
+	if (ba->p->pc != bb->p->pc) return ba->p->pc < bb->p->pc ? -1 : 1;
+	return ba->seq < bb->seq ? -1 : ba->seq > bb->seq;
+}
+
+static uint64 blockWeight(const JITCBlockProfile *p)
+{
+	return p->count * p->insns;
+}
+
+static int compareBlockWeight(const void *a, const void *b)
+{
+	uint64 wa = blockWeight((JITCBlockProfile *)a);
+	uint64 wb = blockWeight((JITCBlockProfile *)b);
+	return wa > wb ? -1 : wa < wb;
+}
+
+struct InterpretedWeight {
+	char name[16];
+	uint64 count;
+	uint32 sites;
+};
+
+static int compareInterpretedWeight(const void *a, const void *b)
+{
+	uint64 wa = ((InterpretedWeight *)a)->count;
+	uint64 wb = ((InterpretedWeight *)b)->count;
+	return wa > wb ? -1 : wa < wb;
+}
+
+static void mnemonic(uint32 opc, char *result, int size)
+{
+	PPCDisassembler dis(PPC_MODE_32);
+	CPU_ADDR addr;
+	addr.addr32.offset = 0;
+	byte code[4];
+	createForeignInt(code, opc, 4, big_endian);
+	const char *str = dis.str(dis.decode(code, 4, addr), 0);
+	int i = 0;
+	while (i < size-1 && str[i] && str[i] != ' ') {
+		result[i] = str[i];
+		i++;
 	}
-	for (int i=0; i<32; i++) {
-		String *s = new String();
-		s->assignFormat("fr%d (lower)", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.fpr[i]), s));
-		s = new String();
-		s->assignFormat("fr%d (upper)", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.fpr[i]+4), s));
+	result[i] = 0;
+}
+
+#define PROFILE_REPORT_BLOCKS	200
+
+/*
+ *	Writes the hot blocks, ranked by executed client instructions
+ *	(count * insns, since timing every block would distort the
+ *	result) with their instruction mix, and the interpreted
+ *	instructions by execution count.
+ *	Retranslations of the same address are merged.
+ */
+extern "C" bool jitcProfileReport(const char *filename)
+{
+	JITC &jitc = *gJITC;
+	uint n = 0;
+	for (JITCProfileChunk *c = jitc.profileChunks; c; c = c->prev) n += c->used;
+	if (!n) return false;
+	FILE *f = fopen(filename, "w");
+	if (!f) return false;
+
+	ProfiledBlock *all = (ProfiledBlock *)malloc(n * sizeof *all);
+	JITCBlockProfile *blocks = (JITCBlockProfile *)malloc(n * sizeof *blocks);
+	uint i = n;
+	for (JITCProfileChunk *c = jitc.profileChunks; c; c = c->prev) {
+		// the newest chunk comes first
+		for (uint j = c->used; j--; ) {
+			i--;
+			all[i].p = &c->blocks[j];
+			all[i].seq = i;
+		}
 	}
-	for (int i=0; i<32; i++) {
-		String *s;
-		for (int j=0; j<4; j++) {
-			s = new String();
-			s->assignFormat("vr%d (%d)", i, j);
-			symbols->insert(new KeyValue(new UInt((uint)&gCPU.vr[i]+4*j), s));
+	qsort(all, n, sizeof *all, compareBlockPC);
+	uint blockCount = 0;
+	uint64 total = 0;
+	for (i=0; i < n; i++) {
+		JITCBlockProfile *p = all[i].p;
+		if (!blockCount || blocks[blockCount-1].pc != p->pc) {
+			blocks[blockCount++] = *p;
+		} else {
+			JITCBlockProfile &b = blocks[blockCount-1];
+			// weigh all translations by the latest length
+			b.count += p->count;
+			b.dispatched += p->dispatched;
+			b.chained += p->chained;
+			b.insns = p->insns;
+			b.interpreted = p->interpreted;
+			memcpy(b.mix, p->mix, sizeof b.mix);
 		}
+		total += blockWeight(p);
 	}
-	for (int i=0; i<4; i++) {
-		String *s = new String();
-		s->assignFormat("ibatl%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.ibatl[i]), s));
-		s = new String();
-		s->assignFormat("ibatu%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.ibatu[i]), s));
-		s = new String();
-		s->assignFormat("ibat_bl17_%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.ibat_bl17[i]), s));
-		s = new String();
-		s->assignFormat("dbatl%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.dbatl[i]), s));
-		s = new String();
-		s->assignFormat("dbatu%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.dbatu[i]), s));
-		s = new String();
-		s->assignFormat("dbat_bl17_%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.dbat_bl17[i]), s));
+	qsort(blocks, blockCount, sizeof *blocks, compareBlockWeight);
+	if (!total) total = 1;
+
+	fprintf(f, "%u blocks (%u translations), %llu client instructions\n\n",
+		blockCount, n, (unsigned long long)total);
+	fprintf(f, "    pc          entered    insns executed   %%    insns  interp  dispatched     chained"
+		"   int  load store branch    fp   vec\n");
+	for (i=0; i < blockCount && i < PROFILE_REPORT_BLOCKS; i++) {
+		JITCBlockProfile &b = blocks[i];
+		fprintf(f, "%08x %14llu %16llu %5.2f %6u %6u %12llu %12llu"
+			" %5u %5u %5u %6u %5u %5u\n",
+			b.pc, (unsigned long long)b.count,
+			(unsigned long long)blockWeight(&b),
+			100.0 * blockWeight(&b) / total, b.insns, b.interpreted,
+			(unsigned long long)b.dispatched, (unsigned long long)b.chained,
+			b.mix[profileInteger], b.mix[profileLoad], b.mix[profileStore],
+			b.mix[profileBranch], b.mix[profileFloat], b.mix[profileVector]);
 	}
-	for (int i=0; i<4; i++) {
-		String *s = new String();
-		s->assignFormat("sprg%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.sprg[i]), s));
+
+	uint weightCount = 0;
+	InterpretedWeight *weights = NULL;
+	for (JITCInterpretedSite *s = jitc.interpretedSites; s; s = s->next) {
+		char name[16];
+		mnemonic(s->opc, name, sizeof name);
+		uint j;
+		for (j=0; j < weightCount; j++) {
+			if (strcmp(weights[j].name, name) == 0) break;
+		}
+		if (j == weightCount) {
+			weights = (InterpretedWeight *)realloc(weights, (weightCount+1) * sizeof *weights);
+			strcpy(weights[j].name, name);
+			weights[j].count = 0;
+			weights[j].sites = 0;
+			weightCount++;
+		}
+		weights[j].count += s->block->count;
+		weights[j].sites++;
 	}
-	for (int i=0; i<16; i++) {
-		String *s = new String();
-		s->assignFormat("hid%d", i);
-		symbols->insert(new KeyValue(new UInt((uint)&gCPU.hid[i]), s));
+	qsort(weights, weightCount, sizeof *weights, compareInterpretedWeight);
+	fprintf(f, "\ninterpreted instructions\n");
+	fprintf(f, "    insn        executed   sites\n");
+	for (i=0; i < weightCount; i++) {
+		fprintf(f, "%-10s %14llu %7u\n", weights[i].name,
+			(unsigned long long)weights[i].count, weights[i].sites);
 	}
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.ctr), new String("ctr")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.lr), new String("lr")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.cr), new String("cr")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.cr+1), new String("cr+1")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.cr+2), new String("cr+2")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.cr+3), new String("cr+3")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.xer), new String("xer")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.xer_ca), new String("xer_ca")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.xer+3), new String("xer+3")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.msr), new String("msr")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.srr[0]), new String("srr0")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.srr[1]), new String("srr1")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.dsisr), new String("dsisr")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.dar), new String("dar")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.dec), new String("dec")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.pvr), new String("pvr")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.vrsave), new String("vrsave")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.reserve), new String("reserve")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.temp), new String("tmp")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.vtemp), new String("vtmp")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.current_code_base), new String("current_code_base")));
-	symbols->insert(new KeyValue(new UInt((uint)&gCPU.current_opc), new String("current_opc")));
-#endif
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_write_effective_byte_asm)), new String("ppc_write_effective_byte_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_write_effective_half_asm)), new String("ppc_write_effective_half_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_write_effective_word_asm)), new String("ppc_write_effective_word_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_write_effective_dword_asm)), new String("ppc_write_effective_dword_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_read_effective_byte_asm)), new String("ppc_read_effective_byte_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_read_effective_half_z_asm)), new String("ppc_read_effective_half_z_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_read_effective_half_s_asm)), new String("ppc_read_effective_half_s_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_read_effective_word_asm)), new String("ppc_read_effective_word_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_read_effective_dword_asm)), new String("ppc_read_effective_dword_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_opc_icbi_asm)), new String("ppc_opc_icbi_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_opc_stswi_asm)), new String("ppc_opc_stswi_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_opc_lswi_asm)), new String("ppc_opc_lswi_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_isi_exception_asm)), new String("ppc_isi_exception_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_dsi_exception_asm)), new String("ppc_dsi_exception_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_program_exception_asm)), new String("ppc_program_exception_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_no_fpu_exception_asm)), new String("ppc_no_fpu_exception_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_sc_exception_asm)), new String("ppc_sc_exception_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_flush_flags_asm)), new String("ppc_flush_flags_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_new_pc_asm)), new String("ppc_new_pc_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_new_pc_rel_asm)), new String("ppc_new_pc_rel_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_set_msr_asm)), new String("ppc_set_msr_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_mmu_tlb_invalidate_all_asm)), new String("ppc_mmu_tlb_invalidate_all_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_start_jitc_asm)), new String("ppc_start_jitc_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_new_pc_this_page_asm)), new String("ppc_new_pc_this_page_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_heartbeat_ext_rel_asm)), new String("ppc_heartbeat_ext_rel_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_flush_flags_signed_0_asm)), new String("ppc_flush_flags_signed_0_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&ppc_flush_flags_unsigned_0_asm)), new String("ppc_flush_flags_unsigned_0_asm")));
-	symbols->insert(new KeyValue(new UInt64(uint64(&call_prom_osi)), new String("call_prom_osi")));
+
+	free(weights);
+	free(blocks);
+	free(all);
+	bool ok = !ferror(f);
+	fclose(f);
+	return ok;
 }
 
 void jitcDebugDone()
 {
-	fclose(gDebugLog);
+	if (gPerfMap) fflush(gPerfMap);
+	if (gJITC->profileChunks) {
+		if (jitcProfileReport("jitc.profile")) {
+			ht_printf("block profile written to jitc.profile\n");
+		}
+	}
+	if (gTraceBuffer && gTraceHead) {
+		if (jitcTraceDump("jitc.trace")) {
+			ht_printf("translation trace written to jitc.trace\n");
+		}
+	}
 }
-
-#endif
@@ -21,7 +21,9 @@
 #ifndef __JITC_DEBUG_H__
 #define __JITC_DEBUG_H__
 
-#define JITC_DEBUG
+#include "jitc_types.h"
+
+struct JITC;
 
 static inline UNUSED uint64 jitcDebugGetTicks()
 {
@@ -30,32 +32,98 @@ static inline UNUSED uint64 jitcDebugGetTicks()
 	return ((uint64)s1)<<32 | s0;
 }
 
-#ifdef JITC_DEBUG
+/*
+ *	The translation trace
+ *
+ *	If enabled, every entrypoint, translated client instruction and
+ *	emitted native instruction is recorded in a ring buffer. It is off
+ *	by default and switched on by the config key cpu_jitc_trace (size
+ *	of the ring buffer in KiB) or from a debugger, e.g. in gdb
+ *	"call jitcTraceEnable(1024)" and "call jitcTraceDump("jitc.trace")".
+ *	The buffer is dumped to jitc.trace when the cpu stops.
+ *
+ *	Use jitctrace to turn a dump into the annotated listing
+ *	the old jitc.log used to contain.
+ */
+#define JITC_TRACE_ENTRYPOINT	1	// pc
+#define JITC_TRACE_INSN		2	// pc, opc
+#define JITC_TRACE_NATIVE	3	// hostOffset, size bytes of code follow
 
-void jitcDebugLogNewInstruction(JITC &jitc);
-void jitcDebugLogEmit(JITC &jitc, const byte *insn, int size);
-void jitcDebugLogAdd(const char *fmt, ...);
+struct JITCTraceRecord {
+	uint32 pc;		// physical client address
+	uint32 opc;		// client opcode
+	uint32 hostOffset;	// offset into the translation cache
+	uint16 size;		// number of bytes following this record
+	uint16 type;
+};
 
-void jitcDebugInit();
-void jitcDebugDone();
+#define JITC_TRACE_MAGIC	"JTRC"
+#define JITC_TRACE_VERSION	1
 
-#else
+/*
+ *	A dump consists of this header, symbols times
+ *	{uint64 address, uint32 length, char name[length]}
+ *	and size bytes of records (oldest first)
+ */
+struct JITCTraceFileHeader {
+	char magic[4];
+	uint32 version;
+	uint64 translationCache;
+	uint32 symbols;
+	uint32 size;
+};
 
-static inline UNUSED void jitcDebugLogNewInstruction(JITC &jitc)
-{
-}
-static inline UNUSED void jitcDebugLogEmit(JITC &jitc, const byte *insn, int size)
-{
-}
-static inline UNUSED void jitcDebugLogAdd(const char *fmt, ...)
+extern bool gJITCTrace;
+
+void jitcTraceAddEntrypoint(uint32 pc);
+void jitcTraceAddInstruction(JITC &jitc);
+void jitcTraceAddNative(JITC &jitc, const byte *insn, int size);
+
+static inline UNUSED void jitcTraceEntrypoint(uint32 pc)
 {
+	if (gJITCTrace) jitcTraceAddEntrypoint(pc);
 }
-static inline UNUSED void jitcDebugInit()
+static inline UNUSED void jitcTraceInstruction(JITC &jitc)
 {
+	if (gJITCTrace) jitcTraceAddInstruction(jitc);
 }
-static inline UNUSED void jitcDebugDone()
+static inline UNUSED void jitcTraceNative(JITC &jitc, const byte *insn, int size)
 {
+	if (gJITCTrace) jitcTraceAddNative(jitc, insn, size);
 }
-#endif
+
+/*
+ *	size in KiB, 0 disables the trace (but keeps the buffer)
+ */
+extern "C" bool jitcTraceEnable(uint size);
+extern "C" bool jitcTraceDump(const char *filename);
+
+/*
+ *	perf map export
+ *
+ *	If enabled by the config key cpu_jitc_perf_map, the native code of
+ *	every translation run is announced in /tmp/perf-<pid>.map, named
+ *	after the physical client address it was translated from. This way
+ *	"perf report" attributes samples inside the translation cache
+ *	to client code. Retranslated addresses get a new entry each time,
+ *	so the map only grows.
+ */
+extern bool gJITCPerfMap;
+
+bool jitcPerfMapEnable();
+void jitcPerfMapAdd(uint32 pc, NativeAddress start, NativeAddress end);
+
+/*
+ *	Block profiling
+ *
+ *	If enabled by the config key cpu_jitc_profile (or by setting
+ *	JITC::profiling from a debugger), translated blocks count how
+ *	often they are entered and left through the dispatcher or a chained
+ *	jump. jitcProfileReport() ranks them (it's called from a debugger
+ *	or writes jitc.profile when the cpu stops).
+ */
+extern "C" bool jitcProfileReport(const char *filename);
+
+void jitcDebugDone();
 
 #endif
@@ -36,6 +36,7 @@ enum JITCFlow {
 	flowContinue,
 	flowEndBlock,
 	flowEndBlockUnreachable,
+	flowFollow,	// continue at jitc.followPC (only in superblocks)
 };
 
 struct PPC_CPU_State;
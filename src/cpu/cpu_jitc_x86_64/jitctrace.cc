@@ -0,0 +1,144 @@
+/*
+ *	PearPC
+ *	jitctrace.cc
+ *
+ *	Decodes a translation trace (see jitc_debug.h)
+ *
+ *	This program is free software; you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License version 2 as
+ *	published by the Free Software Foundation.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program; if not, write to the Free Software
+ *	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "system/types.h"
+#include "tools/data.h"
+#include "tools/str.h"
+#include "tools/endianess.h"
+#include "debug/x86dis.h"
+#include "debug/ppcdis.h"
+#include "jitc_debug.h"
+
+static AVLTree *symbols;
+
+static char *symbol_lookup(CPU_ADDR addr, int *symstrlen, void *context)
+{
+	KeyValue tmp(new UInt64(addr.flat64.addr), NULL);
+	ObjHandle oh = symbols->find(&tmp);
+	if (oh != InvObjHandle) {
+		KeyValue *kv = (KeyValue*)symbols->get(oh);
+		if (symstrlen) *symstrlen = ((String *)kv->mValue)->length();
+		return ((String *)kv->mValue)->contentChar();
+	} else {
+		return NULL;
+	}
+}
+
+static void disasmPPC(uint32 code, uint32 ea, char *result)
+{
+	PPCDisassembler dis(PPC_MODE_32);
+	CPU_ADDR addr;
+	addr.addr32.offset = ea;
+	addr_sym_func = NULL;
+	byte code_buf[4];
+	createForeignInt(code_buf, code, 4, big_endian);
+	strcpy(result, dis.str(dis.decode(code_buf, 4, addr), 0));
+}
+
+static int disasmX86(const byte *code, int size, uint64 ea, char *result)
+{
+	x86_64dis dis;
+	CPU_ADDR addr;
+	addr.flat64.addr = ea;
+	addr_sym_func = symbol_lookup;
+	dis_insn *ret = dis.decode(code, size, addr);
+	strcpy(result, dis.str(ret, DIS_STYLE_HEX_NOZEROPAD));
+	return dis.getSize(ret);
+}
+
+static bool readSymbols(FILE *f, uint32 count)
+{
+	symbols = new AVLTree(true);
+	for (uint32 i=0; i < count; i++) {
+		uint64 addr;
+		uint32 len;
+		char name[256];
+		if (fread(&addr, sizeof addr, 1, f) != 1
+		 || fread(&len, sizeof len, 1, f) != 1
+		 || len >= sizeof name
+		 || fread(name, 1, len, f) != len) return false;
+		name[len] = 0;
+		symbols->insert(new KeyValue(new UInt64(addr), new String(name)));
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 2) {
+		fprintf(stderr, "usage: %s jitc.trace\n", argv[0]);
+		return 1;
+	}
+	FILE *f = fopen(argv[1], "rb");
+	if (!f) {
+		perror(argv[1]);
+		return 1;
+	}
+	JITCTraceFileHeader h;
+	if (fread(&h, sizeof h, 1, f) != 1
+	 || memcmp(h.magic, JITC_TRACE_MAGIC, sizeof h.magic) != 0
+	 || h.version != JITC_TRACE_VERSION
+	 || !readSymbols(f, h.symbols)) {
+		fprintf(stderr, "%s: not a translation trace\n", argv[1]);
+		return 1;
+	}
+	JITCTraceRecord r;
+	byte code[0x10000];
+	char str[256];
+	while (fread(&r, sizeof r, 1, f) == 1) {
+		if (r.size && fread(code, 1, r.size, f) != r.size) {
+			fprintf(stderr, "%s: truncated\n", argv[1]);
+			return 1;
+		}
+		switch (r.type) {
+		case JITC_TRACE_ENTRYPOINT:
+			printf("=== jitcNewEntrypoint: %08x Beginning jitc ===\n", r.pc);
+			break;
+		case JITC_TRACE_INSN:
+			disasmPPC(r.opc, r.pc, str);
+			printf("%08x   %08x  %s\n", r.pc, r.opc, str);
+			break;
+		case JITC_TRACE_NATIVE: {
+			uint64 ea = h.translationCache + r.hostOffset;
+			int size1 = disasmX86(code, r.size, ea, str);
+			if (size1 != r.size) printf(" kaputt! ");
+			printf("  %016llx ", (unsigned long long)ea);
+			for (int i=0; i < 15; i++) {
+				if (i < r.size) {
+					printf("%02x", code[i]);
+				} else {
+					printf("  ");
+				}
+			}
+			printf("  %s\n", str);
+			break;
+		}
+		default:
+			fprintf(stderr, "%s: unknown record type %d\n", argv[1], r.type);
+			return 1;
+		}
+	}
+	fclose(f);
+	return 0;
+}
@@ -592,7 +592,17 @@ JITCFlow ppc_opc_gen_andcx(JITC &jitc)
 	} else {
 		jitc.clobberCarryAndFlags();
 	}
-	if (rA == rS) {
+	if (jitc.hostCPUCaps.bmi1) {
+		NativeReg s = jitc.getClientRegister(PPC_GPR(rS));
+		NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
+		NativeReg a;
+		if (rA == rS || rA == rB) {
+			a = jitc.getClientRegisterDirty(PPC_GPR(rA));
+		} else {
+			a = jitc.mapClientRegisterDirty(PPC_GPR(rA));
+		}
+		jitc.asmANDN32(a, b, s);
+	} else if (rA == rS) {
 		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
 		NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
 		NativeReg tmp = jitc.allocRegister();
@@ -724,21 +734,8 @@ JITCFlow ppc_opc_gen_cmp(JITC &jitc)
 	NativeReg a = jitc.getClientRegister(PPC_GPR(rA));
 	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
 	jitc.asmALU32(X86_CMP, a, b);
-#if 1
-	if (cr == 0) {
-		jitc.asmCALL((NativeAddress)ppc_flush_flags_signed_0_asm);
-	} else {
-		jitc.clobberRegister(RAX | NATIVE_REG);
-		jitc.asmMOV32_NoFlags(RAX, (7-cr)/2);
-		jitc.asmCALL((cr & 1) ? (NativeAddress)ppc_flush_flags_signed_odd_asm : (NativeAddress)ppc_flush_flags_signed_even_asm);
-	}
-#else
-	if (cr & 1) {
-		jitc.flushFlagsAfterCMP_L((7-cr)/2);
-	} else {
-		jitc.flushFlagsAfterCMP_U((7-cr)/2);
-	}
-#endif
+	// the CR field is written when needed (see JITC::flushFlags)
+	jitc.mapFlagsDirty((PPC_CRx)cr, flagsCmpSigned);
 	return flowContinue;
 }
 /*
@@ -777,21 +774,8 @@ JITCFlow ppc_opc_gen_cmpi(JITC &jitc)
 	jitc.clobberCarryAndFlags();
 	NativeReg a = jitc.getClientRegister(PPC_GPR(rA));
 	jitc.asmALU32(X86_CMP, a, imm);
-#if 1
-	if (cr == 0) {
-		jitc.asmCALL((NativeAddress)ppc_flush_flags_signed_0_asm);
-	} else {
-		jitc.clobberRegister(RAX | NATIVE_REG);
-		jitc.asmMOV32_NoFlags(RAX, (7-cr)/2);
-		jitc.asmCALL((cr & 1) ? (NativeAddress)ppc_flush_flags_signed_odd_asm : (NativeAddress)ppc_flush_flags_signed_even_asm);
-	}
-#else
-	if (cr & 1) {
-		jitc.flushFlagsAfterCMP_L((7-cr)/2);
-	} else {
-		jitc.flushFlagsAfterCMP_U((7-cr)/2);
-	}
-#endif
+	// the CR field is written when needed (see JITC::flushFlags)
+	jitc.mapFlagsDirty((PPC_CRx)cr, flagsCmpSigned);
 	return flowContinue;
 }
 /*
@@ -829,21 +813,8 @@ JITCFlow ppc_opc_gen_cmpl(JITC &jitc)
 	NativeReg a = jitc.getClientRegister(PPC_GPR(rA));
 	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
 	jitc.asmALU32(X86_CMP, a, b);
-#if 1
-	if (cr == 0) {
-		jitc.asmCALL((NativeAddress)ppc_flush_flags_unsigned_0_asm);
-	} else {
-		jitc.clobberRegister(RAX | NATIVE_REG);
-	        jitc.asmMOV32_NoFlags(RAX, (7-cr)/2);
-		jitc.asmCALL((cr & 1) ? (NativeAddress)ppc_flush_flags_unsigned_odd_asm : (NativeAddress)ppc_flush_flags_unsigned_even_asm);
-	}
-#else
-	if (cr & 1) {
-		jitc.flushFlagsAfterCMPL_L((7-cr)/2);
-	} else {
-		jitc.flushFlagsAfterCMPL_U((7-cr)/2);
-	}
-#endif
+	// the CR field is written when needed (see JITC::flushFlags)
+	jitc.mapFlagsDirty((PPC_CRx)cr, flagsCmpUnsigned);
 	return flowContinue;
 }
 /*
@@ -882,21 +853,8 @@ JITCFlow ppc_opc_gen_cmpli(JITC &jitc)
 	jitc.clobberCarryAndFlags();
 	NativeReg a = jitc.getClientRegister(PPC_GPR(rA));
 	jitc.asmALU32(X86_CMP, a, imm);
-#if 1
-	if (cr == 0) {
-		jitc.asmCALL((NativeAddress)ppc_flush_flags_unsigned_0_asm);
-	} else {
-		jitc.clobberRegister(RAX | NATIVE_REG);
-		jitc.asmMOV32_NoFlags(RAX, (7-cr)/2);
-		jitc.asmCALL((cr & 1) ? (NativeAddress)ppc_flush_flags_unsigned_odd_asm : (NativeAddress)ppc_flush_flags_unsigned_even_asm);
-	}
-#else
-	if (cr & 1) {
-		jitc.flushFlagsAfterCMPL_L((7-cr)/2);
-	} else {
-		jitc.flushFlagsAfterCMPL_U((7-cr)/2);
-	}
-#endif
+	// the CR field is written when needed (see JITC::flushFlags)
+	jitc.mapFlagsDirty((PPC_CRx)cr, flagsCmpUnsigned);
 	return flowContinue;
 }
 
@@ -929,6 +887,15 @@ JITCFlow ppc_opc_gen_cntlzwx(JITC &jitc)
 	jitc.clobberCarryAndFlags();
 	NativeReg s = jitc.getClientRegister(PPC_GPR(rS));
 	NativeReg a = jitc.mapClientRegisterDirty(PPC_GPR(rA));
+	if (jitc.hostCPUCaps.lzcnt) {
+		jitc.asmLZCNT32(a, s);
+		if (jitc.current_opc & PPC_OPC_Rc) {
+			// lzcnt only sets ZF and CF
+			jitc.asmALU32(X86_TEST, a, a);
+			jitc.mapFlagsDirty();
+		}
+		return flowContinue;
+	}
 	NativeReg z = jitc.allocRegister();
 	jitc.asmALU32(X86_MOV, z, 0xffffffff);
 	jitc.asmBSx32(X86_BSR, a, s);
@@ -2003,8 +1970,12 @@ JITCFlow ppc_opc_gen_rlwimix(JITC &jitc)
 	NativeReg s = jitc.getClientRegister(PPC_GPR(rS));
 	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
 	NativeReg tmp = jitc.allocRegister();
-	jitc.asmALU32(X86_MOV, tmp, s);
-	ppc_opc_gen_rotl_and(jitc, tmp, SH, mask);
+	if (jitc.hostCPUCaps.bmi2) {
+		jitc.asmRORX32(tmp, s, (32-SH) & 0x1f);
+	} else {
+		jitc.asmALU32(X86_MOV, tmp, s);
+		ppc_opc_gen_rotl_and(jitc, tmp, SH, mask);
+	}
 	jitc.asmALU32(X86_AND, a, ~mask);
 	jitc.asmALU32(X86_AND, tmp, mask);
 	jitc.asmALU32(X86_OR, a, tmp);
@@ -2040,15 +2011,21 @@ JITCFlow ppc_opc_gen_rlwinmx(JITC &jitc)
 		jitc.clobberCarryAndFlags();
 	}
 	NativeReg a;
+	uint32 mask = ppc_mask(MB, ME);
 	if (rS == rA) {
 		a = jitc.getClientRegisterDirty(PPC_GPR(rA));
+		ppc_opc_gen_rotl_and(jitc, a, SH, mask);
 	} else {
 		NativeReg s = jitc.getClientRegister(PPC_GPR(rS));
 		a = jitc.mapClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_MOV, a, s);
+		if (jitc.hostCPUCaps.bmi2 && (SH & 0x1f)) {
+			// copy and rotate in one, the AND masks anyway
+			jitc.asmRORX32(a, s, 32-(SH & 0x1f));
+		} else {
+			jitc.asmALU32(X86_MOV, a, s);
+			ppc_opc_gen_rotl_and(jitc, a, SH, mask);
+		}
 	}
-	uint32 mask = ppc_mask(MB, ME);
-	ppc_opc_gen_rotl_and(jitc, a, SH, mask);
 	jitc.asmALU32(X86_AND, a, mask);
 	if (jitc.current_opc & PPC_OPC_Rc) {
 		/*
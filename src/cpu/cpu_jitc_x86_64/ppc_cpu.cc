@@ -29,6 +29,7 @@
 #include "cpu/cpu.h"
 #include "ppc_cpu.h"
 #include "ppc_dec.h"
+#include "ppc_fpu.h"
 #include "ppc_mmu.h"
 #include "jitc.h"
 #include "jitc_asm.h"
@@ -43,7 +44,18 @@ uint32 gBreakpoint2;
 extern "C" void ppc_display_jitc_stats(PPC_CPU_State &aCPU)
 {
 	JITC &jitc = *aCPU.jitc;
-	ht_printf("pg.dest:   write: %qd    out of pages: %qd   out of tc: %qd\r", &jitc.destroy_write, &jitc.destroy_oopages, &jitc.destroy_ootc);
+	ht_printf("pg.dest:   write: %qd    out of pages: %qd   out of tc: %qd   "
+		"evict: translations: %qd  frags freed: %qd  spared: %qd/%qd samples   superblocks: %qd   "
+		"code: %qd bytes, %qd saved   idle: %qd   block loops: %qd   "
+		"tlb misses/hits:   code: %qd/%qd   read: %qd/%qd   write: %qd/%qd\r",
+		&jitc.destroy_write, &jitc.destroy_oopages, &jitc.destroy_ootc,
+		&jitc.translations, &jitc.fragments_freed,
+		&jitc.second_chances, &jitc.hot_samples, &jitc.superblocks,
+		&jitc.code_bytes, &jitc.peephole_saved,
+		&jitc.idle_sleeps, &jitc.block_loops,
+		&aCPU.tlb_code_misses, &aCPU.tlb_code_hits,
+		&aCPU.tlb_data_read_misses, &aCPU.tlb_data_read_hits,
+		&aCPU.tlb_data_write_misses, &aCPU.tlb_data_write_hits);
 }
 
 void ppc_fpu_test();
@@ -59,8 +71,89 @@ uint64 gStartHostCLKTicks;
 uint64 gTBreadITB;
 int gHostClockScale;
 
+/*
+ *	If the host has an invariant TSC, the timebase and the
+ *	decrementer are derived from it instead of the host clock, so
+ *	translated code can read them inline without a call (see
+ *	ppc_opc_gen_tsc_elapsed()). t = (rdtsc - tsc_base) * tsc_mul >> 32
+ *	counts timebase ticks since tsc_base, which corresponds to the
+ *	ideal timebase gTSCIdealBase. tsc_mul is measured against the host
+ *	clock and refined by ppc_calibrate_tsc_timebase(), which moves
+ *	tsc_base (and the offsets) so t stays small and continuous.
+ */
+bool gTSCTimebase = false;
+static uint64 gTSCIdealBase;
+static uint64 gTSCStartTicks, gTSCStart, gTSCCalibrateTicks;
+
+#define TSC_CALIBRATE_INTERVAL	2	// in seconds
+
+static inline uint64 ppc_read_tsc()
+{
+	uint32 lo, hi;
+	asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64)hi)<<32 | lo;
+}
+
+static inline uint64 ppc_tsc_elapsed(uint64 tsc)
+{
+	return ((unsigned __int128)(tsc - gCPU->tsc_base) * gCPU->tsc_mul) >> 32;
+}
+
+/*
+ *	TSC ticks measured against ticks of the host clock
+ *	-> timebase ticks per TSC tick in 32.32 fixed point
+ */
+static uint64 ppc_tsc_mul(uint64 tsc, uint64 ticks)
+{
+	unsigned __int128 tb = (unsigned __int128)gClientTimeBaseFrequency * ticks;
+	return (tb << 32) / ((unsigned __int128)tsc * sys_get_hiresclk_ticks_per_second());
+}
+
+static void ppc_tsc_timebase_init()
+{
+	uint64 ticks = sys_get_hiresclk_ticks();
+	uint64 tsc = ppc_read_tsc();
+	// wait 10ms for a first estimate
+	uint64 wait = sys_get_hiresclk_ticks_per_second() / 100;
+	uint64 now;
+	do {
+		now = sys_get_hiresclk_ticks();
+	} while (now - ticks < wait);
+	gTSCStartTicks = ticks;
+	gTSCStart = tsc;
+	gTSCCalibrateTicks = now;
+	gCPU->tsc_mul = ppc_tsc_mul(ppc_read_tsc() - tsc, now - ticks);
+	gTSCIdealBase = ppc_get_cpu_ideal_timebase();
+	gCPU->tsc_base = ppc_read_tsc();
+	gCPU->tb_offset = ppc_get_cpu_timebase();
+	gCPU->dec_offset = -gTSCIdealBase;
+	gTSCTimebase = true;
+}
+
+/*
+ *	Called from time to time (writeDEC()) to refine tsc_mul over
+ *	the whole time since the start.
+ */
+void ppc_calibrate_tsc_timebase()
+{
+	if (!gTSCTimebase) return;
+	uint64 ticks = sys_get_hiresclk_ticks();
+	if (ticks - gTSCCalibrateTicks < TSC_CALIBRATE_INTERVAL * sys_get_hiresclk_ticks_per_second()) return;
+	gTSCCalibrateTicks = ticks;
+	uint64 tsc = ppc_read_tsc();
+	uint64 t = ppc_tsc_elapsed(tsc);
+	gCPU->tsc_base = tsc;
+	gCPU->tb_offset += t;
+	gCPU->dec_offset -= t;
+	gTSCIdealBase += t;
+	gCPU->tsc_mul = ppc_tsc_mul(tsc - gTSCStart, ticks - gTSCStartTicks);
+}
+
 uint64 ppc_get_cpu_ideal_timebase()
 {
+	if (gTSCTimebase) {
+		return gTSCIdealBase + ppc_tsc_elapsed(ppc_read_tsc());
+	}
 	uint64 ticks = sys_get_hiresclk_ticks();
 	if (gHostClockScale < 0) {
 		// negative shift count -> make it positive
@@ -72,6 +165,10 @@ uint64 ppc_get_cpu_ideal_timebase()
 
 uint64 ppc_get_cpu_timebase()
 {
+	if (gTSCTimebase) {
+		gCPU->tb = gCPU->tb_offset + ppc_tsc_elapsed(ppc_read_tsc());
+		return gCPU->tb;
+	}
 	uint64 ticks = sys_get_hiresclk_ticks();
 	if (gHostClockScale < 0) {
 		gCPU->tb += (ticks - gTBreadITB) >> (-gHostClockScale);
@@ -83,15 +180,56 @@ uint64 ppc_get_cpu_timebase()
 	return gCPU->tb;
 }
 
+void ppc_set_cpu_timebase(uint64 tb)
+{
+	gCPU->tb = tb;
+	if (gTSCTimebase) {
+		gCPU->tb_offset = tb - ppc_tsc_elapsed(ppc_read_tsc());
+	}
+}
+
+/*
+ *	Replaces the host timer for the decrementer, the exception
+ *	is raised ns nanoseconds from now (0 = at the next heartbeat).
+ *	Only check_dec_deadline disarms it (dec_deadline = ~0).
+ */
+void ppc_set_dec_deadline(uint64 ns)
+{
+	unsigned __int128 tb = ((unsigned __int128)ns * gClientTimeBaseFrequency) << 32;
+	gCPU->dec_deadline = ppc_read_tsc() + tb / ((unsigned __int128)gCPU->tsc_mul * 1000000000ULL);
+}
+
+/*
+ *	The decrementer was value at the ideal timebase itb
+ */
+void ppc_set_cpu_dec_reference(uint32 value, uint64 itb)
+{
+	gCPU->dec_offset = value + itb - gTSCIdealBase;
+}
+
 sys_timer gDECtimer;
 sys_semaphore gCPUDozeSem;
 
-extern "C" void cpu_doze()
+/*
+ *	Sleeps for at most ms milliseconds or until an interrupt
+ *	(ppc_cpu_wakeup()) or the decrementer is due. The wait only
+ *	has millisecond resolution, so it doesn't sleep at all if the
+ *	decrementer is due sooner.
+ */
+static void ppc_cpu_sleep(int ms)
 {
-	if (!gCPU->exception_pending) {
+	if (gTSCTimebase && gCPU->dec_deadline != ~0ULL) {
+		// don't sleep past the decrementer, the heartbeat raises it
+		uint64 tsc = ppc_read_tsc();
+		if (tsc >= gCPU->dec_deadline) return;
+		uint64 tb = ((unsigned __int128)(gCPU->dec_deadline - tsc) * gCPU->tsc_mul) >> 32;
+		uint64 ns = 1000000000ULL * tb / gClientTimeBaseFrequency;
+		if (ns < ms * 1000000ULL) ms = ns / 1000000;
+	}
+	if (ms && !gCPU->exception_pending) {
 //		printf("*doze %08x %08x %d\n", gCPU->dec, ppc_cpu_get_pc(0), blbl);
 		sys_lock_semaphore(gCPUDozeSem);
-		sys_wait_semaphore_bounded(gCPUDozeSem, 10);
+		sys_wait_semaphore_bounded(gCPUDozeSem, ms);
 		sys_unlock_semaphore(gCPUDozeSem);
 //	sys_timer_struct *timer = reinterpret_cast<sys_timer_struct *>(gDECtimer);
 
@@ -99,6 +237,46 @@ extern "C" void cpu_doze()
 	}
 }
 
+extern "C" void cpu_doze()
+{
+	ppc_cpu_sleep(10);
+}
+
+/*
+ *	Called by every iteration of a loop which only waits for
+ *	memory, the timebase or an interrupt to change (see
+ *	ppc_opc_gen_idle_loop()). Once the same loop has been spinning
+ *	for IDLE_SPIN_US with interrupts enabled, the host thread
+ *	sleeps like in cpu_doze(), for at most a millisecond at a
+ *	time. Calls further apart than IDLE_GAP_US start over.
+ *
+ *	The end of a timebase-polling loop isn't known, so a sleep
+ *	may overshoot it by up to a millisecond. Waiting for the
+ *	loop to spin that long first keeps shorter delays exact and
+ *	longer ones within a factor of two.
+ */
+#define IDLE_SPIN_US	1000
+#define IDLE_GAP_US	100
+
+static uint32 gIdleLoopPC;
+static uint64 gIdleStart, gIdleLast;
+
+void ppc_cpu_idle_loop(PPC_CPU_State &aCPU, uint32 ofs)
+{
+	uint32 ea = aCPU.current_code_base + ofs;
+	uint64 now = ppc_get_cpu_ideal_timebase();
+	if (ea != gIdleLoopPC || now - gIdleLast > IDLE_GAP_US * gClientTimeBaseFrequency / 1000000) {
+		gIdleLoopPC = ea;
+		gIdleStart = now;
+	}
+	gIdleLast = now;
+	if (now - gIdleStart < IDLE_SPIN_US * gClientTimeBaseFrequency / 1000000) return;
+	if (!(aCPU.msr & MSR_EE) || aCPU.exception_pending) return;
+	aCPU.jitc->idle_sleeps++;
+	ppc_cpu_sleep(1);
+	gIdleLast = ppc_get_cpu_ideal_timebase();
+}
+
 void ppc_cpu_wakeup()
 {
 	sys_signal_semaphore(gCPUDozeSem);
@@ -107,7 +285,10 @@ void ppc_cpu_wakeup()
 static void decTimerCB(sys_timer t)
 {
 	ppc_cpu_atomic_raise_dec_exception(*gCPU);
-//	cpu_wakeup();
+#if defined(HAVE_SYS_TIMERFD_H) && defined(HAVE_SYS_EVENTFD_H)
+	// called by the timer thread, not in a signal handler (see systimer.cc)
+	ppc_cpu_wakeup();
+#endif
 }
 
 void ppc_cpu_run()
@@ -118,7 +299,6 @@ void ppc_cpu_run()
 	gJITCCompileTicks = 0;
 	gJITCRunTicksStart = jitcDebugGetTicks();
 	PPC_CPU_TRACE("execution started at %08x\n", gCPU->pc);
-	jitcDebugInit();
 /*
 	PPC_CPU_WARN("clock ticks / second = %08qx\n", q);
 	q = sys_get_cpu_ticks();
@@ -138,7 +318,9 @@ void ppc_cpu_run()
 	}
 	ht_printf("*** &gCPU: %p, &gJITC: %p\n", gCPU, gCPU->jitc);
 	ht_printf("sizeof cpu: %d\n", int(sizeof(*gCPU)));
+	ppc_fpu_clear_mxcsr();
 	ppc_start_jitc_asm(gCPU->pc, &gCPU, sizeof *gCPU);
+	jitcDebugDone();
 }
 
 void ppc_cpu_map_framebuffer(uint32 pa, uint32 ea)
@@ -229,6 +411,15 @@ void ppc_set_singlestep_nonverbose(bool v)
 }
 
 #define CPU_KEY_PVR	"cpu_pvr"
+#define CPU_KEY_JITC_PAGES	"cpu_jitc_pages"
+#define CPU_KEY_JITC_CACHE	"cpu_jitc_cache_size"	// in MiB
+#define CPU_KEY_JITC_TRACE	"cpu_jitc_trace"	// in KiB, 0 = off
+#define CPU_KEY_JITC_PERF_MAP	"cpu_jitc_perf_map"
+#define CPU_KEY_JITC_PROFILE	"cpu_jitc_profile"
+#define CPU_KEY_JITC_SUPERBLOCK	"cpu_jitc_superblock_threshold"
+#define CPU_KEY_JITC_PEEPHOLE	"cpu_jitc_peephole"
+#define CPU_KEY_JITC_IDLE	"cpu_jitc_idle_detect"
+#define CPU_KEY_JITC_BLOCK_LOOPS	"cpu_jitc_block_loops"
 
 #include "configparser.h"
 
@@ -238,6 +429,7 @@ bool ppc_cpu_init()
 	gCPU = ppc_malloc(sizeof *gCPU);
 	memset(gCPU, 0, sizeof *gCPU);
 	gCPU->pvr = gConfig->getConfigInt(CPU_KEY_PVR);
+	gCPU->dec_deadline = ~0ULL;
 
 	ppc_dec_init();
 	// initialize srs (mostly for prom)
@@ -268,10 +460,49 @@ bool ppc_cpu_init()
 //	exit(1);
 	gCPU->jitc = new JITC;
 	gJITC = gCPU->jitc;
-	return gCPU->jitc->init(4096, 64*1024*1024);
+	uint32 pages = gConfig->getConfigInt(CPU_KEY_JITC_PAGES);
+	uint32 cacheSize = gConfig->getConfigInt(CPU_KEY_JITC_CACHE);
+	// the translation cache must stay within reach of rel32 calls
+	if (pages < 64) pages = 64;
+	if (cacheSize < 4) cacheSize = 4;
+	if (cacheSize > 1024) cacheSize = 1024;
+	if (!gCPU->jitc->init(pages, cacheSize*1024*1024)) return false;
+	if (gCPU->jitc->hostCPUCaps.invariant_tsc) ppc_tsc_timebase_init();
+	uint32 traceSize = gConfig->getConfigInt(CPU_KEY_JITC_TRACE);
+	if (traceSize && !jitcTraceEnable(traceSize)) {
+		ht_printf("unable to allocate the translation trace\n");
+	}
+	if (gConfig->getConfigInt(CPU_KEY_JITC_PERF_MAP) && !jitcPerfMapEnable()) {
+		ht_printf("unable to create the perf map\n");
+	}
+	gCPU->jitc->profiling = gConfig->getConfigInt(CPU_KEY_JITC_PROFILE);
+	uint32 threshold = gConfig->getConfigInt(CPU_KEY_JITC_SUPERBLOCK);
+	// see jitcTierUp()
+	if (threshold > 0x7ffffffe) threshold = 0x7ffffffe;
+	gCPU->jitc->superblockThreshold = threshold;
+	gCPU->jitc->peephole = gConfig->getConfigInt(CPU_KEY_JITC_PEEPHOLE);
+	gCPU->jitc->idleDetect = gConfig->getConfigInt(CPU_KEY_JITC_IDLE);
+	gCPU->jitc->blockLoops = gConfig->getConfigInt(CPU_KEY_JITC_BLOCK_LOOPS);
+	if (gConfig->getConfigInt(CPU_KEY_FASTMEM)) {
+		gCPU->jitc->fastmem = ppc_fastmem_init(*gCPU);
+		if (!gCPU->jitc->fastmem) {
+			ht_printf("fastmem not available on this host, using the soft TLB\n");
+		}
+	}
+	return true;
 }
 
 void ppc_cpu_init_config()
 {
 	gConfig->acceptConfigEntryIntDef("cpu_pvr", 0x000c0201);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_FASTMEM, 0);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_PAGES, 4096);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_CACHE, 64);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_TRACE, 0);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_PERF_MAP, 0);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_PROFILE, 0);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_SUPERBLOCK, 0);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_PEEPHOLE, 1);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_IDLE, 1);
+	gConfig->acceptConfigEntryIntDef(CPU_KEY_JITC_BLOCK_LOOPS, 1);
 }
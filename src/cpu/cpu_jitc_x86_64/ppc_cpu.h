@@ -34,7 +34,39 @@
 #define PPC_BUS_FREQUENCY	(PPC_CLOCK_FREQUENCY/5)
 #define PPC_TIMEBASE_FREQUENCY	(PPC_BUS_FREQUENCY/4)
 
-#define TLB_ENTRIES 32
+/*
+ *	Size of the soft TLBs of the JITC (each for code, data read
+ *	and data write). Must be kept in sync with jitc_common.h.
+ *	There must be at least 2 sets, see ppc_opc_gen_tlb_lookup().
+ */
+#ifndef TLB_SETS_LOG2
+#define TLB_SETS_LOG2	6
+#endif
+#ifndef TLB_WAYS_LOG2
+#define TLB_WAYS_LOG2	2
+#endif
+#if TLB_SETS_LOG2 < 1
+#error "TLB_SETS_LOG2 must be at least 1"
+#endif
+#define TLB_SETS	(1 << TLB_SETS_LOG2)
+#define TLB_WAYS	(1 << TLB_WAYS_LOG2)
+#define TLB_SET_SHIFT	(TLB_WAYS_LOG2 + 4)	// log2 of the size of a set in bytes
+#define TLB_SET_MASK	((TLB_SETS-1) << TLB_SET_SHIFT)
+
+/*
+ *	A TLB entry.
+ *
+ *	tag is (asid << 32) | effective page, where asid identifies the
+ *	translation context of the segment (see tlb_code_asid).
+ *	An invalid entry has the lower 12 bits of tag set.
+ *
+ *	phys is the physical page for code and the host address
+ *	of the page for data.
+ */
+struct PPC_TLB_Entry {
+	uint64 tag;
+	uint64 phys;
+} PACKED;
 
 struct JITC;
 
@@ -106,7 +138,8 @@ struct PPC_CPU_State {
 	uint32 pagetable_hashmask;
 	uint32 reserve;
 	bool   have_reservation;
-	byte   align2[3];
+	bool   code_destroyed;	// see jitcCheckCodeWrite()
+	byte   align2[2];
 	
 	uint32 tlb_last;
 	uint32 tlb_pa[4];
@@ -122,16 +155,33 @@ struct PPC_CPU_State {
 	uint32 x87cw;
 	uint32 pc_ofs;
 	uint32 current_code_base;
+	uint32 align3;
+
+	/*
+	 *	The address space id of each segment, already shifted
+	 *	into the upper half of a TLB tag. It is 0 for untranslated
+	 *	accesses, else it consists of SR (without the reserved bits),
+	 *	MSR[PR] (bit 24) and a bit (25) set for translation.
+	 *	Recomputed by ppc_mmu_tlb_update_asid_asm whenever MSR or
+	 *	a segment register changes, so this doesn't need to flush
+	 *	the TLBs.
+	 */
+	uint64 tlb_code_asid[16];
+	uint64 tlb_data_asid[16];
 
 	/*
-	 *	These are the TLB-Entries
+	 *	These are the TLB-Entries, TLB_WAYS entries per set.
+	 *	The most recently used entry of a set is always its
+	 *	first, only this one is checked by translated code.
+	 */
+	PPC_TLB_Entry tlb_code[TLB_SETS*TLB_WAYS];
+	PPC_TLB_Entry tlb_data_read[TLB_SETS*TLB_WAYS];
+	PPC_TLB_Entry tlb_data_write[TLB_SETS*TLB_WAYS];
+
+	/*
+	 *	Lookups in jitc_mmu.S (i.e. hits in the first entry of
+	 *	a set from translated code aren't counted) and TLB refills
 	 */
-	uint32 tlb_code_eff[TLB_ENTRIES];
-	uint32 tlb_data_read_eff[TLB_ENTRIES];
-	uint32 tlb_data_write_eff[TLB_ENTRIES];
-	uint64 tlb_code_phys[TLB_ENTRIES];
-	uint64 tlb_data_read_phys[TLB_ENTRIES];
-	uint64 tlb_data_write_phys[TLB_ENTRIES];
 	uint64 tlb_code_hits;
 	uint64 tlb_data_read_hits;
 	uint64 tlb_data_write_hits;
@@ -139,6 +189,31 @@ struct PPC_CPU_State {
 	uint64 tlb_data_read_misses;
 	uint64 tlb_data_write_misses;
 
+	/*
+	 *	Host base addresses of the fastmem windows (see ppc_mmu.cc)
+	 *	for untranslated, supervisor and user mode accesses, or 0.
+	 *	fastmem_base is the one of the current MSR[DR,PR], it is
+	 *	maintained by ppc_mmu_tlb_update_asid_asm.
+	 */
+	uint64 fastmem_base;
+	uint64 fastmem_window[3];
+
+	/*
+	 *	With an invariant TSC, t = (rdtsc - tsc_base) * tsc_mul >> 32
+	 *	counts timebase ticks and TB = t + tb_offset,
+	 *	DEC = dec_offset - t (see ppc_cpu.cc)
+	 */
+	uint64 tsc_base;
+	uint64 tsc_mul;
+	uint64 tb_offset;
+	uint64 dec_offset;
+
+	/*
+	 *	With gTSCTimebase the heartbeat raises the decrementer
+	 *	exception once the TSC reaches this (~0 = never)
+	 */
+	uint64 dec_deadline;
+
 	// for altivec
 	uint32 vscr;
 	uint32 vrsave;  // spr 256
@@ -155,6 +230,7 @@ struct PPC_CPU_State {
 #define curCPU(field) RSP, uint32(RSP_OFFSET + offsetof(PPC_CPU_State, field))
 #define curCPUreg(ofs) RSP, uint32(RSP_OFFSET + uint32(ofs))
 #define curCPUsib(field, scale, index) RSP, scale, index, uint32(RSP_OFFSET + offsetof(PPC_CPU_State, field))
+#define curCPUvr(n) RSP, uint32(RSP_OFFSET + offsetof(PPC_CPU_State, vr) + (n)*sizeof (Vector_t))
 
 enum PPC_Register {
 	PPC_REG_NO = 0,
@@ -165,6 +241,7 @@ enum PPC_Register {
 	PPC_FPSCR = offsetof(PPC_CPU_State, fpscr),
 	PPC_VSCR = offsetof(PPC_CPU_State, vscr),
 	PPC_VRSAVE = offsetof(PPC_CPU_State, vrsave),
+	PPC_VTEMP = offsetof(PPC_CPU_State, vtemp),
 	PPC_XER = offsetof(PPC_CPU_State, xer),
 	PPC_LR = offsetof(PPC_CPU_State, lr),
 	PPC_CTR = offsetof(PPC_CPU_State, ctr),
@@ -215,8 +292,15 @@ extern uint64 gClientClockFrequency;
 extern uint64 gClientTimeBaseFrequency;
 extern sys_timer gDECtimer;
 
+extern bool gTSCTimebase;
+
 uint64 ppc_get_cpu_timebase();
 uint64 ppc_get_cpu_ideal_timebase();
+void ppc_set_cpu_timebase(uint64 tb);
+void ppc_set_cpu_dec_reference(uint32 value, uint64 itb);
+void ppc_calibrate_tsc_timebase();
+void ppc_set_dec_deadline(uint64 ns);
+void ppc_cpu_idle_loop(PPC_CPU_State &aCPU, uint32 ofs);
 
 void ppc_run();
 void ppc_stop();
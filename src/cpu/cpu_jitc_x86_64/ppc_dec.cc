@@ -118,6 +118,8 @@ static JITCFlow ppc_opc_gen_special(JITC &jitc)
 		jitc.asmALU32(X86_MOV, RCX, jitc.pc);
 		PPC_ESC_TRACE("pc = %08x\n", jitc.pc);
 		jitc.asmCALL((NativeAddress)&ppc_escape_vm);
+		// escape_memmove() may overwrite translated code
+		ppc_opc_gen_check_code_destroyed(jitc);
 		return flowEndBlock;
 	}
 	if (jitc.pc == (gPromOSIEntry&0xfff) && jitc.current_opc == PROM_MAGIC_OPCODE) {
@@ -406,7 +408,6 @@ static void ppc_opc_init_group2()
 	ppc_opc_table_gen_group2[983] = ppc_opc_gen_stfiwx;
 	ppc_opc_table_gen_group2[1014] = ppc_opc_gen_dcbz;
 
-#if 0 //FIX64
 	if ((ppc_cpu_get_pvr(0) & 0xffff0000) == 0x000c0000) {
 		/* Added for Altivec support */
 		ppc_opc_table_group2[6] = ppc_opc_lvsl;
@@ -441,7 +442,6 @@ static void ppc_opc_init_group2()
 		ppc_opc_table_gen_group2[487] = ppc_opc_gen_stvxl;
 		ppc_opc_table_gen_group2[822] = ppc_opc_gen_dss;
 	}
-#endif
 }
 
 // main opcode 31
@@ -591,7 +591,6 @@ static JITCFlow ppc_opc_gen_group_f2(JITC &aJITC)
 ppc_opc_function ppc_opc_table_groupv[965];
 ppc_opc_gen_function ppc_opc_table_gen_groupv[965];
 
-#if 0
 static void ppc_opc_init_groupv()
 {
 	for (uint i=0; i<(sizeof ppc_opc_table_groupv / sizeof ppc_opc_table_groupv[0]);i++) {
@@ -847,7 +846,7 @@ static void ppc_opc_group_v(PPC_CPU_State &aCPU)
 	uint32 ext = PPC_OPC_EXT(aCPU.current_opc);
 #ifndef  __VEC_EXC_OFF__
 	if ((aCPU.msr & MSR_VEC) == 0) {
-		ppc_exception(PPC_EXC_NO_VEC);
+//		ppc_exception(PPC_EXC_NO_VEC);
 		return;
 	}
 #endif
@@ -976,7 +975,6 @@ static JITCFlow ppc_opc_gen_group_v(JITC &aJITC)
 	}
 	return ppc_opc_table_gen_groupv[ext](aJITC);
 }
-#endif
 
 static ppc_opc_function ppc_opc_table_main[64] = {
 	&ppc_opc_special,	//  0
@@ -1145,10 +1143,8 @@ void ppc_dec_init()
 	ppc_opc_init_group2();
 	if ((ppc_cpu_get_pvr(0) & 0xffff0000) == 0x000c0000) {
 //		ht_printf("[PPC/VEC] Vector Address: %p\n", &aCPU.vr[0]);
-#if 0
 		ppc_opc_table_main[4] = ppc_opc_group_v;
 		ppc_opc_table_gen_main[4] = ppc_opc_gen_group_v;
 		ppc_opc_init_groupv();
-#endif
 	}
 }
@@ -28,7 +28,7 @@ void FASTCALL ppc_exec_opc(PPC_CPU_State &aCPU);
 JITCFlow FASTCALL ppc_gen_opc(JITC &jitc);
 void ppc_dec_init();
 
-#define PPC_OPC_ASSERT(v)
+#define PPC_OPC_ASSERT(v)	((void)sizeof (v))	// not checked, but keeps v "used"
 
 #define PPC_OPC_MAIN(opc)		(((opc)>>26)&0x3f)
 #define PPC_OPC_EXT(opc)		(((opc)>>1)&0x3ff)
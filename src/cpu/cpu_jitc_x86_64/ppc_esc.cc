@@ -25,6 +25,7 @@
 #include "ppc_cpu.h"
 #include "ppc_esc.h"
 #include "ppc_mmu.h"
+#include "jitc.h"
 #include "jitc_asm.h"
 
 typedef void (*ppc_escape_function)(PPC_CPU_State &aCPU, uint64 *stack, uint32 client_pc);
@@ -342,6 +343,169 @@ static void escape_copy_page(PPC_CPU_State &aCPU, uint64 *stack, uint32 client_p
 	memcpy(dst, src, 4096);	
 }
 
+/*
+ *	Checks whether all pages of [ea, ea+size) can be accessed with
+ *	flags. If not, fault is set to the first address which can't.
+ */
+static bool range_accessible(PPC_CPU_State &aCPU, uint32 ea, uint32 size, int flags, uint32 &fault)
+{
+	if (uint64(ea) + size > 0x100000000ULL) {
+		fault = ea;
+		return false;
+	}
+	uint32 end = ea + size;
+	while (ea < end) {
+		if (!memory_handle(aCPU, ea, flags)) {
+			fault = ea;
+			return false;
+		}
+		ea = (ea & ~0xfff) + 4096;
+		if (!ea) break;
+	}
+	return true;
+}
+
+/*
+ *	Page by page like range_accessible(): lets jitcCheckCodeWrite()
+ *	throw away translations the store to [ea, ea+size) would
+ *	overwrite. Only for accessible ranges.
+ */
+static void range_check_code_write(PPC_CPU_State &aCPU, uint32 ea, uint32 size)
+{
+	while (size) {
+		uint32 pa;
+		uint32 s = 4096 - (ea & 0xfff);
+		s = MIN(s, size);
+		ppc_effective_to_physical_vm(aCPU, ea, PPC_MMU_READ | PPC_MMU_WRITE, pa);
+		jitcCheckCodeWrite(*aCPU.jitc, pa, s);
+		ea += s;
+		size -= s;
+	}
+}
+
+/*
+ *	Checks whether a page of the accessible range [ea, ea+size)
+ *	contains translated code.
+ */
+static bool range_has_code(PPC_CPU_State &aCPU, uint32 ea, uint32 size)
+{
+	uint32 end = ea + size;
+	while (ea != end) {
+		uint32 pa;
+		ppc_effective_to_physical_vm(aCPU, ea, PPC_MMU_READ | PPC_MMU_WRITE, pa);
+		uint64 *lines = &aCPU.jitc->codeLines[(pa >> 12)*2];
+		if (lines[0] | lines[1]) return true;
+		uint32 s = 4096 - (ea & 0xfff);
+		ea += MIN(s, end - ea);
+	}
+	return false;
+}
+
+/*
+ *	memmove() of an accessible (see range_accessible()) range,
+ *	page by page and in the order overlapping ranges need.
+ *	The caller has to take care of translated code in dest.
+ */
+static void move_range(PPC_CPU_State &aCPU, uint32 dest, uint32 source, uint32 size)
+{
+	if (dest <= source) {
+		while (size) {
+			uint32 s = 4096 - (dest & 0xfff);
+			uint32 s2 = 4096 - (source & 0xfff);
+			s = MIN(s, s2);
+			s = MIN(s, size);
+			memmove(memory_handle(aCPU, dest, PPC_MMU_READ | PPC_MMU_WRITE),
+				memory_handle(aCPU, source, PPC_MMU_READ), s);
+			dest += s;
+			source += s;
+			size -= s;
+		}
+	} else {
+		dest += size;
+		source += size;
+		while (size) {
+			uint32 s = dest & 0xfff;
+			uint32 s2 = source & 0xfff;
+			if (!s) s = 0x1000;
+			if (!s2) s2 = 0x1000;
+			s = MIN(s, s2);
+			s = MIN(s, size);
+			dest -= s;
+			source -= s;
+			size -= s;
+			memmove(memory_handle(aCPU, dest, PPC_MMU_READ | PPC_MMU_WRITE),
+				memory_handle(aCPU, source, PPC_MMU_READ), s);
+		}
+	}
+}
+
+static void escape_memmove(PPC_CPU_State &aCPU, uint64 *stack, uint32 client_pc)
+{
+	// memmove(dest [r4], src [r5], size [r6])
+	uint32 dest = aCPU.gpr[4];
+	uint32 source = aCPU.gpr[5];
+	uint32 size = aCPU.gpr[6];
+	PPC_ESC_TRACE("memmove(%08x, %08x, %d)\n", dest, source, size);
+	if (!size || dest == source) return;
+	// nothing is copied before everything is accessible, so it can be restarted
+	uint32 fault;
+	if (!range_accessible(aCPU, source, size, PPC_MMU_READ, fault)
+	 || !range_accessible(aCPU, dest, size, PPC_MMU_READ | PPC_MMU_WRITE, fault)) {
+		return_to_dsi_exception_handler(aCPU, fault, stack, client_pc);
+		return;
+	}
+	range_check_code_write(aCPU, dest, size);
+	move_range(aCPU, dest, source, size);
+}
+
+static void escape_strlen(PPC_CPU_State &aCPU, uint64 *stack, uint32 client_pc)
+{
+	// r3 = strlen(s [r4])
+	uint32 s = aCPU.gpr[4];
+	uint32 ea = s;
+	PPC_ESC_TRACE("strlen(%08x)\n", s);
+	while (1) {
+		byte *p = memory_handle(aCPU, ea, PPC_MMU_READ);
+		if (!p) {
+			return_to_dsi_exception_handler(aCPU, ea, stack, client_pc);
+			return;
+		}
+		uint32 a = 4096 - (ea & 0xfff);
+		byte *z = (byte *)memchr(p, 0, a);
+		if (z) {
+			aCPU.gpr[3] = ea + (z - p) - s;
+			return;
+		}
+		ea += a;
+	}
+}
+
+static void escape_csum_partial(PPC_CPU_State &aCPU, uint64 *stack, uint32 client_pc)
+{
+	// r3 = csum_partial(buf [r4], len [r5], sum [r6])
+	// 32 bit one's complement sum of the big-endian halfwords
+	uint32 ea = aCPU.gpr[4];
+	uint32 size = aCPU.gpr[5];
+	PPC_ESC_TRACE("csum_partial(%08x, %d, %08x)\n", ea, size, aCPU.gpr[6]);
+	uint32 fault;
+	if (!range_accessible(aCPU, ea, size, PPC_MMU_READ, fault)) {
+		return_to_dsi_exception_handler(aCPU, fault, stack, client_pc);
+		return;
+	}
+	uint64 sum = aCPU.gpr[6];
+	uint32 i = 0;
+	while (i < size) {
+		byte *p = memory_handle(aCPU, ea + i, PPC_MMU_READ);
+		uint32 a = 4096 - ((ea + i) & 0xfff);
+		a = MIN(a, size - i);
+		for (uint32 j = 0; j < a; j++, i++) {
+			sum += (i & 1) ? p[j] : p[j] << 8;
+		}
+	}
+	while (sum >> 32) sum = (sum & 0xffffffff) + (sum >> 32);
+	aCPU.gpr[3] = sum;
+}
+
 static ppc_escape_function escape_functions[] = {
 	escape_version,
 	
@@ -353,6 +517,9 @@ static ppc_escape_function escape_functions[] = {
 	escape_bcopy_phys,
 	escape_bcopy_phys,
 	escape_copy_page,
+	escape_memmove,
+	escape_strlen,
+	escape_csum_partial,
 };
 
 void FASTCALL ppc_escape_vm(PPC_CPU_State &aCPU, uint32 func, uint64 *stack, uint32 client_pc)
@@ -364,3 +531,80 @@ void FASTCALL ppc_escape_vm(PPC_CPU_State &aCPU, uint32 func, uint64 *stack, uin
 	}
 }
 
+
+/*
+ *	Called by the bdnz of a copy or fill loop recognized by the
+ *	translator (see ppc_opc_gen_block_loop()) after the first
+ *	iteration. Does the remaining CTR-1 iterations at once and
+ *	leaves CTR at 1, so the bdnz exits the loop.
+ *
+ *	Nothing is done if a page isn't accessible, if the element
+ *	by element copy of the loop would differ from a memmove() or
+ *	if the destination contains translated code (maybe the loop
+ *	itself), the loop then simply continues in the guest.
+ */
+void ppc_escape_block_loop(PPC_CPU_State &aCPU, uint32 desc)
+{
+	if (aCPU.ctr < 2) return;	// ctr == 0 means 2^32 iterations
+	uint32 sz = PPC_ESC_LOOP_SIZE(desc);
+	uint64 len64 = uint64(aCPU.ctr - 1) * sz;
+	if (len64 > 0x10000000) return;
+	uint32 len = len64;
+	bool backwards = desc & PPC_ESC_LOOP_BACKWARDS;
+	int rD = PPC_ESC_LOOP_DEST(desc);
+	int rV = PPC_ESC_LOOP_VAL(desc);
+	uint32 dest = aCPU.gpr[rD];
+	uint32 start = backwards ? dest - len : dest + sz;
+	uint32 fault;
+	if (desc & PPC_ESC_LOOP_COPY) {
+		int rS = PPC_ESC_LOOP_SRC(desc);
+		uint32 source = aCPU.gpr[rS];
+		uint32 src = backwards ? source - len : source + sz;
+		if (backwards ? (start < src && start + len > src)
+		              : (start > src && start < src + len)) return;
+		if (!range_accessible(aCPU, src, len, PPC_MMU_READ, fault)
+		 || !range_accessible(aCPU, start, len, PPC_MMU_READ | PPC_MMU_WRITE, fault)
+		 || range_has_code(aCPU, start, len)) return;
+		move_range(aCPU, start, src, len);
+		aCPU.gpr[rS] = backwards ? source - len : source + len;
+		dest = backwards ? dest - len : dest + len;
+		// the last element loaded
+		uint32 v = 0;
+		for (uint32 i = 0; i < sz; i++) {
+			v = (v << 8) | *memory_handle(aCPU, dest + i, PPC_MMU_READ);
+		}
+		aCPU.gpr[rV] = v;
+	} else {
+		if (!range_accessible(aCPU, start, len, PPC_MMU_READ | PPC_MMU_WRITE, fault)
+		 || range_has_code(aCPU, start, len)) return;
+		byte pattern[4];
+		uint32 v = aCPU.gpr[rV];
+		for (uint32 i = 0; i < sz; i++) {
+			pattern[i] = v >> (8 * (sz - 1 - i));
+		}
+		bool uniform = true;
+		for (uint32 i = 1; i < sz; i++) {
+			if (pattern[i] != pattern[0]) uniform = false;
+		}
+		uint32 ea = start, size = len, phase = 0;
+		while (size) {
+			byte *p = memory_handle(aCPU, ea, PPC_MMU_READ | PPC_MMU_WRITE);
+			uint32 a = 4096 - (ea & 0xfff);
+			a = MIN(a, size);
+			if (uniform) {
+				memset(p, pattern[0], a);
+			} else {
+				for (uint32 i = 0; i < a; i++) {
+					p[i] = pattern[phase];
+					phase = (phase + 1) & (sz - 1);
+				}
+			}
+			ea += a;
+			size -= a;
+		}
+		dest = backwards ? dest - len : dest + len;
+	}
+	aCPU.gpr[rD] = dest;
+	aCPU.ctr = 1;
+	aCPU.jitc->block_loops++;
+}
@@ -38,8 +38,24 @@
 #define PPC_INTERN_BCOPY_PHYS		6
 #define PPC_INTERN_BCOPY_PHYSVIR	7
 #define PPC_INTERN_COPY_PAGE		8
+#define PPC_INTERN_MEMMOVE		9
+#define PPC_INTERN_STRLEN		10
+#define PPC_INTERN_CSUM_PARTIAL		11
 
+/*
+ *	Descriptor of a copy or fill loop recognized by the translator
+ *	(see ppc_escape_block_loop())
+ */
+#define PPC_ESC_LOOP_DEST(d)		((d) & 31)		// rD, incremented pointer
+#define PPC_ESC_LOOP_SRC(d)		(((d) >> 5) & 31)	// rS, copy only
+#define PPC_ESC_LOOP_VAL(d)		(((d) >> 10) & 31)	// rT (copy) or rV (fill)
+#define PPC_ESC_LOOP_SIZE(d)		(1 << (((d) >> 15) & 3))
+#define PPC_ESC_LOOP_BACKWARDS		(1 << 17)
+#define PPC_ESC_LOOP_COPY		(1 << 18)
+#define PPC_ESC_LOOP(rD, rS, rV, log2size) \
+	((rD) | ((rS) << 5) | ((rV) << 10) | ((log2size) << 15))
 
 void FASTCALL ppc_escape_vm(PPC_CPU_State &aCPU, uint32 func, uint64 *rsp, uint32 client_pc);
+void ppc_escape_block_loop(PPC_CPU_State &aCPU, uint32 desc);
 
 #endif
@@ -760,209 +760,276 @@ double ppc_fpu_get_double(ppc_double &d)
  *
  */
 
-#define SWAP do {                                                    \
-	int tmp = frA; frA = frB; frB = tmp;                         \
-	tmp = a; a = b; b = tmp;                                     \
-	X86FloatArithOp tmpop = op; op = rop; rop = tmpop;           \
-} while(0);
+/*
+ *	Native floating point code
+ *
+ *	Client floating point registers stay in the 64 bit integer
+ *	registers of the register allocator (so the FP loads and stores
+ *	don't need to know about this). An instruction copies its operands
+ *	into XMM temporaries, computes the result with scalar SSE2 code and
+ *	moves it back into the register mapped to frD.
+ *
+ *	The SSE2 code runs with the default MXCSR (round to nearest, all
+ *	exceptions masked). ppc_opc_gen_check_fpu() verifies once per block
+ *	that FPSCR asks for nothing else; if it does, the page is
+ *	retranslated with all instructions interpreted (see preciseFloat).
+ *	The record forms are interpreted, too.
+ *
+ *	The sticky exception bits end up in FPSCR like with the
+ *	interpreter: invalid operations right away (see
+ *	ppc_opc_gen_check_invalid()), the others when FPSCR is read or
+ *	written as a whole (see ppc_fpu_sync_fpscr()). Like the
+ *	interpreter, the native code doesn't compute FPSCR[FR,FI,FPRF]
+ *	except for the FPCC of compares.
+ */
+static inline bool ppc_opc_gen_fpu_interpret(JITC &jitc)
+{
+	return jitc.currentPage->preciseFloat || (jitc.current_opc & PPC_OPC_Rc);
+}
 
-#if 0 
-static void ppc_opc_gen_binary_floatop(X86FloatArithOp op, X86FloatArithOp rop, int frD, int frA, int frB)
-{
-	jitcFloatRegisterClobberAll();
-//	jitcSetFPUPrecision(53);
-	
-//	ht_printf("binfloatop: %x: %d: %d, %d, %d\n", jitc.pc, op, frD, frA, frB);
-	// op == st(i)/st(0)
-	// rop == st(0)/st(i)
+#define MXCSR_IE	(1<<0)
+#define MXCSR_ZE	(1<<2)
+#define MXCSR_OE	(1<<3)
+#define MXCSR_UE	(1<<4)
+#define MXCSR_PE	(1<<5)
+#define MXCSR_FLAGS	0x3f
 
-	// op == st(0)/mem
-	// rop == mem/st(0)
+static uint32 ppc_fpu_take_mxcsr_flags()
+{
+	uint32 mxcsr;
+	asm volatile("stmxcsr %0" : "=m" (mxcsr));
+	uint32 flags = mxcsr & MXCSR_FLAGS;
+	mxcsr &= ~MXCSR_FLAGS;
+	asm volatile("ldmxcsr %0" : : "m" (mxcsr));
+	return flags;
+}
 
-	// frD := frA (op) frB = frB (rop) frA
+/*
+ *	Moves the exceptions which the native code left in MXCSR into
+ *	FPSCR. Must be called before FPSCR is read or written as a whole.
+ *	Invalid operations have already been moved.
+ */
+void ppc_fpu_sync_fpscr(PPC_CPU_State &aCPU)
+{
+	uint32 flags = ppc_fpu_take_mxcsr_flags();
+	if (flags & MXCSR_ZE) aCPU.fpscr |= FPSCR_ZX;
+	if (flags & MXCSR_OE) aCPU.fpscr |= FPSCR_OX;
+	if (flags & MXCSR_UE) aCPU.fpscr |= FPSCR_UX;
+	if (flags & MXCSR_PE) aCPU.fpscr |= FPSCR_XX;
+}
 
-	// make sure client float register aren't mapped to integer registers
-	jitcClobberClientRegisterForFloat(frA);
-	jitcClobberClientRegisterForFloat(frB);
-	jitcInvalidateClientRegisterForFloat(frD);
+/*
+ *	Forgets what the host did with MXCSR before running the client
+ */
+void ppc_fpu_clear_mxcsr()
+{
+	ppc_fpu_take_mxcsr_flags();
+}
 
-	JitcFloatReg a = jitcGetClientFloatRegisterMapping(frA);
-	JitcFloatReg b = jitcGetClientFloatRegisterMapping(frB);
-//	ht_printf("%d -> %d\n", frA, a);
-//	ht_printf("%d -> %d\n", frB, b);
-	if (a == JITC_FLOAT_REG_NONE && b != JITC_FLOAT_REG_NONE) {
-		// b is mapped but not a, swap them
-		SWAP;
-	}
-	if (a != JITC_FLOAT_REG_NONE) {
-		// a is mapped
-		if (frB == frD && frA != frD) {
-			// b = st(a) (op) b
-//			ht_printf("case a\n");
-			b = jitcGetClientFloatRegister(frB, a);
-			if (jitcFloatRegisterIsTOP(b)) {
-				asmFArith_ST0(op, jitcFloatRegisterToNative(a));
-			} else {
-				jitcFloatRegisterXCHGToFront(a);
-				asmFArith_STi(rop, jitcFloatRegisterToNative(b));
-			}
-			jitcFloatRegisterDirty(b);
-		} else if (frA == frD) {
-			// st(a) = st(a) (op) b
-//			ht_printf("case b\n");
-			b = jitcGetClientFloatRegister(frB, a);
-			if (jitcFloatRegisterIsTOP(b)) {
-				asmFArith_STi(op, jitcFloatRegisterToNative(a));
-			} else {
-				jitcFloatRegisterXCHGToFront(a);
-				asmFArith_ST0(rop, jitcFloatRegisterToNative(b));
-			}
-			jitcFloatRegisterDirty(a);
-		} else {
-//			ht_printf("case c\n");
-			// frA != frD != frB (and frA is mapped, frD isn't mapped)
-			a = jitcFloatRegisterDup(a, b);
-//			ht_printf("%d\n", b);
-			// now a is TOP
-			if (b != JITC_FLOAT_REG_NONE) {
-				asmFArith_ST0(rop, jitcFloatRegisterToNative(b));
-			} else {
-				modrm_o modrm;
-				asmFArith(op, x86_mem2(modrm, &aCPU.fpr[frB]));
-			}
-			JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-			if (d == JITC_FLOAT_REG_NONE) {
-				jitcMapClientFloatRegisterDirty(frD, a);
-			} else {
-				jitcFloatRegisterStoreAndPopTOP(d);
-				jitcFloatRegisterDirty(d);
-			}
-		}
-	} else {
-//			ht_printf("case d\n");
-		// neither a nor b is mapped
-		if (frB == frD && frA != frD) {
-			// frB = frA (op) frB, none of them is mapped
-			b = jitcGetClientFloatRegister(frB);
-			jitcFloatRegisterDirty(b);
-			modrm_o modrm;
-			asmFArith(rop, x86_mem2(modrm, &aCPU.fpr[frA]));
-			return;
-		}
-		if (frA == frD) {
-			// frA = frA (op) frB, none of them is mapped
-			a = jitcGetClientFloatRegister(frA);
-			jitcFloatRegisterDirty(a);
-			modrm_o modrm;
-			asmFArith(op, x86_mem2(modrm, &aCPU.fpr[frB]));
-		} else {
-			// frA != frD != frB (and frA, frB aren't mapped)
-			a = jitcGetClientFloatRegisterUnmapped(frA);
-			modrm_o modrm;
-			asmFArith(op, x86_mem2(modrm, &aCPU.fpr[frB]));
-			JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-			if (d == JITC_FLOAT_REG_NONE) {
-				jitcMapClientFloatRegisterDirty(frD, a);
-			} else {
-				jitcFloatRegisterStoreAndPopTOP(d);
-				jitcFloatRegisterDirty(d);
-			}
+/*
+ *	An invalid operation only sets MXCSR[IE], so it can't tell which
+ *	FPSCR[VX*] bit it stands for once the next one has run. Every
+ *	instruction which may raise one checks IE right away and turns it
+ *	into vx, or into vxZero if the client register zero1 or zero2
+ *	(-1 for none) holds a zero.
+ */
+static void ppc_opc_gen_check_invalid(JITC &jitc, uint32 vx, uint32 vxZero = 0, int zero1 = -1, int zero2 = -1)
+{
+	jitc.clobberCarryAndFlags();
+	NativeReg fpscr = jitc.getClientRegisterDirty(PPC_FPSCR);
+	NativeReg z[2];
+	z[0] = (zero1 < 0) ? REG_NO : jitc.getClientRegister(PPC_FPR(zero1));
+	z[1] = (zero2 < 0) ? REG_NO : jitc.getClientRegister(PPC_FPR(zero2));
+	NativeReg t = (zero1 < 0) ? REG_NO : jitc.allocRegister();
+
+	jitc.asmSTMXCSR(curCPU(temp2));
+	jitc.asmTEST32(curCPU(temp2), MXCSR_IE);
+	NativeAddress valid = jitc.asmJxxFixup(X86_Z);
+	jitc.asmAND32(curCPU(temp2), ~MXCSR_IE);
+	jitc.asmLDMXCSR(curCPU(temp2));
+	if (t != REG_NO) {
+		NativeAddress zero[2];
+		int n = 0;
+		for (int i=0; i < 2; i++) {
+			if (z[i] == REG_NO) continue;
+			// +0.0 and -0.0 are zero without the sign bit
+			jitc.asmALU64(X86_MOV, t, z[i]);
+			jitc.asmALU64(X86_ADD, t, t);
+			zero[n++] = jitc.asmJxxFixup(X86_Z);
 		}
+		jitc.asmALU32(X86_OR, fpscr, vx);
+		NativeAddress done = jitc.asmJMPFixup();
+		for (int i=0; i < n; i++) jitc.asmResolveFixup(zero[i]);
+		jitc.asmALU32(X86_OR, fpscr, vxZero);
+		jitc.asmResolveFixup(done);
+	} else if (vx) {
+		jitc.asmALU32(X86_OR, fpscr, vx);
 	}
+	jitc.asmResolveFixup(valid);
 }
 
-static inline void ppc_opc_gen_unary_floatop(X86FloatOp op, int frD, int frA)
-{
-	jitcClobberClientRegisterForFloat(frA);
-	jitcInvalidateClientRegisterForFloat(frD);
-	if (frD == frA) {
-		JitcFloatReg a = jitcGetClientFloatRegister(frA);
-		jitcFloatRegisterDirty(a);
-		jitcFloatRegisterXCHGToFront(a);
-	} else {
-		JitcFloatReg a = jitcGetClientFloatRegisterMapping(frA);
-		if (a == JITC_FLOAT_REG_NONE) {
-			a = jitcGetClientFloatRegisterUnmapped(frA);
-		} else {
-			a = jitcFloatRegisterDup(a);
-		}
-		JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-		if (d == JITC_FLOAT_REG_NONE) {
-			jitcMapClientFloatRegisterDirty(frD, a);
-		} else {
-			asmFSimple(op);
-			jitcFloatRegisterStoreAndPopTOP(d);
-			jitcFloatRegisterDirty(d);
-			return;
-		}
-	}
-	asmFSimple(op);
+static NativeVectorReg ppc_opc_gen_get_fpr(JITC &jitc, int fr)
+{
+	NativeReg r = jitc.getClientRegister(PPC_FPR(fr));
+	NativeVectorReg x = jitc.allocVectorRegister();
+	jitc.asmMOVQ(x, r);
+	return x;
+}
+
+static void ppc_opc_gen_set_fpr(JITC &jitc, int fr, NativeVectorReg x)
+{
+	NativeReg r = jitc.mapClientRegisterDirty(PPC_FPR(fr));
+	jitc.asmMOVQ(r, x);
+}
+
+static NativeVectorReg ppc_opc_gen_double_constant(JITC &jitc, uint64 value)
+{
+	NativeReg r = jitc.allocRegister();
+	NativeVectorReg x = jitc.allocVectorRegister();
+	jitc.asmMOVABS(r, value);
+	jitc.asmMOVQ(x, r);
+	return x;
 }
 
+#define DOUBLE_ONE	0x3ff0000000000000ULL
+#define DOUBLE_INTMAX	0x41dfffffffc00000ULL	// 2147483647.0
 
 /*
- fmadd     FADD  false
- fmsub     FSUB  false
- fnmadd    FADD  true
- fnmsub    FSUBR false
-*/
+ *	Rounds to single precision (and back to double)
+ */
+static inline void ppc_opc_gen_round_single(JITC &jitc, NativeVectorReg x)
+{
+	jitc.asmALUSD(X86_CVTSD2SS, x, x);
+	jitc.asmCVTSS2SD(x, x);
+}
+
+/*
+ *	frD = frA op frB
+ */
+static void ppc_opc_gen_binary_floatop(JITC &jitc, X86ALUSDopc op, int frD, int frA, int frB, bool single)
+{
+	NativeVectorReg a = ppc_opc_gen_get_fpr(jitc, frA);
+	NativeVectorReg b = (frA == frB) ? a : ppc_opc_gen_get_fpr(jitc, frB);
+	jitc.asmALUSD(op, a, b);
+	if (single) ppc_opc_gen_round_single(jitc, a);
+	switch (op) {
+	case X86_MULSD:
+		ppc_opc_gen_check_invalid(jitc, FPSCR_VXIMZ);
+		break;
+	case X86_DIVSD:
+		// 0/0 or inf/inf
+		ppc_opc_gen_check_invalid(jitc, FPSCR_VXIDI, FPSCR_VXZDZ, frB);
+		break;
+	default:
+		ppc_opc_gen_check_invalid(jitc, FPSCR_VXISI);
+		break;
+	}
+	ppc_opc_gen_set_fpr(jitc, frD, a);
+}
 
-static void ppc_opc_gen_ternary_floatop(X86FloatArithOp op, X86FloatArithOp rop, bool chs, int frD, int frA, int frC, int frB)
-{
-	jitcFloatRegisterClobberAll();
-//	jitcSetFPUPrecision(64);
-	jitcClobberClientRegisterForFloat(frA);
-	jitcClobberClientRegisterForFloat(frC);
-	jitcClobberClientRegisterForFloat(frB);
-	jitcInvalidateClientRegisterForFloat(frD);
+/*
+ *	frD = op frB
+ */
+static void ppc_opc_gen_unary_floatop(JITC &jitc, X86ALUSDopc op, int frD, int frB, bool single)
+{
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	jitc.asmALUSD(op, b, b);
+	if (single) ppc_opc_gen_round_single(jitc, b);
+	ppc_opc_gen_check_invalid(jitc, op == X86_SQRTSD ? FPSCR_VXSQRT : FPSCR_VXSNAN);
+	ppc_opc_gen_set_fpr(jitc, frD, b);
+}
 
-	JitcFloatReg a = jitcGetClientFloatRegisterMapping(frA);
-	if (a != JITC_FLOAT_REG_NONE) {
-		ht_printf("askf lsa flsd\n");
-		a = jitcFloatRegisterDup(a, jitcGetClientFloatRegisterMapping(frC));
+/*
+ *	frD = [-](frA * frC op frB)
+ *
+ *	Note that SSE2 has no fused multiply-add, so without FMA the
+ *	product is rounded. With FMA the double forms round once like
+ *	the PowerPC, but the single forms still round twice (to double,
+ *	then to single), which may be off by one ulp in rare cases.
+ */
+static void ppc_opc_gen_ternary_floatop(JITC &jitc, X86ALUSDopc op, bool neg, int frD, int frA, int frC, int frB, bool single)
+{
+	NativeVectorReg a = ppc_opc_gen_get_fpr(jitc, frA);
+	NativeVectorReg c = (frA == frC) ? a : ppc_opc_gen_get_fpr(jitc, frC);
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	if (jitc.hostCPUCaps.fma) {
+		// fused like on the PowerPC
+		jitc.asmVFMASD(op == X86_ADDSD ? X86_VFMADD213SD : X86_VFMSUB213SD, a, c, b);
 	} else {
-		a = jitcGetClientFloatRegisterUnmapped(frA, jitcGetClientFloatRegisterMapping(frC), jitcGetClientFloatRegisterMapping(frB));
+		jitc.asmALUSD(X86_MULSD, a, c);
+		jitc.asmALUSD(op, a, b);
 	}
-	// a is TOP now
-	JitcFloatReg c = jitcGetClientFloatRegisterMapping(frC);
-	if (c != JITC_FLOAT_REG_NONE) {
-		asmFArith_ST0(X86_FMUL, jitcFloatRegisterToNative(c));
-	} else {
-		modrm_o modrm;
-		asmFArith(X86_FMUL, x86_mem2(modrm, &aCPU.fpr[frC]));
+	if (neg) {
+		// b = sign bit, unless the result is a NaN (which isn't negated)
+		jitc.asmALUPS(X86_MOVAPS, b, a);
+		jitc.asmCMPSD(X86_CMPORDPS, b, a);
+		jitc.asmPShift(X86_PSLLQ, b, 63);
+		jitc.asmALUPS(X86_XORPS, a, b);
 	}
-	JitcFloatReg b = jitcGetClientFloatRegisterMapping(frB);
-	if (b != JITC_FLOAT_REG_NONE) {
-		asmFArith_ST0(rop, jitcFloatRegisterToNative(b));
+	if (single) ppc_opc_gen_round_single(jitc, a);
+	// inf*0 or inf-inf
+	ppc_opc_gen_check_invalid(jitc, FPSCR_VXISI, FPSCR_VXIMZ, frA, frC);
+	ppc_opc_gen_set_fpr(jitc, frD, a);
+}
+
+/*
+ *	Changes the sign bit of frB in the integer domain
+ */
+static void ppc_opc_gen_sign_floatop(JITC &jitc, X86ALUopc op, uint64 mask, int frD, int frB)
+{
+	jitc.clobberCarryAndFlags();
+	NativeReg t = jitc.allocRegister();
+	jitc.asmMOVABS(t, mask);
+	if (frD == frB) {
+		NativeReg b = jitc.getClientRegisterDirty(PPC_FPR(frB));
+		jitc.asmALU64(op, b, t);
 	} else {
-		modrm_o modrm;
-		asmFArith(op, x86_mem2(modrm, &aCPU.fpr[frB]));
-	}
-	if (chs) {
-		asmFSimple(FCHS);
+		NativeReg b = jitc.getClientRegister(PPC_FPR(frB));
+		NativeReg d = jitc.mapClientRegisterDirty(PPC_FPR(frD));
+		jitc.asmALU64(X86_MOV, d, b);
+		jitc.asmALU64(op, d, t);
 	}
-	JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-	if (d == JITC_FLOAT_REG_NONE) {
-		jitcMapClientFloatRegisterDirty(frD, a);
-	} else {
-		jitcFloatRegisterStoreAndPopTOP(d);
-		jitcFloatRegisterDirty(d);
-	}		
 }
 
-//#define JITC
- 
-static void FASTCALL ppc_opc_gen_update_cr1_output_err(const char *err)
-{
-	PPC_FPU_ERR("%s\n", err);
+/*
+ *	frD = (frA >= 0.0) ? frC : frB
+ */
+static void ppc_opc_gen_select_floatop(JITC &jitc, int frD, int frA, int frC, int frB)
+{
+	NativeVectorReg a = ppc_opc_gen_get_fpr(jitc, frA);
+	NativeVectorReg m = jitc.allocVectorRegister();
+	jitc.asmALUPS(X86_XORPS, m, m);
+	// m = (0.0 <= frA) ? ~0 : 0, a NaN compares false
+	jitc.asmCMPSD(X86_CMPLEPS, m, a);
+	NativeVectorReg c = ppc_opc_gen_get_fpr(jitc, frC);
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	jitc.asmALUPS(X86_ANDPS, c, m);
+	jitc.asmALUPS(X86_ANDNPS, m, b);
+	jitc.asmALUPS(X86_ORPS, m, c);
+	// cmplesd raises an invalid operation on a NaN, fsel doesn't
+	ppc_opc_gen_check_invalid(jitc, 0);
+	ppc_opc_gen_set_fpr(jitc, frD, m);
 }
 
-static void ppc_opc_gen_update_cr1(const char *err)
-{
-	asmALU(X86_MOV, EAX, (uint32)err);
-	asmCALL((NativeAddress)ppc_opc_gen_update_cr1_output_err);
+/*
+ *	frD = (uint32)(int32)frB
+ *
+ *	cvt(t)sd2si returns 0x80000000 for all invalid inputs,
+ *	so positive overflows are clipped to INT_MAX before.
+ */
+static void ppc_opc_gen_convert_floatop(JITC &jitc, bool truncate, int frD, int frB)
+{
+	NativeVectorReg t = ppc_opc_gen_double_constant(jitc, DOUBLE_INTMAX);
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	jitc.asmALUSD(X86_MINSD, t, b);
+	NativeReg d = jitc.mapClientRegisterDirty(PPC_FPR(frD));
+	if (truncate) {
+		jitc.asmCVTTSD2SI(d, t);
+	} else {
+		jitc.asmCVTSD2SI(d, t);
+	}
+	ppc_opc_gen_check_invalid(jitc, FPSCR_VXCVI);
 }
-#endif
 
 /*
  *	fabsx		Floating Absolute Value
@@ -981,36 +1048,14 @@ void ppc_opc_fabsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fabsx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB;
-	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
-	if (jitcGetClientFloatRegisterMapping(frB) == JITC_FLOAT_REG_NONE) {
-		JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-		if (d != JITC_FLOAT_REG_NONE) jitcFloatRegisterInvalidate(d);
-		jitcClobberCarryAndFlags();	
-		if (frD != frB) {
-			NativeReg bh = jitcGetClientRegister(PPC_FPR_U(frB));
-			NativeReg bl = jitcGetClientRegister(PPC_FPR_L(frB));
-			NativeReg dh = jitcMapClientRegisterDirty(PPC_FPR_U(frD));
-			NativeReg dl = jitcMapClientRegisterDirty(PPC_FPR_L(frD));
-			asmALU(X86_MOV, dh, bh);
-			asmALU(X86_MOV, dl, bl);
-			asmALU(X86_AND, dh, 0x7fffffff);
-		} else {
-			NativeReg b = jitcGetClientRegisterDirty(PPC_FPR_U(frB));
-			asmALU(X86_AND, b, 0x7fffffff);
-		}
-	} else {
-		ppc_opc_gen_unary_floatop(FABS, frD, frB);
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fabsx);
+		return flowEndBlock;
 	}
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fabs.\n");
-	}	
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_sign_floatop(jitc, X86_AND, ~FPU_SIGN_BIT, frD, frB);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fabsx);
-	return flowEndBlock;
 }
 /*
  *	faddx		Floating Add (Double-Precision)
@@ -1036,20 +1081,14 @@ void ppc_opc_faddx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_faddx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB, frC;
-	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	PPC_OPC_ASSERT(frC==0);
-	ppc_opc_gen_binary_floatop(X86_FADD, X86_FADD, frD, frA, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fadd.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_faddx);
+		return flowEndBlock;
 	}
+	int frD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	ppc_opc_gen_binary_floatop(jitc, X86_ADDSD, frD, frA, frB, false);
 	return flowContinue;
-#else
-	ppc_opc_gen_interpret(jitc, ppc_opc_faddx);
-	return flowEndBlock;
-#endif
 }
 /*
  *	faddsx		Floating Add Single
@@ -1075,8 +1114,14 @@ void ppc_opc_faddsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_faddsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_faddsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_faddsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	ppc_opc_gen_binary_floatop(jitc, X86_ADDSD, frD, frA, frB, true);
+	return flowContinue;
 }
 /*
  *	fcmpo		Floating Compare Ordered
@@ -1092,6 +1137,43 @@ static uint32 ppc_fpu_cmp_and_mask[8] = {
 	0xf0ffffff,
 	0x0fffffff,
 };
+/*
+ *	Sets CR field crfD and FPSCR[FPCC] from a comparison
+ *	of frA and frB, and the FPSCR bits vx for a signaling NaN.
+ */
+static void ppc_opc_gen_compare_floatop(JITC &jitc, int crfD, int frA, int frB, uint32 vx)
+{
+	jitc.clobberCarryAndFlags();
+	NativeVectorReg a = ppc_opc_gen_get_fpr(jitc, frA);
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	NativeReg fpscr = jitc.getClientRegisterDirty(PPC_FPSCR);
+	NativeReg c = jitc.allocRegister();
+	jitc.asmUCOMISD(a, b);
+	jitc.asmMOV32_NoFlags(c, 1);
+	NativeAddress unordered = jitc.asmJxxFixup(X86_PE);
+	jitc.asmMOV32_NoFlags(c, 2);
+	NativeAddress equal = jitc.asmJxxFixup(X86_E);
+	jitc.asmMOV32_NoFlags(c, 8);
+	NativeAddress less = jitc.asmJxxFixup(X86_B);
+	jitc.asmMOV32_NoFlags(c, 4);
+	jitc.asmResolveFixup(unordered);
+	jitc.asmResolveFixup(equal);
+	jitc.asmResolveFixup(less);
+
+	crfD = 7-crfD;
+	jitc.asmShift32(X86_SHL, c, 12);
+	jitc.asmALU32(X86_AND, fpscr, ~0x1f000);
+	jitc.asmALU32(X86_OR, fpscr, c);
+	if (crfD*4 > 12) {
+		jitc.asmShift32(X86_SHL, c, crfD*4 - 12);
+	} else if (crfD*4 < 12) {
+		jitc.asmShift32(X86_SHR, c, 12 - crfD*4);
+	}
+	jitc.asmAND32(curCPU(cr), ppc_fpu_cmp_and_mask[crfD]);
+	jitc.asmALU32(X86_OR, curCPU(cr), c);
+	ppc_opc_gen_check_invalid(jitc, vx);
+}
+
 void ppc_opc_fcmpo(PPC_CPU_State &aCPU)
 {
 	int crfD, frA, frB;
@@ -1116,8 +1198,15 @@ void ppc_opc_fcmpo(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fcmpo(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fcmpo);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fcmpo);
+		return flowEndBlock;
+	}
+	int crfD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, crfD, frA, frB);
+	crfD >>= 2;
+	ppc_opc_gen_compare_floatop(jitc, crfD, frA, frB, FPSCR_VXSNAN | FPSCR_VXVC);
+	return flowContinue;
 }
 /*
  *	fcmpu		Floating Compare Unordered
@@ -1146,8 +1235,15 @@ void ppc_opc_fcmpu(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fcmpu(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fcmpu);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fcmpu);
+		return flowEndBlock;
+	}
+	int crfD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, crfD, frA, frB);
+	crfD >>= 2;
+	ppc_opc_gen_compare_floatop(jitc, crfD, frA, frB, FPSCR_VXSNAN);
+	return flowContinue;
 }
 /*
  *	fctiwx		Floating Convert to Integer Word
@@ -1168,37 +1264,14 @@ void ppc_opc_fctiwx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fctiwx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB;
-	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
-	PPC_OPC_ASSERT(frA==0);
-	jitcClobberClientRegisterForFloat(frB);
-	jitcInvalidateClientRegisterForFloat(frD);
-
-	JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-	if (frB != frD && d != JITC_FLOAT_REG_NONE) {
-		jitcFloatRegisterXCHGToFront(d);
-		asmFFREEP(Float_ST0);
-		jitc.nativeFloatRegState[d] = rsUnused;
-		jitc.clientFloatReg[frD] = JITC_FLOAT_REG_NONE;
-		jitc.nativeFloatTOP--;	
-	}
-
-	modrm_o modrm;
-	JitcFloatReg b = jitcGetClientFloatRegisterUnmapped(frB);
-	asmFISTP_D(x86_mem2(modrm, &aCPU.fpr[frD]));
-	jitc.nativeFloatRegState[b] = rsUnused;
-	jitc.clientFloatReg[frB] = JITC_FLOAT_REG_NONE;
-	jitc.nativeFloatTOP--;
-	
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fctiw.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fctiwx);
+		return flowEndBlock;
 	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_convert_floatop(jitc, false, frD, frB);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fctiwx);
-	return flowEndBlock;
 }
 /*
  *	fctiwzx		Floating Convert to Integer Word with Round toward Zero
@@ -1223,52 +1296,14 @@ void ppc_opc_fctiwzx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fctiwzx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB;
-	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
-	PPC_OPC_ASSERT(frA==0);
-	
-	static uint16 cw = 0xfff;
-	
-	modrm_o modrm;
-	if (!jitc.hostCPUCaps.sse3) {
-		asmFLDCW(x86_mem2(modrm, &cw));
-	}
-	
-	jitcClobberClientRegisterForFloat(frB);
-	jitcInvalidateClientRegisterForFloat(frD);
-
-	JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-	if (frB != frD && d != JITC_FLOAT_REG_NONE) {
-		jitcFloatRegisterXCHGToFront(d);
-		asmFFREEP(Float_ST0);
-		jitc.nativeFloatRegState[d] = rsUnused;
-		jitc.clientFloatReg[frD] = JITC_FLOAT_REG_NONE;
-		jitc.nativeFloatTOP--;	
-	}
-
-	JitcFloatReg b = jitcGetClientFloatRegisterUnmapped(frB);
-	if (jitc.hostCPUCaps.sse3) {
-		asmFISTTP(x86_mem2(modrm, &aCPU.fpr[frD]));
-	} else {
-		asmFISTP_D(x86_mem2(modrm, &aCPU.fpr[frD]));
-	}
-	jitc.nativeFloatRegState[b] = rsUnused;
-	jitc.clientFloatReg[frB] = JITC_FLOAT_REG_NONE;
-	jitc.nativeFloatTOP--;
-	
-	if (!jitc.hostCPUCaps.sse3) {
-		asmFLDCW(x86_mem2(modrm, &aCPU.x87cw));
-	}
-	
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fctiwz.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fctiwzx);
+		return flowEndBlock;
 	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_convert_floatop(jitc, true, frD, frB);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fctiwzx);
-	return flowEndBlock;
 }
 /*
  *	fdivx		Floating Divide (Double-Precision)
@@ -1301,20 +1336,14 @@ void ppc_opc_fdivx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fdivx(JITC &jitc)
 {
-#if 1
-	ppc_opc_gen_interpret(jitc, ppc_opc_fdivx);
-	return flowEndBlock;
-#else
-	int frD, frA, frB, frC;
-	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	PPC_OPC_ASSERT(frC==0);
-	ppc_opc_gen_binary_floatop(X86_FDIV, X86_FDIVR, frD, frA, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fdiv.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fdivx);
+		return flowEndBlock;
 	}
+	int frD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	ppc_opc_gen_binary_floatop(jitc, X86_DIVSD, frD, frA, frB, false);
 	return flowContinue;
-#endif
 }
 /*
  *	fdivsx		Floating Divide Single
@@ -1347,8 +1376,14 @@ void ppc_opc_fdivsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fdivsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fdivsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fdivsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	ppc_opc_gen_binary_floatop(jitc, X86_DIVSD, frD, frA, frB, true);
+	return flowContinue;
 }
 /*
  *	fmaddx		Floating Multiply-Add (Double-Precision)
@@ -1371,18 +1406,14 @@ void ppc_opc_fmaddx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmaddx(JITC &jitc)
 {
-#if 0
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmaddx);
+		return flowEndBlock;
+	}
 	int frD, frA, frB, frC;
 	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	ppc_opc_gen_ternary_floatop(X86_FADD, X86_FADD, false, frD, frA, frC, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fmadd.\n");
-	}
+	ppc_opc_gen_ternary_floatop(jitc, X86_ADDSD, false, frD, frA, frC, frB, false);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmaddx);
-	return flowEndBlock;
 }
 /*
  *	fmaddx		Floating Multiply-Add Single
@@ -1405,8 +1436,14 @@ void ppc_opc_fmaddsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmaddsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmaddsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmaddsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB, frC;
+	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
+	ppc_opc_gen_ternary_floatop(jitc, X86_ADDSD, false, frD, frA, frC, frB, true);
+	return flowContinue;
 }
 /*
  *	fmrx		Floating Move Register
@@ -1425,41 +1462,18 @@ void ppc_opc_fmrx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmrx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB;
-	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmrx);
+		return flowEndBlock;
+	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
 	if (frD != frB) {
-		JitcFloatReg a = jitcGetClientFloatRegisterMapping(frB);
-		if (a == JITC_FLOAT_REG_NONE) {
-			JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-			if (d != JITC_FLOAT_REG_NONE) jitcFloatRegisterInvalidate(d);
-			NativeReg bu = jitcGetClientRegister(PPC_FPR_U(frB));
-			NativeReg bl = jitcGetClientRegister(PPC_FPR_L(frB));
-			NativeReg du = jitcMapClientRegisterDirty(PPC_FPR_U(frD));
-			NativeReg dl = jitcMapClientRegisterDirty(PPC_FPR_L(frD));
-			asmALU(X86_MOV, du, bu);
-        		asmALU(X86_MOV, dl, bl);
-		} else {
-			jitcInvalidateClientRegisterForFloat(frD);
-			JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-			if (d == JITC_FLOAT_REG_NONE) {
-				d = jitcFloatRegisterDup(a);
-				jitcMapClientFloatRegisterDirty(frD, d);
-			} else {
-				jitcFloatRegisterXCHGToFront(a);
-				asmFST(jitcFloatRegisterToNative(d));
-				jitcFloatRegisterDirty(d);
-			}
-		}
+		NativeReg b = jitc.getClientRegister(PPC_FPR(frB));
+		NativeReg d = jitc.mapClientRegisterDirty(PPC_FPR(frD));
+		jitc.asmALU64(X86_MOV, d, b);
 	}
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fabs.\n");
-	}	
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmrx);
-	return flowEndBlock;
 }
 /*
  *	fmsubx		Floating Multiply-Subtract (Double-Precision)
@@ -1483,18 +1497,14 @@ void ppc_opc_fmsubx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmsubx(JITC &jitc)
 {
-#if 0
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmsubx);
+		return flowEndBlock;
+	}
 	int frD, frA, frB, frC;
 	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	ppc_opc_gen_ternary_floatop(X86_FSUB, X86_FSUBR, false, frD, frA, frC, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fmsub.\n");
-	}
+	ppc_opc_gen_ternary_floatop(jitc, X86_SUBSD, false, frD, frA, frC, frB, false);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmsubx);
-	return flowEndBlock;
 }
 /*
  *	fmsubsx		Floating Multiply-Subtract Single
@@ -1518,8 +1528,14 @@ void ppc_opc_fmsubsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmsubsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmsubsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmsubsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB, frC;
+	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
+	ppc_opc_gen_ternary_floatop(jitc, X86_SUBSD, false, frD, frA, frC, frB, true);
+	return flowContinue;
 }
 /*
  *	fmulx		Floating Multiply (Double-Precision)
@@ -1546,20 +1562,15 @@ void ppc_opc_fmulx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmulx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB, frC;
-	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	PPC_OPC_ASSERT(frB==0);
-	ppc_opc_gen_binary_floatop(X86_FMUL, X86_FMUL, frD, frA, frC);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fmul.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmulx);
+		return flowEndBlock;
 	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frA = (jitc.current_opc >> 16) & 0x1f;
+	int frC = (jitc.current_opc >> 6) & 0x1f;
+	ppc_opc_gen_binary_floatop(jitc, X86_MULSD, frD, frA, frC, false);
 	return flowContinue;
-#else
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmulx);
-	return flowEndBlock;
-#endif
 }
 /*
  *	fmulsx		Floating Multiply Single
@@ -1586,8 +1597,15 @@ void ppc_opc_fmulsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fmulsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fmulsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fmulsx);
+		return flowEndBlock;
+	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frA = (jitc.current_opc >> 16) & 0x1f;
+	int frC = (jitc.current_opc >> 6) & 0x1f;
+	ppc_opc_gen_binary_floatop(jitc, X86_MULSD, frD, frA, frC, true);
+	return flowContinue;
 }
 /*
  *	fnabsx		Floating Negative Absolute Value
@@ -1606,37 +1624,14 @@ void ppc_opc_fnabsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fnabsx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB;
-	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
-	if (jitcGetClientFloatRegisterMapping(frB) == JITC_FLOAT_REG_NONE) {
-		JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-		if (d != JITC_FLOAT_REG_NONE) jitcFloatRegisterInvalidate(d);
-		jitcClobberCarryAndFlags();
-		if (frD != frB) {
-			NativeReg bh = jitcGetClientRegister(PPC_FPR_U(frB));
-			NativeReg bl = jitcGetClientRegister(PPC_FPR_L(frB));
-			NativeReg dh = jitcMapClientRegisterDirty(PPC_FPR_U(frD));
-			NativeReg dl = jitcMapClientRegisterDirty(PPC_FPR_L(frD));
-			asmALU(X86_MOV, dh, bh);
-			asmALU(X86_MOV, dl, bl);
-			asmALU(X86_OR, dh, 0x80000000);
-		} else {
-			NativeReg b = jitcGetClientRegisterDirty(PPC_FPR_U(frB));
-			asmALU(X86_OR, b, 0x80000000);
-		}
-	} else {
-		ppc_opc_gen_unary_floatop(FABS, frD, frB);
-		asmFSimple(FCHS);
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fnabsx);
+		return flowEndBlock;
 	}
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fnabs.\n");
-	}	
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_sign_floatop(jitc, X86_OR, FPU_SIGN_BIT, frD, frB);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fnabsx);
-	return flowEndBlock;
 }
 /*
  *	fnegx		Floating Negate
@@ -1655,36 +1650,14 @@ void ppc_opc_fnegx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fnegx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB;
-	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
-	if (jitcGetClientFloatRegisterMapping(frB) == JITC_FLOAT_REG_NONE) {
-		JitcFloatReg d = jitcGetClientFloatRegisterMapping(frD);
-		if (d != JITC_FLOAT_REG_NONE) jitcFloatRegisterInvalidate(d);
-		jitcClobberCarryAndFlags();
-		if (frD != frB) {
-			NativeReg bh = jitcGetClientRegister(PPC_FPR_U(frB));
-			NativeReg bl = jitcGetClientRegister(PPC_FPR_L(frB));
-			NativeReg dh = jitcMapClientRegisterDirty(PPC_FPR_U(frD));
-			NativeReg dl = jitcMapClientRegisterDirty(PPC_FPR_L(frD));
-			asmALU(X86_MOV, dh, bh);
-			asmALU(X86_MOV, dl, bl);
-			asmALU(X86_XOR, dh, 0x80000000);
-		} else {
-			NativeReg b = jitcGetClientRegisterDirty(PPC_FPR_U(frB));
-			asmALU(X86_XOR, b, 0x80000000);
-		}
-	} else {
-		ppc_opc_gen_unary_floatop(FCHS, frD, frB);
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fnegx);
+		return flowEndBlock;
 	}
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fneg.\n");
-	}	
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_sign_floatop(jitc, X86_XOR, FPU_SIGN_BIT, frD, frB);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fnegx);
-	return flowEndBlock;
 }
 /*
  *	fnmaddx		Floating Negative Multiply-Add (Double-Precision) 
@@ -1699,7 +1672,7 @@ void ppc_opc_fnmaddx(PPC_CPU_State &aCPU)
 	ppc_fpu_unpack_double(B, aCPU.fpr[frB]);
 	ppc_fpu_unpack_double(C, aCPU.fpr[frC]);
 	ppc_fpu_mul_add(aCPU.fpscr, D, A, C, B);
-	D.s ^= 1;
+	if (D.type != ppc_fpr_NaN) D.s ^= 1;
 	aCPU.fpscr |= ppc_fpu_pack_double(aCPU.fpscr, D, aCPU.fpr[frD]);
 	if (aCPU.current_opc & PPC_OPC_Rc) {
 		// update cr1 flags
@@ -1708,18 +1681,14 @@ void ppc_opc_fnmaddx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fnmaddx(JITC &jitc)
 {
-#if 0
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fnmaddx);
+		return flowEndBlock;
+	}
 	int frD, frA, frB, frC;
 	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	ppc_opc_gen_ternary_floatop(X86_FADD, X86_FADD, true, frD, frA, frC, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fnmadd.\n");
-	}
+	ppc_opc_gen_ternary_floatop(jitc, X86_ADDSD, true, frD, frA, frC, frB, false);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fnmaddx);
-	return flowEndBlock;
 }
 /*
  *	fnmaddsx	Floating Negative Multiply-Add Single
@@ -1734,7 +1703,7 @@ void ppc_opc_fnmaddsx(PPC_CPU_State &aCPU)
 	ppc_fpu_unpack_double(B, aCPU.fpr[frB]);
 	ppc_fpu_unpack_double(C, aCPU.fpr[frC]);
 	ppc_fpu_mul_add(aCPU.fpscr, D, A, C, B);
-	D.s ^= 1;
+	if (D.type != ppc_fpr_NaN) D.s ^= 1;
 	aCPU.fpscr |= ppc_fpu_pack_double_as_single(aCPU.fpscr, D, aCPU.fpr[frD]);
 	if (aCPU.current_opc & PPC_OPC_Rc) {
 		// update cr1 flags
@@ -1743,8 +1712,14 @@ void ppc_opc_fnmaddsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fnmaddsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fnmaddsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fnmaddsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB, frC;
+	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
+	ppc_opc_gen_ternary_floatop(jitc, X86_ADDSD, true, frD, frA, frC, frB, true);
+	return flowContinue;
 }
 /*
  *	fnmsubx		Floating Negative Multiply-Subtract (Double-Precision)
@@ -1760,7 +1735,7 @@ void ppc_opc_fnmsubx(PPC_CPU_State &aCPU)
 	ppc_fpu_unpack_double(C, aCPU.fpr[frC]);
 	B.s ^= 1;
 	ppc_fpu_mul_add(aCPU.fpscr, D, A, C, B);
-	D.s ^= 1;
+	if (D.type != ppc_fpr_NaN) D.s ^= 1;
 	aCPU.fpscr |= ppc_fpu_pack_double(aCPU.fpscr, D, aCPU.fpr[frD]);
 	if (aCPU.current_opc & PPC_OPC_Rc) {
 		// update cr1 flags
@@ -1769,18 +1744,14 @@ void ppc_opc_fnmsubx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fnmsubx(JITC &jitc)
 {
-#if 0
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fnmsubx);
+		return flowEndBlock;
+	}
 	int frD, frA, frB, frC;
 	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	ppc_opc_gen_ternary_floatop(X86_FSUBR, X86_FSUB, false, frD, frA, frC, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fnmsub.\n");
-	}
+	ppc_opc_gen_ternary_floatop(jitc, X86_SUBSD, true, frD, frA, frC, frB, false);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fnmsubx);
-	return flowEndBlock;
 }
 /*
  *	fnmsubsx	Floating Negative Multiply-Subtract Single
@@ -1796,7 +1767,7 @@ void ppc_opc_fnmsubsx(PPC_CPU_State &aCPU)
 	ppc_fpu_unpack_double(C, aCPU.fpr[frC]);
 	B.s ^= 1;
 	ppc_fpu_mul_add(aCPU.fpscr, D, A, C, B);
-	D.s ^= 1;
+	if (D.type != ppc_fpr_NaN) D.s ^= 1;
 	aCPU.fpscr |= ppc_fpu_pack_double_as_single(aCPU.fpscr, D, aCPU.fpr[frD]);
 	if (aCPU.current_opc & PPC_OPC_Rc) {
 		// update cr1 flags
@@ -1805,8 +1776,14 @@ void ppc_opc_fnmsubsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fnmsubsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fnmsubsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fnmsubsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB, frC;
+	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
+	ppc_opc_gen_ternary_floatop(jitc, X86_SUBSD, true, frD, frA, frC, frB, true);
+	return flowContinue;
 }
 /*
  *	fresx		Floating Reciprocal Estimate Single
@@ -1825,8 +1802,19 @@ void ppc_opc_fresx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fresx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fresx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fresx);
+		return flowEndBlock;
+	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	NativeVectorReg d = ppc_opc_gen_double_constant(jitc, DOUBLE_ONE);
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	jitc.asmALUSD(X86_DIVSD, d, b);
+	ppc_opc_gen_round_single(jitc, d);
+	ppc_opc_gen_check_invalid(jitc, FPSCR_VXSNAN);
+	ppc_opc_gen_set_fpr(jitc, frD, d);
+	return flowContinue;
 }
 /*
  *	frspx		Floating Round to Single
@@ -1847,8 +1835,17 @@ void ppc_opc_frspx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_frspx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_frspx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_frspx);
+		return flowEndBlock;
+	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	ppc_opc_gen_round_single(jitc, b);
+	ppc_opc_gen_check_invalid(jitc, FPSCR_VXSNAN);
+	ppc_opc_gen_set_fpr(jitc, frD, b);
+	return flowContinue;
 }
 /*
  *	frsqrtex	Floating Reciprocal Square Root Estimate
@@ -1875,26 +1872,19 @@ void ppc_opc_frsqrtex(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_frsqrtex(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB, frC;
-	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	PPC_OPC_ASSERT(frA==0 && frC==0);
-	ppc_opc_gen_unary_floatop(FSQRT, frD, frB);
-	if (jitc.nativeFloatTOP == 8) {
-		jitcPopFloatStack(jitcGetClientFloatRegisterMapping(frD), JITC_FLOAT_REG_NONE);
-	}
-	jitc.nativeFloatTOP++;
-	asmFSimple(FLD1);
-	asmFArithP_STi(X86_FDIVR, jitcFloatRegisterToNative(jitcGetClientFloatRegisterMapping(frD)));
-	jitc.nativeFloatTOP--;
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("frsqrte.\n");
-	}
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_frsqrtex);
+		return flowEndBlock;
+	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	NativeVectorReg d = ppc_opc_gen_double_constant(jitc, DOUBLE_ONE);
+	NativeVectorReg b = ppc_opc_gen_get_fpr(jitc, frB);
+	jitc.asmALUSD(X86_SQRTSD, b, b);
+	jitc.asmALUSD(X86_DIVSD, d, b);
+	ppc_opc_gen_check_invalid(jitc, FPSCR_VXSQRT);
+	ppc_opc_gen_set_fpr(jitc, frD, d);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_frsqrtex);
-	return flowEndBlock;
 }
 /*
  *	fselx		Floating Select
@@ -1918,8 +1908,14 @@ void ppc_opc_fselx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fselx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fselx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fselx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB, frC;
+	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
+	ppc_opc_gen_select_floatop(jitc, frD, frA, frC, frB);
+	return flowContinue;
 }
 /*
  *	fsqrtx		Floating Square Root (Double-Precision)
@@ -1942,19 +1938,14 @@ void ppc_opc_fsqrtx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fsqrtx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB, frC;
-	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	PPC_OPC_ASSERT(frA==0 && frC==0);
-	ppc_opc_gen_unary_floatop(FSQRT, frD, frB);
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fsqrt.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fsqrtx);
+		return flowEndBlock;
 	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_unary_floatop(jitc, X86_SQRTSD, frD, frB, false);
 	return flowContinue;
-#endif
-	ppc_opc_gen_interpret(jitc, ppc_opc_fsqrtx);
-	return flowEndBlock;
 }
 /*
  *	fsqrtsx		Floating Square Root Single
@@ -1973,8 +1964,14 @@ void ppc_opc_fsqrtsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fsqrtsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fsqrtsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fsqrtsx);
+		return flowEndBlock;
+	}
+	int frD = (jitc.current_opc >> 21) & 0x1f;
+	int frB = (jitc.current_opc >> 11) & 0x1f;
+	ppc_opc_gen_unary_floatop(jitc, X86_SQRTSD, frD, frB, true);
+	return flowContinue;
 }
 /*
  *	fsubx		Floating Subtract (Double-Precision)
@@ -2003,25 +2000,14 @@ void ppc_opc_fsubx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fsubx(JITC &jitc)
 {
-#if 0
-	int frD, frA, frB, frC;
-	PPC_OPC_TEMPL_A(jitc.current_opc, frD, frA, frB, frC);
-	PPC_OPC_ASSERT(frC==0);
-	ppc_opc_gen_binary_floatop(X86_FSUB, X86_FSUBR, frD, frA, frB);
-	/*
-	 *	FIXME: This solves the a floating point bug.
-	 *	I have no idea why.
-	 */
-	jitcFloatRegisterClobberAll();
-	if (jitc.current_opc & PPC_OPC_Rc) {
-		// update cr1 flags
-		ppc_opc_gen_update_cr1("fsub.\n");
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fsubx);
+		return flowEndBlock;
 	}
+	int frD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	ppc_opc_gen_binary_floatop(jitc, X86_SUBSD, frD, frA, frB, false);
 	return flowContinue;
-#else
-	ppc_opc_gen_interpret(jitc, ppc_opc_fsubx);
-	return flowEndBlock;
-#endif
 }
 /*
  *	fsubsx		Floating Subtract Single
@@ -2050,7 +2036,13 @@ void ppc_opc_fsubsx(PPC_CPU_State &aCPU)
 }
 JITCFlow ppc_opc_gen_fsubsx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(jitc, ppc_opc_fsubsx);
-	return flowEndBlock;
+	if (ppc_opc_gen_fpu_interpret(jitc)) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_fsubsx);
+		return flowEndBlock;
+	}
+	int frD, frA, frB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, frD, frA, frB);
+	ppc_opc_gen_binary_floatop(jitc, X86_SUBSD, frD, frA, frB, true);
+	return flowContinue;
 }
 
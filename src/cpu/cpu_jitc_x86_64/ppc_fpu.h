@@ -640,11 +640,17 @@ double ppc_fpu_get_double(ppc_double &d);
 #include "jitc_asm.h"
 #include "ppc_exc.h"
 
+/*
+ *	The native FPU code only implements round to nearest
+ *	with all exceptions disabled (and NI cleared).
+ */
+#define FPSCR_NATIVE_MASK (FPSCR_VXVE | FPSCR_VXOE | FPSCR_VXUE | FPSCR_VXZE | FPSCR_VXXE | FPSCR_VXNI | 3)
+
 static UNUSED void ppc_opc_gen_check_fpu(JITC &jitc)
 {
 	if (!jitc.checkedFloat) {
 //		jitcFloatRegisterClobberAll(); FIXME64
-//		jitc.flushVectorRegister();
+		jitc.flushVectorRegister();
 		jitc.clobberCarryAndFlags();
 
 		NativeReg r1 = jitc.getClientRegister(PPC_MSR);
@@ -656,6 +662,19 @@ static UNUSED void ppc_opc_gen_check_fpu(JITC &jitc)
 		jitc.asmJMP((NativeAddress)ppc_no_fpu_exception_asm);
 
 		jitc.asmResolveFixup(fixup);
+
+		if (!jitc.currentPage->preciseFloat) {
+			NativeReg r2 = jitc.getClientRegister(PPC_FPSCR);
+			jitc.asmALU32(X86_TEST, r2, FPSCR_NATIVE_MASK);
+			fixup = jitc.asmJxxFixup(X86_Z);
+
+			jitc.flushRegisterDirty();
+			jitc.asmMOVABS(RSI, (uint64)jitc.currentPage);
+			jitc.asmALU32(X86_MOV, RAX, jitc.pc);
+			jitc.asmJMP((NativeAddress)ppc_precise_float_asm);
+
+			jitc.asmResolveFixup(fixup);
+		}
 		jitc.checkedFloat = true;
 	}
 }
@@ -691,6 +710,9 @@ void ppc_opc_fsqrtsx(PPC_CPU_State &aCPU);
 void ppc_opc_fsubx(PPC_CPU_State &aCPU);
 void ppc_opc_fsubsx(PPC_CPU_State &aCPU);
 
+void ppc_fpu_sync_fpscr(PPC_CPU_State &aCPU);
+void ppc_fpu_clear_mxcsr();
+
 JITCFlow ppc_opc_gen_fabsx(JITC &aJITC);
 JITCFlow ppc_opc_gen_faddx(JITC &aJITC);
 JITCFlow ppc_opc_gen_faddsx(JITC &aJITC);
@@ -23,6 +23,8 @@
 #include <cstring>
 #include "tools/snprintf.h"
 #include "debug/tracers.h"
+#include "system/sysvm.h"
+#include "configparser.h"
 #include "io/prom/prom.h"
 #include "io/io.h"
 #include "ppc_cpu.h"
@@ -32,10 +34,12 @@
 #include "ppc_exc.h"
 #include "ppc_tools.h"
 
+#include "jitc.h"
 #include "jitc_asm.h"
 
 byte *gMemory = NULL;
 uint32 gMemorySize;
+static sys_mapping_area gMemoryArea = NULL;
 
 #undef TLB
 
@@ -414,6 +418,24 @@ void ppc_mmu_tlb_invalidate(PPC_CPU_State &aCPU)
 	ppc_mmu_tlb_invalidate_all_asm(&aCPU);
 }
 
+/*
+ *	Called when the physical page pa gets translated code.
+ *	Stores to it have to be checked from now on (see
+ *	jitcCheckCodeWrite()), so they must not bypass the
+ *	slow path via the write TLB or fastmem.
+ */
+void ppc_mmu_protect_code_page(PPC_CPU_State &aCPU, uint32 pa)
+{
+	uint64 phys = (uint64)(gMemory + pa);
+	for (int i=0; i < TLB_SETS*TLB_WAYS; i++) {
+		if (aCPU.tlb_data_write[i].phys == phys) {
+			aCPU.tlb_data_write[i].tag = (uint64)-1;
+			aCPU.tlb_data_write[i].phys = (uint64)-1;
+		}
+	}
+	ppc_fastmem_protect_code_page(aCPU, pa);
+}
+
 /*
 pagetable:
 min. 2^10 (64k) PTEGs
@@ -459,6 +481,7 @@ bool FASTCALL ppc_mmu_set_sdr1(PPC_CPU_State &aCPU, uint32 newval, bool quiesce)
 	if (quiesce) {
 		prom_quiesce();
 	}
+	ppc_fastmem_invalidate(&aCPU);
 	return true;
 }
 
@@ -661,9 +684,20 @@ int FASTCALL ppc_read_effective_byte(PPC_CPU_State &aCPU, uint32 addr, uint8 &re
 	return r;
 }
 
+extern JITC *gJITC;
+
+/*
+ *	Stores from C code have to check for translated code, too
+ */
+static inline void ppc_write_physical_check_code(uint32 addr, uint size)
+{
+	if (gJITC) jitcCheckCodeWrite(*gJITC, addr, size);
+}
+
 int FASTCALL ppc_write_physical_qword(uint32 addr, Vector_t data)
 {
 	if (addr < gMemorySize) {
+		ppc_write_physical_check_code(addr, 16);
 		// big endian
 		*((uint64*)(gMemory+addr)) = ppc_dword_to_BE(VECT_D(data,0));
 		*((uint64*)(gMemory+addr+8)) = ppc_dword_to_BE(VECT_D(data,1));
@@ -679,6 +713,7 @@ int FASTCALL ppc_write_physical_qword(uint32 addr, Vector_t data)
 int FASTCALL ppc_write_physical_dword(uint32 addr, uint64 data)
 {
 	if (addr < gMemorySize) {
+		ppc_write_physical_check_code(addr, 8);
 		// big endian
 		*((uint64*)(gMemory+addr)) = ppc_dword_to_BE(data);
 		return PPC_MMU_OK;
@@ -693,6 +728,7 @@ int FASTCALL ppc_write_physical_dword(uint32 addr, uint64 data)
 int FASTCALL ppc_write_physical_word(uint32 addr, uint32 data)
 {
 	if (addr < gMemorySize) {
+		ppc_write_physical_check_code(addr, 4);
 		// big endian
 		*((uint32*)(gMemory+addr)) = ppc_word_to_BE(data);
 		return PPC_MMU_OK;
@@ -703,6 +739,7 @@ int FASTCALL ppc_write_physical_word(uint32 addr, uint32 data)
 int FASTCALL ppc_write_physical_half(uint32 addr, uint16 data)
 {
 	if (addr < gMemorySize) {
+		ppc_write_physical_check_code(addr, 2);
 		// big endian
 		*((uint16*)(gMemory+addr)) = ppc_half_to_BE(data);
 		return PPC_MMU_OK;
@@ -713,6 +750,7 @@ int FASTCALL ppc_write_physical_half(uint32 addr, uint16 data)
 int FASTCALL ppc_write_physical_byte(uint32 addr, uint8 data)
 {
 	if (addr < gMemorySize) {
+		ppc_write_physical_check_code(addr, 1);
 		// big endian
 		gMemory[addr] = data;
 		return PPC_MMU_OK;
@@ -821,10 +859,17 @@ bool FASTCALL ppc_init_physical_memory(uint size)
 	if (size < 64*1024*1024) {
 		PPC_MMU_ERR("Main memory size must >= 64MB!\n");
 	}
-	gMemory = (byte*)malloc(size+4095);
-//	gMemory = (byte*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED | MAP_32BIT, -1, 0);
-	if ((uint64)gMemory & 0x0fff) {
-		gMemory += 4096 - ((uint64)gMemory & 0x0fff);
+	if (gConfig->getConfigInt(CPU_KEY_FASTMEM) && sys_support_vm()
+	 && sys_alloc_mapping_area(&gMemoryArea, size)) {
+		// the fastmem windows map pages of this area
+		gMemory = (byte*)sys_mapping_area_ptr(gMemoryArea);
+	} else {
+		gMemoryArea = NULL;
+		gMemory = (byte*)malloc(size+4095);
+//		gMemory = (byte*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED | MAP_32BIT, -1, 0);
+		if ((uint64)gMemory & 0x0fff) {
+			gMemory += 4096 - ((uint64)gMemory & 0x0fff);
+		}
 	}
  
 	printf("&gMemory: %p\n", gMemory);
@@ -935,6 +980,207 @@ bool ppc_prom_page_free(uint32 ea)
 	return true;
 }
 
+/***************************************************************************
+ *	Fastmem
+ *
+ *	Each of the three guest data address spaces (untranslated,
+ *	supervisor and user) gets a 4 GiB window of host address space,
+ *	so an inline load or store can simply access
+ *	fastmem_base + effective address.
+ *
+ *	The untranslated window maps all of the main memory at once.
+ *	The translated windows start empty and are filled lazily: an
+ *	access to a page which isn't mapped (or is only mapped read-only)
+ *	faults, ppc_fastmem_fault() redirects it to the miss path of its
+ *	access and ppc_fastmem_map() maps the page there if the MMU allows
+ *	the access. Otherwise the access takes the usual slow path which
+ *	raises the DSI. Accesses to anything but main memory (mostly
+ *	MMIO) are patched to always take the slow path.
+ *
+ *	The translated windows are unmapped whenever the MMU state
+ *	changes (BATs, SDR1, segment registers, tlbia) and per page by
+ *	tlbie.
+ *
+ *	Pages containing translated code are mapped read-only, so
+ *	stores to them fault and take the slow path, which checks them
+ *	(see ppc_mmu_protect_code_page()). To find the mappings of a
+ *	physical page, the (single) effective page mapping it is
+ *	remembered per window.
+ */
+
+#define FASTMEM_WINDOW_SIZE	(0x100000000ULL + 0x10000)	// 64k guard for accesses at 0xffffxxxx
+#define FASTMEM_PAGES		(0x100000000ULL >> 12)
+
+#define FASTMEM_ALIAS_MANY	2	// else effective page | 1 or 0
+
+static byte *gFastmemArea = NULL;
+static uint32 *gFastmemMapped[3];
+static uint32 gFastmemMappedCount[3];
+static uint32 *gFastmemAlias[3];
+
+/*
+ *	Every inline access instruction is preceded by a 7 byte NOP
+ *	("nop dword [rax+disp32]") whose displacement is the distance to
+ *	the miss path of the access.
+ */
+static bool ppc_fastmem_fault(void *addr, void **pc)
+{
+	if ((byte*)addr < gFastmemArea || (byte*)addr >= gFastmemArea + 3*FASTMEM_WINDOW_SIZE) {
+		return false;
+	}
+	byte *p = (byte*)*pc;
+	if (p[-7] != 0x0f || p[-6] != 0x1f || p[-5] != 0x80) {
+		return false;
+	}
+	*pc = p + *(sint32*)(p-4);
+	return true;
+}
+
+bool ppc_fastmem_init(PPC_CPU_State &aCPU)
+{
+	if (!gMemoryArea) return false;
+	gFastmemArea = (byte*)sys_reserve_area(NULL, 3*FASTMEM_WINDOW_SIZE);
+	if (!gFastmemArea) return false;
+	if (!sys_map_area_fixed(gMemoryArea, 0, gFastmemArea, gMemorySize, SYSVM_PROT_READ | SYSVM_PROT_WRITE)) {
+		return false;
+	}
+	for (int i=0; i<3; i++) {
+		aCPU.fastmem_window[i] = (uint64)(gFastmemArea + i*FASTMEM_WINDOW_SIZE);
+		gFastmemMapped[i] = (uint32*)malloc(FASTMEM_PAGES / 8);
+		memset(gFastmemMapped[i], 0, FASTMEM_PAGES / 8);
+		gFastmemMappedCount[i] = 0;
+		gFastmemAlias[i] = (uint32*)malloc(gMemorySize / 4096 * 4);
+		memset(gFastmemAlias[i], 0, gMemorySize / 4096 * 4);
+	}
+	// fastmem_base will be set by ppc_mmu_tlb_update_asid_asm()
+	aCPU.fastmem_base = aCPU.fastmem_window[0];
+	if (!sys_set_access_fault_handler(ppc_fastmem_fault)) {
+		aCPU.fastmem_window[0] = aCPU.fastmem_window[1] = aCPU.fastmem_window[2] = 0;
+		aCPU.fastmem_base = 0;
+		return false;
+	}
+	return true;
+}
+
+/*
+ *	Called from the miss path of an inline access (site) to the
+ *	effective addresses ea..last. Maps the pages into the current
+ *	window and returns 1, or returns 0 if the access has to take
+ *	the slow path. If it always will, site is patched to jump to
+ *	slow directly.
+ */
+extern "C" int ppc_fastmem_map(PPC_CPU_State *aCPU, uint32 ea, uint32 last, NativeAddress site, NativeAddress slow, int write)
+{
+	int w = ((byte*)aCPU->fastmem_base - gFastmemArea) / FASTMEM_WINDOW_SIZE;
+	byte *base = (byte*)aCPU->fastmem_base;
+	if (last < ea) return 0;
+	for (uint32 page = ea & ~0xfff; ; page = last & ~0xfff) {
+		uint32 pa = page;
+		if (w) {
+			int flags = (write ? PPC_MMU_WRITE : PPC_MMU_READ) | PPC_MMU_NO_EXC;
+			if (ppc_effective_to_physical(*aCPU, page, flags, pa) != PPC_MMU_OK) {
+				return 0;
+			}
+		}
+		if (pa >= gMemorySize) {
+			site[0] = 0xe9;
+			*(sint32*)(site+1) = slow - (site+5);
+			return 0;
+		}
+		if (write) {
+			uint32 start = (page == (ea & ~0xfff)) ? (ea & 0xfff) : 0;
+			uint32 end = (page == (last & ~0xfff)) ? (last & 0xfff) : 0xfff;
+			if (jitcCheckCodeWrite(*aCPU->jitc, pa | start, end - start + 1)) {
+				// the store misses the translated code, but others may not
+				return 0;
+			}
+			if (aCPU->code_destroyed) {
+				// maybe our own code, the slow path leaves the block
+				return 0;
+			}
+		}
+		if (!sys_map_area_fixed(gMemoryArea, pa, base + page, 4096,
+		write ? (SYSVM_PROT_READ | SYSVM_PROT_WRITE) : SYSVM_PROT_READ)) {
+			return 0;
+		}
+		if (w) {
+			uint32 *bit = &gFastmemMapped[w][page >> 17];
+			uint32 mask = 1 << ((page >> 12) & 31);
+			if (!(*bit & mask)) {
+				*bit |= mask;
+				gFastmemMappedCount[w]++;
+			}
+			uint32 &alias = gFastmemAlias[w][pa >> 12];
+			if (!alias) {
+				alias = page | 1;
+			} else if ((alias & ~0xfff) != page) {
+				alias = FASTMEM_ALIAS_MANY;
+			}
+		}
+		if ((page ^ last) < 4096) break;
+	}
+	return 1;
+}
+
+static void ppc_fastmem_invalidate_window(int w)
+{
+	if (!gFastmemMappedCount[w]) return;
+	sys_reserve_area(gFastmemArea + w*FASTMEM_WINDOW_SIZE, FASTMEM_WINDOW_SIZE);
+	memset(gFastmemMapped[w], 0, FASTMEM_PAGES / 8);
+	memset(gFastmemAlias[w], 0, gMemorySize / 4096 * 4);
+	gFastmemMappedCount[w] = 0;
+}
+
+/*
+ *	Unmaps all pages of the translated windows
+ */
+extern "C" void ppc_fastmem_invalidate(PPC_CPU_State *aCPU)
+{
+	ppc_fastmem_invalidate_window(1);
+	ppc_fastmem_invalidate_window(2);
+}
+
+/*
+ *	Makes all mappings of the physical page pa read-only
+ */
+void ppc_fastmem_protect_code_page(PPC_CPU_State &aCPU, uint32 pa)
+{
+	if (!gFastmemArea) return;
+	sys_mprotect(gFastmemArea + pa, 4096, SYSVM_PROT_READ);
+	for (int w=1; w<3; w++) {
+		uint32 alias = gFastmemAlias[w][pa >> 12];
+		if (alias == FASTMEM_ALIAS_MANY) {
+			ppc_fastmem_invalidate_window(w);
+		} else if (alias) {
+			// the page might have been remapped since, that's harmless
+			uint32 page = alias & ~0xfff;
+			if (gFastmemMapped[w][page >> 17] & (1 << ((page >> 12) & 31))) {
+				sys_mprotect(gFastmemArea + w*FASTMEM_WINDOW_SIZE + page, 4096, SYSVM_PROT_READ);
+			}
+		}
+	}
+}
+
+/*
+ *	Unmaps the page of ea (in all segments) of the translated windows
+ */
+extern "C" void ppc_fastmem_invalidate_page(PPC_CPU_State *aCPU, uint32 ea)
+{
+	for (int w=1; w<3; w++) {
+		if (!gFastmemMappedCount[w]) continue;
+		for (int sr=0; sr<16; sr++) {
+			uint32 page = (sr << 28) | (ea & 0x0ffff000);
+			uint32 *bit = &gFastmemMapped[w][page >> 17];
+			uint32 mask = 1 << ((page >> 12) & 31);
+			if (*bit & mask) {
+				sys_reserve_area(gFastmemArea + w*FASTMEM_WINDOW_SIZE + page, 4096);
+				*bit &= ~mask;
+				gFastmemMappedCount[w]--;
+			}
+		}
+	}
+}
+
 /***************************************************************************
  *	MMU Opcodes
  */
@@ -1072,32 +1318,6 @@ static void getRAX_0_Isum(JITC &jitc, PPC_Register cr1, uint32 imm)
 	}
 }
 
-static void getRAXIsumAndEDX(JITC &jitc, PPC_Register cr1, uint32 imm, PPC_Register cr2)
-{
-	if (jitc.getClientRegisterMapping(cr2) == RDX) jitc.touchRegister(RDX);
-	jitc.getClientRegister(cr1, NATIVE_REG | RAX);
-	if (cr1 == cr2) {
-		jitc.asmALU32(X86_MOV, RDX, RAX);
-	} else {
-		jitc.getClientRegister(cr2, NATIVE_REG | RDX);
-	}
-	jitc.clobberRegister(NATIVE_REG | RAX);
-	if (imm) {
-		jitc.asmALU32(X86_ADD, RAX, imm);
-	}
-}
-
-static void getRAX_0_IsumAndEDX(JITC &jitc, PPC_Register cr1, uint32 imm, PPC_Register cr2)
-{
-	if (cr1 == PPC_GPR(0)) {
-		jitc.getClientRegister(cr2, NATIVE_REG | RDX);
-		jitc.clobberRegister(NATIVE_REG | RAX);
-		jitc.asmALU32(X86_MOV, RAX, imm);
-	} else {
-		getRAXIsumAndEDX(jitc, cr1, imm, cr2);
-	}
-}
-
 
 static void ppc_opc_gen_helper_l(JITC &jitc, PPC_Register cr1, uint32 imm)
 {
@@ -1135,49 +1355,460 @@ static void ppc_opc_gen_helper_lx(JITC &jitc, PPC_Register cr1, PPC_Register cr2
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 }
 
-static void ppc_opc_gen_helper_st(JITC &jitc, PPC_Register cr1, uint32 imm, PPC_Register cr2)
+static void ppc_opc_gen_helper_stx(JITC &jitc, PPC_Register cr1, PPC_Register cr2, PPC_Register cr3)
 {
 	jitc.clobberCarryAndFlags();
 	jitc.flushRegister();
-	getRAX_0_IsumAndEDX(jitc, cr1, imm, cr2);
+	getRAX_0_RsumAndEDX(jitc, cr1, cr2, cr3);
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 }
 
-static void ppc_opc_gen_helper_stu(JITC &jitc, PPC_Register cr1, uint32 imm, PPC_Register cr2)
+static void ppc_opc_gen_helper_tlb(JITC &jitc, NativeReg src, NativeReg d1, NativeReg d2)
+{
+	jitc.asmALU32(X86_MOV, d1, src);
+	jitc.asmALU32(X86_MOV, d2, src);
+	jitc.asmShift32(X86_SHR, d1, 12);
+	jitc.asmALU32(X86_AND, d2, 0xfffff000);
+	jitc.asmALU32(X86_AND, d1, TLB_SETS-1);
+}
+
+/*
+ *	Inline TLB lookup
+ *
+ *	The following helpers compile a load or store into an inline
+ *	lookup of the data TLB. Only on a TLB miss (or if the access
+ *	crosses a page boundary) the asm helpers are called.
+ *	MMIO accesses are never entered into the TLB, so they always
+ *	take the slow path.
+ *
+ *	In contrast to ppc_opc_gen_helper_*() the mapped client registers
+ *	stay mapped, only RAX, RCX and RDX are used as scratch registers.
+ */
+
+/*
+ *	puts (cr1|0)+imm into RAX and allocates RAX
+ */
+static void ppc_opc_gen_ea_imm(JITC &jitc, PPC_Register cr1, uint32 imm, bool zero)
 {
 	jitc.clobberCarryAndFlags();
-	jitc.flushRegister();
-	getRAXIsumAndEDX(jitc, cr1, imm, cr2);
-	jitc.clobberAll();
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
+	if (zero && cr1 == PPC_GPR(0)) {
+		jitc.allocRegister(NATIVE_REG | RAX);
+		jitc.asmALU32(X86_MOV, RAX, imm);
+		return;
+	}
+	NativeReg r1 = jitc.getClientRegisterMapping(cr1);
+	/*
+	 *	If cr1 is mapped to RAX, its value
+	 *	survives the allocation.
+	 */
+	jitc.allocRegister(NATIVE_REG | RAX);
+	if (r1 == RAX) {
+		if (imm) jitc.asmALU32(X86_ADD, RAX, imm);
+	} else if (r1 != REG_NO) {
+		jitc.asmALU32(X86_LEA, RAX, r1, imm);
+	} else {
+		jitc.asmALU32(X86_MOV, RAX, curCPUreg(cr1));
+		if (imm) jitc.asmALU32(X86_ADD, RAX, imm);
+	}
 }
 
-static void ppc_opc_gen_helper_stux(JITC &jitc, PPC_Register cr1, PPC_Register cr2, PPC_Register cr3)
+/*
+ *	puts (cr1|0)+cr2 into RAX and allocates RAX
+ */
+static void ppc_opc_gen_ea_reg(JITC &jitc, PPC_Register cr1, PPC_Register cr2, bool zero)
 {
 	jitc.clobberCarryAndFlags();
-	jitc.flushRegister();
-	getRAXRsumAndEDX(jitc,cr1, cr2, cr3);
-	jitc.clobberAll();
+	if (zero && cr1 == PPC_GPR(0)) {
+		ppc_opc_gen_ea_imm(jitc, cr2, 0, false);
+		return;
+	}
+	NativeReg r1 = jitc.getClientRegisterMapping(cr1);
+	NativeReg r2 = jitc.getClientRegisterMapping(cr2);
+	jitc.allocRegister(NATIVE_REG | RAX);
+	if (r1 != RAX) {
+		if (r2 == RAX) {
+			r2 = r1;
+			cr2 = cr1;
+		} else if (r1 != REG_NO) {
+			jitc.asmALU32(X86_MOV, RAX, r1);
+		} else {
+			jitc.asmALU32(X86_MOV, RAX, curCPUreg(cr1));
+		}
+	}
+	if (r2 == RAX) {
+		jitc.asmALU32(X86_ADD, RAX, RAX);
+	} else if (r2 != REG_NO) {
+		jitc.asmALU32(X86_ADD, RAX, r2);
+	} else {
+		jitc.asmALU32(X86_ADD, RAX, curCPUreg(cr2));
+	}
+}
+
+struct TLBLookup {
+	NativeAddress miss;
+	NativeAddress retry;
+	bool write;
+	int size;
+};
+
+/*
+ *	IN:	EAX: effective address
+ *	OUT:	RCX: host address (if hit)
+ *
+ *	Only the first (most recently used) entry of the set is checked.
+ *	The tag is computed from the last byte of the access but the set
+ *	from the first, so an access crossing a page boundary can never hit.
+ *
+ *	With fastmem there is no lookup at all, RCX simply points into
+ *	the current window. The miss path is taken on a host fault
+ *	instead (see ppc_opc_gen_tlb_access()).
+ */
+static void ppc_opc_gen_tlb_lookup(JITC &jitc, TLBLookup &l, bool write, int size)
+{
+	l.write = write;
+	l.size = size;
+	if (jitc.fastmem) {
+		// ppc_fastmem_map() may patch a jmp over the first 5 bytes
+		jitc.emitAssure(8);
+		l.retry = jitc.asmHERE();
+		jitc.asmALU64(X86_MOV, RCX, curCPU(fastmem_base));
+		jitc.asmALU64(X86_ADD, RCX, RAX);
+		return;
+	}
+	if (size > 1) {
+		jitc.asmALU32(X86_LEA, RCX, RAX, size-1);
+	} else {
+		jitc.asmALU32(X86_MOV, RCX, RAX);
+	}
+	jitc.asmALU32(X86_MOV, RDX, RCX);
+	jitc.asmShift32(X86_SHR, RDX, 28);
+	jitc.asmALU32(X86_AND, RCX, 0xfffff000);
+	jitc.asmALU64(X86_OR, RCX, curCPUsib(tlb_data_asid, 8, RDX));
+	jitc.asmALU32(X86_MOV, RDX, RAX);
+	jitc.asmShift32(X86_SHR, RDX, 12-TLB_SET_SHIFT);
+	jitc.asmALU32(X86_AND, RDX, TLB_SET_MASK);
+	if (write) {
+		jitc.asmALU64(X86_CMP, RCX, curCPUsib(tlb_data_write[0].tag, 1, RDX));
+	} else {
+		jitc.asmALU64(X86_CMP, RCX, curCPUsib(tlb_data_read[0].tag, 1, RDX));
+	}
+	l.miss = jitc.asmJxxFixup(X86_NE);
+	if (write) {
+		jitc.asmALU64(X86_MOV, RCX, curCPUsib(tlb_data_write[0].phys, 1, RDX));
+	} else {
+		jitc.asmALU64(X86_MOV, RCX, curCPUsib(tlb_data_read[0].phys, 1, RDX));
+	}
+	jitc.asmALU32(X86_MOV, RDX, RAX);
+	jitc.asmALU32(X86_AND, RDX, 0xfff);
+	jitc.asmALU64(X86_ADD, RCX, RDX);
+}
+
+/*
+ *	Must directly precede the instruction accessing [RCX].
+ *
+ *	With fastmem this emits the marker ppc_fastmem_fault() looks for,
+ *	a 7 byte NOP holding the distance to the miss path.
+ */
+static void ppc_opc_gen_tlb_access(JITC &jitc, TLBLookup &l)
+{
+	if (!jitc.fastmem) return;
+	byte instr[7];
+	jitc.emitAssure(sizeof instr + 8);
+	instr[0] = 0x0f;		// nop dword [rax+miss]
+	instr[1] = 0x1f;
+	instr[2] = 0x80;
+	*((uint32 *)&instr[3]) = 0;
+	jitc.emit(instr, sizeof instr);
+	l.miss = jitc.asmHERE() - 4;
+}
+
+/*
+ *	Starts the miss path. With fastmem it first tries to map
+ *	the page(s) and to retry the access.
+ */
+static void ppc_opc_gen_tlb_resolve_miss(JITC &jitc, TLBLookup &l)
+{
+	jitc.asmResolveFixup(l.miss, jitc.asmHERE());
+	if (!jitc.fastmem) return;
+	// the helper finds the slow path behind the jnc
+	jitc.emitAssure(5+7+5+6);
+	jitc.asmALU32(X86_MOV, RCX, l.size-1);
+	byte instr[7];
+	instr[0] = 0x48;		// lea rdx, [rip+retry]
+	instr[1] = 0x8d;
+	instr[2] = 0x15;
+	*((uint32 *)&instr[3]) = uint32(l.retry - (jitc.asmHERE() + sizeof instr));
+	jitc.emit(instr, sizeof instr);
+	jitc.asmCALL(l.write ? (NativeAddress)ppc_fastmem_map_write_asm : (NativeAddress)ppc_fastmem_map_read_asm);
+	jitc.asmResolveFixup(jitc.asmJxxFixup(X86_NC), l.retry);
+}
+
+/*
+ *	Calls the asm helper for the slow path.
+ *	If update is set, EAX (the effective address) is preserved.
+ */
+static void ppc_opc_gen_tlb_miss(JITC &jitc, NativeAddress helper, PPC_Register cs, bool update)
+{
+	jitc.flushRegisterDirty();
+	jitc.flushVectorRegisterDirty();
+	if (update) {
+		jitc.asmALU32(X86_MOV, curCPU(temp), RAX);
+	}
+	if (cs != PPC_REG_NO) {
+		NativeReg s = jitc.getClientRegisterMapping(cs);
+		if (s != REG_NO) {
+			jitc.asmALU32(X86_MOV, RDX, s);
+		} else {
+			jitc.asmALU32(X86_MOV, RDX, curCPUreg(cs));
+		}
+	}
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
+	jitc.asmCALL(helper);
+	jitc.reloadRegister();
+	jitc.reloadVectorRegister();
+	if (update) {
+		jitc.asmALU32(X86_MOV, RAX, curCPU(temp));
+	}
 }
 
-static void ppc_opc_gen_helper_stx(JITC &jitc, PPC_Register cr1, PPC_Register cr2, PPC_Register cr3)
+/*
+ *	Emitted after a store helper returns. If the store has thrown
+ *	away a translation (jitcCheckCodeWrite()) it may have been the
+ *	one we are running in: its fragments are free now, so we leave
+ *	to the next instruction without linking, like icbi does.
+ *	All client registers must be in memory here, if cu != PPC_REG_NO
+ *	it gets EAX (the effective address) first.
+ */
+void ppc_opc_gen_check_code_destroyed(JITC &jitc, PPC_Register cu)
+{
+	jitc.asmALU8(X86_CMP, curCPU(code_destroyed), 0);
+	NativeAddress fixup = jitc.asmJxxFixup(X86_Z);
+	jitc.asmALU8(X86_MOV, curCPU(code_destroyed), 0);
+	if (cu != PPC_REG_NO) {
+		jitc.asmALU32(X86_MOV, curCPUreg(cu), RAX);
+	}
+	jitc.asmALU32(X86_MOV, RAX, jitc.pc+4);
+	jitc.asmJMP((NativeAddress)ppc_new_pc_rel_asm);
+	jitc.asmResolveFixup(fixup, jitc.asmHERE());
+}
+
+/*
+ *	Loads size bytes from the effective address in EAX into cd.
+ *	If cd == PPC_REG_NO the value is left in EDX.
+ *	If cu != PPC_REG_NO the effective address is written to cu afterwards.
+ */
+static void ppc_opc_gen_load(JITC &jitc, PPC_Register cd, int size, bool algebraic, PPC_Register cu = PPC_REG_NO)
+{
+	NativeAddress helper;
+	switch (size) {
+	case 1: helper = (NativeAddress)ppc_read_effective_byte_asm; break;
+	case 2: helper = algebraic ? (NativeAddress)ppc_read_effective_half_s_asm : (NativeAddress)ppc_read_effective_half_z_asm; break;
+	default: helper = (NativeAddress)ppc_read_effective_word_asm; break;
+	}
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+
+	TLBLookup l;
+	ppc_opc_gen_tlb_lookup(jitc, l, false, size);
+	ppc_opc_gen_tlb_access(jitc, l);
+	switch (size) {
+	case 1:
+		jitc.asmMOVxx32_8(X86_MOVZX, RDX, RCX, 0u);
+		break;
+	case 2:
+		jitc.asmMOVxx32_16(X86_MOVZX, RDX, RCX, 0u);
+		jitc.asmShift16(X86_ROL, RDX, 8);
+		if (algebraic) jitc.asmMOVxx32_16(X86_MOVSX, RDX, RDX);
+		break;
+	default:
+		if (jitc.hostCPUCaps.movbe) {
+			jitc.asmMOVBE32(RDX, RCX, 0u);
+		} else {
+			jitc.asmALU32(X86_MOV, RDX, RCX, 0u);
+			jitc.asmBSWAP32(RDX);
+		}
+		break;
+	}
+	NativeAddress done = jitc.asmJMPFixup();
+
+	ppc_opc_gen_tlb_resolve_miss(jitc, l);
+	ppc_opc_gen_tlb_miss(jitc, helper, PPC_REG_NO, cu != PPC_REG_NO);
+
+	jitc.asmResolveFixup(done, jitc.asmHERE());
+	if (cu != PPC_REG_NO) {
+		jitc.mapClientRegisterDirty(cu, NATIVE_REG | RAX);
+	}
+	if (cd != PPC_REG_NO) {
+		jitc.mapClientRegisterDirty(cd, NATIVE_REG | RDX);
+	}
+}
+
+/*
+ *	Stores size bytes of cs to the effective address in EAX.
+ *	If cu != PPC_REG_NO the effective address is written to cu afterwards.
+ */
+static void ppc_opc_gen_store(JITC &jitc, PPC_Register cs, int size, PPC_Register cu = PPC_REG_NO)
+{
+	NativeAddress helper;
+	switch (size) {
+	case 1: helper = (NativeAddress)ppc_write_effective_byte_asm; break;
+	case 2: helper = (NativeAddress)ppc_write_effective_half_asm; break;
+	default: helper = (NativeAddress)ppc_write_effective_word_asm; break;
+	}
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+
+	TLBLookup l;
+	ppc_opc_gen_tlb_lookup(jitc, l, true, size);
+	NativeReg s = jitc.getClientRegisterMapping(cs);
+	if (s != REG_NO) {
+		jitc.asmALU32(X86_MOV, RDX, s);
+	} else {
+		jitc.asmALU32(X86_MOV, RDX, curCPUreg(cs));
+	}
+	switch (size) {
+	case 1:
+		ppc_opc_gen_tlb_access(jitc, l);
+		jitc.asmALU8(X86_MOV, RCX, 0u, RDX);
+		break;
+	case 2:
+		jitc.asmShift16(X86_ROL, RDX, 8);
+		ppc_opc_gen_tlb_access(jitc, l);
+		jitc.asmALU16(X86_MOV, RCX, 0u, RDX);
+		break;
+	default:
+		if (jitc.hostCPUCaps.movbe) {
+			ppc_opc_gen_tlb_access(jitc, l);
+			jitc.asmMOVBE32(RCX, 0u, RDX);
+		} else {
+			jitc.asmBSWAP32(RDX);
+			ppc_opc_gen_tlb_access(jitc, l);
+			jitc.asmALU32(X86_MOV, RCX, 0u, RDX);
+		}
+		break;
+	}
+	NativeAddress done = jitc.asmJMPFixup();
+
+	ppc_opc_gen_tlb_resolve_miss(jitc, l);
+	ppc_opc_gen_tlb_miss(jitc, helper, cs, cu != PPC_REG_NO);
+	ppc_opc_gen_check_code_destroyed(jitc, cu);
+
+	jitc.asmResolveFixup(done, jitc.asmHERE());
+	if (cu != PPC_REG_NO) {
+		jitc.mapClientRegisterDirty(cu, NATIVE_REG | RAX);
+	}
+}
+
+/*
+ *	Update forms with rA == 0 (or rA == rD for loads) are invalid,
+ *	they raise an illegal instruction program exception.
+ */
+static JITCFlow ppc_opc_gen_invalid_update(JITC &jitc)
 {
-	jitc.clobberCarryAndFlags();
-	jitc.flushRegister();
-	getRAX_0_RsumAndEDX(jitc, cr1, cr2, cr3);
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
+	jitc.asmALU32(X86_MOV, RCX, PPC_EXC_PROGRAM_ILL);
+	jitc.asmJMP((NativeAddress)ppc_program_exception_asm);
+	return flowEndBlockUnreachable;
 }
 
-static void ppc_opc_gen_helper_tlb(JITC &jitc, NativeReg src, NativeReg d1, NativeReg d2)
+/*
+ *	Emits a marker for a multiple access (see ppc_opc_gen_multiple())
+ *	and remembers it, all of them lead to the same miss path.
+ */
+static void ppc_opc_gen_multiple_access(JITC &jitc, TLBLookup &l, NativeAddress *misses, int &count)
 {
-	jitc.asmALU32(X86_MOV, d1, src);
-	jitc.asmALU32(X86_MOV, d2, src);
-	jitc.asmShift32(X86_SHR, d1, 12);
-	jitc.asmALU32(X86_AND, d2, 0xfffff000);
-	jitc.asmALU32(X86_AND, d1, TLB_ENTRIES-1);
+	ppc_opc_gen_tlb_access(jitc, l);
+	if (jitc.fastmem) misses[count++] = l.miss;
+}
+
+/*
+ *	Copies nb bytes between the effective address in EAX and the
+ *	GPRs starting with r (wrapping around to r0), like lswi and
+ *	stswi do. lmw and stmw are the case of whole words.
+ *
+ *	The whole range is looked up in the data TLB once and copied
+ *	with byte-swapping word moves. The lookup can't hit if the
+ *	range crosses a page (or is MMIO), then ppc_opc_lswi_asm or
+ *	ppc_opc_stswi_asm do it byte by byte.
+ */
+static void ppc_opc_gen_multiple(JITC &jitc, int r, int nb, bool write)
+{
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+	if (!write) {
+		// the loaded values go to aCPU.gpr directly
+		for (int i=0; i < (nb+3)/4; i++) {
+			NativeReg d = jitc.getClientRegisterMapping(PPC_GPR((r+i) & 31));
+			if (d != REG_NO) jitc.clobberRegister(NATIVE_REG | d);
+		}
+	}
+
+	TLBLookup l;
+	NativeAddress misses[32+3];
+	int count = 0;
+	ppc_opc_gen_tlb_lookup(jitc, l, write, nb);
+	for (int ofs=0; ofs < nb; ofs += 4) {
+		PPC_Register creg = PPC_GPR((r + ofs/4) & 31);
+		int n = MIN(4, nb - ofs);
+		if (write) {
+			NativeReg s = jitc.getClientRegisterMapping(creg);
+			if (s != REG_NO) {
+				jitc.asmALU32(X86_MOV, RDX, s);
+			} else {
+				jitc.asmALU32(X86_MOV, RDX, curCPUreg(creg));
+			}
+			if (n < 4) {
+				for (int i=0; i < n; i++) {
+					jitc.asmShift32(X86_ROL, RDX, 8);
+					ppc_opc_gen_multiple_access(jitc, l, misses, count);
+					jitc.asmALU8(X86_MOV, RCX, ofs+i, RDX);
+				}
+			} else if (jitc.hostCPUCaps.movbe) {
+				ppc_opc_gen_multiple_access(jitc, l, misses, count);
+				jitc.asmMOVBE32(RCX, ofs, RDX);
+			} else {
+				jitc.asmBSWAP32(RDX);
+				ppc_opc_gen_multiple_access(jitc, l, misses, count);
+				jitc.asmALU32(X86_MOV, RCX, ofs, RDX);
+			}
+		} else {
+			if (n < 4) {
+				ppc_opc_gen_multiple_access(jitc, l, misses, count);
+				jitc.asmMOVxx32_8(X86_MOVZX, RDX, RCX, ofs);
+				for (int i=1; i < n; i++) {
+					jitc.asmShift32(X86_SHL, RDX, 8);
+					ppc_opc_gen_multiple_access(jitc, l, misses, count);
+					jitc.asmALU8(X86_MOV, RDX, RCX, ofs+i);
+				}
+				jitc.asmShift32(X86_SHL, RDX, 8*(4-n));
+			} else if (jitc.hostCPUCaps.movbe) {
+				ppc_opc_gen_multiple_access(jitc, l, misses, count);
+				jitc.asmMOVBE32(RDX, RCX, ofs);
+			} else {
+				ppc_opc_gen_multiple_access(jitc, l, misses, count);
+				jitc.asmALU32(X86_MOV, RDX, RCX, ofs);
+				jitc.asmBSWAP32(RDX);
+			}
+			jitc.asmALU32(X86_MOV, curCPUreg(creg), RDX);
+		}
+	}
+	NativeAddress done = jitc.asmJMPFixup();
+
+	for (int i=0; i < count; i++) jitc.asmResolveFixup(misses[i], jitc.asmHERE());
+	ppc_opc_gen_tlb_resolve_miss(jitc, l);
+	jitc.flushRegisterDirty();
+	jitc.flushVectorRegisterDirty();
+	jitc.asmALU32(X86_MOV, RCX, nb);
+	jitc.asmALU32(X86_MOV, RBX, r);
+	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
+	jitc.asmCALL(write ? (NativeAddress)ppc_opc_stswi_asm : (NativeAddress)ppc_opc_lswi_asm);
+	if (write) ppc_opc_gen_check_code_destroyed(jitc);
+	jitc.reloadRegister();
+	jitc.reloadVectorRegister();
+
+	jitc.asmResolveFixup(done, jitc.asmHERE());
 }
 
 static uint64 FASTCALL ppc_opc_single_to_double(uint32 fpscr, uint32 r)
@@ -1245,6 +1876,7 @@ JITCFlow ppc_opc_gen_dcbz(JITC &jitc)
 	jitc.asmALU32(X86_ADD, RAX, 24);
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 
@@ -1268,24 +1900,8 @@ JITCFlow ppc_opc_gen_lbz(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_l(jitc, PPC_GPR(rA), imm);
-#if 0
-	ppc_opc_gen_helper_tlb(jitc, RAX, RDX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_read_eff, 4, RDX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_ADD, RAX, curCPUsib(tlb_data_read_phys, 8, RDX));
-	jitc.asmMOVxx32_8(X86_MOVZX, RDX, RAX, 0u);
-	
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-#endif
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 1, false);
 	return flowContinue;
 }
 /*
@@ -1310,33 +1926,9 @@ JITCFlow ppc_opc_gen_lbzu(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_lu(jitc, PPC_GPR(rA), imm);
-#if 0
-	ppc_opc_gen_helper_tlb(jitc, RAX, RDX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_read_eff, 4, RDX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA), NATIVE_REG | RAX);
-	if (imm) {
-		jitc.asmALU32(X86_ADD, a, imm);
-	}
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_MOV, RDX, curCPUsib(tlb_data_read_phys, 8, RDX));
-	jitc.asmALU32(X86_ADD, RDX, RAX);
-	jitc.asmMOVxx32_8(X86_MOVZX, RDX, RDX, 0u);
-	
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	if (imm) {
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, a, imm);
-	}
-#endif
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 1, false, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -1359,19 +1951,9 @@ JITCFlow ppc_opc_gen_lbzux(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lux(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-	if (rD == rB) {
-		// don't ask...
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA), NATIVE_REG | RAX);
-		jitc.asmALU32(X86_ADD, a, curCPUreg(PPC_GPR(rB)));
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	} else {
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-		jitc.asmALU32(X86_ADD, a, b);
-	}
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 1, false, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -1392,9 +1974,8 @@ JITCFlow ppc_opc_gen_lbzx(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lx(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 1, false);
 	return flowContinue;
 }
 /*
@@ -1726,9 +2307,8 @@ JITCFlow ppc_opc_gen_lha(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_l(jitc, PPC_GPR(rA), imm);
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_s_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, true);
 	return flowContinue;
 }
 /*
@@ -1753,13 +2333,9 @@ JITCFlow ppc_opc_gen_lhau(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_lu(jitc, PPC_GPR(rA), imm);
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_s_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	if (imm) {
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, a, imm);
-	}
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, true, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -1782,18 +2358,9 @@ JITCFlow ppc_opc_gen_lhaux(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lux(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_s_asm);
-	if (rD == rB) {
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA), NATIVE_REG | RAX);
-		jitc.asmALU32(X86_ADD, a, curCPUreg(PPC_GPR(rB)));
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	} else {
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-		jitc.asmALU32(X86_ADD, a, b);
-	}
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, true, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -1815,9 +2382,8 @@ JITCFlow ppc_opc_gen_lhax(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lx(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_s_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, true);
 	return flowContinue;
 }
 /*
@@ -1864,9 +2430,8 @@ JITCFlow ppc_opc_gen_lhz(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_l(jitc, PPC_GPR(rA), imm);
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_z_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, false);
 	return flowContinue;
 }
 /*
@@ -1891,13 +2456,9 @@ JITCFlow ppc_opc_gen_lhzu(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_lu(jitc, PPC_GPR(rA), imm);
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_z_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	if (imm) {
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, a, imm);
-	}
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, false, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -1920,18 +2481,9 @@ JITCFlow ppc_opc_gen_lhzux(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lux(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_z_asm);
-	if (rD == rB) {
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA), NATIVE_REG | RAX);
-		jitc.asmALU32(X86_ADD, a, curCPUreg(PPC_GPR(rB)));
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	} else {
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-		jitc.asmALU32(X86_ADD, a, b);
-	}
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, false, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -1952,9 +2504,8 @@ JITCFlow ppc_opc_gen_lhzx(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lx(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_z_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 2, false);
 	return flowContinue;
 }
 /*
@@ -1980,14 +2531,8 @@ JITCFlow ppc_opc_gen_lmw(JITC &jitc)
 	int rD, rA;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	
-	while (rD <= 31) {
-		ppc_opc_gen_helper_l(jitc, PPC_GPR(rA), imm);
-		jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-		rD += 1;
-		imm += 4;
-	}
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_multiple(jitc, rD, 4*(32-rD), false);
 	return flowContinue;
 }
 /*
@@ -2028,19 +2573,9 @@ JITCFlow ppc_opc_gen_lswi(JITC &jitc)
 	int rA, rD, NB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, NB);
 	if (NB==0) NB=32;
-	jitc.clobberCarryAndFlags();
-	jitc.flushRegister();
-	if (rA) {
-		jitc.getClientRegister(PPC_GPR(rA), NATIVE_REG | RAX);
-	} else {
-		jitc.asmALU32(X86_MOV, RAX, 0);
-	}
-	jitc.asmALU32(X86_MOV, RCX, NB);
-	jitc.asmALU32(X86_MOV, RBX, rD);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-	jitc.clobberAll();
-	jitc.asmCALL((NativeAddress)ppc_opc_lswi_asm);
-	return flowEndBlock;
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), 0, true);
+	ppc_opc_gen_multiple(jitc, rD, NB, false);
+	return flowContinue;
 }
 /*
  *	lswx		Load String Word Indexed
@@ -2118,9 +2653,9 @@ JITCFlow ppc_opc_gen_lwarx(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lx(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 4, false);
+	// rD is mapped to RDX
 	jitc.asmALU32(X86_MOV, curCPU(reserve), RDX);
 	jitc.asmALU8(X86_MOV, curCPU(have_reservation), 1);
 	return flowContinue;
@@ -2169,28 +2704,8 @@ JITCFlow ppc_opc_gen_lwz(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_l(jitc, PPC_GPR(rA), imm);
-#if 0
-	jitc.asmALU32(X86_TEST, RAX, 3);
-	NativeAddress fixup3 = jitc.asmJxxFixup(X86_NZ);
-	ppc_opc_gen_helper_tlb(jitc, RAX, RDX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_read_eff, 4, RDX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmResolveFixup(fixup3, jitc.asmHERE());
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_ADD, RAX, curCPUsib(tlb_data_read_phys, 8, RDX));
-	jitc.asmALU32(X86_MOV, RDX, RAX, 0u);
-	jitc.asmBSWAP32(RDX);
-
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-#endif
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 4, false);
 	return flowContinue;
 }
 /*
@@ -2215,37 +2730,9 @@ JITCFlow ppc_opc_gen_lwzu(JITC &jitc)
 	int rA, rD;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rD, rA, imm);
-	ppc_opc_gen_helper_lu(jitc, PPC_GPR(rA), imm);
-#if 0
-	jitc.asmALU32(X86_TEST, RAX, 3);
-	NativeAddress fixup3 = jitc.asmJxxFixup(X86_NZ);
-	ppc_opc_gen_helper_tlb(jitc, RAX, RDX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_read_eff, 4, RDX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmResolveFixup(fixup3, jitc.asmHERE());
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA), NATIVE_REG | RAX);
-	if (imm) {
-		jitc.asmALU32(X86_ADD, a, imm);
-	}
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_MOV, RDX, curCPUsib(tlb_data_read_phys, 8, RDX));
-	jitc.asmALU32(X86_ADD, RDX, RAX);
-	jitc.asmALU32(X86_MOV, RDX, RDX, 0u);
-	jitc.asmBSWAP32(RDX);
-	
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	if (imm) {
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, a, imm);
-	}
-#endif
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 4, false, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -2268,19 +2755,9 @@ JITCFlow ppc_opc_gen_lwzux(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lux(jitc, PPC_GPR(rA), PPC_GPR(rB));
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	if (rD == rB) {
-		// don't ask...
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA), NATIVE_REG | RAX);
-		jitc.asmALU32(X86_ADD, a, curCPUreg(PPC_GPR(rB)));
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-	} else {
-		jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
-		NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-		jitc.asmALU32(X86_ADD, a, b);
-	}
+	if (rA == 0 || rA == rD) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 4, false, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -2301,131 +2778,57 @@ JITCFlow ppc_opc_gen_lwzx(JITC &jitc)
 {
 	int rA, rD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rD, rA, rB);
-	ppc_opc_gen_helper_lx(jitc, PPC_GPR(rA), PPC_GPR(rB));
-#if 0
-	jitc.asmALU32(X86_TEST, RAX, 3);
-	NativeAddress fixup3 = jitc.asmJxxFixup(X86_NZ);	
-	ppc_opc_gen_helper_tlb(jitc, RAX, RDX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_read_eff, 4, RDX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmResolveFixup(fixup3, jitc.asmHERE());
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_ADD, RAX, curCPUsib(tlb_data_read_phys, 8, RDX));
-	jitc.asmALU32(X86_MOV, RDX, RAX, 0u);
-	jitc.asmBSWAP32(RDX);
-
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-#endif
-	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RDX);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_load(jitc, PPC_GPR(rD), 4, false);
 	return flowContinue;
 }
 
-#if 0
-static inline NativeReg FASTCALL ppc_opc_gen_helper_lvx_hint(int rA, int rB, int hint)
+/*
+ *	Reverses the byte order of r, using t as scratch register.
+ *	Guest memory is big-endian, aCPU.vr is stored in host order.
+ */
+static void ppc_opc_gen_bswap_vec(JITC &jitc, NativeVectorReg r, NativeVectorReg t)
 {
-	NativeReg ret = REG_NO;
-	byte modrm[6];
-
-	NativeReg reg1 = jitc.getClientRegisterMapping(PPC_GPR(rA));
-	NativeReg reg2 = jitc.getClientRegisterMapping(PPC_GPR(rB));
-
-	if (reg1 == hint) {
-		jitc.clobberCarryAndFlags();
-		jitc.clobberRegister(NATIVE_REG | reg1);
-		ret = reg1;
-		jitc.touchRegister(ret);
-
-		if (reg2 != REG_NO) {
-			jitc.asmALU32(X86_ADD, ret, reg2);
-		} else {
-			asmALURegMem(X86_ADD, ret, modrm,
-				x86_mem(modrm, REG_NO, (uint32)&aCPU.gpr[rB]));
-		}
-	} else if (reg2 == hint) {
-		jitc.clobberCarryAndFlags();
-		jitc.clobberRegister(NATIVE_REG | reg2);
-		ret = reg2;
-		jitc.touchRegister(ret);
-
-		if (reg1 != REG_NO) {
-			jitc.asmALU32(X86_ADD, ret, reg1);
-		} else {
-			asmALURegMem(X86_ADD, ret, modrm,
-				x86_mem(modrm, REG_NO, (uint32)&aCPU.gpr[rA]));
-		}
-	} else if ((reg1 != REG_NO) && (reg2 != REG_NO)) {
-		/* If both are in register space, and not the hint we're best
-		 *   off clobbering the hint, then using leal as a 3-operand
-		 *   ADD.
-		 * This gives us the performance of an ADD, and removes the
-		 *   need for a later MOV into the hint.
-		 */
-		jitc.clobberRegister(NATIVE_REG | hint);
-		ret = (NativeReg)hint;
-		jitc.touchRegister(ret);
-
-		asmLEA(ret, modrm, x86_mem_sib(modrm, reg1, 1, reg2, 0));
-	}
-
-	return ret;
+	jitc.asmPSHUFD(r, r, 0x1b);
+	jitc.asmPSHUFLW(r, r, 0xb1);
+	jitc.asmPSHUFHW(r, r, 0xb1);
+	jitc.asmALUPS(X86_MOVAPS, t, r);
+	jitc.asmPShift(X86_PSRLW, r, 8);
+	jitc.asmPShift(X86_PSLLW, t, 8);
+	jitc.asmPALU(X86_POR, r, t);
 }
 
-static inline NativeReg FASTCALL ppc_opc_gen_helper_lvx(int rA, int rB, int hint=0)
+/*
+ *	Computes the host address of the element of vr
+ *	addressed by the effective address in EAX into RCX.
+ *	Clobbers RAX.
+ */
+static void ppc_opc_gen_vec_element(JITC &jitc, int vr, int size)
 {
-	NativeReg ret = REG_NO;
-	byte modrm[6];
-
-	if (!rA) {
-		ret = jitc.getClientRegisterMapping(PPC_GPR(rB));
-
-		if (ret == REG_NO) {
-			ret = jitc.getClientRegister(PPC_GPR(rB), hint);
-		}
-
-		jitc.clobberRegister(NATIVE_REG | ret);
-		jitc.touchRegister(ret);
-
-		return ret;
-	}
-
-	if (hint & NATIVE_REG) {
-		ret = ppc_opc_gen_helper_lvx_hint(rA, rB, hint & 0x0f);
-
-		if (ret != REG_NO)
-			return ret;
-	}
-
-	jitc.clobberCarryAndFlags();
-
-	NativeReg reg1 = jitc.getClientRegisterMapping(PPC_GPR(rA));
-	NativeReg reg2 = jitc.getClientRegisterMapping(PPC_GPR(rB));
-
-	if (reg2 == REG_NO) {
-		ret = jitc.getClientRegister(PPC_GPR(rA));
-		jitc.clobberRegister(NATIVE_REG | ret);
-
-		asmALURegMem(X86_ADD, ret, modrm,
-			x86_mem(modrm, REG_NO, (uint32)&aCPU.gpr[rB]));
-	} else {
-		jitc.clobberRegister(NATIVE_REG | reg2);
-		ret = reg2;
+	jitc.asmALU32(X86_MOV, RCX, 16-size);
+	jitc.asmALU32(X86_AND, RAX, 16-size);
+	jitc.asmALU32(X86_SUB, RCX, RAX);
+	jitc.asmALU64(X86_LEA, RAX, curCPUvr(vr));
+	jitc.asmALU64(X86_ADD, RCX, RAX);
+}
 
-		if (reg1 != REG_NO) {
-			jitc.asmALU32(X86_ADD, ret, reg1);
-		} else {
-			asmALURegMem(X86_ADD, ret, modrm,
-				x86_mem(modrm, REG_NO, (uint32)&aCPU.gpr[rA]));
-		}
+/*
+ *	Loads one element of size bytes into vrD
+ */
+static void ppc_opc_gen_load_vec_element(JITC &jitc, int vrD, int rA, int rB, int size)
+{
+	jitc.trashClientVectorRegister(vrD);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	if (size > 1) jitc.asmALU32(X86_AND, RAX, ~(size-1));
+	jitc.asmALU32(X86_MOV, curCPU(vtemp), RAX);
+	ppc_opc_gen_load(jitc, PPC_REG_NO, size, false);
+	jitc.asmALU32(X86_MOV, RAX, curCPU(vtemp));
+	ppc_opc_gen_vec_element(jitc, vrD, size);
+	switch (size) {
+	case 1: jitc.asmALU8(X86_MOV, RCX, 0u, RDX); break;
+	case 2: jitc.asmALU16(X86_MOV, RCX, 0u, RDX); break;
+	default: jitc.asmALU32(X86_MOV, RCX, 0u, RDX); break;
 	}
-
-	jitc.touchRegister(ret);
-	return ret;
 }
 
 /*      lvx	     Load Vector Indexed
@@ -2446,63 +2849,45 @@ void ppc_opc_lvx(PPC_CPU_State &aCPU)
 
 	int ea = ((rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB]);
 
-	int ret = ppc_read_effective_qword(ea, r);
+	int ret = ppc_read_effective_qword(aCPU, ea, r);
 	if (ret == PPC_MMU_OK) {
 		aCPU.vr[vrD] = r;
 	}
 }
-JITCFlow ppc_opc_gen_lvx()
+JITCFlow ppc_opc_gen_lvx(JITC &jitc)
 {
-	ppc_opc_gen_check_vec();
+	ppc_opc_gen_check_vec(jitc);
 	int rA, vrD, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
-	jitcDropClientVectorRegister(vrD);
-	jitcAssertFlushedVectorRegister(vrD);
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(rA, rB, NATIVE_REG | RAX);
-#if 1
-	jitc.clobberAll();
-	if (regA != RAX) {
-		//printf("*** hint miss r%u != r0\n", regA);
-		jitc.asmALU32(X86_MOV, RAX, regA);
-	}
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-	jitc.asmALU32(X86_MOV, EDX, (uint32)&(aCPU.vr[vrD]));
-
-	if (0 && jitc.hostCPUCaps.sse) {
-		jitc.asmCALL((NativeAddress)ppc_read_effective_qword_sse_asm);
-		jitc.nativeVectorReg = vrD;
-	} else {
-		jitc.asmCALL((NativeAddress)ppc_read_effective_qword_asm);
-	}
-#else
-	jitc.asmALU32(X86_AND, regA, ~0x0f);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-
-	jitc.clobberAll();
-	if (regA != RAX) {
-		//printf("*** hint miss r%u != r0\n", regA);
-		jitc.asmALU32(X86_MOV, RAX, regA);
-	}
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	jitc.asmCALL((NativeAddress)ppc_read_effective_dword_asm);
-	asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[3]), RCX);
-	asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[2]), EDX);
-
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_OR, RAX, 8);
-
-	jitc.asmCALL((NativeAddress)ppc_read_effective_dword_asm);
-	asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[1]), RCX);
-	asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[0]), EDX);
-#endif
 
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	jitc.asmALU32(X86_AND, RAX, ~0x0f);
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+	/*
+	 *	Allocate everything before the paths split,
+	 *	so both of them leave the register state alike.
+	 */
+	NativeVectorReg d = jitc.allocVectorRegister();
+	NativeVectorReg t = jitc.allocVectorRegister();
+
+	TLBLookup l;
+	ppc_opc_gen_tlb_lookup(jitc, l, false, 16);
+	ppc_opc_gen_tlb_access(jitc, l);
+	jitc.asmMOVUPS(d, RCX, 0);
+	ppc_opc_gen_bswap_vec(jitc, d, t);
+	NativeAddress done = jitc.asmJMPFixup();
+
+	ppc_opc_gen_tlb_resolve_miss(jitc, l);
+	jitc.asmALU64(X86_LEA, RDX, curCPUvr(vrD));
+	ppc_opc_gen_tlb_miss(jitc, (NativeAddress)ppc_read_effective_qword_asm, PPC_REG_NO, false);
+	jitc.asmMOVUPS(d, curCPUvr(vrD));
+
+	jitc.asmResolveFixup(done, jitc.asmHERE());
+	jitc.renameVectorRegisterDirty(d, vrD);
 	return flowContinue;
 }
 
-
 /*      lvxl	    Load Vector Index LRU
  *      v.128
  */
@@ -2514,13 +2899,12 @@ void ppc_opc_lvxl(PPC_CPU_State &aCPU)
 	 *   so this is effectively exactly the same as lvx.
 	 */
 }
-JITCFlow ppc_opc_gen_lvxl()
+JITCFlow ppc_opc_gen_lvxl(JITC &jitc)
 {
-	return ppc_opc_gen_lvx();
+	return ppc_opc_gen_lvx(jitc);
 }
 
-
-/*      lvRBX	   Load Vector Element Byte Indexed
+/*      lvebx	   Load Vector Element Byte Indexed
  *      v.119
  */
 void ppc_opc_lvebx(PPC_CPU_State &aCPU)
@@ -2537,40 +2921,17 @@ void ppc_opc_lvebx(PPC_CPU_State &aCPU)
 	uint32 ea;
 	uint8 r;
 	ea = (rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB];
-	int ret = ppc_read_effective_byte(ea, r);
+	int ret = ppc_read_effective_byte(aCPU, ea, r);
 	if (ret == PPC_MMU_OK) {
 		VECT_B(aCPU.vr[vrD], ea & 0x0f) = r;
 	}
 }
-JITCFlow ppc_opc_gen_lvebx()
+JITCFlow ppc_opc_gen_lvebx(JITC &jitc)
 {
-	ppc_opc_gen_check_vec();
+	ppc_opc_gen_check_vec(jitc);
 	int rA, vrD, rB;
-	byte modrm[6];
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
-	jitcDropClientVectorRegister(vrD);
-	jitcAssertFlushedVectorRegister(vrD);
-
-	if (vrD == jitc.nativeVectorReg) {
-		jitc.nativeVectorReg = VECTREG_NO;
-	}
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(rA, rB, NATIVE_REG | RAX);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	jitc.asmCALL((NativeAddress)ppc_read_effective_byte_asm);
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_AND, RAX, 0x0f);
-	asmALUReg(X86_NOT, RAX);
-
-	asmALUMemReg8(X86_MOV, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrD])+16), DL);
-
+	ppc_opc_gen_load_vec_element(jitc, vrD, rA, rB, 1);
 	return flowContinue;
 }
 
@@ -2591,43 +2952,17 @@ void ppc_opc_lvehx(PPC_CPU_State &aCPU)
 	uint32 ea;
 	uint16 r;
 	ea = ((rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB]) & ~1;
-	int ret = ppc_read_effective_half(ea, r);
+	int ret = ppc_read_effective_half(aCPU, ea, r);
 	if (ret == PPC_MMU_OK) {
 		VECT_H(aCPU.vr[vrD], (ea & 0x0f) >> 1) = r;
 	}
 }
-JITCFlow ppc_opc_gen_lvehx()
+JITCFlow ppc_opc_gen_lvehx(JITC &jitc)
 {
-	ppc_opc_gen_check_vec();
-	int rA, vrD, rB;
-	byte modrm[6];
-	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
-	jitcDropClientVectorRegister(vrD);
-	jitcAssertFlushedVectorRegister(vrD);
-
-	if (vrD == jitc.nativeVectorReg) {
-		jitc.nativeVectorReg = VECTREG_NO;
-	}
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(rA, rB, NATIVE_REG | RAX);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-	jitc.asmALU32(X86_AND, regA, ~0x01);
-
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	jitc.asmCALL((NativeAddress)ppc_read_effective_half_z_asm);
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_AND, RAX, 0x0e);
-	asmALUReg(X86_NOT, RAX);
-
-	asmALUMemReg8(X86_MOV, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrD])+15), DL);
-	asmALUMemReg8(X86_MOV, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrD])+16), DH);
-
+	ppc_opc_gen_check_vec(jitc);
+	int rA, vrD, rB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
+	ppc_opc_gen_load_vec_element(jitc, vrD, rA, rB, 2);
 	return flowContinue;
 }
 
@@ -2648,40 +2983,17 @@ void ppc_opc_lvewx(PPC_CPU_State &aCPU)
 	uint32 ea;
 	uint32 r;
 	ea = ((rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB]) & ~3;
-	int ret = ppc_read_effective_word(ea, r);
+	int ret = ppc_read_effective_word(aCPU, ea, r);
 	if (ret == PPC_MMU_OK) {
 		VECT_W(aCPU.vr[vrD], (ea & 0xf) >> 2) = r;
 	}
 }
-JITCFlow ppc_opc_gen_lvewx()
+JITCFlow ppc_opc_gen_lvewx(JITC &jitc)
 {
-	ppc_opc_gen_check_vec();
+	ppc_opc_gen_check_vec(jitc);
 	int rA, vrD, rB;
-	byte modrm[6];
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
-	jitcDropClientVectorRegister(vrD);
-	jitcAssertFlushedVectorRegister(vrD);
-
-	if (vrD == jitc.nativeVectorReg) {
-		jitc.nativeVectorReg = VECTREG_NO;
-	}
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(rA, rB, NATIVE_REG | RAX);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-	jitc.asmALU32(X86_AND, regA, ~0x03);
-
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_AND, RAX, 0x0c);
-	asmALUReg(X86_NOT, RAX);
-
-	asmALUMemReg(X86_MOV, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrD])+13), EDX);
+	ppc_opc_gen_load_vec_element(jitc, vrD, rA, rB, 4);
 	return flowContinue;
 }
 
@@ -2701,43 +3013,20 @@ const static byte lvsl_helper[] = {
 #endif
 };
 
-const static uint32 lvsl_helper_full[16*4] = {
-	VECT_BUILD(0x00010203, 0x04050607, 0x08090A0B, 0x0C0D0E0F),
-	VECT_BUILD(0x01020304, 0x05060708, 0x090A0B0C, 0x0D0E0F10),
-	VECT_BUILD(0x02030405, 0x06070809, 0x0A0B0C0D, 0x0E0F1011),
-	VECT_BUILD(0x03040506, 0x0708090A, 0x0B0C0D0E, 0x0F101112),
-	VECT_BUILD(0x04050607, 0x08090A0B, 0x0C0D0E0F, 0x10111213),
-	VECT_BUILD(0x05060708, 0x090A0B0C, 0x0D0E0F10, 0x11121314),
-	VECT_BUILD(0x06070809, 0x0A0B0C0D, 0x0E0F1011, 0x12131415),
-	VECT_BUILD(0x0708090A, 0x0B0C0D0E, 0x0F101112, 0x13141516),
-	VECT_BUILD(0x08090A0B, 0x0C0D0E0F, 0x10111213, 0x14151617),
-	VECT_BUILD(0x090A0B0C, 0x0D0E0F10, 0x11121314, 0x15161718),
-	VECT_BUILD(0x0A0B0C0D, 0x0E0F1011, 0x12131415, 0x16171819),
-	VECT_BUILD(0x0B0C0D0E, 0x0F101112, 0x13141516, 0x1718191A),
-	VECT_BUILD(0x0C0D0E0F, 0x10111213, 0x14151617, 0x18191A1B),
-	VECT_BUILD(0x0D0E0F10, 0x11121314, 0x15161718, 0x191A1B1C),
-	VECT_BUILD(0x0E0F1011, 0x12131415, 0x16171819, 0x1A1B1C1D),
-	VECT_BUILD(0x0F101112, 0x13141516, 0x1718191A, 0x1B1C1D1E),
-};
-
-const static uint32 lvsr_helper_full[16*4] = {
-	VECT_BUILD(0x10111213, 0x14151617, 0x18191A1B, 0x1C1D1E1F),
-	VECT_BUILD(0x0F101112, 0x13141516, 0x1718191A, 0x1B1C1D1E),
-	VECT_BUILD(0x0E0F1011, 0x12131415, 0x16171819, 0x1A1B1C1D),
-	VECT_BUILD(0x0D0E0F10, 0x11121314, 0x15161718, 0x191A1B1C),
-	VECT_BUILD(0x0C0D0E0F, 0x10111213, 0x14151617, 0x18191A1B),
-	VECT_BUILD(0x0B0C0D0E, 0x0F101112, 0x13141516, 0x1718191A),
-	VECT_BUILD(0x0A0B0C0D, 0x0E0F1011, 0x12131415, 0x16171819),
-	VECT_BUILD(0x090A0B0C, 0x0D0E0F10, 0x11121314, 0x15161718),
-	VECT_BUILD(0x08090A0B, 0x0C0D0E0F, 0x10111213, 0x14151617),
-	VECT_BUILD(0x0708090A, 0x0B0C0D0E, 0x0F101112, 0x13141516),
-	VECT_BUILD(0x06070809, 0x0A0B0C0D, 0x0E0F1011, 0x12131415),
-	VECT_BUILD(0x05060708, 0x090A0B0C, 0x0D0E0F10, 0x11121314),
-	VECT_BUILD(0x04050607, 0x08090A0B, 0x0C0D0E0F, 0x10111213),
-	VECT_BUILD(0x03040506, 0x0708090A, 0x0B0C0D0E, 0x0F101112),
-	VECT_BUILD(0x02030405, 0x06070809, 0x0A0B0C0D, 0x0E0F1011),
-	VECT_BUILD(0x01020304, 0x05060708, 0x090A0B0C, 0x0D0E0F10),
-};
+/*
+ *	Loads the lvsl/lvsr permute vector for (rA|0)+rB from
+ *	lvsl_helper+ofs-(ea & 0xf), or lvsl_helper+ofs+(ea & 0xf) if !neg
+ */
+static void ppc_opc_gen_lvsx(JITC &jitc, int vrD, int rA, int rB, uint32 ofs, bool neg)
+{
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	jitc.asmALU32(X86_AND, RAX, 0x0f);
+	NativeReg r = jitc.allocRegister();
+	jitc.asmMOVABS(r, (uint64)(lvsl_helper + ofs));
+	jitc.asmALU64(neg ? X86_SUB : X86_ADD, r, RAX);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmMOVUPS(d, r, 0);
+}
 
 /*
  *      lvsl	    Load Vector for Shift Left
@@ -2764,51 +3053,12 @@ void ppc_opc_lvsl(PPC_CPU_State &aCPU)
 #error Endianess not supported!
 #endif
 }
-JITCFlow ppc_opc_gen_lvsl()
+JITCFlow ppc_opc_gen_lvsl(JITC &jitc)
 {
-	ppc_opc_gen_check_vec();
+	ppc_opc_gen_check_vec(jitc);
 	int rA, vrD, rB;
-	byte modrm[6];
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
-
-	if (vrD == jitc.nativeVectorReg) {
-		jitc.nativeVectorReg = VECTREG_NO;
-	}
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(rA, rB);
-	jitc.asmALU32(X86_AND, regA, 0x0f);
-
-	if (jitc.hostCPUCaps.sse) {
-		asmShiftRegImm(X86_SHL, regA, 4);
-
-		NativeVectorReg reg1 = jitc.mapClientVectorRegisterDirty(vrD);
-
-		asmALUPS(X86_MOVAPS, reg1,
-			x86_mem2(modrm, regA, (uint32)&lvsl_helper_full));
-	} else {
-		asmALUReg(X86_NOT, regA);
-		jitcDropClientVectorRegister(vrD);
-
-		NativeReg reg1 = jitcAllocRegister();
-		NativeReg reg2 = jitcAllocRegister();
-		NativeReg reg3 = jitcAllocRegister();
-
-		asmALURegMem(X86_MOV, reg1, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+0x11));
-		asmALURegMem(X86_MOV, reg2, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+0x15));
-		asmALURegMem(X86_MOV, reg3, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+0x19));
-		asmALURegMem(X86_MOV, regA, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+0x1d));
-
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[0]), reg1);
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[1]), reg2);
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[2]), reg3);
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[3]), regA);
-	}
-
+	ppc_opc_gen_lvsx(jitc, vrD, rA, rB, 0x10, true);
 	return flowContinue;
 }
 
@@ -2837,51 +3087,12 @@ void ppc_opc_lvsr(PPC_CPU_State &aCPU)
 #error Endianess not supported!
 #endif
 }
-JITCFlow ppc_opc_gen_lvsr()
+JITCFlow ppc_opc_gen_lvsr(JITC &jitc)
 {
-	ppc_opc_gen_check_vec();
+	ppc_opc_gen_check_vec(jitc);
 	int rA, vrD, rB;
-	byte modrm[6];
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, rA, rB);
-
-	if (vrD == jitc.nativeVectorReg) {
-		jitc.nativeVectorReg = VECTREG_NO;
-	}
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(rA, rB);
-	jitc.asmALU32(X86_AND, regA, 0x0f);
-
-	if (jitc.hostCPUCaps.sse) {
-		asmShiftRegImm(X86_SHL, regA, 4);
-
-		NativeVectorReg reg1 = jitc.mapClientVectorRegisterDirty(vrD);
-
-		asmALUPS(X86_MOVAPS, reg1,
-			x86_mem2(modrm, regA, (uint32)&lvsr_helper_full));
-	} else {
-		jitcDropClientVectorRegister(vrD);
-		jitcAssertFlushedVectorRegister(vrD);
-
-		NativeReg reg1 = jitcAllocRegister();
-		NativeReg reg2 = jitcAllocRegister();
-		NativeReg reg3 = jitcAllocRegister();
-
-		asmALURegMem(X86_MOV, reg1, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper));
-		asmALURegMem(X86_MOV, reg2, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+4));
-		asmALURegMem(X86_MOV, reg3, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+8));
-		asmALURegMem(X86_MOV, regA, modrm,
-			x86_mem(modrm, regA, (uint32)&lvsl_helper+12));
-
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[0]), reg1);
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[1]), reg2);
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[2]), reg3);
-		asmMOVDMemReg((uint32)&(aCPU.vr[vrD].w[3]), regA);
-	}
-
+	ppc_opc_gen_lvsx(jitc, vrD, rA, rB, 0, false);
 	return flowContinue;
 }
 
@@ -2894,12 +3105,11 @@ void ppc_opc_dst(PPC_CPU_State &aCPU)
 	VECTOR_DEBUG;
 	/* Since we are not emulating the cache, this is a nop */
 }
-JITCFlow ppc_opc_gen_dst()
+JITCFlow ppc_opc_gen_dst(JITC &jitc)
 {
 	/* Since we are not emulating the cache, this is a nop */
 	return flowContinue;
 }
-#endif
 
 /*
  *	stb		Store Byte
@@ -2917,28 +3127,9 @@ JITCFlow ppc_opc_gen_stb(JITC &jitc)
 	int rA, rS;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-	ppc_opc_gen_helper_st(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-#if 0
-	jitc.asmALU32(X86_MOV, RBX, RAX);
-	jitc.asmALU32(X86_MOV, RCX, RAX);
-	jitc.asmShift32(X86_SHR, RBX, 12);
-	jitc.asmALU32(X86_AND, RCX, 0xfffff000);
-	jitc.asmALU32(X86_AND, RBX, TLB_ENTRIES-1);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_write_eff, 4, RBX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmCALL((NativeAddress)ppc_write_effective_byte_asm);
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_ADD, RAX, curCPUsib(tlb_data_write_phys, 8, RBX));
-	jitc.asmALU8(X86_MOV, RAX, 0u, RDX);
-	
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_write_effective_byte_asm);
-#endif
-	return flowEndBlock;
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 1);
+	return flowContinue;
 }
 /*
  *	stbu		Store Byte with Update
@@ -2960,13 +3151,9 @@ JITCFlow ppc_opc_gen_stbu(JITC &jitc)
 	int rA, rS;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-	// FIXME: check rA!=0
-	ppc_opc_gen_helper_stu(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_byte_asm);
-	if (imm) {
-		NativeReg r = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, r, imm);
-	}
+	if (rA == 0) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 1, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -2987,11 +3174,9 @@ JITCFlow ppc_opc_gen_stbux(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	ppc_opc_gen_helper_stux(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_byte_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-	jitc.asmALU32(X86_ADD, a, b);
+	if (rA == 0) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 1, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -3008,9 +3193,9 @@ JITCFlow ppc_opc_gen_stbx(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_byte_asm);
-	return flowEndBlock;
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 1);
+	return flowContinue;
 }
 /*
  *	stfd		Store Floating-Point Double
@@ -3057,6 +3242,7 @@ JITCFlow ppc_opc_gen_stfd(JITC &jitc)
 	jitc.asmResolveFixup(fixup3, jitc.asmHERE());
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	NativeAddress fixup2 = jitc.asmJMPFixup();
 	
 	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
@@ -3068,6 +3254,7 @@ JITCFlow ppc_opc_gen_stfd(JITC &jitc)
 #else
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 #endif
 	return flowEndBlock;
 }
@@ -3109,9 +3296,9 @@ JITCFlow ppc_opc_gen_stfdu(JITC &jitc)
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
 	if (imm) {
-		NativeReg r = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, r, imm);
+		jitc.asmALU32(X86_ADD, curCPUreg(PPC_GPR(rA)), imm);
 	}
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowContinue;
 }
 /*
@@ -3147,9 +3334,9 @@ JITCFlow ppc_opc_gen_stfdux(JITC &jitc)
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-	jitc.asmALU32(X86_ADD, a, b);
+	jitc.asmALU32(X86_MOV, RAX, curCPUreg(PPC_GPR(rB)));
+	jitc.asmALU32(X86_ADD, curCPUreg(PPC_GPR(rA)), RAX);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowContinue;
 }
 /*
@@ -3184,6 +3371,7 @@ JITCFlow ppc_opc_gen_stfdx(JITC &jitc)
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 /*
@@ -3209,6 +3397,7 @@ JITCFlow ppc_opc_gen_stfiwx(JITC &jitc)
 	ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_FPR(frS));
 	// FIXME64: loading lower half would be enough
 	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 /*
@@ -3253,6 +3442,7 @@ JITCFlow ppc_opc_gen_stfs(JITC &jitc)
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 /*
@@ -3299,9 +3489,9 @@ JITCFlow ppc_opc_gen_stfsu(JITC &jitc)
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
 	if (imm) {
-		NativeReg r = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, r, imm);
+		jitc.asmALU32(X86_ADD, curCPUreg(PPC_GPR(rA)), imm);
 	}
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowContinue;
 }
 /*
@@ -3343,9 +3533,9 @@ JITCFlow ppc_opc_gen_stfsux(JITC &jitc)
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-	jitc.asmALU32(X86_ADD, a, b);
+	jitc.asmALU32(X86_MOV, RAX, curCPUreg(PPC_GPR(rB)));
+	jitc.asmALU32(X86_ADD, curCPUreg(PPC_GPR(rA)), RAX);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowContinue;
 }
 /*
@@ -3386,6 +3576,7 @@ JITCFlow ppc_opc_gen_stfsx(JITC &jitc)
 	jitc.clobberAll();
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 /*
@@ -3404,9 +3595,9 @@ JITCFlow ppc_opc_gen_sth(JITC &jitc)
 	int rA, rS;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-	ppc_opc_gen_helper_st(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_half_asm);
-	return flowEndBlock;
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 2);
+	return flowContinue;
 }
 /*
  *	sthbrx		Store Half Word Byte-Reverse Indexed
@@ -3425,6 +3616,7 @@ JITCFlow ppc_opc_gen_sthbrx(JITC &jitc)
 	ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
 	jitc.asmShift16(X86_ROL, RDX, 8);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_half_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 /*
@@ -3447,13 +3639,9 @@ JITCFlow ppc_opc_gen_sthu(JITC &jitc)
 	int rA, rS;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-	// FIXME: check rA!=0
-	ppc_opc_gen_helper_stu(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_half_asm);
-	if (imm) {
-		NativeReg r = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, r, imm);
-	}
+	if (rA == 0) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 2, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -3474,11 +3662,9 @@ JITCFlow ppc_opc_gen_sthux(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	ppc_opc_gen_helper_stux(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_half_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-	jitc.asmALU32(X86_ADD, a, b);
+	if (rA == 0) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 2, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -3495,9 +3681,9 @@ JITCFlow ppc_opc_gen_sthx(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_half_asm);
-	return flowEndBlock;
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 2);
+	return flowContinue;
 }
 /*
  *	stmw		Store Multiple Word
@@ -3522,14 +3708,9 @@ JITCFlow ppc_opc_gen_stmw(JITC &jitc)
 	int rS, rA;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-        while (rS <= 31) {
-                ppc_opc_gen_helper_st(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-//                jitc.getClientRegister(PPC_GPR(rS), NATIVE_REG | RDX);
-                jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-                rS += 1;
-                imm += 4;
-        } 
-	return flowEndBlock;
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_multiple(jitc, rS, 4*(32-rS), true);
+	return flowContinue;
 }
 /*
  *	stswi		Store String Word Immediate
@@ -3565,19 +3746,9 @@ JITCFlow ppc_opc_gen_stswi(JITC &jitc)
 	int rA, rS, NB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, NB);
 	if (NB==0) NB=32;
-	jitc.clobberCarryAndFlags();
-	jitc.flushRegister();
-	if (rA) {
-		jitc.getClientRegister(PPC_GPR(rA), NATIVE_REG | RAX);
-	} else {
-		jitc.asmALU32(X86_MOV, RAX, 0);
-	}
-	jitc.asmALU32(X86_MOV, RCX, NB);
-	jitc.asmALU32(X86_MOV, RBX, rS);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-	jitc.clobberAll();
-	jitc.asmCALL((NativeAddress)ppc_opc_stswi_asm);
-	return flowEndBlock;
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), 0, true);
+	ppc_opc_gen_multiple(jitc, rS, NB, true);
+	return flowContinue;
 }
 /*
  *	stswx		Store String Word Indexed
@@ -3627,6 +3798,7 @@ JITCFlow ppc_opc_gen_stswx(JITC &jitc)
 	jitc.asmALU32(X86_MOV, RBX, rS);
 	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
 	jitc.asmCALL((NativeAddress)ppc_opc_stswi_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	jitc.asmResolveFixup(fixup, jitc.asmHERE());
 	return flowEndBlock;
 }
@@ -3646,30 +3818,9 @@ JITCFlow ppc_opc_gen_stw(JITC &jitc)
 	int rA, rS;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-	ppc_opc_gen_helper_st(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-#if 0
-	jitc.asmALU32(X86_TEST, RAX, 3);
-	NativeAddress fixup3 = jitc.asmJxxFixup(X86_NZ);
-	
-	ppc_opc_gen_helper_tlb(jitc, RAX, RBX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_write_eff, 4, RBX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmResolveFixup(fixup3, jitc.asmHERE());
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_ADD, RAX, curCPUsib(tlb_data_write_phys, 8, RBX));
-	jitc.asmBSWAP32(RDX);
-	jitc.asmALU32(X86_MOV, RAX, 0u, RDX);
-	
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-	return flowEndBlock;
-#else
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	return flowEndBlock;
-#endif
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, true);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 4);
+	return flowContinue;
 }
 /*
  *	stwbrx		Store Word Byte-Reverse Indexed
@@ -3689,6 +3840,7 @@ JITCFlow ppc_opc_gen_stwbrx(JITC &jitc)
 	ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
 	jitc.asmBSWAP32(RDX);
 	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
+	ppc_opc_gen_check_code_destroyed(jitc);
 	return flowEndBlock;
 }
 /*
@@ -3717,31 +3869,72 @@ void ppc_opc_stwcx_(PPC_CPU_State &aCPU)
 		}
 	}
 }
+/*
+ *	The word is loaded and compared with the reserved value and
+ *	stored through the same inline TLB lookup as ppc_opc_gen_store(),
+ *	so only a TLB miss calls the helpers. With fastmem both accesses
+ *	get a marker, a fault of either retries the whole sequence.
+ */
 JITCFlow ppc_opc_gen_stwcx_(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	jitc.clobberCarryAndFlags();
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
 	jitc.asmALU8(X86_AND, curCPU(cr)+3, 0x0f);
+	jitc.asmTEST32(curCPU(xer), XER_SO);
+	NativeAddress no_so = jitc.asmJxxFixup(X86_Z);
+		jitc.asmOR32(curCPU(cr), 0x10000000);  // CR_CR0_SO
+	jitc.asmResolveFixup(no_so, jitc.asmHERE());
 	jitc.asmBTx32(X86_BTR, curCPU(have_reservation), 0);
 	NativeAddress no_reservation = jitc.asmJxxFixup(X86_NC);
-		ppc_opc_gen_helper_lx(jitc, PPC_GPR(rA), PPC_GPR(rB));
-		jitc.asmCALL((NativeAddress)ppc_read_effective_word_asm);
-		jitc.asmALU32(X86_CMP, RDX, curCPU(reserve));
-		// FIXME: mapFlags?
-		NativeAddress fixup = jitc.asmJxxFixup(X86_NE);
-		ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-		jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-		jitc.asmOR32(curCPU(cr), 0x20000000);  // CR_CR0_EQ
-	
-	jitc.asmResolveFixup(fixup, jitc.asmHERE());
+
+	TLBLookup l;
+	ppc_opc_gen_tlb_lookup(jitc, l, true, 4);
+	ppc_opc_gen_tlb_access(jitc, l);
+	NativeAddress load_miss = l.miss;
+	if (jitc.hostCPUCaps.movbe) {
+		jitc.asmMOVBE32(RDX, RCX, 0u);
+	} else {
+		jitc.asmALU32(X86_MOV, RDX, RCX, 0u);
+		jitc.asmBSWAP32(RDX);
+	}
+	jitc.asmALU32(X86_CMP, RDX, curCPU(reserve));
+	NativeAddress fail = jitc.asmJxxFixup(X86_NE);
+	NativeReg s = jitc.getClientRegisterMapping(PPC_GPR(rS));
+	if (s != REG_NO) {
+		jitc.asmALU32(X86_MOV, RDX, s);
+	} else {
+		jitc.asmALU32(X86_MOV, RDX, curCPUreg(PPC_GPR(rS)));
+	}
+	if (jitc.hostCPUCaps.movbe) {
+		ppc_opc_gen_tlb_access(jitc, l);
+		jitc.asmMOVBE32(RCX, 0u, RDX);
+	} else {
+		jitc.asmBSWAP32(RDX);
+		ppc_opc_gen_tlb_access(jitc, l);
+		jitc.asmALU32(X86_MOV, RCX, 0u, RDX);
+	}
+	NativeAddress done = jitc.asmJMPFixup();
+
+	if (jitc.fastmem) jitc.asmResolveFixup(load_miss, jitc.asmHERE());
+	ppc_opc_gen_tlb_resolve_miss(jitc, l);
+	ppc_opc_gen_tlb_miss(jitc, (NativeAddress)ppc_read_effective_word_asm, PPC_REG_NO, true);
+	jitc.asmALU32(X86_CMP, RDX, curCPU(reserve));
+	NativeAddress fail_miss = jitc.asmJxxFixup(X86_NE);
+	ppc_opc_gen_tlb_miss(jitc, (NativeAddress)ppc_write_effective_word_asm, PPC_GPR(rS), false);
+	jitc.asmOR32(curCPU(cr), 0x20000000);  // CR_CR0_EQ
+	ppc_opc_gen_check_code_destroyed(jitc);
+	NativeAddress done_miss = jitc.asmJMPFixup();
+
+	jitc.asmResolveFixup(done, jitc.asmHERE());
+	jitc.asmOR32(curCPU(cr), 0x20000000);  // CR_CR0_EQ
+	jitc.asmResolveFixup(fail, jitc.asmHERE());
+	jitc.asmResolveFixup(fail_miss, jitc.asmHERE());
 	jitc.asmResolveFixup(no_reservation, jitc.asmHERE());
-	
-	jitc.asmTEST32(curCPU(xer), XER_SO);
-	fixup = jitc.asmJxxFixup(X86_Z);
-		jitc.asmOR32(curCPU(cr), 0x10000000);  // CR_CR0_SO
-	jitc.asmResolveFixup(fixup, jitc.asmHERE());
-	return flowEndBlock;
+	jitc.asmResolveFixup(done_miss, jitc.asmHERE());
+	return flowContinue;
 }
 /*
  *	stwu		Store Word with Update
@@ -3763,13 +3956,9 @@ JITCFlow ppc_opc_gen_stwu(JITC &jitc)
 	int rA, rS;
 	uint32 imm;
 	PPC_OPC_TEMPL_D_SImm(jitc.current_opc, rS, rA, imm);
-	// FIXME: check rA!=0
-	ppc_opc_gen_helper_stu(jitc, PPC_GPR(rA), imm, PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	if (imm) {
-		NativeReg r = jitc.getClientRegisterDirty(PPC_GPR(rA));
-		jitc.asmALU32(X86_ADD, r, imm);
-	}
+	if (rA == 0) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_imm(jitc, PPC_GPR(rA), imm, false);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 4, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -3790,11 +3979,9 @@ JITCFlow ppc_opc_gen_stwux(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	ppc_opc_gen_helper_stux(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	NativeReg a = jitc.getClientRegisterDirty(PPC_GPR(rA));
-	NativeReg b = jitc.getClientRegister(PPC_GPR(rB));
-	jitc.asmALU32(X86_ADD, a, b);
+	if (rA == 0) return ppc_opc_gen_invalid_update(jitc);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), false);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 4, PPC_GPR(rA));
 	return flowContinue;
 }
 /*
@@ -3811,32 +3998,36 @@ JITCFlow ppc_opc_gen_stwx(JITC &jitc)
 {
 	int rA, rS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, rS, rA, rB);
-	ppc_opc_gen_helper_stx(jitc, PPC_GPR(rA), PPC_GPR(rB), PPC_GPR(rS));
-#if 0
-	jitc.asmALU32(X86_TEST, RAX, 3);
-	NativeAddress fixup3 = jitc.asmJxxFixup(X86_NZ);
-	
-	ppc_opc_gen_helper_tlb(jitc, RAX, RBX, RCX);
-	
-	jitc.asmALU32(X86_CMP, RCX, curCPUsib(tlb_data_write_eff, 4, RBX));
-	NativeAddress fixup1 = jitc.asmJxxFixup(X86_E);
-	jitc.asmResolveFixup(fixup3, jitc.asmHERE());
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	NativeAddress fixup2 = jitc.asmJMPFixup();
-	
-	jitc.asmResolveFixup(fixup1, jitc.asmHERE());
-	jitc.asmALU64(X86_ADD, RAX, curCPUsib(tlb_data_write_phys, 8, RBX));
-	jitc.asmBSWAP32(RDX);
-	jitc.asmALU32(X86_MOV, RAX, 0u, RDX);
-	
-	jitc.asmResolveFixup(fixup2, jitc.asmHERE());
-#else
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-#endif
-	return flowEndBlock;
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	ppc_opc_gen_store(jitc, PPC_GPR(rS), 4);
+	return flowContinue;
+}
+
+/*
+ *	Stores one element of size bytes of vrS
+ */
+static void ppc_opc_gen_store_vec_element(JITC &jitc, int vrS, int rA, int rB, int size)
+{
+	jitc.flushClientVectorRegister(vrS);
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	if (size > 1) jitc.asmALU32(X86_AND, RAX, ~(size-1));
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+	jitc.asmALU32(X86_MOV, RDX, RAX);
+	jitc.asmALU32(X86_MOV, RCX, 16-size);
+	jitc.asmALU32(X86_AND, RDX, 16-size);
+	jitc.asmALU32(X86_SUB, RCX, RDX);
+	jitc.asmALU64(X86_LEA, RDX, curCPUvr(vrS));
+	jitc.asmALU64(X86_ADD, RCX, RDX);
+	switch (size) {
+	case 1: jitc.asmMOVxx32_8(X86_MOVZX, RDX, RCX, 0u); break;
+	case 2: jitc.asmMOVxx32_16(X86_MOVZX, RDX, RCX, 0u); break;
+	default: jitc.asmALU32(X86_MOV, RDX, RCX, 0u); break;
+	}
+	jitc.asmALU32(X86_MOV, curCPU(vtemp), RDX);
+	ppc_opc_gen_store(jitc, PPC_VTEMP, size);
 }
 
-#if 0
 /*      stvx	    Store Vector Indexed
  *      v.134
  */
@@ -3854,7 +4045,7 @@ void ppc_opc_stvx(PPC_CPU_State &aCPU)
 
 	int ea = ((rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB]);
 
-	ppc_write_effective_qword(ea, aCPU.vr[vrS]);
+	ppc_write_effective_qword(aCPU, ea, aCPU.vr[vrS]);
 }
 JITCFlow ppc_opc_gen_stvx(JITC &jitc)
 {
@@ -3862,46 +4053,29 @@ JITCFlow ppc_opc_gen_stvx(JITC &jitc)
 	int rA, vrS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrS, rA, rB);
 
-	jitc.flushClientVectorRegister(vrS);
-	jitcAssertFlushedVectorRegister(vrS);
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(jitc, rA, rB, NATIVE_REG | RAX);
-
-#if 1
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	if (0 && vrS == jitc.nativeVectorReg) {
-		jitc.asmALU32(X86_MOV, EDX, (uint32)&(aCPU.vr[JITC_VECTOR_TEMP]));
-		jitc.asmCALL((NativeAddress)ppc_write_effective_qword_sse_asm);
-	} else {
-		jitc.asmALU32(X86_MOV, EDX, (uint32)&(aCPU.vr[vrS]));
-		jitc.asmCALL((NativeAddress)ppc_write_effective_qword_asm);
-	}
-#else
-	jitc.asmALU32(X86_AND, regA, ~0x0f);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	asmMOVRegDMem(RCX, (uint32)&(aCPU.vr[vrS])+12);
-	asmMOVRegDMem(EDX, (uint32)&(aCPU.vr[vrS])+8);
-
-	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
-
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_OR, RAX, 8);
-
-	asmMOVRegDMem(RCX, (uint32)&(aCPU.vr[vrS])+4);
-	asmMOVRegDMem(EDX, (uint32)&(aCPU.vr[vrS])+0);
-
-	jitc.asmCALL((NativeAddress)ppc_write_effective_dword_asm);
-#endif
-	return flowEndBlock;
+	ppc_opc_gen_ea_reg(jitc, PPC_GPR(rA), PPC_GPR(rB), true);
+	jitc.asmALU32(X86_AND, RAX, ~0x0f);
+	jitc.allocRegister(NATIVE_REG | RCX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+	NativeVectorReg s = jitc.getClientVectorRegister(vrS);
+	NativeVectorReg t = jitc.allocVectorRegister();
+	NativeVectorReg u = jitc.allocVectorRegister();
+
+	TLBLookup l;
+	ppc_opc_gen_tlb_lookup(jitc, l, true, 16);
+	jitc.asmALUPS(X86_MOVAPS, t, s);
+	ppc_opc_gen_bswap_vec(jitc, t, u);
+	ppc_opc_gen_tlb_access(jitc, l);
+	jitc.asmMOVUPS(RCX, 0, t);
+	NativeAddress done = jitc.asmJMPFixup();
+
+	ppc_opc_gen_tlb_resolve_miss(jitc, l);
+	jitc.asmALU64(X86_LEA, RDX, curCPUvr(vrS));
+	ppc_opc_gen_tlb_miss(jitc, (NativeAddress)ppc_write_effective_qword_asm, PPC_REG_NO, false);
+	ppc_opc_gen_check_code_destroyed(jitc);
+
+	jitc.asmResolveFixup(done, jitc.asmHERE());
+	return flowContinue;
 }
 
 /*      stvxl	   Store Vector Indexed LRU
@@ -3920,14 +4094,14 @@ JITCFlow ppc_opc_gen_stvxl(JITC &jitc)
 	return ppc_opc_gen_stvx(jitc);
 }
 
-/*      stvRBX	  Store Vector Element Byte Indexed
+/*      stvebx	  Store Vector Element Byte Indexed
  *      v.131
  */
 void ppc_opc_stvebx(PPC_CPU_State &aCPU)
 {
 #ifndef __VEC_EXC_OFF__
 	if ((aCPU.msr & MSR_VEC) == 0) {
-		ppc_exception(PPC_EXC_NO_VEC);
+//		ppc_exception(PPC_EXC_NO_VEC);
 		return;
 	}
 #endif
@@ -3936,37 +4110,17 @@ void ppc_opc_stvebx(PPC_CPU_State &aCPU)
 	PPC_OPC_TEMPL_X(aCPU.current_opc, vrS, rA, rB);
 	uint32 ea;
 	ea = (rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB];
-	ppc_write_effective_byte(ea, VECT_B(aCPU.vr[vrS], ea & 0xf));
+	ppc_write_effective_byte(aCPU, ea, VECT_B(aCPU.vr[vrS], ea & 0xf));
 }
 JITCFlow ppc_opc_gen_stvebx(JITC &jitc)
 {
 	ppc_opc_gen_check_vec(jitc);
 	int rA, vrS, rB;
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrS, rA, rB);
-
-	jitc.flushClientVectorRegister(vrS);
-	jitcAssertFlushedVectorRegister(vrS);
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(jitc, rA, rB, NATIVE_REG | RAX);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-	jitc.asmALU32(X86_AND, regA, 0x0f);
-	asmALUReg(X86_NOT, regA);
-
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	asmALURegMem8(X86_MOV, DL, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrS])+16));
-
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-
-	jitc.asmCALL((NativeAddress)ppc_write_effective_byte_asm);
-	return flowEndBlock;
+	ppc_opc_gen_store_vec_element(jitc, vrS, rA, rB, 1);
+	return flowContinue;
 }
 
-
 /*      stvehx	  Store Vector Element Half Word Indexed
  *      v.132
  */
@@ -3974,7 +4128,7 @@ void ppc_opc_stvehx(PPC_CPU_State &aCPU)
 {
 #ifndef __VEC_EXC_OFF__
 	if ((aCPU.msr & MSR_VEC) == 0) {
-		ppc_exception(PPC_EXC_NO_VEC);
+//		ppc_exception(PPC_EXC_NO_VEC);
 		return;
 	}
 #endif
@@ -3983,41 +4137,17 @@ void ppc_opc_stvehx(PPC_CPU_State &aCPU)
 	PPC_OPC_TEMPL_X(aCPU.current_opc, vrS, rA, rB);
 	uint32 ea;
 	ea = ((rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB]) & ~1;
-	ppc_write_effective_half(ea, VECT_H(aCPU.vr[vrS], (ea & 0xf) >> 1));
+	ppc_write_effective_half(aCPU, ea, VECT_H(aCPU.vr[vrS], (ea & 0xf) >> 1));
 }
 JITCFlow ppc_opc_gen_stvehx(JITC &jitc)
 {
 	ppc_opc_gen_check_vec(jitc);
 	int rA, vrS, rB;
-	byte modrm[6];
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrS, rA, rB);
-
-	jitc.flushClientVectorRegister(vrS);
-	jitcAssertFlushedVectorRegister(vrS);
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(jitc, rA, rB, NATIVE_REG | RAX);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-	jitc.asmALU32(X86_AND, regA, 0x0e);
-	asmALUReg(X86_NOT, regA);
-
-	jitc.clobberAll();
-	if (regA != RAX)	jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	asmALURegMem8(X86_MOV, DL, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrS])+15));
-	asmALURegMem8(X86_MOV, DH, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrS])+16));
-
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_AND, RAX, ~0x1);
-
-	jitc.asmCALL((NativeAddress)ppc_write_effective_half_asm);
-	return flowEndBlock;
+	ppc_opc_gen_store_vec_element(jitc, vrS, rA, rB, 2);
+	return flowContinue;
 }
 
-
 /*      stvewx	  Store Vector Element Word Indexed
  *      v.133
  */
@@ -4025,7 +4155,7 @@ void ppc_opc_stvewx(PPC_CPU_State &aCPU)
 {
 #ifndef __VEC_EXC_OFF__
 	if ((aCPU.msr & MSR_VEC) == 0) {
-		ppc_exception(PPC_EXC_NO_VEC);
+//		ppc_exception(PPC_EXC_NO_VEC);
 		return;
 	}
 #endif
@@ -4034,36 +4164,15 @@ void ppc_opc_stvewx(PPC_CPU_State &aCPU)
 	PPC_OPC_TEMPL_X(aCPU.current_opc, vrS, rA, rB);
 	uint32 ea;
 	ea = ((rA?aCPU.gpr[rA]:0)+aCPU.gpr[rB]) & ~3;
-	ppc_write_effective_word(ea, VECT_W(aCPU.vr[vrS], (ea & 0xf) >> 2));
+	ppc_write_effective_word(aCPU, ea, VECT_W(aCPU.vr[vrS], (ea & 0xf) >> 2));
 }
 JITCFlow ppc_opc_gen_stvewx(JITC &jitc)
 {
 	ppc_opc_gen_check_vec(jitc);
 	int rA, vrS, rB;
-	byte modrm[6];
 	PPC_OPC_TEMPL_X(jitc.current_opc, vrS, rA, rB);
-
-	jitc.flushClientVectorRegister(vrS);
-	jitcAssertFlushedVectorRegister(vrS);
-
-	jitc.clobberCarryAndFlags();
-	NativeReg regA = ppc_opc_gen_helper_lvx(jitc, rA, rB, NATIVE_REG | RAX);
-	asmMOVDMemReg((uint32)&aCPU.vtemp, regA);
-	jitc.asmALU32(X86_AND, regA, 0x0c);
-	asmALUReg(X86_NOT, regA);
-
-	jitc.clobberAll();
-	if (regA != RAX) jitc.asmALU32(X86_MOV, RAX, regA);
-	jitc.asmALU32(X86_MOV, RSI, jitc.pc);
-
-	asmALURegMem(X86_MOV, EDX, modrm,
-		x86_mem(modrm, RAX, ((uint32)&aCPU.vr[vrS])+13));
-
-	asmMOVRegDMem(RAX, (uint32)&aCPU.vtemp);
-	jitc.asmALU32(X86_AND, RAX, ~0x3);
-
-	jitc.asmCALL((NativeAddress)ppc_write_effective_word_asm);
-	return flowEndBlock;
+	ppc_opc_gen_store_vec_element(jitc, vrS, rA, rB, 4);
+	return flowContinue;
 }
 
 /*      dstst	   Data Stream Touch for Store
@@ -4093,4 +4202,3 @@ JITCFlow ppc_opc_gen_dss(JITC &jitc)
 	/* Since we are not emulating the cache, this is a nop */
 	return flowContinue;
 }
-#endif
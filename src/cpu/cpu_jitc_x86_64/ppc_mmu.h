@@ -39,6 +39,7 @@ int FASTCALL ppc_effective_to_physical(PPC_CPU_State &aCPU, uint32 addr, int fla
 int FASTCALL ppc_effective_to_physical_vm(PPC_CPU_State &aCPU, uint32 addr, int flags, uint32 &result);
 bool FASTCALL ppc_mmu_set_sdr1(PPC_CPU_State &aCPU, uint32 newval, bool quiesce);
 void ppc_mmu_tlb_invalidate(PPC_CPU_State &aCPU);
+void ppc_mmu_protect_code_page(PPC_CPU_State &aCPU, uint32 pa);
 
 int FASTCALL ppc_read_physical_dword(uint32 addr, uint64 &result);
 int FASTCALL ppc_read_physical_word(uint32 addr, uint32 &result);
@@ -68,6 +69,13 @@ bool FASTCALL ppc_mmu_page_create(PPC_CPU_State &aCPU, uint32 ea, uint32 pa);
 bool FASTCALL ppc_mmu_page_free(PPC_CPU_State &aCPU, uint32 ea);
 bool FASTCALL ppc_init_physical_memory(uint size);
 
+#define CPU_KEY_FASTMEM	"cpu_fastmem"
+
+bool ppc_fastmem_init(PPC_CPU_State &aCPU);
+void ppc_fastmem_protect_code_page(PPC_CPU_State &aCPU, uint32 pa);
+extern "C" void ppc_fastmem_invalidate(PPC_CPU_State *aCPU);
+extern "C" void ppc_fastmem_invalidate_page(PPC_CPU_State *aCPU, uint32 ea);
+
 /*
 pte: (page table entry)
 1st word:
@@ -166,6 +174,8 @@ void ppc_opc_dss(PPC_CPU_State &aCPU);
 
 #include "jitc_types.h"
 
+void ppc_opc_gen_check_code_destroyed(JITC &aJITC, PPC_Register cu = PPC_REG_NO);
+
 JITCFlow ppc_opc_gen_dcbz(JITC &aJITC);
 
 JITCFlow ppc_opc_gen_lbz(JITC &aJITC);
@@ -27,6 +27,9 @@
 #include "ppc_mmu.h"
 #include "ppc_opc.h"
 #include "ppc_dec.h"
+#include "ppc_esc.h"
+#include "ppc_fpu.h"
+#include "ppc_tools.h"
 
 #include "jitc.h"
 #include "jitc_asm.h"
@@ -45,7 +48,11 @@ static void FASTCALL writeDEC(PPC_CPU_State &aCPU, uint32 newdec)
 //	PPC_OPC_WARN("write dec=%08x\n", newdec);
 	if (!(aCPU.dec & 0x80000000) && (newdec & 0x80000000)) {
 		aCPU.dec = newdec;
-		sys_set_timer(gDECtimer, 0, 0, false);
+		if (gTSCTimebase) {
+			ppc_set_dec_deadline(0);
+		} else {
+			sys_set_timer(gDECtimer, 0, 0, false);
+		}
  	} else {
 		aCPU.dec = newdec;
 		/*
@@ -61,23 +68,60 @@ static void FASTCALL writeDEC(PPC_CPU_State &aCPU, uint32 newdec)
 			PPC_OPC_WARN("write dec > 20 millisec := %08x (%qu)\n", aCPU.dec, q);
 			q = 10 * 1000 * 1000;
 		}
-		sys_set_timer(gDECtimer, 0, q, false);
+		if (gTSCTimebase) {
+			// no syscall, see ppc_heartbeat_ext_asm
+			ppc_set_dec_deadline(q);
+		} else {
+			sys_set_timer(gDECtimer, 0, q, false);
+		}
 //		PPC_OPC_WARN("timer(%qu)\n", q);
 	}
+	ppc_calibrate_tsc_timebase();
 	gDECwriteValue = aCPU.dec;
 	gDECwriteITB = ppc_get_cpu_ideal_timebase();
+	ppc_set_cpu_dec_reference(gDECwriteValue, gDECwriteITB);
+}
+
+/*
+ *	RAX = t, see ppc_cpu.cc. Only if gTSCTimebase.
+ */
+static void ppc_opc_gen_tsc_elapsed(JITC &jitc)
+{
+	jitc.clobberCarryAndFlags();
+	jitc.allocRegister(NATIVE_REG | RAX);
+	jitc.allocRegister(NATIVE_REG | RDX);
+	jitc.asmSimple(X86_RDTSC);
+	jitc.asmShift64(X86_SHL, RDX, 32);
+	jitc.asmALU64(X86_OR, RAX, RDX);
+	jitc.asmALU64(X86_SUB, RAX, curCPU(tsc_base));
+	jitc.asmALU64(X86_MOV, RDX, curCPU(tsc_mul));
+	jitc.asmALU64(X86_MUL, RDX);
+	jitc.asmSHRD64(RAX, RDX, 32);
+}
+
+static void ppc_opc_gen_read_timebase(JITC &jitc, int rD, bool upper)
+{
+	if (gTSCTimebase) {
+		ppc_opc_gen_tsc_elapsed(jitc);
+		jitc.asmALU64(X86_ADD, RAX, curCPU(tb_offset));
+	} else {
+		jitc.clobberAll();
+		jitc.asmCALL((NativeAddress)ppc_get_cpu_timebase);
+	}
+	if (upper) jitc.asmShift64(X86_SHR, RAX, 32);
+	jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RAX);
 }
 
 static void FASTCALL writeTBL(PPC_CPU_State &aCPU, uint32 newtbl)
 {
 	uint64 tbBase = ppc_get_cpu_timebase();
-	aCPU.tb = (tbBase & 0xffffffff00000000ULL) | (uint64)newtbl;
+	ppc_set_cpu_timebase((tbBase & 0xffffffff00000000ULL) | (uint64)newtbl);
 }
 									
 static void FASTCALL writeTBU(PPC_CPU_State &aCPU, uint32 newtbu)
 {
 	uint64 tbBase = ppc_get_cpu_timebase();
-	aCPU.tb = ((uint64)newtbu << 32) | (tbBase & 0xffffffff);
+	ppc_set_cpu_timebase(((uint64)newtbu << 32) | (tbBase & 0xffffffff));
 }
 
 void ppc_set_msr(PPC_CPU_State &aCPU, uint32 newmsr)
@@ -88,7 +132,6 @@ void ppc_set_msr(PPC_CPU_State &aCPU, uint32 newmsr)
 			aCPU.ext_exception = true;
 		}
 	}*/
-	ppc_mmu_tlb_invalidate(aCPU);
 #ifndef PPC_CPU_ENABLE_SINGLESTEP
 	if (newmsr & MSR_SE) {
 		SINGLESTEP("");
@@ -105,7 +148,7 @@ void ppc_set_msr(PPC_CPU_State &aCPU, uint32 newmsr)
 		newmsr &= ~MSR_POW;
 	}
 	aCPU.msr = newmsr;
-	
+	ppc_mmu_tlb_invalidate(aCPU);
 }
 
 void ppc_opc_gen_check_privilege(JITC &jitc)
@@ -113,7 +156,7 @@ void ppc_opc_gen_check_privilege(JITC &jitc)
 	if (!jitc.checkedPriviledge) {
 		jitc.clobberCarryAndFlags();
 		jitc.floatRegisterClobberAll();
-//		jitc.flushVectorRegister(); FIXME64
+		jitc.flushVectorRegister();
 		NativeReg msr = jitc.getClientRegisterMapping(PPC_MSR);
 		if (msr == REG_NO) {
 			jitc.asmTEST32(curCPU(msr), MSR_PR);
@@ -131,10 +174,279 @@ void ppc_opc_gen_check_privilege(JITC &jitc)
 	}
 }
 
+/*
+ *	Branch to another page.
+ *
+ *	The branch is linked by ppc_new_pc_link_asm to jump directly
+ *	into the translated code of the target page. Since the
+ *	effective to physical mapping of the target may change, the
+ *	linked jump is guarded by a lookup in the code TLB, which
+ *	must yield the physical page we linked to. Everything else
+ *	goes through ppc_new_pc_link_asm again (and relinks).
+ *
+ *	If the target page is destroyed, jitcUnlinkClientPage
+ *	sets the physical page to LINK_UNLINKED, which never matches.
+ *
+ *	ea is relative to current_code_base if rel is set.
+ */
+static void ppc_opc_gen_set_pc_far(JITC &jitc, uint32 ea, bool rel)
+{
+	jitcProfileExit(jitc, true);
+	jitc.asmMOV32_NoFlags(RAX, ea);
+	if (rel) {
+		jitc.asmCALL((NativeAddress)ppc_heartbeat_ext_rel_asm);
+		jitc.asmALU32(X86_MOV, RAX, curCPU(current_code_base));
+		jitc.asmALU32(X86_ADD, RAX, ea & 0xfffff000);
+	} else {
+		jitc.asmCALL((NativeAddress)ppc_heartbeat_ext_asm);
+		jitc.asmALU32(X86_MOV, RAX, ea & 0xfffff000);
+	}
+	jitc.asmALU32(X86_MOV, RDX, RAX);
+	jitc.asmALU32(X86_MOV, RCX, RAX);
+	jitc.asmShift32(X86_SHR, RDX, 28);
+	jitc.asmALU64(X86_OR, RCX, curCPUsib(tlb_code_asid, 8, RDX));
+	jitc.asmALU32(X86_MOV, RDX, RAX);
+	jitc.asmShift32(X86_SHR, RDX, 12-TLB_SET_SHIFT);
+	jitc.asmALU32(X86_AND, RDX, TLB_SET_MASK);
+	jitc.asmALU64(X86_CMP, RCX, curCPUsib(tlb_code[0].tag, 1, RDX));
+	NativeAddress miss = jitc.asmJxxFixup(X86_NE);
+
+	/*
+	 *	This will be patched (see jitcNewPCLink),
+	 *	so it must not cross fragments.
+	 */
+	byte instr[49];
+	jitc.emitAssure(sizeof instr);
+	NativeAddress site = jitc.asmHERE() + sizeof instr - 8;
+
+	instr[0] = 0xb9;			// mov ecx, phys
+	*((uint32 *)&instr[1]) = LINK_UNLINKED;
+	instr[5] = 0x48;			// cmp rcx, [tlb_code[0].phys+rdx]
+	instr[6] = 0x3b;
+	instr[7] = 0x8c;
+	instr[8] = 0x14;
+	*((uint32 *)&instr[9]) = RSP_OFFSET + offsetof(PPC_CPU_State, tlb_code[0].phys);
+	instr[13] = 0x0f;			// jne slow
+	instr[14] = 0x85;
+	*((uint32 *)&instr[15]) = 7+5;
+	instr[19] = 0x89;			// mov [current_code_base], eax
+	instr[20] = 0x84;
+	instr[21] = 0x24;
+	*((uint32 *)&instr[22]) = RSP_OFFSET + offsetof(PPC_CPU_State, current_code_base);
+	instr[26] = 0xe9;			// jmp target
+	*((uint32 *)&instr[27]) = 0;
+	// slow:
+	instr[31] = 0xb8;			// mov eax, ea
+	*((uint32 *)&instr[32]) = ea;
+	instr[36] = 0xe8;			// call ppc_new_pc_link_(rel_)asm
+	*((uint32 *)&instr[37]) = (rel ? (NativeAddress)ppc_new_pc_link_rel_asm
+		: (NativeAddress)ppc_new_pc_link_asm) - site;
+	*((ClientPage **)&instr[41]) = jitc.currentPage;
+	jitc.emit(instr, sizeof instr);
+
+	jitc.asmResolveFixup(miss, site - 10);
+}
+
+/*
+ *	Registers read and written by an instruction of an idle
+ *	loop: bits 0-31 are the GPRs, bit 32 is XER[CA] and bits
+ *	33-40 are the CR fields. Returns false for instructions
+ *	which have side effects or aren't known.
+ */
+#define IDLE_CA		(1ULL << 32)
+#define IDLE_CR(crf)	(1ULL << (33 + (crf)))
+#define IDLE_GPR(r)	(1ULL << (r))
+
+static bool ppc_opc_idle_insn(uint32 opc, uint64 &r, uint64 &w)
+{
+	uint rD = (opc >> 21) & 31, rA = (opc >> 16) & 31, rB = (opc >> 11) & 31;
+	uint64 rA0 = rA ? IDLE_GPR(rA) : 0;
+	r = w = 0;
+	switch (PPC_OPC_MAIN(opc)) {
+	case 32:	// lwz
+	case 34:	// lbz
+	case 40:	// lhz
+	case 42:	// lha
+	case 14:	// addi
+		r = rA0; w = IDLE_GPR(rD);
+		return true;
+	case 10:	// cmpli
+	case 11:	// cmpi
+		r = IDLE_GPR(rA); w = IDLE_CR(rD >> 2);
+		return true;
+	case 28:	// andi.
+		r = IDLE_GPR(rD); w = IDLE_GPR(rA) | IDLE_CR(0);
+		return true;
+	case 21:	// rlwinmx
+		r = IDLE_GPR(rD); w = IDLE_GPR(rA);
+		if (opc & PPC_OPC_Rc) w |= IDLE_CR(0);
+		return true;
+	case 24:	// ori
+		if (rD == rA && !(opc & 0xffff)) return true;	// nop
+		r = IDLE_GPR(rD); w = IDLE_GPR(rA);
+		return true;
+	case 16:	// bcx, leaving the loop
+		if ((opc & PPC_OPC_LK) || !(rD & 4)) return false;
+		if (!(rD & 16)) r = IDLE_CR(rA >> 2);
+		return true;
+	case 19:
+		return PPC_OPC_EXT(opc) == 150;	// isync
+	case 31:
+		switch (PPC_OPC_EXT(opc)) {
+		case 23:	// lwzx
+		case 87:	// lbzx
+		case 279:	// lhzx
+		case 343:	// lhax
+			r = rA0 | IDLE_GPR(rB); w = IDLE_GPR(rD);
+			return true;
+		case 0:		// cmp
+		case 32:	// cmpl
+			r = IDLE_GPR(rA) | IDLE_GPR(rB); w = IDLE_CR(rD >> 2);
+			return true;
+		case 339:	// mfspr
+			if (rB != 8 || (rA != 12 && rA != 13)) return false;
+			// fall through, TBL or TBU
+		case 371:	// mftb
+			w = IDLE_GPR(rD);
+			return true;
+		case 136:	// subfex
+		case 138:	// addex
+			r = IDLE_CA;
+			// fall through
+		case 8:		// subfcx
+		case 10:	// addcx
+			w = IDLE_CA;
+			// fall through
+		case 40:	// subfx
+		case 266:	// addx
+			if (opc & PPC_OPC_OE) return false;
+			r |= IDLE_GPR(rA) | IDLE_GPR(rB);
+			w |= IDLE_GPR(rD);
+			if (opc & PPC_OPC_Rc) w |= IDLE_CR(0);
+			return true;
+		case 598:	// sync
+		case 854:	// eieio
+			return true;
+		}
+		return false;
+	}
+	return false;
+}
+
+/*
+ *	Checks whether the backward branch being translated closes
+ *	a loop which only waits: a few loads, compares and the like
+ *	starting at ofs, without stores, calls or SPR writes and
+ *	without a value carried from one iteration to the next.
+ *	Such a loop can only end by memory (written by DMA or an
+ *	interrupt handler), the timebase or an interrupt changing,
+ *	so the host may sleep in it (see ppc_cpu_idle_loop()).
+ */
+static bool ppc_opc_gen_idle_loop(JITC &jitc, uint32 ofs)
+{
+	uint32 opc = jitc.current_opc;
+	uint64 r, w;
+	if (opc & PPC_OPC_LK) return false;
+	if (jitc.pc - ofs > 8*4) return false;
+	if (PPC_OPC_MAIN(opc) == 16) {
+		if (!ppc_opc_idle_insn(opc, r, w)) return false;
+	} else {
+		r = 0;
+	}
+	uint64 branchReads = r;
+
+	byte *physpage;
+	ppc_direct_physical_memory_handle(jitc.currentPage->baseaddress, physpage);
+	uint64 loopWrites = 0;
+	for (uint32 i = ofs; i < jitc.pc; i += 4) {
+		if (!ppc_opc_idle_insn(ppc_word_from_BE(*(uint32 *)&physpage[i]), r, w)) return false;
+		loopWrites |= w;
+	}
+	uint64 written = 0;
+	for (uint32 i = ofs; i < jitc.pc; i += 4) {
+		ppc_opc_idle_insn(ppc_word_from_BE(*(uint32 *)&physpage[i]), r, w);
+		if (r & loopWrites & ~written) return false;
+		written |= w;
+	}
+	return !(branchReads & loopWrites & ~written);
+}
+
+/*
+ *	Recognizes the inner loops of byte, halfword and word copying
+ *	and filling routines (memcpy, bcopy, bzero, memset...) when
+ *	translating their bdnz:
+ *
+ *	loop:	lbzu	rT, 1(rS)	lhzu/lwzu, or backwards
+ *		stbu	rT, 1(rD)	with -1, -2 or -4
+ *		bdnz	loop
+ *
+ *	loop:	stbu	rV, 1(rD)	sthu/stwu, or backwards
+ *		bdnz	loop
+ *
+ *	Returns the descriptor for ppc_escape_block_loop() or 0.
+ */
+static int ppc_opc_block_loop_size(uint32 opc, bool store)
+{
+	switch (PPC_OPC_MAIN(opc)) {
+	case 35: return store ? -1 : 0;	// lbzu
+	case 41: return store ? -1 : 1;	// lhzu
+	case 33: return store ? -1 : 2;	// lwzu
+	case 39: return store ? 0 : -1;	// stbu
+	case 45: return store ? 1 : -1;	// sthu
+	case 37: return store ? 2 : -1;	// stwu
+	}
+	return -1;
+}
+
+static uint32 ppc_opc_gen_block_loop(JITC &jitc, uint32 ofs)
+{
+	if (ofs >= jitc.pc || jitc.pc - ofs > 2*4) return 0;
+	byte *physpage;
+	ppc_direct_physical_memory_handle(jitc.currentPage->baseaddress, physpage);
+	uint32 st = ppc_word_from_BE(*(uint32 *)&physpage[jitc.pc - 4]);
+	int size = ppc_opc_block_loop_size(st, true);
+	int rV, rD;
+	uint32 d;
+	PPC_OPC_TEMPL_D_SImm(st, rV, rD, d);
+	if (size < 0 || !rD || rV == rD) return 0;
+	uint32 desc;
+	if (d == uint32(1 << size)) {
+		desc = 0;
+	} else if (d == uint32(-(1 << size))) {
+		desc = PPC_ESC_LOOP_BACKWARDS;
+	} else {
+		return 0;
+	}
+	if (ofs == jitc.pc - 4) {
+		// fill
+		return desc | PPC_ESC_LOOP(rD, 0, rV, size);
+	}
+	uint32 ld = ppc_word_from_BE(*(uint32 *)&physpage[ofs]);
+	int rT, rS;
+	uint32 d2;
+	PPC_OPC_TEMPL_D_SImm(ld, rT, rS, d2);
+	if (ppc_opc_block_loop_size(ld, false) != size || d2 != d
+	 || rT != rV || !rS || rS == rD || rT == rS) return 0;
+	return desc | PPC_ESC_LOOP_COPY | PPC_ESC_LOOP(rD, rS, rT, size);
+}
+
 static inline void ppc_opc_gen_set_pc_rel(JITC &jitc, uint32 li)
 {
 	li += jitc.pc;
 	if (li < 4096) {		
+		if (jitc.superblock) {
+			if (li == jitc.superblockHead) jitcEmitSuperblockLoop(jitc);
+		} else if (li <= jitc.pc && jitc.superblockThreshold) {
+			// a loop, may become a superblock
+			jitcEmitTierCounter(jitc, li);
+		}
+		if (!jitc.superblock && li <= jitc.pc && jitc.idleDetect
+		 && ppc_opc_gen_idle_loop(jitc, li)) {
+			jitc.asmALU64(X86_LEA, RDI, curCPU(all));
+			jitc.asmMOV32_NoFlags(RSI, li);
+			jitc.asmCALL((NativeAddress)ppc_cpu_idle_loop);
+		}
+		jitcProfileExit(jitc, true);
 		jitc.asmMOV32_NoFlags(RAX, li);
 		jitc.asmCALL((NativeAddress)ppc_heartbeat_ext_rel_asm);
 		/*
@@ -144,11 +456,40 @@ static inline void ppc_opc_gen_set_pc_rel(JITC &jitc, uint32 li)
 		jitc.asmMOV32_NoFlags(RAX, li); // 5
 		jitc.asmCALL((NativeAddress)ppc_new_pc_this_page_asm); // 5
 	} else {
-		jitc.asmALU32(X86_MOV, RAX, li);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_rel_asm);
+		ppc_opc_gen_set_pc_far(jitc, li, true);
 	}
 }
 
+/*
+ *	While translating a superblock (see jitcTierUp()) unconditional
+ *	branches within the page are not translated but followed, so
+ *	registers and flags stay mapped across them.
+ */
+static inline bool ppc_opc_gen_follow(JITC &jitc, uint32 li)
+{
+	return jitc.superblock
+		&& !(jitc.current_opc & (PPC_OPC_AA | PPC_OPC_LK))
+		&& jitcSuperblockFollow(jitc, li + jitc.pc);
+}
+
+/*
+ *	Pushes the return address of a call onto the return stack
+ *	(see ppc_new_pc_return_asm). RAX must contain the new LR.
+ *
+ *	Returns a fixup which must be resolved to the native code
+ *	of the instruction following the call, so the caller must
+ *	return flowEndBlock.
+ */
+static NativeAddress ppc_opc_gen_push_return(JITC &jitc)
+{
+	jitc.asmALU32(X86_MOV, RDX, jitc.currentPage->baseaddress);
+	byte instr[7] = {0x48, 0x8d, 0x0d};	// lea rcx, [rip+rel32]
+	jitc.emit(instr, sizeof instr);
+	NativeAddress fixup = jitc.asmHERE() - 4;
+	jitc.asmCALL((NativeAddress)ppc_push_return_asm);
+	return fixup;
+}
+
 /*
  *	bx		Branch
  *	.435
@@ -170,21 +511,109 @@ JITCFlow ppc_opc_gen_bx(JITC &jitc)
 {
 	uint32 li;
 	PPC_OPC_TEMPL_I(jitc.current_opc, li);
+	if (ppc_opc_gen_follow(jitc, li)) return flowFollow;
 	jitc.clobberAll();
+	NativeAddress ret = NULL;
 	if (jitc.current_opc & PPC_OPC_LK) {
 		jitc.asmALU32(X86_MOV, RAX, curCPU(current_code_base));
 		jitc.asmALU32(X86_ADD, RAX, jitc.pc+4);
 		jitc.asmALU32(X86_MOV, curCPU(lr), RAX);
+		if (jitc.pc+4 < 4096) {
+			ret = ppc_opc_gen_push_return(jitc);
+		}
 	}
 	if (jitc.current_opc & PPC_OPC_AA) {
-		jitc.asmALU32(X86_MOV, RAX, li);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+		ppc_opc_gen_set_pc_far(jitc, li, false);
 	} else {
 		ppc_opc_gen_set_pc_rel(jitc, li);
 	}
+	if (ret) {
+		// translate the code the call returns to, too
+		jitc.asmResolveFixup(ret);
+		return flowEndBlock;
+	}
 	return flowEndBlockUnreachable;
 }
 
+/*
+ *	Returns true if the code at ofs (within the current page)
+ *	overwrites CR field crf before anything may read it. Only
+ *	follows a few instructions which are known not to read the
+ *	CR, everything else counts as a read.
+ *
+ *	An exception taken in between may see a stale field, but
+ *	the code it returns to doesn't use it.
+ */
+static bool ppc_opc_gen_cr_field_dead(JITC &jitc, uint32 ofs, uint crf)
+{
+	byte *physpage;
+	ppc_direct_physical_memory_handle(jitc.currentPage->baseaddress, physpage);
+	for (int i=0; i < 16 && ofs < 4096; i++, ofs += 4) {
+		uint32 opc = ppc_word_from_BE(*(uint32 *)&physpage[ofs]);
+		bool rc = opc & PPC_OPC_Rc;
+		switch (PPC_OPC_MAIN(opc)) {
+		case 10:	// cmpli
+		case 11:	// cmpi
+			if (((opc >> 23) & 7) == crf) return true;
+			continue;
+		case 13:	// addic.
+		case 28:	// andi.
+		case 29:	// andis.
+			if (crf == 0) return true;
+			continue;
+		case 20:	// rlwimix
+		case 21:	// rlwinmx
+		case 23:	// rlwnmx
+			if (rc && crf == 0) return true;
+			continue;
+		case 7:		// mulli
+		case 8:		// subfic
+		case 12:	// addic
+		case 14:	// addi
+		case 15:	// addis
+		case 24:	// ori
+		case 25:	// oris
+		case 26:	// xori
+		case 27:	// xoris
+			continue;
+		case 31:
+			switch (PPC_OPC_EXT(opc)) {
+			case 0:		// cmp
+			case 32:	// cmpl
+				if (((opc >> 23) & 7) == crf) return true;
+				continue;
+			case 150:	// stwcx.
+				if (crf == 0) return true;
+				continue;
+			case 8:	case 10: case 11: case 40: case 75: case 104:
+			case 136: case 138: case 200: case 202: case 232:
+			case 234: case 235: case 266: case 459: case 491:
+				// arithmetic without OE
+			case 24: case 26: case 28: case 60: case 124: case 284:
+			case 316: case 412: case 444: case 476: case 536:
+			case 792: case 824: case 922: case 954:
+				// logical and shifts
+				if (rc && crf == 0) return true;
+				continue;
+			case 23: case 55: case 87: case 119: case 151: case 183:
+			case 215: case 247: case 279: case 311: case 343: case 375:
+			case 407: case 439: case 534: case 662: case 790: case 918:
+				// indexed loads and stores
+				if (rc) return false;
+				continue;
+			}
+			return false;
+		default:
+			if (PPC_OPC_MAIN(opc) >= 32 && PPC_OPC_MAIN(opc) <= 55) {
+				// loads and stores
+				continue;
+			}
+			return false;
+		}
+	}
+	return false;
+}
+
 /*
  *	bcx		Branch Conditional
  *	.436
@@ -216,7 +645,7 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 	PPC_OPC_TEMPL_B(jitc.current_opc, BO, BI, BD);
 	NativeAddress fixup = NULL;
 	jitc.floatRegisterClobberAll();
-//	jitc.flushVectorRegister(); FIX64
+	jitc.flushVectorRegister();
 	if (!(BO & 16)) {
 		// only branch if condition
 		if (BO & 4) {
@@ -227,7 +656,24 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 				// and not SO flag (which isnt mapped)
 				jitc.clobberRegister(NATIVE_REG | RDI);
 				NativeAddress fixup2=NULL;
-				switch (BI%4) {
+				JITCFlagsType type = jitc.getFlagsType();
+				if (type != flagsResult) {
+					// flags of a compare: one condition per bit
+					X86FlagTest t;
+					switch (BI%4) {
+					case 0:
+						t = (type == flagsCmpSigned) ? X86_L : X86_B;
+						break;
+					case 1:
+						t = (type == flagsCmpSigned) ? X86_G : X86_A;
+						break;
+					default:
+						t = X86_E;
+						break;
+					}
+					// skip the branch if the condition doesn't hold
+					fixup = jitc.asmJxxFixup((BO & 8) ? X86FlagTest(t ^ 1) : t);
+				} else switch (BI%4) {
 				case 0:
 					// less than
 					fixup = jitc.asmJxxFixup((BO & 8) ? X86_NS : X86_S);
@@ -255,7 +701,10 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 				if (jitc.carryMapped()) {
 					jitc.asmSET8(X86_C, curCPU(xer_ca));
 				}
-				jitc.asmCALL((NativeAddress)ppc_flush_flags_asm);
+				if ((jitc.current_opc & PPC_OPC_AA)
+				 || !ppc_opc_gen_cr_field_dead(jitc, BD + jitc.pc, cr)) {
+					jitc.flushFlagsDirty();
+				}
 				jitc.flushRegisterDirty();
 				if (jitc.current_opc & PPC_OPC_LK) {
 					jitc.asmALU32(X86_MOV, RAX, curCPU(current_code_base));
@@ -263,8 +712,7 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 					jitc.asmALU32(X86_MOV, curCPU(lr), RAX);
 				}
 				if (jitc.current_opc & PPC_OPC_AA) {
-					jitc.asmALU32(X86_MOV, RAX, BD);
-					jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+					ppc_opc_gen_set_pc_far(jitc, BD, false);
 				} else {
 					ppc_opc_gen_set_pc_rel(jitc, BD);
 				}
@@ -272,6 +720,9 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 				if (fixup2) {
 					jitc.asmResolveFixup(fixup2, jitc.asmHERE());
 				}
+				if (ppc_opc_gen_cr_field_dead(jitc, jitc.pc + 4, cr)) {
+					jitc.discardFlags();
+				}
 				return flowContinue;
 			} else {
 				jitc.clobberCarryAndFlags();
@@ -294,8 +745,7 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 				jitc.asmALU32(X86_MOV, curCPU(lr), RAX);
 			}
 			if (jitc.current_opc & PPC_OPC_AA) {
-				jitc.asmALU32(X86_MOV, RAX, BD);
-				jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+				ppc_opc_gen_set_pc_far(jitc, BD, false);
 			} else {
 				ppc_opc_gen_set_pc_rel(jitc, BD);
 			}
@@ -307,6 +757,7 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 		// don't check condition
 		if (BO & 4) {
 			// always branch
+			if (ppc_opc_gen_follow(jitc, BD)) return flowFollow;
 			jitc.clobberCarryAndFlags();
 			jitc.flushRegister();
 			if (jitc.current_opc & PPC_OPC_LK) {
@@ -315,14 +766,21 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 				jitc.asmALU32(X86_MOV, curCPU(lr), RAX);
 			}
 			if (jitc.current_opc & PPC_OPC_AA) {
-				jitc.asmALU32(X86_MOV, RAX, BD);
-				jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+				ppc_opc_gen_set_pc_far(jitc, BD, false);
 		    	} else {
 				ppc_opc_gen_set_pc_rel(jitc, BD);
 			}
 			return flowEndBlockUnreachable;
 		} else {
 			// decrement ctr and branch on ctr
+			uint32 loop;
+			if (!(BO & 2) && !(jitc.current_opc & (PPC_OPC_AA | PPC_OPC_LK))
+			 && jitc.blockLoops && (loop = ppc_opc_gen_block_loop(jitc, BD + jitc.pc))) {
+				jitc.clobberAll();
+				jitc.asmALU64(X86_LEA, RDI, curCPU(all));
+				jitc.asmALU32(X86_MOV, RSI, loop);
+				jitc.asmCALL((NativeAddress)ppc_escape_block_loop);
+			}
 			jitc.clobberCarryAndFlags();
 			NativeReg ctr = jitc.getClientRegisterDirty(PPC_CTR);
 			jitc.asmDEC32(ctr);
@@ -336,8 +794,7 @@ JITCFlow ppc_opc_gen_bcx(JITC &jitc)
 		jitc.asmALU32(X86_MOV, curCPU(lr), RAX);
 	}
 	if (jitc.current_opc & PPC_OPC_AA) {
-		jitc.asmALU32(X86_MOV, RAX, BD);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+		ppc_opc_gen_set_pc_far(jitc, BD, false);
 	} else {
 		ppc_opc_gen_set_pc_rel(jitc, BD);
 	}
@@ -369,19 +826,31 @@ JITCFlow ppc_opc_gen_bcctrx(JITC &jitc)
 	uint32 BO, BI, BD;
 	PPC_OPC_TEMPL_XL(jitc.current_opc, BO, BI, BD);
 	jitc.floatRegisterClobberAll();
-//	jitc.flushVectorRegister(); FIXME64
+	jitc.flushVectorRegister();
 	if (BO & 16) {
 		// branch always
 		jitc.clobberCarryAndFlags();
 		jitc.flushRegister();
 		jitc.getClientRegister(PPC_CTR, NATIVE_REG | RAX);
+		NativeAddress ret = NULL;
 		if (jitc.current_opc & PPC_OPC_LK) {
 			jitc.asmALU32(X86_MOV, RCX, curCPU(current_code_base));
 			jitc.asmALU32(X86_ADD, RCX, jitc.pc+4);
 			jitc.asmALU32(X86_MOV, curCPU(lr), RCX);
+			if (jitc.pc+4 < 4096) {
+				jitc.asmALU32(X86_MOV, R9, RAX);
+				jitc.asmALU32(X86_MOV, RAX, RCX);
+				ret = ppc_opc_gen_push_return(jitc);
+				jitc.asmALU32(X86_MOV, RAX, R9);
+			}
 		}
 		jitc.asmALU32(X86_AND, RAX, 0xfffffffc);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+		jitc.asmJMP((NativeAddress)ppc_new_pc_cached_asm);
+		if (ret) {
+			// translate the code the call returns to, too
+			jitc.asmResolveFixup(ret);
+			return flowEndBlock;
+		}
 		return flowEndBlockUnreachable;
 	} else {
 		// test specific crX bit
@@ -396,7 +865,7 @@ JITCFlow ppc_opc_gen_bcctrx(JITC &jitc)
 			jitc.asmALU32(X86_MOV, curCPU(lr), RCX);
 		}
 		jitc.asmALU32(X86_AND, RAX, 0xfffffffc);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+		jitc.asmJMP((NativeAddress)ppc_new_pc_cached_asm);
 		jitc.asmResolveFixup(fixup, jitc.asmHERE());	
 		return flowContinue;
 	}
@@ -432,8 +901,10 @@ JITCFlow ppc_opc_gen_bclrx(JITC &jitc)
 	if (!(BO & 4)) {
 		PPC_OPC_ERR("not impl.: bclrx + BO&4\n");
 	}
+	// blrl is rather an indirect call than a return
+	void (*newPC)() = (jitc.current_opc & PPC_OPC_LK) ? ppc_new_pc_cached_asm : ppc_new_pc_return_asm;
 	jitc.floatRegisterClobberAll();
-//	jitc.flushVectorRegister(); FIX64
+	jitc.flushVectorRegister();
 	if (BO & 16) {
 		// branch always
 		jitc.clobberCarryAndFlags();
@@ -445,7 +916,7 @@ JITCFlow ppc_opc_gen_bclrx(JITC &jitc)
 			jitc.asmALU32(X86_MOV, curCPU(lr), RCX);
 		}
 		jitc.asmALU32(X86_AND, RAX, 0xfffffffc);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+		jitc.asmJMP((NativeAddress)newPC);
 		return flowEndBlockUnreachable;
 	} else {
 		jitc.clobberCarryAndFlags();
@@ -460,7 +931,7 @@ JITCFlow ppc_opc_gen_bclrx(JITC &jitc)
 			jitc.asmALU32(X86_MOV, curCPU(lr), RCX);
 		}
 		jitc.asmALU32(X86_AND, RAX, 0xfffffffc);
-		jitc.asmJMP((NativeAddress)ppc_new_pc_asm);
+		jitc.asmJMP((NativeAddress)newPC);
 		jitc.asmResolveFixup(fixup, jitc.asmHERE());
 		return flowContinue;
 	}
@@ -723,6 +1194,7 @@ void ppc_opc_mffsx(PPC_CPU_State &aCPU)
 	int frD, rA, rB;
 	PPC_OPC_TEMPL_X(aCPU.current_opc, frD, rA, rB);
 	PPC_OPC_ASSERT(rA==0 && rB==0);
+	ppc_fpu_sync_fpscr(aCPU);
 	aCPU.fpr[frD] = aCPU.fpscr;
 	if (aCPU.current_opc & PPC_OPC_Rc) {
 		// update cr1 flags
@@ -947,6 +1419,15 @@ JITCFlow ppc_opc_gen_mfspr(JITC &jitc)
 		case 18: move_reg(jitc, PPC_GPR(rD), PPC_DSISR); return flowContinue;
 		case 19: move_reg(jitc, PPC_GPR(rD), PPC_DAR); return flowContinue;
 		case 22: {
+			if (gTSCTimebase) {
+				// DEC = dec_offset - t
+				ppc_opc_gen_tsc_elapsed(jitc);
+				jitc.asmALU64(X86_NEG, RAX);
+				jitc.asmALU64(X86_ADD, RAX, curCPU(dec_offset));
+				jitc.asmALU32(X86_MOV, curCPU(dec), RAX);
+				jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RAX);
+				return flowContinue;
+			}
 			jitc.clobberAll();
 			jitc.asmALU64(X86_LEA, RDI, curCPU(all));			
 			jitc.asmCALL((NativeAddress)readDEC);
@@ -960,19 +1441,12 @@ JITCFlow ppc_opc_gen_mfspr(JITC &jitc)
 		break;
 	case 8:
 		switch (spr1) {
-		case 12: {
-			jitc.clobberAll();
-			jitc.asmCALL((NativeAddress)ppc_get_cpu_timebase);
-			jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RAX);
+		case 12:
+			ppc_opc_gen_read_timebase(jitc, rD, false);
 			return flowContinue;
-		}
-		case 13: {
-			jitc.clobberAll();
-			jitc.asmCALL((NativeAddress)ppc_get_cpu_timebase);
-			jitc.asmShift32(X86_SHR, RAX, 32);
-			jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RAX);
+		case 13:
+			ppc_opc_gen_read_timebase(jitc, rD, true);
 			return flowContinue;
-		}
 		case 16: move_reg(jitc, PPC_GPR(rD), PPC_SPRG(0)); return flowContinue;
 		case 17: move_reg(jitc, PPC_GPR(rD), PPC_SPRG(1)); return flowContinue;
 		case 18: move_reg(jitc, PPC_GPR(rD), PPC_SPRG(2)); return flowContinue;
@@ -1118,16 +1592,11 @@ JITCFlow ppc_opc_gen_mftb(JITC &jitc)
 	case 8:
 		switch (spr1) {
 		case 12:
-			jitc.clobberAll();
-			jitc.asmCALL((NativeAddress)ppc_get_cpu_timebase);
-			jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RAX);
+			ppc_opc_gen_read_timebase(jitc, rD, false);
 			return flowContinue;
 							
 		case 13:
-			jitc.clobberAll();
-			jitc.asmCALL((NativeAddress)ppc_get_cpu_timebase);
-			jitc.asmShift64(X86_SHR, RAX, 32);
-			jitc.mapClientRegisterDirty(PPC_GPR(rD), NATIVE_REG | RAX);
+			ppc_opc_gen_read_timebase(jitc, rD, true);
 			return flowContinue;
 		}
 		break;
@@ -1205,11 +1674,23 @@ static void ppc_opc_set_fpscr_roundmode(JITC &jitc, NativeReg r)
 // FIXME64
 }
 
+/*
+ *	Collects the exceptions the native floating point code
+ *	left in MXCSR before FPSCR is modified
+ */
+static void ppc_opc_gen_sync_fpscr(JITC &jitc)
+{
+	jitc.clobberAll();
+	jitc.asmALU64(X86_LEA, RDI, curCPU(all));
+	jitc.asmCALL((NativeAddress)ppc_fpu_sync_fpscr);
+}
+
 JITCFlow ppc_opc_gen_mtfsb0x(JITC &jitc)
 {
 	int crbD, n1, n2;
 	PPC_OPC_TEMPL_X(jitc.current_opc, crbD, n1, n2);
 	if (crbD != 1 && crbD != 2) {
+		ppc_opc_gen_sync_fpscr(jitc);
 		jitc.getClientRegister(PPC_FPSCR, NATIVE_REG | RAX);
 		jitc.clobberAll();
 		jitc.asmALU32(X86_AND, RAX, ~(1<<(31-crbD)));
@@ -1218,6 +1699,8 @@ JITCFlow ppc_opc_gen_mtfsb0x(JITC &jitc)
 			ppc_opc_set_fpscr_roundmode(jitc, RAX);
 		}
 	}
+	// FPSCR may have changed, recheck it before the next FP instruction
+	jitc.checkedFloat = false;
 	return flowContinue;
 }
 /*
@@ -1246,6 +1729,7 @@ JITCFlow ppc_opc_gen_mtfsb1x(JITC &jitc)
 	int crbD, n1, n2;
 	PPC_OPC_TEMPL_X(jitc.current_opc, crbD, n1, n2);
 	if (crbD != 1 && crbD != 2) {
+		ppc_opc_gen_sync_fpscr(jitc);
 		jitc.getClientRegister(PPC_FPSCR, NATIVE_REG | RAX);
 		jitc.clobberAll();
 		jitc.asmALU32(X86_OR, RAX, 1<<(31-crbD));
@@ -1254,6 +1738,7 @@ JITCFlow ppc_opc_gen_mtfsb1x(JITC &jitc)
 			ppc_opc_set_fpscr_roundmode(jitc, RAX);
 		}
 	}
+	jitc.checkedFloat = false;
 	return flowContinue;
 }
 /*
@@ -1286,6 +1771,7 @@ JITCFlow ppc_opc_gen_mtfsfx(JITC &jitc)
 	FM = ((fm&0x80)?0xf0000000:0)|((fm&0x40)?0x0f000000:0)|((fm&0x20)?0x00f00000:0)|((fm&0x10)?0x000f0000:0)|
 	     ((fm&0x08)?0x0000f000:0)|((fm&0x04)?0x00000f00:0)|((fm&0x02)?0x000000f0:0)|((fm&0x01)?0x0000000f:0);
 	     
+	ppc_opc_gen_sync_fpscr(jitc);
 	NativeReg fpscr = jitc.getClientRegister(PPC_FPSCR);
 	NativeReg b = jitc.getClientRegister(PPC_FPR(frB));
 	jitc.clobberAll();
@@ -1302,6 +1788,7 @@ JITCFlow ppc_opc_gen_mtfsfx(JITC &jitc)
 		// update cr1 flags
 		PPC_OPC_ERR("mtfsf. unimplemented.\n");
 	}
+	jitc.checkedFloat = false;
 	return flowContinue;
 }
 /*
@@ -1336,6 +1823,7 @@ JITCFlow ppc_opc_gen_mtfsfix(JITC &jitc)
 	crfD >>= 2;
 	imm >>= 1;
 	crfD = 7-crfD;
+	ppc_opc_gen_sync_fpscr(jitc);
 	NativeReg fpscr = jitc.getClientRegister(PPC_FPSCR);
 	jitc.clobberAll();
 	jitc.asmALU32(X86_AND, fpscr, ppc_cmp_and_mask[crfD]);
@@ -1350,6 +1838,7 @@ JITCFlow ppc_opc_gen_mtfsfix(JITC &jitc)
 		// update cr1 flags
 		PPC_OPC_ERR("mtfsfi. unimplemented.\n");
 	}
+	jitc.checkedFloat = false;
 	return flowContinue;
 }
 /*
@@ -1842,7 +2331,11 @@ JITCFlow ppc_opc_gen_mtsr(JITC &jitc)
 	move_reg(jitc, PPC_SR(SR & 0xf), PPC_GPR(rS));
 	jitc.clobberAll();
 	jitc.asmALU64(X86_LEA, RDI, curCPU(all));
-	jitc.asmCALL((NativeAddress)ppc_mmu_tlb_invalidate_all_asm);
+	jitc.asmCALL((NativeAddress)ppc_mmu_tlb_update_asid_asm);
+	if (jitc.fastmem) {
+		// RDI is still the cpu
+		jitc.asmCALL((NativeAddress)ppc_fastmem_invalidate);
+	}
 	// sync
 //	jitc.asmALU32(X86_MOV, EAX, jitc.pc+4);
 //	jitc.asmJMP((NativeAddress)ppc_new_pc_rel_asm);
@@ -1882,7 +2375,11 @@ JITCFlow ppc_opc_gen_mtsrin(JITC &jitc)
 	// mov [4*b+sr], s
 	jitc.asmALU32(X86_MOV, curCPUsib(sr, 4, b), s);
 	jitc.asmALU64(X86_LEA, RDI, curCPU(all));
-	jitc.asmCALL((NativeAddress)ppc_mmu_tlb_invalidate_all_asm);
+	jitc.asmCALL((NativeAddress)ppc_mmu_tlb_update_asid_asm);
+	if (jitc.fastmem) {
+		// RDI is still the cpu
+		jitc.asmCALL((NativeAddress)ppc_fastmem_invalidate);
+	}
 	// sync
 //	jitc.asmALU32(X86_MOV, EAX, jitc.pc+4);
 //	jitc.asmJMP((NativeAddress)ppc_new_pc_rel_asm);
@@ -1935,6 +2432,7 @@ JITCFlow ppc_opc_gen_sc(JITC &jitc)
 {
 	jitc.clobberCarryAndFlags();
 	jitc.flushRegister();	
+	jitc.flushVectorRegister();
 	
 	NativeReg r1 = jitc.getClientRegister(PPC_GPR(3));
 	jitc.asmALU32(X86_CMP, r1, 0x113724fa);
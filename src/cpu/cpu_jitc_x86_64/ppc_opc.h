@@ -40,6 +40,7 @@ static inline void ppc_update_cr0(PPC_CPU_State &aCPU, uint32 r)
 
 static UNUSED void ppc_opc_gen_interpret(JITC &jitc, ppc_opc_function func) 
 {
+	jitcProfileInterpreted(jitc);
 	jitc.clobberAll();
 	
 	jitc.asmALU64(X86_LEA, RDI, curCPU(all));
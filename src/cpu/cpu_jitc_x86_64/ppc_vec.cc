@@ -1,4 +1,3 @@
-#if 0
 /*
  *	PearPC
  *	ppc_vec.cc
@@ -38,28 +37,15 @@
 #define exp2(x)	pow(2, x)
 #endif /* HAS_EXP2 */
 
-#define ASSERT_FLUSHED(vrA)
-//#define ASSERT_FLUSHED(vrA)	jitcAssertFlushedVectorRegister(vrA)
-
 #include "debug/tracers.h"
 #include "ppc_cpu.h"
 #include "ppc_dec.h"
 #include "ppc_fpu.h"
+#include "ppc_opc.h"
 #include "ppc_vec.h"
 
 #define	SIGN32	0x80000000
 
-#define RL2RH(RL)	(NativeReg8)(RL+4)
-
-#define vrT	JITC_VECTOR_TEMP
-#define vrNEG1	JITC_VECTOR_NEG1
-
-static inline void commutative_operation(X86ALUPSopc opc, int vrD, int vrA, int vrB);
-static inline void noncommutative_operation(X86ALUPSopc opc, int vrD, int vrA, int vrB);
-
-static inline void commutative_operation(X86PALUopc opc, int vrD, int vrA, int vrB);
-static inline void noncommutative_operation(X86PALUopc opc, int vrD, int vrA, int vrB);
-
 /*	PACK_PIXEL	Packs a uint32 pixel to uint16 pixel
  *	v.219
  */
@@ -81,1150 +67,633 @@ static inline uint32 UNPACK_PIXEL(uint16 clr)
 		 (((clr) & 0x8000) ? 0xff000000 : 0));
 }
 
-static inline uint8 SATURATE_UB(uint16 val)
+static inline uint8 SATURATE_UB(PPC_CPU_State &aCPU, uint16 val)
 {
 	if (val & 0xff00) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0xff;
 	}
 	return val;
 }
-static inline uint8 SATURATE_0B(uint16 val)
+
+static inline uint8 SATURATE_0B(PPC_CPU_State &aCPU, uint16 val)
 {
 	if (val & 0xff00) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0;
 	}
 	return val;
 }
 
-static inline uint16 SATURATE_UH(uint32 val)
+static inline uint16 SATURATE_UH(PPC_CPU_State &aCPU, uint32 val)
 {
 	if (val & 0xffff0000) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0xffff;
 	}
 	return val;
 }
 
-static inline uint16 SATURATE_0H(uint32 val)
+static inline uint16 SATURATE_0H(PPC_CPU_State &aCPU, uint32 val)
 {
 	if (val & 0xffff0000) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0;
 	}
 	return val;
 }
 
-static inline sint8 SATURATE_SB(sint16 val)
+static inline sint8 SATURATE_SB(PPC_CPU_State &aCPU, sint16 val)
 {
 	if (val > 127) {			// 0x7F
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 127;
 	} else if (val < -128) {		// 0x80
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return -128;
 	}
 	return val;
 }
 
-static inline uint8 SATURATE_USB(sint16 val)
+static inline uint8 SATURATE_USB(PPC_CPU_State &aCPU, sint16 val)
 {
 	if (val > 0xff) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0xff;
 	} else if (val < 0) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0;
 	}
 	return (uint8)val;
 }
 
-static inline sint16 SATURATE_SH(sint32 val)
+static inline sint16 SATURATE_SH(PPC_CPU_State &aCPU, sint32 val)
 {
 	if (val > 32767) {			// 0x7fff
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 32767;
 	} else if (val < -32768) {		// 0x8000
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return -32768;
 	}
 	return val;
 }
 
-static inline uint16 SATURATE_USH(sint32 val)
+static inline uint16 SATURATE_USH(PPC_CPU_State &aCPU, sint32 val)
 {
 	if (val > 0xffff) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0xffff;
 	} else if (val < 0) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0;
 	}
 	return (uint16)val;
 }
 
-static inline sint32 SATURATE_UW(sint64 val)
+static inline sint32 SATURATE_UW(PPC_CPU_State &aCPU, sint64 val)
 {
 	if (val > 0xffffffffLL) {
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 0xffffffffLL;
 	}
 	return val;
 }
 
-static inline sint32 SATURATE_SW(sint64 val)
+static inline sint32 SATURATE_SW(PPC_CPU_State &aCPU, sint64 val)
 {
 	if (val > 2147483647LL) {			// 0x7fffffff
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return 2147483647LL;
 	} else if (val < -2147483648LL) {		// 0x80000000
-		gCPU.vscr |= VSCR_SAT;
+		aCPU.vscr |= VSCR_SAT;
 		return -2147483648LL;
 	}
 	return val;
 }
 
-static inline void vec_raise_saturate(void)
-{
-	asmOR(&gCPU.vscr, VSCR_SAT);
-}
-
-static inline void vec_saturateSB(NativeReg reg, NativeReg reg2)
-{
-	jitcClobberCarryAndFlags();
-
-	asmMOV_NoFlags(reg2, 0x7f);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip1 = asmJxxFixup(X86_G);
-
-	asmMOV_NoFlags(reg2, 0xffffff80);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip2 = asmJxxFixup(X86_L);
-
-	NativeAddress skip3 = asmJMPFixup();
-
-	asmResolveFixup(skip1);
-	asmResolveFixup(skip2);
-
-	asmALU(X86_MOV, reg, reg2);
-	vec_raise_saturate();
-
-	asmResolveFixup(skip3);
-}
-
-static inline void vec_saturateSUB(NativeReg reg, NativeReg reg2)
-{
-	jitcClobberCarryAndFlags();
-
-	asmMOV_NoFlags(reg2, 0xff);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip1 = asmJxxFixup(X86_G);
-
-	asmALU(X86_XOR, reg2, reg2);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip2 = asmJxxFixup(X86_L);
-
-	NativeAddress skip3 = asmJMPFixup();
-
-	asmResolveFixup(skip1);
-	asmResolveFixup(skip2);
-
-	asmALU(X86_MOV, reg, reg2);
-	vec_raise_saturate();
-
-	asmResolveFixup(skip3);
-}
-
-static inline void vec_saturateUB(NativeReg8 reg)
-{
-	jitcClobberCarryAndFlags();
-
-	asmALU(X86_CMP, (NativeReg)reg, 0xff);
-	NativeAddress skip1 = asmJxxFixup(X86_BE);
-
-	asmSET(X86_S, reg);
-	asmALU(X86_SUB, reg, 1);
-
-	vec_raise_saturate();
-
-	asmResolveFixup(skip1);
-}
-
-
-static inline void vec_saturateSH(NativeReg reg, NativeReg reg2)
-{
-	jitcClobberCarryAndFlags();
-
-	asmMOV_NoFlags(reg2, 0x7fff);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip1 = asmJxxFixup(X86_G);
-
-	asmMOV_NoFlags(reg2, 0xffff8000);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip2 = asmJxxFixup(X86_L);
-
-	NativeAddress skip3 = asmJMPFixup();
-
-	asmResolveFixup(skip1);
-	asmResolveFixup(skip2);
-
-	asmALU(X86_MOV, reg, reg2);
-	vec_raise_saturate();
-
-	asmResolveFixup(skip3);
-}
-
-static inline void vec_saturateSUH(NativeReg reg, NativeReg reg2)
-{
-	jitcClobberCarryAndFlags();
-
-	asmMOV_NoFlags(reg2, 0xffff);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip1 = asmJxxFixup(X86_G);
-
-	asmALU(X86_XOR, reg2, reg2);
-	asmALU(X86_CMP, reg, reg2);
-	NativeAddress skip2 = asmJxxFixup(X86_L);
-
-	NativeAddress skip3 = asmJMPFixup();
-
-	asmResolveFixup(skip1);
-	asmResolveFixup(skip2);
-
-	asmALU(X86_MOV, reg, reg2);
-	vec_raise_saturate();
-
-	asmResolveFixup(skip3);
-}
-
-static inline void vec_saturateUH(NativeReg8 reg)
-{
-	jitcClobberCarryAndFlags();
-
-	asmALU(X86_CMP, (NativeReg)reg, 0xffff);
-	NativeAddress skip1 = asmJxxFixup(X86_BE);
-
-	asmSET(X86_S, reg);
-	asmMOVxx(X86_MOVZX, (NativeReg)reg, reg);
-	asmALU(X86_SUB, (NativeReg)reg, 1);
-
-	vec_raise_saturate();
+#define CR_CR6		(0x00f0)
+#define CR_CR6_EQ	(1<<7)
+#define CR_CR6_NE_SOME	(1<<6)
+#define CR_CR6_NE	(1<<5)
+#define CR_CR6_EQ_SOME	(1<<4)
 
-	asmResolveFixup(skip1);
-}
+/*
+ *	Client vector registers are cached in XMM0-XMM15.
+ *	aCPU.vr isn't 16-byte aligned on the host stack, so all SSE
+ *	arithmetic is done register to register and loads/stores go
+ *	through MOVUPS (see loadVectorRegister()).
+ *
+ *	Whatever has no reasonable SSE2 equivalent is interpreted.
+ *	Vector instructions never change the program flow, so we can
+ *	continue the block after calling the interpreter.
+ */
 
-static inline void vec_getByte(NativeReg8 dest, int src, NativeReg r, int i)
+/*
+ *	Returns a temporary native vector register holding a copy of vr.
+ */
+static NativeVectorReg vec_temp_copy(JITC &jitc, int vr)
 {
-	modrm_o modrm;
-
-	ASSERT_FLUSHED(src);
-
-	asmALU(X86_MOV, dest, x86_mem2(modrm, r, &(gCPU.vr[src].b[i])));
+	NativeVectorReg s = jitc.getClientVectorRegister(vr);
+	NativeVectorReg t = jitc.allocVectorRegister();
+	jitc.asmALUPS(X86_MOVAPS, t, s);
+	return t;
 }
 
-static inline void vec_setByte(int dest, NativeReg r, int i, NativeReg8 src)
+static void vec_move(JITC &jitc, int vrD, int vrS)
 {
-	modrm_o modrm;
-
-	ASSERT_FLUSHED(dest);
-
-	asmALU(X86_MOV, x86_mem2(modrm, r, &(gCPU.vr[dest].b[i])), src);
+	if (vrD == vrS) return;
+	NativeVectorReg s = jitc.getClientVectorRegister(vrS);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmALUPS(X86_MOVAPS, d, s);
 }
 
-static inline void vec_getByteZ(NativeReg dest, int src, int i)
+/*
+ *	Fills all four words of d with val
+ */
+static void vec_load_constant(JITC &jitc, NativeVectorReg d, uint32 val)
 {
-	modrm_o modrm;
-
-	ASSERT_FLUSHED(src);
-
-	asmMOVxx_B(X86_MOVZX, dest, x86_mem2(modrm, &(gCPU.vr[src].b[i])));
+	if (val == 0) {
+		jitc.asmPALU(X86_PXOR, d, d);
+	} else if (val == 0xffffffff) {
+		jitc.asmPALU(PALUD(X86_PCMPEQ), d, d);
+	} else {
+		NativeReg r = jitc.allocRegister();
+		jitc.asmMOV32_NoFlags(r, val);
+		jitc.asmMOVD(d, r);
+		jitc.asmPSHUFD(d, d, 0x00);
+	}
 }
 
-static inline void vec_getByteS(NativeReg dest, int src, int i)
+/*
+ *	Prepares d = a op b as d op= s.
+ *	If vrD == vrB and the operation isn't commutative, d is a
+ *	temporary register, which has to be renamed to vrD afterwards.
+ */
+static NativeVectorReg vec_prepare_binary(JITC &jitc, NativeVectorReg &d, int vrD, int vrA, int vrB, bool commutative)
 {
-	modrm_o modrm;
-
-	ASSERT_FLUSHED(src);
-
-	asmMOVxx_B(X86_MOVSX, dest, x86_mem2(modrm, &(gCPU.vr[src].b[i])));
+	if (vrA == vrD) {
+		d = jitc.getClientVectorRegisterDirty(vrD);
+		return jitc.getClientVectorRegister(vrB);
+	}
+	if (vrB == vrD && commutative) {
+		d = jitc.getClientVectorRegisterDirty(vrD);
+		return jitc.getClientVectorRegister(vrA);
+	}
+	NativeVectorReg a = jitc.getClientVectorRegister(vrA);
+	NativeVectorReg s = jitc.getClientVectorRegister(vrB);
+	if (vrB == vrD) {
+		d = jitc.allocVectorRegister();
+	} else {
+		d = jitc.mapClientVectorRegisterDirty(vrD);
+	}
+	jitc.asmALUPS(X86_MOVAPS, d, a);
+	return s;
 }
 
-static inline void vec_getHalf(NativeReg16 dest, int src, int i)
+static void commutative_operation(JITC &jitc, X86ALUPSopc opc, int vrD, int vrA, int vrB)
 {
-	ASSERT_FLUSHED(src);
-
-	asmMOV(dest, &(gCPU.vr[src].b[i]));
+	NativeVectorReg d;
+	NativeVectorReg s = vec_prepare_binary(jitc, d, vrD, vrA, vrB, true);
+	jitc.asmALUPS(opc, d, s);
 }
 
-static inline void vec_setHalf(int dest, int i, NativeReg16 src)
+static void noncommutative_operation(JITC &jitc, X86ALUPSopc opc, int vrD, int vrA, int vrB)
 {
-	ASSERT_FLUSHED(dest);
-
-	asmMOV(&(gCPU.vr[dest].b[i]), src);
+	NativeVectorReg d;
+	NativeVectorReg s = vec_prepare_binary(jitc, d, vrD, vrA, vrB, false);
+	jitc.asmALUPS(opc, d, s);
+	if (vrB == vrD && vrA != vrD) jitc.renameVectorRegisterDirty(d, vrD);
 }
 
-static inline void vec_getHalfZ(NativeReg dest, int src, int i)
+static void commutative_operation(JITC &jitc, X86PALUopc opc, int vrD, int vrA, int vrB)
 {
-	modrm_o modrm;
-
-	ASSERT_FLUSHED(src);
-
-	asmMOVxx_W(X86_MOVZX, dest, x86_mem2(modrm, &(gCPU.vr[src].b[i])));
+	NativeVectorReg d;
+	NativeVectorReg s = vec_prepare_binary(jitc, d, vrD, vrA, vrB, true);
+	jitc.asmPALU(opc, d, s);
 }
 
-static inline void vec_getHalfS(NativeReg dest, int src, int i)
+static void noncommutative_operation(JITC &jitc, X86PALUopc opc, int vrD, int vrA, int vrB)
 {
-	modrm_o modrm;
-
-	ASSERT_FLUSHED(src);
-
-	asmMOVxx_W(X86_MOVSX, dest, x86_mem2(modrm, &(gCPU.vr[src].b[i])));
+	NativeVectorReg d;
+	NativeVectorReg s = vec_prepare_binary(jitc, d, vrD, vrA, vrB, false);
+	jitc.asmPALU(opc, d, s);
+	if (vrB == vrD && vrA != vrD) jitc.renameVectorRegisterDirty(d, vrD);
 }
 
-static inline void vec_getWord(NativeReg dest, int src, int i)
+static void vec_compare_fp(JITC &jitc, X86CMPPSPredicate pred, int vrD, int vrA, int vrB)
 {
-	ASSERT_FLUSHED(src);
-
-	asmMOV(dest, &(gCPU.vr[src].b[i]));
+	NativeVectorReg d;
+	NativeVectorReg s = vec_prepare_binary(jitc, d, vrD, vrA, vrB, false);
+	jitc.asmCMPPS(pred, d, s);
+	if (vrB == vrD && vrA != vrD) jitc.renameVectorRegisterDirty(d, vrD);
 }
 
-static inline void vec_setWord(int dest, int i, NativeReg src)
+/*
+ *	There is no unsigned PCMPGT, so flip the sign bits of both
+ *	operands and compare signed.
+ */
+static void vec_compare_unsigned(JITC &jitc, X86PALUopc opc, uint32 bias, int vrD, int vrA, int vrB)
 {
-	ASSERT_FLUSHED(dest);
-
-	asmMOV(&(gCPU.vr[dest].b[i]), src);
+	NativeVectorReg k = jitc.allocVectorRegister();
+	vec_load_constant(jitc, k, bias);
+	NativeVectorReg d = vec_temp_copy(jitc, vrA);
+	NativeVectorReg t = vec_temp_copy(jitc, vrB);
+	jitc.asmPALU(X86_PXOR, d, k);
+	jitc.asmPALU(X86_PXOR, t, k);
+	jitc.asmPALU(opc, d, t);
+	jitc.renameVectorRegisterDirty(d, vrD);
 }
 
-#define SSE_AVAIL	gJITC.hostCPUCaps.sse
-//#define SSE_AVAIL	0
-
-#define SSE2_AVAIL	gJITC.hostCPUCaps.sse2
-//#define SSE2_AVAIL	0
-
-#define SSE_NO		0
-#define SSE2_NO		0
-
-const static sint32 sint32_max = 2147483647;
-const static sint32 sint32_min = -2147483648;
-const static double uint32_max = 4294967295;
-const static uint32 uint32_min = 0;
-
-static inline void vec_Copy(int dest, int src)
+/*
+ *	Sets VSCR[SAT] unless all bytes of eq are 0xff,
+ *	eq being the comparison of the saturated with the modulo result.
+ */
+static void vec_check_saturation(JITC &jitc, NativeVectorReg eq)
 {
-	if (dest == src);
-
-	else if (SSE_AVAIL) {
-		NativeVectorReg reg = jitcMapClientVectorRegisterDirty(dest);
-		NativeVectorReg reg2 = jitcGetClientVectorRegisterMapping(src);
-
-		if (reg2 == VECTREG_NO)
-			asmMOVAPS(reg, &gCPU.vr[src]);
-		else
-			asmALUPS(X86_MOVAPS, reg, reg2);
-	} else {
-		jitcFlushClientVectorRegister(src);
-		jitcDropClientVectorRegister(dest);
-
-		NativeReg reg = jitcAllocRegister();
-
-		for (int i=0; i<16; i+=4) {
-			vec_getWord(reg, src, i);
-			vec_setWord(dest, i, reg);
-		}
-	}
+	jitc.clobberCarryAndFlags();
+	NativeReg r = jitc.allocRegister();
+	jitc.asmPMOVMSKB(r, eq);
+	jitc.asmALU32(X86_CMP, r, 0xffff);
+	NativeAddress fixup = jitc.asmJxxFixup(X86_E);
+	jitc.asmOR32(curCPU(vscr), VSCR_SAT);
+	jitc.asmResolveFixup(fixup);
 }
 
-static inline void vec_Zero(int dest)
+static void vec_saturating_operation(JITC &jitc, X86PALUopc opc, X86PALUopc modulo, int vrD, int vrA, int vrB)
 {
-	if (SSE_AVAIL) {
-		NativeVectorReg reg = jitcMapClientVectorRegisterDirty(dest);
-
-		asmALUPS(X86_XORPS, reg, reg);
-	} else {
-		jitcDropClientVectorRegister(dest);
-
-		NativeReg reg = jitcAllocRegister();
-
-		asmMOV_NoFlags(reg, 0);	// avoid flag clobber
-
-		vec_setWord(dest, 0, reg);
-		vec_setWord(dest, 4, reg);
-		vec_setWord(dest, 8, reg);
-		vec_setWord(dest,12, reg);
-	}
+	NativeVectorReg t = vec_temp_copy(jitc, vrA);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	jitc.asmPALU(modulo, t, b);
+	NativeVectorReg d = vec_temp_copy(jitc, vrA);
+	jitc.asmPALU(opc, d, b);
+	jitc.asmPALU(PALUB(X86_PCMPEQ), t, d);
+	jitc.renameVectorRegisterDirty(d, vrD);
+	vec_check_saturation(jitc, t);
 }
 
-static inline void vec_Neg1(int dest)
-{
-	if (SSE_AVAIL) {
-		NativeVectorReg reg = jitcMapClientVectorRegisterDirty(dest);
-		NativeVectorReg n1 = jitcGetClientVectorRegister(vrNEG1);
-
-		asmALUPS(X86_MOVAPS, reg, n1);
-	} else {
-		jitcDropClientVectorRegister(dest);
-
-		NativeReg reg = jitcAllocRegister();
-
-		asmMOV_NoFlags(reg, 0xffffffff);	// avoid flag clobber
-
-		vec_setWord(dest, 0, reg);
-		vec_setWord(dest, 4, reg);
-		vec_setWord(dest, 8, reg);
-		vec_setWord(dest,12, reg);
-	}
+/*
+ *	Sets CR6 from the result of a vector compare in vrD,
+ *	just like the interpreter does.
+ */
+static void vec_update_cr6(JITC &jitc, int vrD)
+{
+	jitc.clobberCarryAndFlags();
+	NativeVectorReg d = jitc.getClientVectorRegister(vrD);
+	NativeReg r = jitc.allocRegister();
+	NativeReg tf = jitc.allocRegister();
+	NativeReg t = jitc.allocRegister();
+	jitc.asmPMOVMSKB(r, d);
+	jitc.asmMOV32_NoFlags(tf, CR_CR6_EQ_SOME | CR_CR6_NE_SOME);
+	jitc.asmMOV32_NoFlags(t, CR_CR6_EQ | CR_CR6_EQ_SOME);
+	jitc.asmALU32(X86_CMP, r, 0xffff);
+	jitc.asmCMOV32(X86_E, tf, t);
+	jitc.asmMOV32_NoFlags(t, CR_CR6_NE | CR_CR6_NE_SOME);
+	jitc.asmALU32(X86_TEST, r, r);
+	jitc.asmCMOV32(X86_Z, tf, t);
+	jitc.asmAND32(curCPU(cr), ~CR_CR6);
+	jitc.asmALU32(X86_OR, curCPU(cr), tf);
 }
 
-static inline void vec_Not(int dest, int src)
+/*
+ *	Splats the 16-bit word w (host order) of s into all of d
+ */
+static void vec_splat_half(JITC &jitc, NativeVectorReg d, NativeVectorReg s, int w)
 {
-	if (SSE_AVAIL) {
-		NativeVectorReg reg1;
-		NativeVectorReg reg2;
-
-		if (src == dest) {
-			reg1 = jitcGetClientVectorRegisterDirty(dest);
-		} else  {
-			reg1 = jitcMapClientVectorRegisterDirty(dest);
-			reg2 = jitcGetClientVectorRegisterMapping(src);
-
-			if (reg2 == VECTREG_NO)	
-				asmMOVAPS(reg1, &gCPU.vr[src]);
-			else
-				asmALUPS(X86_MOVAPS, reg1, reg2);
-		}
-
-		reg2 = jitcGetClientVectorRegister(vrNEG1);
-
-		asmALUPS(X86_XORPS, reg1, reg2);
+	if (w < 4) {
+		jitc.asmPSHUFLW(d, s, w * 0x55);
+		jitc.asmPSHUFD(d, d, 0x00);
 	} else {
-		jitcFlushClientVectorRegister(src);
-		jitcDropClientVectorRegister(dest);
-
-		// according to documentation NOT does not effect flags!
-		NativeReg reg = jitcAllocRegister();
-
-		for (int i=0; i<16; i+=4) {
-			vec_getWord(reg, src, i);
-			asmALU(X86_NOT, reg);
-			vec_setWord(dest, i, reg);
-		}
+		jitc.asmPSHUFHW(d, s, (w - 4) * 0x55);
+		jitc.asmPSHUFD(d, d, 0xff);
 	}
 }
 
-static inline void vec_SelectiveLoadByte(X86FlagTest flags, NativeReg8 reg1, NativeReg reg2, int vrA, int vrB)
-{
-	modrm_o modrm;
-
-	NativeAddress skip = asmJxxFixup(flags);
-	asmALU(X86_MOV, (NativeReg)reg1,
-		x86_mem2(modrm, reg2, &(gCPU.vr[vrA].b[16])));
-
-	NativeAddress end = asmJMPFixup();
-
-	asmResolveFixup(skip);
-	asmALU(X86_MOV, (NativeReg)reg1,
-		x86_mem2(modrm, reg2, &(gCPU.vr[vrB].b[16])));
-
-	asmResolveFixup(end);
-}
-
-static inline void vec_PermuteQuad(NativeReg8 reg1, NativeReg reg2, NativeReg8 regT, NativeReg regA, NativeReg regB, int vrA, int vrB, int vrD, int i)
+/*
+ *	Sign extends one half of vrB by interleaving it with itself
+ *	and shifting it back arithmetically.
+ */
+static void vec_unpack_signed(JITC &jitc, X86PALUopc unpck, X86PShiftOpc sra, int bits, int vrD, int vrB)
 {
-	modrm_o modrm;
-
-	asmMOVxx(X86_MOVSX, regA, reg1);
-	asmMOVxx(X86_MOVSX, regB, RL2RH(reg1));
-
-	if (gJITC.hostCPUCaps.cmov) {
-		asmALU(X86_TEST, reg2, 0x10);
-		asmCMOV(X86_Z, (NativeReg)regT,
-			x86_mem2(modrm, regA, &(gCPU.vr[vrA].b[16])));
-		asmCMOV(X86_NZ, (NativeReg)regT,
-			x86_mem2(modrm, regA, &(gCPU.vr[vrB].b[16])));
-
-		vec_setByte(vrD, REG_NO, i, regT);
-
-		asmALU(X86_TEST, reg2, 0x1000);
-		asmCMOV(X86_Z, (NativeReg)regT,
-			x86_mem2(modrm, regB, &(gCPU.vr[vrA].b[16])));
-		asmCMOV(X86_NZ, (NativeReg)regT,
-			x86_mem2(modrm, regB, &(gCPU.vr[vrB].b[16])));
-
-		vec_setByte(vrD, REG_NO, i+1, regT);
-
-		asmShift(X86_SHR, (NativeReg)reg1, 16);
-
-		asmMOVxx(X86_MOVSX, regA, reg1);
-		asmMOVxx(X86_MOVSX, regB, RL2RH(reg1));
-
-		asmALU(X86_TEST, reg2, 0x100000);
-		asmCMOV(X86_Z, (NativeReg)regT,
-			x86_mem2(modrm, regA, &(gCPU.vr[vrA].b[16])));
-		asmCMOV(X86_NZ, (NativeReg)regT,
-			x86_mem2(modrm, regA, &(gCPU.vr[vrB].b[16])));
-
-		vec_setByte(vrD, REG_NO, i+2, regT);
-
-		asmALU(X86_TEST, reg2, 0x10000000);
-		asmCMOV(X86_Z, (NativeReg)regT,
-			x86_mem2(modrm, regB, &(gCPU.vr[vrA].b[16])));
-		asmCMOV(X86_NZ, (NativeReg)regT,
-			x86_mem2(modrm, regB, &(gCPU.vr[vrB].b[16])));
-
-		vec_setByte(vrD, REG_NO, i+3, regT);
-	} else {
-		asmALU(X86_TEST, reg2, 0x10);
-		vec_SelectiveLoadByte(X86_NZ, regT, regA, vrA, vrB);
-		vec_setByte(vrD, REG_NO, i, regT);
-
-		asmALU(X86_TEST, reg2, 0x1000);
-		vec_SelectiveLoadByte(X86_NZ, regT, regB, vrA, vrB);
-		vec_setByte(vrD, REG_NO, i+1, regT);
-
-		asmShift(X86_SHR, (NativeReg)reg1, 16);
-
-		asmMOVxx(X86_MOVSX, regA, reg1);
-		asmMOVxx(X86_MOVSX, regB, RL2RH(reg1));
-
-		asmALU(X86_TEST, reg2, 0x100000);
-		vec_SelectiveLoadByte(X86_NZ, regT, regA, vrA, vrB);
-		vec_setByte(vrD, REG_NO, i+2, regT);
-
-		asmALU(X86_TEST, reg2, 0x10000000);
-		vec_SelectiveLoadByte(X86_NZ, regT, regB, vrA, vrB);
-		vec_setByte(vrD, REG_NO, i+3, regT);
-	}
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	if (d != b) jitc.asmALUPS(X86_MOVAPS, d, b);
+	jitc.asmPALU(unpck, d, d);
+	jitc.asmPShift(sra, d, bits);
 }
 
 /*	vperm		Vector Permutation
  *	v.218
  */
-void ppc_opc_vperm()
+void ppc_opc_vperm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrA, vrB, vrC;
 	int sel;
 	Vector_t r;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 	for (int i=0; i<16; i++) {
-		sel = gCPU.vr[vrC].b[i];
+		sel = aCPU.vr[vrC].b[i];
 		if (sel & 0x10)
-			r.b[i] = VECT_B(gCPU.vr[vrB], sel & 0xf);
+			r.b[i] = VECT_B(aCPU.vr[vrB], sel & 0xf);
 		else
-			r.b[i] = VECT_B(gCPU.vr[vrA], sel & 0xf);
+			r.b[i] = VECT_B(aCPU.vr[vrA], sel & 0xf);
 	}
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vperm()
+JITCFlow ppc_opc_gen_vperm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vperm);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB, vrC, vrTMP;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcFlushClientVectorRegister(vrC);
-
-	jitcClobberCarryAndFlags();
-	NativeReg8 reg1 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-	NativeReg8 regT = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-	NativeReg reg2 = jitcAllocRegister();
-	NativeReg regA = jitcAllocRegister();
-	NativeReg regB = jitcAllocRegister();
-
-	vrTMP = ((vrD == vrA) || (vrD == vrB)) ? vrT : vrD;
-	jitcDropClientVectorRegister(vrTMP);
-
-	for (int i=0; i<16; i+=4) {
-		vec_getWord((NativeReg)reg1, vrC, i);
-
-		asmALU(X86_MOV, reg2, (NativeReg)reg1);
-
-		asmALU(X86_AND, (NativeReg)reg1, 0x0f0f0f0f);
-		asmALU(X86_NOT, (NativeReg)reg1);
-
-		// reg1 = original map (selector mask)
-		// reg2 = negative offsets - 1
-		// regT = spare use register (must be 8-bit)
-		// regA = spare use register
-		// regB = spare use register
-		vec_PermuteQuad(reg1, reg2, regT, regA, regB, vrA, vrB, vrTMP, i);
-	}
-
-	if (vrTMP == vrT) {
-		if (SSE_AVAIL) {
-			vec_Copy(vrD, vrT);
-		} else {
-			/* Since we already have a number of registers
-			 *   allocated, this is much faster than the non-SSE
-			 *   vec_Copy()
-			 */
-			jitcDropClientVectorRegister(vrD);
-
-			vec_getWord((NativeReg)reg1, vrT, 0);
-			vec_getWord(reg2, vrT, 4);
-			vec_getWord(regA, vrT, 8);
-			vec_getWord(regB, vrT,12);
-
-			vec_setWord(vrD, 0, (NativeReg)reg1);
-			vec_setWord(vrD, 4, reg2);
-			vec_setWord(vrD, 8, regA);
-			vec_setWord(vrD,12, regB);
-		}
+	if (!jitc.hostCPUCaps.ssse3) {
+		ppc_opc_gen_interpret(jitc, ppc_opc_vperm);
+		return flowContinue;
 	}
+	int vrD, vrA, vrB, vrC;
+	PPC_OPC_TEMPL_A(jitc.current_opc, vrD, vrA, vrB, vrC);
 
+	/*
+	 *	Element n is host byte 15-n, so PSHUFB wants ~sel & 0x0f.
+	 *	Bit 4 of sel then chooses between the shuffled vA and vB.
+	 */
+	NativeVectorReg a = jitc.getClientVectorRegister(vrA);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg c = jitc.getClientVectorRegister(vrC);
+	NativeVectorReg idx = jitc.allocVectorRegister();
+	NativeVectorReg t = jitc.allocVectorRegister();
+	vec_load_constant(jitc, t, 0x0f0f0f0f);
+	jitc.asmALUPS(X86_MOVAPS, idx, c);
+	jitc.asmPALU(X86_PANDN, idx, t);
+
+	NativeVectorReg ra = jitc.allocVectorRegister();
+	jitc.asmALUPS(X86_MOVAPS, ra, a);
+	jitc.asmPSHUFB(ra, idx);
+	NativeVectorReg rb = jitc.allocVectorRegister();
+	jitc.asmALUPS(X86_MOVAPS, rb, b);
+	jitc.asmPSHUFB(rb, idx);
+
+	jitc.asmALUPS(X86_MOVAPS, t, c);
+	jitc.asmPShift(X86_PSLLW, t, 3);
+	jitc.asmPALU(X86_PXOR, idx, idx);
+	jitc.asmPALU(PALUB(X86_PCMPGT), idx, t);
+
+	jitc.asmPALU(X86_PAND, rb, idx);
+	jitc.asmPALU(X86_PANDN, idx, ra);
+	jitc.asmPALU(X86_POR, idx, rb);
+	jitc.renameVectorRegisterDirty(idx, vrD);
 	return flowContinue;
-#endif
 }
 
 /*	vsel		Vector Select
  *	v.238
  */
-void ppc_opc_vsel()
+void ppc_opc_vsel(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	uint64 mask, val;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
-	mask = gCPU.vr[vrC].d[0];
-	val = gCPU.vr[vrB].d[0] & mask;
-	val |= gCPU.vr[vrA].d[0] & ~mask;
-	gCPU.vr[vrD].d[0] = val;
+	mask = aCPU.vr[vrC].d[0];
+	val = aCPU.vr[vrB].d[0] & mask;
+	val |= aCPU.vr[vrA].d[0] & ~mask;
+	aCPU.vr[vrD].d[0] = val;
 
-	mask = gCPU.vr[vrC].d[1];
-	val = gCPU.vr[vrB].d[1] & mask;
-	val |= gCPU.vr[vrA].d[1] & ~mask;
-	gCPU.vr[vrD].d[1] = val;
+	mask = aCPU.vr[vrC].d[1];
+	val = aCPU.vr[vrB].d[1] & mask;
+	val |= aCPU.vr[vrA].d[1] & ~mask;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vsel()
+JITCFlow ppc_opc_gen_vsel(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsel);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB, vrC;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(jitc.current_opc, vrD, vrA, vrB, vrC);
 
 	if (vrA == vrB) {
-		vec_Copy(vrD, vrB);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		modrm_o modrm;
-
-		/* We cannot use jitcMapClientVectorRegisterDirty(vrD) here,
-		 *	because if vrD == vrC
-		 */
-		NativeVectorReg d = jitcAllocVectorRegister();
-		NativeVectorReg c;
-
-		if (vrA == vrC) {
-			c = jitcGetClientVectorRegisterMapping(vrC);
-
-			if (c == VECTREG_NO) {
-				asmMOVAPS(d, &gCPU.vr[vrC]);
-			} else {
-				asmALUPS(X86_MOVAPS, d, c);
-			}
-		} else {
-			c = jitcGetClientVectorRegister(vrC);
-			jitcTrashVectorRegister(NATIVE_REG | c);
-
-			asmALUPS(X86_MOVAPS, d, c);
-		}
-
-		if (vrB != vrC) {
-			NativeVectorReg b = jitcGetClientVectorRegisterMapping(vrB);
-
-			if (b == VECTREG_NO) {
-				asmALUPS(X86_ANDPS, d,
-					x86_mem2(modrm, &gCPU.vr[vrB]));
-			} else
-				asmALUPS(X86_ANDPS, d, b);
-		}
-
-		if (vrA != vrC) {
-			NativeVectorReg a = jitcGetClientVectorRegisterMapping(vrA);
-
-			if (a == VECTREG_NO) {
-				asmALUPS(X86_ANDNPS, c,
-					x86_mem2(modrm, &gCPU.vr[vrA]));
-			} else
-				asmALUPS(X86_ANDNPS, c, a);
-
-			asmALUPS(X86_ORPS, d, c);
-		}
-
-		jitcRenameVectorRegisterDirty(d, vrD);
-
+		vec_move(jitc, vrD, vrB);
 		return flowContinue;
 	}
 
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcFlushClientVectorRegister(vrC);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-	modrm_o modrm;
-
-	for (int i=0; i<16; i+=4) {
-		vec_getWord(reg1, vrC, i);
-		asmALU(X86_MOV, reg2, reg1);
-		asmALU(X86_NOT, reg2);
-
-		asmALU(X86_AND, reg1, x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmALU(X86_AND, reg2, x86_mem2(modrm, &(gCPU.vr[vrA].b[i])));
-
-		asmALU(X86_OR, reg1, reg2);
-		vec_setWord(vrD, i, reg1);
-	}
-
+	NativeVectorReg a = jitc.getClientVectorRegister(vrA);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg c = jitc.getClientVectorRegister(vrC);
+	NativeVectorReg t = jitc.allocVectorRegister();
+	jitc.asmALUPS(X86_MOVAPS, t, c);
+	jitc.asmPALU(X86_PAND, t, b);
+	NativeVectorReg d = jitc.allocVectorRegister();
+	jitc.asmALUPS(X86_MOVAPS, d, c);
+	jitc.asmPALU(X86_PANDN, d, a);
+	jitc.asmPALU(X86_POR, d, t);
+	jitc.renameVectorRegisterDirty(d, vrD);
 	return flowContinue;
-#endif
 }
 
 /*	vsrb		Vector Shift Right Byte
  *	v.256
  */
-void ppc_opc_vsrb()
+void ppc_opc_vsrb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<16; i++) {
-		gCPU.vr[vrD].b[i] = gCPU.vr[vrA].b[i] >> (gCPU.vr[vrB].b[i] & 0x7);
+		aCPU.vr[vrD].b[i] = aCPU.vr[vrA].b[i] >> (aCPU.vr[vrB].b[i] & 0x7);
 	}
 }
-JITCFlow ppc_opc_gen_vsrb()
+JITCFlow ppc_opc_gen_vsrb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsrb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg8 reg = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg, vrA, REG_NO, i);
-		vec_getByte(CL, vrB, REG_NO, i);
-
-		asmALU(X86_AND, CL, 0x7);
-		asmShift_CL(X86_SHR, reg);
-
-		vec_setByte(vrD, REG_NO, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsrb);
 	return flowContinue;
-#endif
 }
 
 /*	vsrh		Vector Shift Right Half Word
  *	v.257
  */
-void ppc_opc_vsrh()
+void ppc_opc_vsrh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<8; i++) {
-		gCPU.vr[vrD].h[i] = gCPU.vr[vrA].h[i] >> (gCPU.vr[vrB].h[i] & 0xf);
+		aCPU.vr[vrD].h[i] = aCPU.vr[vrA].h[i] >> (aCPU.vr[vrB].h[i] & 0xf);
 	}
 }
-JITCFlow ppc_opc_gen_vsrh()
+JITCFlow ppc_opc_gen_vsrh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsrh);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg16 reg = (NativeReg16)jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getHalf(reg, vrA, i);
-		vec_getHalf(CX, vrB, i);
-
-		asmALU(X86_AND, CL, 0x0f);
-		asmShift_CL(X86_SHR, reg);
-
-		vec_setHalf(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsrh);
 	return flowContinue;
-#endif
 }
 
 /*	vsrw		Vector Shift Right Word
  *	v.259
  */
-void ppc_opc_vsrw()
+void ppc_opc_vsrw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<4; i++) {
-		gCPU.vr[vrD].w[i] = gCPU.vr[vrA].w[i] >> (gCPU.vr[vrB].w[i] & 0x1f);
+		aCPU.vr[vrD].w[i] = aCPU.vr[vrA].w[i] >> (aCPU.vr[vrB].w[i] & 0x1f);
 	}
 }
-JITCFlow ppc_opc_gen_vsrw()
+JITCFlow ppc_opc_gen_vsrw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsrw);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getWord(reg, vrA, i);
-		vec_getWord(ECX, vrB, i);
-
-		// this instruction auto-masks to 0x1f
-		asmShift_CL(X86_SHR, reg);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsrw);
 	return flowContinue;
-#endif
 }
 
 /*	vsrab		Vector Shift Right Arithmetic Byte
  *	v.253
  */
-void ppc_opc_vsrab()
+void ppc_opc_vsrab(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<16; i++) {
-		gCPU.vr[vrD].sb[i] = gCPU.vr[vrA].sb[i] >> (gCPU.vr[vrB].b[i] & 0x7);
+		aCPU.vr[vrD].sb[i] = aCPU.vr[vrA].sb[i] >> (aCPU.vr[vrB].b[i] & 0x7);
 	}
 }
-JITCFlow ppc_opc_gen_vsrab()
+JITCFlow ppc_opc_gen_vsrab(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsrab);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg8 reg = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg, vrA, REG_NO, i);
-		vec_getByte(CL, vrB, REG_NO, i);
-
-		asmALU(X86_AND, CL, 0x7);
-		asmShift_CL(X86_SAR, reg);
-
-		vec_setByte(vrD, REG_NO, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsrab);
 	return flowContinue;
-#endif
 }
 
 /*	vsrah		Vector Shift Right Arithmetic Half Word
  *	v.254
  */
-void ppc_opc_vsrah()
+void ppc_opc_vsrah(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<8; i++) {
-		gCPU.vr[vrD].sh[i] = gCPU.vr[vrA].sh[i] >> (gCPU.vr[vrB].h[i] & 0xf);
+		aCPU.vr[vrD].sh[i] = aCPU.vr[vrA].sh[i] >> (aCPU.vr[vrB].h[i] & 0xf);
 	}
 }
-JITCFlow ppc_opc_gen_vsrah()
+JITCFlow ppc_opc_gen_vsrah(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsrah);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg16 reg = (NativeReg16)jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getHalf(reg, vrA, i);
-		vec_getHalf(CX, vrB, i);
-
-		asmALU(X86_AND, CL, 0x0f);
-		asmShift_CL(X86_SAR, reg);
-
-		vec_setHalf(vrD, i, reg);
-	}
-
-	return flowContinue;
-#endif
-}
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsrah);
+	return flowContinue;
+}
 
 /*	vsraw		Vector Shift Right Arithmetic Word
  *	v.255
  */
-void ppc_opc_vsraw()
+void ppc_opc_vsraw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<4; i++) {
-		gCPU.vr[vrD].sw[i] = gCPU.vr[vrA].sw[i] >> (gCPU.vr[vrB].w[i] & 0x1f);
+		aCPU.vr[vrD].sw[i] = aCPU.vr[vrA].sw[i] >> (aCPU.vr[vrB].w[i] & 0x1f);
 	}
 }
-JITCFlow ppc_opc_gen_vsraw()
+JITCFlow ppc_opc_gen_vsraw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsraw);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getWord(reg, vrA, i);
-		vec_getWord(ECX, vrB, i);
-
-		// this instruction auto-masks to 0x1f
-		asmShift_CL(X86_SAR, reg);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsraw);
 	return flowContinue;
-#endif
 }
 
 /*	vslb		Vector Shift Left Byte
  *	v.240
  */
-void ppc_opc_vslb()
+void ppc_opc_vslb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<16; i++) {
-		gCPU.vr[vrD].b[i] = gCPU.vr[vrA].b[i] << (gCPU.vr[vrB].b[i] & 0x7);
+		aCPU.vr[vrD].b[i] = aCPU.vr[vrA].b[i] << (aCPU.vr[vrB].b[i] & 0x7);
 	}
 }
-JITCFlow ppc_opc_gen_vslb()
+JITCFlow ppc_opc_gen_vslb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vslb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg8 reg = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg, vrA, REG_NO, i);
-		vec_getByte(CL, vrB, REG_NO, i);
-
-		asmALU(X86_AND, CL, 0x7);
-		asmShift_CL(X86_SHL, reg);
-
-		vec_setByte(vrD, REG_NO, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vslb);
 	return flowContinue;
-#endif
 }
 
 /*	vslh		Vector Shift Left Half Word
  *	v.242
  */
-void ppc_opc_vslh()
+void ppc_opc_vslh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<8; i++) {
-		gCPU.vr[vrD].h[i] = gCPU.vr[vrA].h[i] << (gCPU.vr[vrB].h[i] & 0xf);
+		aCPU.vr[vrD].h[i] = aCPU.vr[vrA].h[i] << (aCPU.vr[vrB].h[i] & 0xf);
 	}
 }
-JITCFlow ppc_opc_gen_vslh()
+JITCFlow ppc_opc_gen_vslh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vslh);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg16 reg = (NativeReg16)jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getHalf(reg, vrA, i);
-		vec_getHalf(CX, vrB, i);
-
-		asmALU(X86_AND, CL, 0x0f);
-		asmShift_CL(X86_SHL, reg);
-
-		vec_setHalf(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vslh);
 	return flowContinue;
-#endif
 }
 
 /*	vslw		Vector Shift Left Word
  *	v.244
  */
-void ppc_opc_vslw()
+void ppc_opc_vslw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	for (int i=0; i<4; i++) {
-		gCPU.vr[vrD].w[i] = gCPU.vr[vrA].w[i] << (gCPU.vr[vrB].w[i] & 0x1f);
+		aCPU.vr[vrD].w[i] = aCPU.vr[vrA].w[i] << (aCPU.vr[vrB].w[i] & 0x1f);
 	}
 }
-JITCFlow ppc_opc_gen_vslw()
+JITCFlow ppc_opc_gen_vslw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vslw);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getWord(reg, vrA, i);
-		vec_getWord(ECX, vrB, i);
-
-		// this instruction auto-masks to 0x1f
-		asmShift_CL(X86_SHL, reg);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vslw);
 	return flowContinue;
-#endif
 }
 
 /*	vsr		Vector Shift Right
  *	v.251
  */
-void ppc_opc_vsr()
+void ppc_opc_vsr(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
 	int shift;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	/* Specs say that the low-order 3 bits of all byte elements in vB
 	 *   must be the same, or the result is undefined.  So we can just
 	 *   use the same low-order 3 bits for all of our shifts.
 	 */
-	shift = gCPU.vr[vrB].w[0] & 0x7;
+	shift = aCPU.vr[vrB].w[0] & 0x7;
 
-	r.d[0] = gCPU.vr[vrA].d[0] >> shift;
-	r.d[1] = gCPU.vr[vrA].d[1] >> shift;
+	r.d[0] = aCPU.vr[vrA].d[0] >> shift;
+	r.d[1] = aCPU.vr[vrA].d[1] >> shift;
 
-	VECT_D(r, 1) |= VECT_D(gCPU.vr[vrA], 0) << (64 - shift);
+	VECT_D(r, 1) |= VECT_D(aCPU.vr[vrA], 0) << (64 - shift);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vsr()
+JITCFlow ppc_opc_gen_vsr(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsr);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsr);
+	return flowContinue;
 }
 
 /*	vsro		Vector Shift Right Octet
  *	v.258
  */
-void ppc_opc_vsro()
+void ppc_opc_vsro(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
 	int shift, i;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	shift = (gCPU.vr[vrB].w[0] >> 3) & 0xf;
+	shift = (aCPU.vr[vrB].w[0] >> 3) & 0xf;
 #if HOST_ENDIANESS == HOST_ENDIANESS_LE
 	for (i=0; i<(16-shift); i++) {
-		r.b[i] = gCPU.vr[vrA].b[i+shift];
+		r.b[i] = aCPU.vr[vrA].b[i+shift];
 	}
 
 	for (; i<16; i++) {
@@ -1236,73 +705,73 @@ void ppc_opc_vsro()
 	}
 
 	for (; i<16; i++) {
-		r.b[i] = gCPU.vr[vrA].b[i-shift];
+		r.b[i] = aCPU.vr[vrA].b[i-shift];
 	}
 #else
 #error Endianess not supported!
 #endif
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vsro()
+JITCFlow ppc_opc_gen_vsro(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsro);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsro);
+	return flowContinue;
 }
 
 /*	vsl		Vector Shift Left
  *	v.239
  */
-void ppc_opc_vsl()
+void ppc_opc_vsl(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
 	int shift;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	/* Specs say that the low-order 3 bits of all byte elements in vB
 	 *   must be the same, or the result is undefined.  So we can just
 	 *   use the same low-order 3 bits for all of our shifts.
 	 */
-	shift = gCPU.vr[vrB].w[0] & 0x7;
+	shift = aCPU.vr[vrB].w[0] & 0x7;
 
-	r.d[0] = gCPU.vr[vrA].d[0] << shift;
-	r.d[1] = gCPU.vr[vrA].d[1] << shift;
+	r.d[0] = aCPU.vr[vrA].d[0] << shift;
+	r.d[1] = aCPU.vr[vrA].d[1] << shift;
 
-	VECT_D(r, 0) |= VECT_D(gCPU.vr[vrA], 1) >> (64 - shift);
+	VECT_D(r, 0) |= VECT_D(aCPU.vr[vrA], 1) >> (64 - shift);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vsl()
+JITCFlow ppc_opc_gen_vsl(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsl);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsl);
+	return flowContinue;
 }
 
 /*	vslo		Vector Shift Left Octet
  *	v.243
  */
-void ppc_opc_vslo()
+void ppc_opc_vslo(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
 	int shift, i;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	shift = (gCPU.vr[vrB].w[0] >> 3) & 0xf;
+	shift = (aCPU.vr[vrB].w[0] >> 3) & 0xf;
 #if HOST_ENDIANESS == HOST_ENDIANESS_LE
 	for (i=0; i<shift; i++) {
 		r.b[i] = 0;
 	}
 
 	for (; i<16; i++) {
-		r.b[i] = gCPU.vr[vrA].b[i-shift];
+		r.b[i] = aCPU.vr[vrA].b[i-shift];
 	}
 #elif HOST_ENDIANESS == HOST_ENDIANESS_BE
 	for (i=0; i<(16-shift); i++) {
-		r.b[i] = gCPU.vr[vrA].b[i+shift];
+		r.b[i] = aCPU.vr[vrA].b[i+shift];
 	}
 
 	for (; i<16; i++) {
@@ -1312,2606 +781,1269 @@ void ppc_opc_vslo()
 #error Endianess not supported!
 #endif
 
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vslo()
-{
-	ppc_opc_gen_interpret(ppc_opc_vslo);
-	return flowEndBlock;
-}
-
-static inline void ppc_opc_gen_helper_vsldoi_left(int vrA, int vrD, int shift, int pshift, NativeReg reg)
-{
-	for (int i=12; i>=shift; i-=4) {
-		vec_getWord(reg, vrA, i-shift);
-
-		vec_setWord(vrD, i, reg);
-	}
-
-	if (pshift) {
-		for (int i=shift+4-pshift; i>=shift; i--) {
-			vec_getByte((NativeReg8)reg, vrA, REG_NO, i-shift);
-
-			vec_setByte(vrD, REG_NO, i, (NativeReg8)reg);
-		}
-	}
+	aCPU.vr[vrD] = r;
 }
-
-static inline void ppc_opc_gen_helper_vsldoi_right(int vrB, int vrD, int shift, int ashift, int bshift, NativeReg reg)
+JITCFlow ppc_opc_gen_vslo(JITC &jitc)
 {
-	for (int i=0; i<bshift; i+=4) {
-		vec_getWord(reg, vrB, i+ashift);
-
-		vec_setWord(vrD, i, reg);
-	}
-
-	for (int i=bshift; i<shift; i++) {
-		vec_getByte((NativeReg8)reg, vrB, REG_NO, i+ashift);
-
-		vec_setByte(vrD, REG_NO, i, (NativeReg8)reg);
-	}
+	ppc_opc_gen_interpret(jitc, ppc_opc_vslo);
+	return flowContinue;
 }
 
 /*	vsldoi		Vector Shift Left Double by Octet Immediate
  *	v.241
  */
-void ppc_opc_vsldoi()
+void ppc_opc_vsldoi(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrA, vrB, shift, ashift;
 	int i;
 	Vector_t r;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, shift);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, shift);
 
 	shift &= 0xf;
 	ashift = 16 - shift;
 
 #if HOST_ENDIANESS == HOST_ENDIANESS_LE
 	for (i=0; i<shift; i++) {
-		r.b[i] = gCPU.vr[vrB].b[i+ashift];
+		r.b[i] = aCPU.vr[vrB].b[i+ashift];
 	}
 
 	for (; i<16; i++) {
-		r.b[i] = gCPU.vr[vrA].b[i-shift];
+		r.b[i] = aCPU.vr[vrA].b[i-shift];
 	}
 #elif HOST_ENDIANESS == HOST_ENDIANESS_BE
 	for (i=0; i<ashift; i++) {
-		r.b[i] = gCPU.vr[vrA].b[i+shift];
+		r.b[i] = aCPU.vr[vrA].b[i+shift];
 	}
 
 	for (; i<16; i++) {
-		r.b[i] = gCPU.vr[vrB].b[i-ashift];
+		r.b[i] = aCPU.vr[vrB].b[i-ashift];
 	}
 #else
 #error Endianess not supported!
 #endif
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vsldoi()
+JITCFlow ppc_opc_gen_vsldoi(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsldoi);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	int shift, ashift, pshift, bshift;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, shift);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
+	int vrD, vrA, vrB, shift;
+	PPC_OPC_TEMPL_A(jitc.current_opc, vrD, vrA, vrB, shift);
 
 	shift &= 0xf;
-	ashift = 16 - shift;
-	bshift = (shift & ~0x03);
-	pshift = shift & 0x03;
-
-	NativeReg reg = jitcAllocRegister(NATIVE_REG_8);
-
-	if ((vrD == vrA) && (vrD != vrB)) {
-		ppc_opc_gen_helper_vsldoi_left(vrA, vrD, shift, pshift, reg);
-
-		ppc_opc_gen_helper_vsldoi_right(vrB, vrD, shift, ashift, bshift, reg);
-
+	if (!shift) {
+		vec_move(jitc, vrD, vrA);
 		return flowContinue;
 	}
 
-	if (vrD == vrA) {
-		jitcDropClientVectorRegister(vrT);
-		ppc_opc_gen_helper_vsldoi_right(vrB, vrT, shift, ashift, bshift, reg);
-	} else {
-		ppc_opc_gen_helper_vsldoi_right(vrB, vrD, shift, ashift, bshift, reg);
-	}
-
-	ppc_opc_gen_helper_vsldoi_left(vrA, vrD, shift, pshift, reg);
-
-	if (vrD == vrA) {
-		for (int i=0; i<bshift; i+=4) {
-			vec_getWord(reg, vrT, i);
-			vec_setWord(vrD, i, reg);
-		}
-
-		for (int i=bshift; i<shift; i++) {
-			vec_getByte((NativeReg8)reg, vrT, REG_NO, i);
-			vec_setByte(vrD, REG_NO, i, (NativeReg8)reg);
-		}
-	}
-
+	NativeVectorReg t = vec_temp_copy(jitc, vrB);
+	jitc.asmPShift(X86_PSRLDQ, t, 16 - shift);
+	NativeVectorReg d = vec_temp_copy(jitc, vrA);
+	jitc.asmPShift(X86_PSLLDQ, d, shift);
+	jitc.asmPALU(X86_POR, d, t);
+	jitc.renameVectorRegisterDirty(d, vrD);
 	return flowContinue;
-#endif
 }
 
 /*	vrlb		Vector Rotate Left Byte
  *	v.234
  */
-void ppc_opc_vrlb()
+void ppc_opc_vrlb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, shift;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		shift = (gCPU.vr[vrB].b[i] & 0x7);
+		shift = (aCPU.vr[vrB].b[i] & 0x7);
 
-		r.b[i] = gCPU.vr[vrA].b[i] << shift;
-		r.b[i] |= gCPU.vr[vrA].b[i] >> (8 - shift);
+		r.b[i] = aCPU.vr[vrA].b[i] << shift;
+		r.b[i] |= aCPU.vr[vrA].b[i] >> (8 - shift);
 	}
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vrlb()
+JITCFlow ppc_opc_gen_vrlb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrlb);
-	return flowEndBlock;
-#else
-
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcAllocRegister(NATIVE_REG | ECX);
-	NativeReg8 reg = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg, vrA, REG_NO, i);
-		vec_getByte(CL, vrB, REG_NO, i);
-
-		asmShift_CL(X86_ROL, reg);
-
-		vec_setByte(vrD, REG_NO, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrlb);
 	return flowContinue;
-#endif
 }
 
 /*	vrlh		Vector Rotate Left Half Word
  *	v.235
  */
-void ppc_opc_vrlh()
+void ppc_opc_vrlh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, shift;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		shift = (gCPU.vr[vrB].h[i] & 0xf);
+		shift = (aCPU.vr[vrB].h[i] & 0xf);
 
-		r.h[i] = gCPU.vr[vrA].h[i] << shift;
-		r.h[i] |= gCPU.vr[vrA].h[i] >> (16 - shift);
+		r.h[i] = aCPU.vr[vrA].h[i] << shift;
+		r.h[i] |= aCPU.vr[vrA].h[i] >> (16 - shift);
 	}
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vrlh()
+JITCFlow ppc_opc_gen_vrlh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vrlh);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrlh);
+	return flowContinue;
 }
 
 /*	vrlw		Vector Rotate Left Word
  *	v.236
  */
-void ppc_opc_vrlw()
+void ppc_opc_vrlw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, shift;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		shift = (gCPU.vr[vrB].w[i] & 0x1F);
+		shift = (aCPU.vr[vrB].w[i] & 0x1F);
 
-		r.w[i] = gCPU.vr[vrA].w[i] << shift;
-		r.w[i] |= gCPU.vr[vrA].w[i] >> (32 - shift);
+		r.w[i] = aCPU.vr[vrA].w[i] << shift;
+		r.w[i] |= aCPU.vr[vrA].w[i] >> (32 - shift);
 	}
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vrlw()
+JITCFlow ppc_opc_gen_vrlw(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vrlw);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrlw);
+	return flowContinue;
 }
 
-/* With the merges, I just don't see any point in risking that a compiler
- *   might generate actual alu code to calculate anything when it's
- *   compile-time known.  Plus, it's easier to validate it like this.
- */
-
 /*	vmrghb		Vector Merge High Byte
  *	v.195
  */
-void ppc_opc_vmrghb()
+void ppc_opc_vmrghb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
-
-	VECT_B(r, 0) = VECT_B(gCPU.vr[vrA], 0);
-	VECT_B(r, 1) = VECT_B(gCPU.vr[vrB], 0);
-	VECT_B(r, 2) = VECT_B(gCPU.vr[vrA], 1);
-	VECT_B(r, 3) = VECT_B(gCPU.vr[vrB], 1);
-	VECT_B(r, 4) = VECT_B(gCPU.vr[vrA], 2);
-	VECT_B(r, 5) = VECT_B(gCPU.vr[vrB], 2);
-	VECT_B(r, 6) = VECT_B(gCPU.vr[vrA], 3);
-	VECT_B(r, 7) = VECT_B(gCPU.vr[vrB], 3);
-	VECT_B(r, 8) = VECT_B(gCPU.vr[vrA], 4);
-	VECT_B(r, 9) = VECT_B(gCPU.vr[vrB], 4);
-	VECT_B(r,10) = VECT_B(gCPU.vr[vrA], 5);
-	VECT_B(r,11) = VECT_B(gCPU.vr[vrB], 5);
-	VECT_B(r,12) = VECT_B(gCPU.vr[vrA], 6);
-	VECT_B(r,13) = VECT_B(gCPU.vr[vrB], 6);
-	VECT_B(r,14) = VECT_B(gCPU.vr[vrA], 7);
-	VECT_B(r,15) = VECT_B(gCPU.vr[vrB], 7);
-
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vmrghb()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmrghb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUB(X86_PUNPCKH), vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg8 reg1 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-	NativeReg8 reg2 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 8);
-	vec_getHalf((NativeReg16)reg2, vrA, 8);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 0, (NativeReg16)reg1);
-	vec_setHalf(vrD, 2, (NativeReg16)reg2);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 10);
-	vec_getHalf((NativeReg16)reg2, vrA, 10);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 4, (NativeReg16)reg1);
-	vec_setHalf(vrD, 6, (NativeReg16)reg2);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 12);
-	vec_getHalf((NativeReg16)reg2, vrA, 12);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 8, (NativeReg16)reg1);
-	vec_setHalf(vrD, 10, (NativeReg16)reg2);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 14);
-	vec_getHalf((NativeReg16)reg2, vrA, 14);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 12, (NativeReg16)reg1);
-	vec_setHalf(vrD, 14, (NativeReg16)reg2);
-
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
+
+	VECT_B(r, 0) = VECT_B(aCPU.vr[vrA], 0);
+	VECT_B(r, 1) = VECT_B(aCPU.vr[vrB], 0);
+	VECT_B(r, 2) = VECT_B(aCPU.vr[vrA], 1);
+	VECT_B(r, 3) = VECT_B(aCPU.vr[vrB], 1);
+	VECT_B(r, 4) = VECT_B(aCPU.vr[vrA], 2);
+	VECT_B(r, 5) = VECT_B(aCPU.vr[vrB], 2);
+	VECT_B(r, 6) = VECT_B(aCPU.vr[vrA], 3);
+	VECT_B(r, 7) = VECT_B(aCPU.vr[vrB], 3);
+	VECT_B(r, 8) = VECT_B(aCPU.vr[vrA], 4);
+	VECT_B(r, 9) = VECT_B(aCPU.vr[vrB], 4);
+	VECT_B(r,10) = VECT_B(aCPU.vr[vrA], 5);
+	VECT_B(r,11) = VECT_B(aCPU.vr[vrB], 5);
+	VECT_B(r,12) = VECT_B(aCPU.vr[vrA], 6);
+	VECT_B(r,13) = VECT_B(aCPU.vr[vrB], 6);
+	VECT_B(r,14) = VECT_B(aCPU.vr[vrA], 7);
+	VECT_B(r,15) = VECT_B(aCPU.vr[vrB], 7);
+
+	aCPU.vr[vrD] = r;
+}
+JITCFlow ppc_opc_gen_vmrghb(JITC &jitc)
+{
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUB(X86_PUNPCKH), vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vmrghh		Vector Merge High Half Word
  *	v.196
  */
-void ppc_opc_vmrghh()
+void ppc_opc_vmrghh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = VECT_H(gCPU.vr[vrA], 0);
-	VECT_H(r, 1) = VECT_H(gCPU.vr[vrB], 0);
-	VECT_H(r, 2) = VECT_H(gCPU.vr[vrA], 1);
-	VECT_H(r, 3) = VECT_H(gCPU.vr[vrB], 1);
-	VECT_H(r, 4) = VECT_H(gCPU.vr[vrA], 2);
-	VECT_H(r, 5) = VECT_H(gCPU.vr[vrB], 2);
-	VECT_H(r, 6) = VECT_H(gCPU.vr[vrA], 3);
-	VECT_H(r, 7) = VECT_H(gCPU.vr[vrB], 3);
+	VECT_H(r, 0) = VECT_H(aCPU.vr[vrA], 0);
+	VECT_H(r, 1) = VECT_H(aCPU.vr[vrB], 0);
+	VECT_H(r, 2) = VECT_H(aCPU.vr[vrA], 1);
+	VECT_H(r, 3) = VECT_H(aCPU.vr[vrB], 1);
+	VECT_H(r, 4) = VECT_H(aCPU.vr[vrA], 2);
+	VECT_H(r, 5) = VECT_H(aCPU.vr[vrB], 2);
+	VECT_H(r, 6) = VECT_H(aCPU.vr[vrA], 3);
+	VECT_H(r, 7) = VECT_H(aCPU.vr[vrB], 3);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vmrghh()
+JITCFlow ppc_opc_gen_vmrghh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmrghh);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUW(X86_PUNPCKH), vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg16 reg1 = (NativeReg16)jitcAllocRegister();
-
-	vec_getHalf(reg1, vrB, 8);
-	vec_setHalf(vrD, 0, reg1);
-	vec_getHalf(reg1, vrB, 10);
-	vec_setHalf(vrD, 4, reg1);
-
-	vec_getHalf(reg1, vrA, 8);
-	vec_setHalf(vrD, 2, reg1);
-	vec_getHalf(reg1, vrA, 10);
-	vec_setHalf(vrD, 6, reg1);
-
-	vec_getHalf(reg1, vrB, 12);
-	vec_setHalf(vrD, 8, reg1);
-
-	vec_getHalf(reg1, vrA, 12);
-	vec_setHalf(vrD, 10, reg1);
-
-	vec_getHalf(reg1, vrB, 14);
-	vec_setHalf(vrD, 12, reg1);
-
-	if (vrD != vrA) {
-		vec_getHalf(reg1, vrA, 14);
-		vec_setHalf(vrD, 14, reg1);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUW(X86_PUNPCKH), vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vmrghw		Vector Merge High Word
  *	v.197
  */
-void ppc_opc_vmrghw()
+void ppc_opc_vmrghw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_W(r, 0) = VECT_W(gCPU.vr[vrA], 0);
-	VECT_W(r, 1) = VECT_W(gCPU.vr[vrB], 0);
-	VECT_W(r, 2) = VECT_W(gCPU.vr[vrA], 1);
-	VECT_W(r, 3) = VECT_W(gCPU.vr[vrB], 1);
+	VECT_W(r, 0) = VECT_W(aCPU.vr[vrA], 0);
+	VECT_W(r, 1) = VECT_W(aCPU.vr[vrB], 0);
+	VECT_W(r, 2) = VECT_W(aCPU.vr[vrA], 1);
+	VECT_W(r, 3) = VECT_W(aCPU.vr[vrB], 1);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vmrghw()
+JITCFlow ppc_opc_gen_vmrghw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmrghw);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUD(X86_PUNPCKH), vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		NativeVectorReg dest, src;
-		int shuf_map = 0x72;
-		int vrS = vrB;
-
-		if (vrA == vrD) {
-			dest = jitcGetClientVectorRegisterDirty(vrA);
-			src = jitcGetClientVectorRegisterMapping(vrB);
-		} else if (vrB == vrD) {
-			dest = jitcGetClientVectorRegisterDirty(vrB);
-			src = jitcGetClientVectorRegisterMapping(vrA);
-			shuf_map = 0xd8;
-			vrS = vrA;
-		} else {
-			dest = jitcMapClientVectorRegisterDirty(vrD);
-			src = jitcGetClientVectorRegisterMapping(vrA);
-
-			if (src == VECTREG_NO)
-				asmMOVAPS(dest, &gCPU.vr[vrA]);
-			else
-				asmALUPS(X86_MOVAPS, dest, src);
-
-			src = jitcGetClientVectorRegisterMapping(vrB);
-		}
-
-		if (src == VECTREG_NO) {
-			asmSHUFPS(dest, x86_mem2(modrm, &gCPU.vr[vrS]), 0xee);
-		} else {
-			asmSHUFPS(dest, src, 0xee);
-		}
-
-		asmSHUFPS(dest, dest, shuf_map);
-
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg reg = jitcAllocRegister();
-	JitcVectorReg vrTMP = vrD;
-
-	if (vrA == vrD || vrB == vrD) {
-		vrTMP = vrT;
-	}
-
-	vec_getWord(reg, vrA, 12);
-	vec_setWord(vrTMP, 12, reg);
-
-	vec_getWord(reg, vrB, 12);
-	vec_setWord(vrTMP, 8, reg);
-
-	vec_getWord(reg, vrA, 8);
-	vec_setWord(vrTMP, 4, reg);
-
-	vec_getWord(reg, vrB, 8);
-	vec_setWord(vrTMP, 0, reg);
-
-	vec_Copy(vrD, vrTMP);
-	
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUD(X86_PUNPCKH), vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vmrglb		Vector Merge Low Byte
  *	v.198
  */
-void ppc_opc_vmrglb()
+void ppc_opc_vmrglb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
-
-	VECT_B(r, 0) = VECT_B(gCPU.vr[vrA], 8);
-	VECT_B(r, 1) = VECT_B(gCPU.vr[vrB], 8);
-	VECT_B(r, 2) = VECT_B(gCPU.vr[vrA], 9);
-	VECT_B(r, 3) = VECT_B(gCPU.vr[vrB], 9);
-	VECT_B(r, 4) = VECT_B(gCPU.vr[vrA],10);
-	VECT_B(r, 5) = VECT_B(gCPU.vr[vrB],10);
-	VECT_B(r, 6) = VECT_B(gCPU.vr[vrA],11);
-	VECT_B(r, 7) = VECT_B(gCPU.vr[vrB],11);
-	VECT_B(r, 8) = VECT_B(gCPU.vr[vrA],12);
-	VECT_B(r, 9) = VECT_B(gCPU.vr[vrB],12);
-	VECT_B(r,10) = VECT_B(gCPU.vr[vrA],13);
-	VECT_B(r,11) = VECT_B(gCPU.vr[vrB],13);
-	VECT_B(r,12) = VECT_B(gCPU.vr[vrA],14);
-	VECT_B(r,13) = VECT_B(gCPU.vr[vrB],14);
-	VECT_B(r,14) = VECT_B(gCPU.vr[vrA],15);
-	VECT_B(r,15) = VECT_B(gCPU.vr[vrB],15);
-
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vmrglb()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmrglb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUB(X86_PUNPCKL), vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg8 reg1 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-	NativeReg8 reg2 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 6);
-	vec_getHalf((NativeReg16)reg2, vrA, 6);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 12, (NativeReg16)reg1);
-	vec_setHalf(vrD, 14, (NativeReg16)reg2);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 4);
-	vec_getHalf((NativeReg16)reg2, vrA, 4);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 8, (NativeReg16)reg1);
-	vec_setHalf(vrD, 10, (NativeReg16)reg2);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 2);
-	vec_getHalf((NativeReg16)reg2, vrA, 2);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 4, (NativeReg16)reg1);
-	vec_setHalf(vrD, 6, (NativeReg16)reg2);
-
-	vec_getHalf((NativeReg16)reg1, vrB, 0);
-	vec_getHalf((NativeReg16)reg2, vrA, 0);
-	asmALU(X86_XCHG, RL2RH(reg1), reg2);
-	vec_setHalf(vrD, 0, (NativeReg16)reg1);
-	vec_setHalf(vrD, 2, (NativeReg16)reg2);
-
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
+
+	VECT_B(r, 0) = VECT_B(aCPU.vr[vrA], 8);
+	VECT_B(r, 1) = VECT_B(aCPU.vr[vrB], 8);
+	VECT_B(r, 2) = VECT_B(aCPU.vr[vrA], 9);
+	VECT_B(r, 3) = VECT_B(aCPU.vr[vrB], 9);
+	VECT_B(r, 4) = VECT_B(aCPU.vr[vrA],10);
+	VECT_B(r, 5) = VECT_B(aCPU.vr[vrB],10);
+	VECT_B(r, 6) = VECT_B(aCPU.vr[vrA],11);
+	VECT_B(r, 7) = VECT_B(aCPU.vr[vrB],11);
+	VECT_B(r, 8) = VECT_B(aCPU.vr[vrA],12);
+	VECT_B(r, 9) = VECT_B(aCPU.vr[vrB],12);
+	VECT_B(r,10) = VECT_B(aCPU.vr[vrA],13);
+	VECT_B(r,11) = VECT_B(aCPU.vr[vrB],13);
+	VECT_B(r,12) = VECT_B(aCPU.vr[vrA],14);
+	VECT_B(r,13) = VECT_B(aCPU.vr[vrB],14);
+	VECT_B(r,14) = VECT_B(aCPU.vr[vrA],15);
+	VECT_B(r,15) = VECT_B(aCPU.vr[vrB],15);
+
+	aCPU.vr[vrD] = r;
+}
+JITCFlow ppc_opc_gen_vmrglb(JITC &jitc)
+{
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUB(X86_PUNPCKL), vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vmrglh		Vector Merge Low Half Word
  *	v.199
  */
-void ppc_opc_vmrglh()
+void ppc_opc_vmrglh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = VECT_H(gCPU.vr[vrA], 4);
-	VECT_H(r, 1) = VECT_H(gCPU.vr[vrB], 4);
-	VECT_H(r, 2) = VECT_H(gCPU.vr[vrA], 5);
-	VECT_H(r, 3) = VECT_H(gCPU.vr[vrB], 5);
-	VECT_H(r, 4) = VECT_H(gCPU.vr[vrA], 6);
-	VECT_H(r, 5) = VECT_H(gCPU.vr[vrB], 6);
-	VECT_H(r, 6) = VECT_H(gCPU.vr[vrA], 7);
-	VECT_H(r, 7) = VECT_H(gCPU.vr[vrB], 7);
+	VECT_H(r, 0) = VECT_H(aCPU.vr[vrA], 4);
+	VECT_H(r, 1) = VECT_H(aCPU.vr[vrB], 4);
+	VECT_H(r, 2) = VECT_H(aCPU.vr[vrA], 5);
+	VECT_H(r, 3) = VECT_H(aCPU.vr[vrB], 5);
+	VECT_H(r, 4) = VECT_H(aCPU.vr[vrA], 6);
+	VECT_H(r, 5) = VECT_H(aCPU.vr[vrB], 6);
+	VECT_H(r, 6) = VECT_H(aCPU.vr[vrA], 7);
+	VECT_H(r, 7) = VECT_H(aCPU.vr[vrB], 7);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vmrglh()
+JITCFlow ppc_opc_gen_vmrglh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmrglh);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUW(X86_PUNPCKL), vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg16 reg1 = (NativeReg16)jitcAllocRegister();
-
-	vec_getHalf(reg1, vrA, 6);
-	vec_setHalf(vrD, 14, reg1);
-	vec_getHalf(reg1, vrA, 4);
-	vec_setHalf(vrD, 10, reg1);
-
-	vec_getHalf(reg1, vrB, 6);
-	vec_setHalf(vrD, 12, reg1);
-	vec_getHalf(reg1, vrB, 4);
-	vec_setHalf(vrD, 8, reg1);
-
-	vec_getHalf(reg1, vrA, 2);
-	vec_setHalf(vrD, 6, reg1);
-
-	vec_getHalf(reg1, vrB, 2);
-	vec_setHalf(vrD, 4, reg1);
-
-	vec_getHalf(reg1, vrA, 0);
-	vec_setHalf(vrD, 2, reg1);
-
-	if (vrD != vrB) {
-		vec_getHalf(reg1, vrB, 0);
-		vec_setHalf(vrD, 0, reg1);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUW(X86_PUNPCKL), vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vmrglw		Vector Merge Low Word
  *	v.200
  */
-void ppc_opc_vmrglw()
+void ppc_opc_vmrglw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_W(r, 0) = VECT_W(gCPU.vr[vrA], 2);
-	VECT_W(r, 1) = VECT_W(gCPU.vr[vrB], 2);
-	VECT_W(r, 2) = VECT_W(gCPU.vr[vrA], 3);
-	VECT_W(r, 3) = VECT_W(gCPU.vr[vrB], 3);
+	VECT_W(r, 0) = VECT_W(aCPU.vr[vrA], 2);
+	VECT_W(r, 1) = VECT_W(aCPU.vr[vrB], 2);
+	VECT_W(r, 2) = VECT_W(aCPU.vr[vrA], 3);
+	VECT_W(r, 3) = VECT_W(aCPU.vr[vrB], 3);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vmrglw()
+JITCFlow ppc_opc_gen_vmrglw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmrglw);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUD(X86_PUNPCKL), vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		NativeVectorReg dest, src;
-		int shuf_map = 0x72;
-		int vrS = vrB;
-
-		if (vrA == vrD) {
-			dest = jitcGetClientVectorRegisterDirty(vrA);
-			src = jitcGetClientVectorRegisterMapping(vrB);
-		} else if (vrB == vrD) {
-			dest = jitcGetClientVectorRegisterDirty(vrB);
-			src = jitcGetClientVectorRegisterMapping(vrA);
-			shuf_map = 0xd8;
-			vrS = vrA;
-		} else {
-			dest = jitcGetClientVectorRegister(vrA);
-			jitcRenameVectorRegisterDirty(dest, vrD);
-
-			src = jitcGetClientVectorRegisterMapping(vrB);
-		}
-
-		if (src == VECTREG_NO) {
-			asmSHUFPS(dest, x86_mem2(modrm, &gCPU.vr[vrS]), 0x44);
-		} else {
-			asmSHUFPS(dest, src, 0x44);
-		}
-
-		asmSHUFPS(dest, dest, shuf_map);
-
-		return flowContinue;
-	}
-
-	NativeReg reg = jitcAllocRegister();
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	vec_getWord(reg, vrA, 4);
-	vec_setWord(vrD, 12, reg);
-
-	vec_getWord(reg, vrB, 4);
-	vec_setWord(vrD,  8, reg);
-
-	vec_getWord(reg, vrA, 0);
-	vec_setWord(vrD, 4, reg);
-
-	if (vrB != vrD) {
-		vec_getWord(reg, vrB, 0);
-		vec_setWord(vrD, 0, reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUD(X86_PUNPCKL), vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vspltb		Vector Splat Byte
  *	v.245
  */
-void ppc_opc_vspltb()
+void ppc_opc_vspltb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrB;
 	uint32 uimm;
 	uint64 val;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
 	/* The documentation doesn't stipulate what a value higher than 0xf
 	 *   will do.  Thus, this is by default an undefined value.  We
 	 *   are thus doing this the fastest way that won't crash us.
 	 */
-	val = VECT_B(gCPU.vr[vrB], uimm & 0xf);
+	val = VECT_B(aCPU.vr[vrB], uimm & 0xf);
 	val |= (val << 8);
 	val |= (val << 16);
 	val |= (val << 32);
 
-	gCPU.vr[vrD].d[0] = val;
-	gCPU.vr[vrD].d[1] = val;
+	aCPU.vr[vrD].d[0] = val;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vspltb()
+JITCFlow ppc_opc_gen_vspltb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vspltb);
-	return flowEndBlock;
-#else
 	int vrD, vrB;
 	uint32 uimm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, uimm, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister(NATIVE_REG_8);
-	NativeReg reg2 = jitcAllocRegister();
-
-	/* The documentation doesn't stipulate what a value higher than 0xf
-	 *   will do.  Thus, this is by default an undefined value.  We
-	 *   are thus doing this the fastest way that won't crash us.
-	 */
-	vec_getByteZ(reg1, vrB, (15 - (uimm & 0xf)));
-	asmALU(X86_MOV, RL2RH(reg1), (NativeReg8)reg1);
-
-	asmALU(X86_MOV, reg2, reg1);
-	asmShift(X86_SHL, reg2, 16);
-	asmALU(X86_OR, reg1, reg2);
-
-	vec_setWord(vrD,  0, reg1);
-	vec_setWord(vrD,  4, reg1);
-	vec_setWord(vrD,  8, reg1);
-	vec_setWord(vrD, 12, reg1);
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, uimm, vrB);
+
+	int n = 15 - (uimm & 0xf);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	if (d != b) jitc.asmALUPS(X86_MOVAPS, d, b);
+	if (n < 8) {
+		jitc.asmPALU(PALUB(X86_PUNPCKL), d, d);
+	} else {
+		jitc.asmPALU(PALUB(X86_PUNPCKH), d, d);
+	}
+	vec_splat_half(jitc, d, d, n & 7);
 	return flowContinue;
-#endif
 }
 
 /*	vsplth		Vector Splat Half Word
  *	v.246
  */
-void ppc_opc_vsplth()
+void ppc_opc_vsplth(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrB;
 	uint32 uimm;
 	uint64 val;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
 	/* The documentation doesn't stipulate what a value higher than 0x7
 	 *   will do.  Thus, this is by default an undefined value.  We
 	 *   are thus doing this the fastest way that won't crash us.
 	 */
-	val = VECT_H(gCPU.vr[vrB], uimm & 0x7);
+	val = VECT_H(aCPU.vr[vrB], uimm & 0x7);
 	val |= (val << 16);
 	val |= (val << 32);
 
-	gCPU.vr[vrD].d[0] = val;
-	gCPU.vr[vrD].d[1] = val;
+	aCPU.vr[vrD].d[0] = val;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vsplth()
+JITCFlow ppc_opc_gen_vsplth(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsplth);
-	return flowEndBlock;
-#else
 	int vrD, vrB;
 	uint32 uimm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, uimm, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	/* The documentation doesn't stipulate what a value higher than 0x7
-	 *   will do.  Thus, this is by default an undefined value.  We
-	 *   are thus doing this the fastest way that won't crash us.
-	 */
-	vec_getHalfZ(reg1, vrB, (7 - (uimm & 0x7)) << 1);
-
-	asmALU(X86_MOV, reg2, reg1);
-	asmShift(X86_SHL, reg2, 16);
-	asmALU(X86_OR, reg1, reg2);
-
-	vec_setWord(vrD,  0, reg1);
-	vec_setWord(vrD,  4, reg1);
-	vec_setWord(vrD,  8, reg1);
-	vec_setWord(vrD, 12, reg1);
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, uimm, vrB);
 
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	vec_splat_half(jitc, d, b, 7 - (uimm & 0x7));
 	return flowContinue;
-#endif
 }
 
 /*	vspltw		Vector Splat Word
  *	v.250
  */
-void ppc_opc_vspltw()
+void ppc_opc_vspltw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrB;
 	uint32 uimm;
 	uint64 val;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
 	/* The documentation doesn't stipulate what a value higher than 0x3
 	 *   will do.  Thus, this is by default an undefined value.  We
 	 *   are thus doing this the fastest way that won't crash us.
 	 */
-	val = VECT_W(gCPU.vr[vrB], uimm & 0x3);
+	val = VECT_W(aCPU.vr[vrB], uimm & 0x3);
 	val |= (val << 32);
 
-	gCPU.vr[vrD].d[0] = val;
-	gCPU.vr[vrD].d[1] = val;
+	aCPU.vr[vrD].d[0] = val;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vspltw()
+JITCFlow ppc_opc_gen_vspltw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vspltw);
-	return flowEndBlock;
-#else
 	int vrD, vrB;
 	uint32 uimm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, uimm, vrB);
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, uimm, vrB);
 
-	if (SSE_AVAIL) {
-		NativeVectorReg reg;
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmPSHUFD(d, b, (3 - (uimm & 0x3)) * 0x55);
+	return flowContinue;
+}
 
-		if (vrD == vrB) {
-			reg = jitcGetClientVectorRegisterDirty(vrD);
-		} else {
-			reg = jitcMapClientVectorRegisterDirty(vrD);
-			NativeVectorReg reg2 = jitcGetClientVectorRegisterMapping(vrB);
+/*	vspltisb	Vector Splat Immediate Signed Byte
+ *	v.247
+ */
+void ppc_opc_vspltisb(PPC_CPU_State &aCPU)
+{
+	VECTOR_DEBUG_COMMON;
+	int vrD, vrB;
+	uint32 simm;
+	uint64 val;
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, simm, vrB);
+	PPC_OPC_ASSERT(vrB==0);
 
-			if (reg2 == VECTREG_NO)
-				asmMOVAPS(reg, &gCPU.vr[vrB]);
-			else
-				asmALUPS(X86_MOVAPS, reg, reg2);
-		}
+	val = (simm & 0x10) ? (simm | 0xE0) : simm;
+	val |= (val << 8);
+	val |= (val << 16);
+	val |= (val << 32);
 
-		asmSHUFPS(reg, reg, 0xff - ((uimm & 0x3) * 0x55));
-
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-
-	/* The documentation doesn't stipulate what a value higher than 0xf
-	 *   will do.  Thus, this is by default an undefined value.  We
-	 *   are thus doing this the fastest way that won't crash us.
-	 */
-	vec_getWord(reg1, vrB, (3 - (uimm & 0x3)) << 2);
-
-	vec_setWord(vrD,  0, reg1);
-	vec_setWord(vrD,  4, reg1);
-	vec_setWord(vrD,  8, reg1);
-	vec_setWord(vrD, 12, reg1);
-
-	return flowContinue;
-#endif
-}
-
-/*	vspltisb	Vector Splat Immediate Signed Byte
- *	v.247
- */
-void ppc_opc_vspltisb()
-{
-	VECTOR_DEBUG_COMMON;
-	int vrD, vrB;
-	uint32 simm;
-	uint64 val;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, simm, vrB);
-	PPC_OPC_ASSERT(vrB==0);
-
-	val = (simm & 0x10) ? (simm | 0xE0) : simm;
-	val |= (val << 8);
-	val |= (val << 16);
-	val |= (val << 32);
-
-	gCPU.vr[vrD].d[0] = val;
-	gCPU.vr[vrD].d[1] = val;
+	aCPU.vr[vrD].d[0] = val;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vspltisb()
+JITCFlow ppc_opc_gen_vspltisb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vspltisb);
-	return flowEndBlock;
-#else
-	int vrD, vrB;
-	uint32 simm, val;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, simm, vrB);
-
-	if (simm == 0) {
-		vec_Zero(vrD);
-		return flowContinue;
-	} else if (simm == 0x1f) {
-		vec_Neg1(vrD);
-		return flowContinue;
-	}
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	uint32 simm = (jitc.current_opc >> 16) & 0x1f;
 
-	val = (simm & 0x10) ? (simm | 0xE0) : simm;
+	uint32 val = (simm & 0x10) ? (simm | 0xE0) : simm;
 	val |= (val << 8);
 	val |= (val << 16);
 
-	if (SSE_AVAIL) {
-		modrm_o modrm;
-		NativeVectorReg reg1 = jitcMapClientVectorRegisterDirty(vrD);
-
-		asmALU_D(X86_MOV, x86_mem2(modrm, &gCPU.vtemp), val);
-		asmMOVSS(reg1, &gCPU.vtemp);
-		asmSHUFPS(reg1, reg1, 0x00);
-
-		return flowContinue;
-	}
-
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg r1 = jitcAllocRegister();
-	asmALU(X86_MOV, r1, val);
-
-	vec_setWord(vrD, 0, r1);
-	vec_setWord(vrD, 4, r1);
-	vec_setWord(vrD, 8, r1);
-	vec_setWord(vrD,12, r1);
-
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	vec_load_constant(jitc, d, val);
 	return flowContinue;
-#endif
 }
 
 /*	vspltish	Vector Splat Immediate Signed Half Word
  *	v.248
  */
-void ppc_opc_vspltish()
+void ppc_opc_vspltish(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrB;
 	uint32 simm;
 	uint64 val;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, simm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, simm, vrB);
 	PPC_OPC_ASSERT(vrB==0);
 
 	val = (simm & 0x10) ? (simm | 0xFFE0) : simm;
 	val |= (val << 16);
 	val |= (val << 32);
 
-	gCPU.vr[vrD].d[0] = val;
-	gCPU.vr[vrD].d[1] = val;
+	aCPU.vr[vrD].d[0] = val;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vspltish()
+JITCFlow ppc_opc_gen_vspltish(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vspltish);
-	return flowEndBlock;
-#else
-	int vrD, vrB;
-	uint32 simm, val;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, simm, vrB);
-
-	if (simm == 0) {
-		vec_Zero(vrD);
-		return flowContinue;
-	} else if (simm == 0x1f) {
-		vec_Neg1(vrD);
-		return flowContinue;
-	}
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	uint32 simm = (jitc.current_opc >> 16) & 0x1f;
 
-	val = (simm & 0x10) ? (simm | 0xFFE0) : simm;
+	uint32 val = (simm & 0x10) ? (simm | 0xFFE0) : simm;
 	val |= (val << 16);
 
-	if (SSE_AVAIL) {
-		modrm_o modrm;
-		NativeVectorReg reg1 = jitcMapClientVectorRegisterDirty(vrD);
-
-		asmALU_D(X86_MOV, x86_mem2(modrm, &gCPU.vtemp), val);
-		asmMOVSS(reg1, &gCPU.vtemp);
-		asmSHUFPS(reg1, reg1, 0x00);
-
-		return flowContinue;
-	}
-
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg r1 = jitcAllocRegister();
-	asmALU(X86_MOV, r1, val);
-
-	vec_setWord(vrD, 0, r1);
-	vec_setWord(vrD, 4, r1);
-	vec_setWord(vrD, 8, r1);
-	vec_setWord(vrD,12, r1);
-
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	vec_load_constant(jitc, d, val);
 	return flowContinue;
-#endif
 }
 
 /*	vspltisw	Vector Splat Immediate Signed Word
  *	v.249
  */
-void ppc_opc_vspltisw()
+void ppc_opc_vspltisw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrB;
 	uint32 simm;
 	uint64 val;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, simm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, simm, vrB);
 	PPC_OPC_ASSERT(vrB==0);
 
 	val = (simm & 0x10) ? (simm | 0xFFFFFFE0) : simm;
 	val |= (val << 32);
 
-	gCPU.vr[vrD].d[0] = val;
-	gCPU.vr[vrD].d[1] = val;
+	aCPU.vr[vrD].d[0] = val;
+	aCPU.vr[vrD].d[1] = val;
 }
-JITCFlow ppc_opc_gen_vspltisw()
+JITCFlow ppc_opc_gen_vspltisw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vspltisw);
-	return flowEndBlock;
-#else
-	int vrD, vrB;
-	uint32 simm, val;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, simm, vrB);
-
-	if (simm == 0) {
-		vec_Zero(vrD);
-		return flowContinue;
-	} else if (simm == 0x1f) {
-		vec_Neg1(vrD);
-		return flowContinue;
-	}
-
-	val = (simm & 0x10) ? (simm | 0xFFFFFFE0) : simm;
-
-	if (SSE_AVAIL) {
-		modrm_o modrm;
-		NativeVectorReg reg1 = jitcMapClientVectorRegisterDirty(vrD);
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	uint32 simm = (jitc.current_opc >> 16) & 0x1f;
 
-		asmALU_D(X86_MOV, x86_mem2(modrm, &gCPU.vtemp), val);
-		asmMOVSS(reg1, &gCPU.vtemp);
-		asmSHUFPS(reg1, reg1, 0x00);
-
-		return flowContinue;
-	}
-
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg r1 = jitcAllocRegister();
-	asmALU(X86_MOV, r1, val);
-
-	vec_setWord(vrD, 0, r1);
-	vec_setWord(vrD, 4, r1);
-	vec_setWord(vrD, 8, r1);
-	vec_setWord(vrD,12, r1);
+	uint32 val = (simm & 0x10) ? (simm | 0xFFFFFFE0) : simm;
 
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	vec_load_constant(jitc, d, val);
 	return flowContinue;
-#endif
 }
 
 /*	mfvscr		Move from Vector Status and Control Register
  *	v.129
  */
-void ppc_opc_mfvscr()
+void ppc_opc_mfvscr(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 	PPC_OPC_ASSERT(vrB==0);
 
-	VECT_W(gCPU.vr[vrD], 3) = gCPU.vscr;
-	VECT_W(gCPU.vr[vrD], 2) = 0;
-	VECT_D(gCPU.vr[vrD], 0) = 0;
+	VECT_W(aCPU.vr[vrD], 3) = aCPU.vscr;
+	VECT_W(aCPU.vr[vrD], 2) = 0;
+	VECT_D(aCPU.vr[vrD], 0) = 0;
 }
-JITCFlow ppc_opc_gen_mfvscr()
+JITCFlow ppc_opc_gen_mfvscr(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_mfvscr);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE_AVAIL) {
-		NativeVectorReg reg1 = jitcMapClientVectorRegisterDirty(vrD);
-		NativeReg reg2 = jitcGetClientRegisterMapping(PPC_VSCR);
-
-		if (reg1 != VECTREG_NO)
-			jitcFlushRegister(NATIVE_REG | reg2);
-
-		asmMOVSS(reg1, &gCPU.vscr);
-	} else {
-		jitcDropClientVectorRegister(vrD);
-
-		NativeReg r1 = jitcGetClientRegister(PPC_VSCR);
-		vec_setWord(vrD, 0, r1);
-
-		jitcClobberRegister(NATIVE_REG | r1);
-
-		asmMOV_NoFlags(r1, 0);	// avoid flag clobber
-		vec_setWord(vrD, 4, r1);
-		vec_setWord(vrD, 8, r1);
-		vec_setWord(vrD,12, r1);
-	}
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
 
+	NativeReg r = jitc.allocRegister();
+	jitc.asmALU32(X86_MOV, r, curCPU(vscr));
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmMOVD(d, r);
 	return flowContinue;
-#endif
 }
 
 /*	mtvscr		Move to Vector Status and Control Register
  *	v.130
  */
-void ppc_opc_mtvscr()
+void ppc_opc_mtvscr(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 	PPC_OPC_ASSERT(vrD==0);
 
-	gCPU.vscr = VECT_W(gCPU.vr[vrB], 3);
+	aCPU.vscr = VECT_W(aCPU.vr[vrB], 3);
 }
-JITCFlow ppc_opc_gen_mtvscr()
+JITCFlow ppc_opc_gen_mtvscr(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_mtvscr);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE_AVAIL) {
-		NativeVectorReg reg1 = jitcGetClientVectorRegisterMapping(vrB);
-
-		if (reg1 != VECTREG_NO) {
-			NativeReg reg2 = jitcGetClientRegisterMapping(PPC_VSCR);
-
-			if (reg2 != REG_NO)
-				jitcClobberRegister(NATIVE_REG | reg2);
-
-			asmMOVSS(&gCPU.vscr, reg1);
-			return flowContinue;
-		}
-	}
-
-	jitcFlushClientVectorRegister(vrB);
-
-	NativeReg r1 = jitcMapClientRegisterDirty(PPC_VSCR);
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
 
-	vec_getWord(r1, vrB, 0);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeReg r = jitc.allocRegister();
+	jitc.asmMOVD(r, b);
+	jitc.asmALU32(X86_MOV, curCPU(vscr), r);
 	return flowContinue;
-#endif
 }
 
 /*	vpkuhum		Vector Pack Unsigned Half Word Unsigned Modulo
  *	v.224
  */
-void ppc_opc_vpkuhum()
+void ppc_opc_vpkuhum(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
-
-	VECT_B(r, 0) = VECT_B(gCPU.vr[vrA], 1);
-	VECT_B(r, 1) = VECT_B(gCPU.vr[vrA], 3);
-	VECT_B(r, 2) = VECT_B(gCPU.vr[vrA], 5);
-	VECT_B(r, 3) = VECT_B(gCPU.vr[vrA], 7);
-	VECT_B(r, 4) = VECT_B(gCPU.vr[vrA], 9);
-	VECT_B(r, 5) = VECT_B(gCPU.vr[vrA],11);
-	VECT_B(r, 6) = VECT_B(gCPU.vr[vrA],13);
-	VECT_B(r, 7) = VECT_B(gCPU.vr[vrA],15);
-
-	VECT_B(r, 8) = VECT_B(gCPU.vr[vrB], 1);
-	VECT_B(r, 9) = VECT_B(gCPU.vr[vrB], 3);
-	VECT_B(r,10) = VECT_B(gCPU.vr[vrB], 5);
-	VECT_B(r,11) = VECT_B(gCPU.vr[vrB], 7);
-	VECT_B(r,12) = VECT_B(gCPU.vr[vrB], 9);
-	VECT_B(r,13) = VECT_B(gCPU.vr[vrB],11);
-	VECT_B(r,14) = VECT_B(gCPU.vr[vrB],13);
-	VECT_B(r,15) = VECT_B(gCPU.vr[vrB],15);
-
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vpkuhum()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vpkuhum);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg8 reg1 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	if (vrB == vrD && vrA == vrD) {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalf((NativeReg16)reg1, vrA, i);
-
-			vec_setByte(vrT, REG_NO, (i >> 1), reg1);
-			vec_setByte(vrT, REG_NO, 8+(i >> 1), reg1);
-		}
-
-		vec_Copy(vrD, vrT);
-	} else if (vrA == vrD) {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalf((NativeReg16)reg1, vrA, 14 - i);
-			vec_setByte(vrD, REG_NO, 15 - (i >> 1), reg1);
-		}
-
-		for (int i=0; i<16; i += 2) {
-			vec_getHalf((NativeReg16)reg1, vrB, i);
-			vec_setByte(vrD, REG_NO, (i >> 1), reg1);
-		}
-	} else {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalf((NativeReg16)reg1, vrB, i);
-			vec_setByte(vrD, REG_NO, (i >> 1), reg1);
-		}
-
-		for (int i=0; i<16; i += 2) {
-			vec_getHalf((NativeReg16)reg1, vrA, i);
-			vec_setByte(vrD, REG_NO, 8 + (i >> 1), reg1);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
+
+	VECT_B(r, 0) = VECT_B(aCPU.vr[vrA], 1);
+	VECT_B(r, 1) = VECT_B(aCPU.vr[vrA], 3);
+	VECT_B(r, 2) = VECT_B(aCPU.vr[vrA], 5);
+	VECT_B(r, 3) = VECT_B(aCPU.vr[vrA], 7);
+	VECT_B(r, 4) = VECT_B(aCPU.vr[vrA], 9);
+	VECT_B(r, 5) = VECT_B(aCPU.vr[vrA],11);
+	VECT_B(r, 6) = VECT_B(aCPU.vr[vrA],13);
+	VECT_B(r, 7) = VECT_B(aCPU.vr[vrA],15);
+
+	VECT_B(r, 8) = VECT_B(aCPU.vr[vrB], 1);
+	VECT_B(r, 9) = VECT_B(aCPU.vr[vrB], 3);
+	VECT_B(r,10) = VECT_B(aCPU.vr[vrB], 5);
+	VECT_B(r,11) = VECT_B(aCPU.vr[vrB], 7);
+	VECT_B(r,12) = VECT_B(aCPU.vr[vrB], 9);
+	VECT_B(r,13) = VECT_B(aCPU.vr[vrB],11);
+	VECT_B(r,14) = VECT_B(aCPU.vr[vrB],13);
+	VECT_B(r,15) = VECT_B(aCPU.vr[vrB],15);
+
+	aCPU.vr[vrD] = r;
+}
+JITCFlow ppc_opc_gen_vpkuhum(JITC &jitc)
+{
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+
+	NativeVectorReg m = jitc.allocVectorRegister();
+	vec_load_constant(jitc, m, 0x00ff00ff);
+	NativeVectorReg d = vec_temp_copy(jitc, vrB);
+	jitc.asmPALU(X86_PAND, d, m);
+	NativeVectorReg t = vec_temp_copy(jitc, vrA);
+	jitc.asmPALU(X86_PAND, t, m);
+	jitc.asmPALU(X86_PACKUSWB, d, t);
+	jitc.renameVectorRegisterDirty(d, vrD);
 	return flowContinue;
-#endif
 }
 
 /*	vpkuwum		Vector Pack Unsigned Word Unsigned Modulo
  *	v.226
  */
-void ppc_opc_vpkuwum()
+void ppc_opc_vpkuwum(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = VECT_H(gCPU.vr[vrA], 1);
-	VECT_H(r, 1) = VECT_H(gCPU.vr[vrA], 3);
-	VECT_H(r, 2) = VECT_H(gCPU.vr[vrA], 5);
-	VECT_H(r, 3) = VECT_H(gCPU.vr[vrA], 7);
+	VECT_H(r, 0) = VECT_H(aCPU.vr[vrA], 1);
+	VECT_H(r, 1) = VECT_H(aCPU.vr[vrA], 3);
+	VECT_H(r, 2) = VECT_H(aCPU.vr[vrA], 5);
+	VECT_H(r, 3) = VECT_H(aCPU.vr[vrA], 7);
 
-	VECT_H(r, 4) = VECT_H(gCPU.vr[vrB], 1);
-	VECT_H(r, 5) = VECT_H(gCPU.vr[vrB], 3);
-	VECT_H(r, 6) = VECT_H(gCPU.vr[vrB], 5);
-	VECT_H(r, 7) = VECT_H(gCPU.vr[vrB], 7);
+	VECT_H(r, 4) = VECT_H(aCPU.vr[vrB], 1);
+	VECT_H(r, 5) = VECT_H(aCPU.vr[vrB], 3);
+	VECT_H(r, 6) = VECT_H(aCPU.vr[vrB], 5);
+	VECT_H(r, 7) = VECT_H(aCPU.vr[vrB], 7);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vpkuwum()
+JITCFlow ppc_opc_gen_vpkuwum(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vpkuwum);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg16 reg1 = (NativeReg16)jitcAllocRegister();
-
-	if (vrB == vrD && vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord((NativeReg)reg1, vrA, i);
-
-			vec_setHalf(vrT, (i >> 1), reg1);
-			vec_setHalf(vrT, 8+(i >> 1), reg1);
-		}
-
-		vec_Copy(vrD, vrT);
-	} else if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord((NativeReg)reg1, vrA, 12 - i);
-			vec_setHalf(vrD, 14 - (i >> 1), reg1);
-		}
-
-		for (int i=0; i<16; i += 4) {
-			vec_getWord((NativeReg)reg1, vrB, i);
-			vec_setHalf(vrD, (i >> 1), reg1);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord((NativeReg)reg1, vrB, i);
-			vec_setHalf(vrD, (i >> 1), reg1);
-		}
-
-		for (int i=0; i<16; i += 4) {
-			vec_getWord((NativeReg)reg1, vrA, i);
-			vec_setHalf(vrD, 8 + (i >> 1), reg1);
-		}
-	}
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
 
+	/* sign extending the low halves lets PACKSSDW truncate */
+	NativeVectorReg d = vec_temp_copy(jitc, vrB);
+	jitc.asmPShift(X86_PSLLD, d, 16);
+	jitc.asmPShift(X86_PSRAD, d, 16);
+	NativeVectorReg t = vec_temp_copy(jitc, vrA);
+	jitc.asmPShift(X86_PSLLD, t, 16);
+	jitc.asmPShift(X86_PSRAD, t, 16);
+	jitc.asmPALU(X86_PACKSSDW, d, t);
+	jitc.renameVectorRegisterDirty(d, vrD);
 	return flowContinue;
-#endif
-}
-
-static inline void ppc_opc_gen_helper_vpkpx(NativeReg reg1, NativeReg reg2, NativeReg reg3)
-{
-	asmALU(X86_MOV, reg2, reg1);
-	asmALU(X86_MOV, reg3, reg1);
-
-	asmALU(X86_AND, reg1, 0x000000f8);
-	asmALU(X86_AND, reg2, 0x0000f800);
-	asmALU(X86_AND, reg3, 0x01f80000);
-
-	asmShift(X86_SHR, reg1, 3);
-	asmShift(X86_SHR, reg2, 6);
-	asmShift(X86_SHR, reg3, 9);
-
-	asmALU(X86_OR, reg1, reg2);
-	asmALU(X86_OR, reg1, reg3);
 }
 
 /*	vpkpx		Vector Pack Pixel32
  *	v.219
  */
-void ppc_opc_vpkpx()
+void ppc_opc_vpkpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = PACK_PIXEL(VECT_W(gCPU.vr[vrA], 0));
-	VECT_H(r, 1) = PACK_PIXEL(VECT_W(gCPU.vr[vrA], 1));
-	VECT_H(r, 2) = PACK_PIXEL(VECT_W(gCPU.vr[vrA], 2));
-	VECT_H(r, 3) = PACK_PIXEL(VECT_W(gCPU.vr[vrA], 3));
+	VECT_H(r, 0) = PACK_PIXEL(VECT_W(aCPU.vr[vrA], 0));
+	VECT_H(r, 1) = PACK_PIXEL(VECT_W(aCPU.vr[vrA], 1));
+	VECT_H(r, 2) = PACK_PIXEL(VECT_W(aCPU.vr[vrA], 2));
+	VECT_H(r, 3) = PACK_PIXEL(VECT_W(aCPU.vr[vrA], 3));
 
-	VECT_H(r, 4) = PACK_PIXEL(VECT_W(gCPU.vr[vrB], 0));
-	VECT_H(r, 5) = PACK_PIXEL(VECT_W(gCPU.vr[vrB], 1));
-	VECT_H(r, 6) = PACK_PIXEL(VECT_W(gCPU.vr[vrB], 2));
-	VECT_H(r, 7) = PACK_PIXEL(VECT_W(gCPU.vr[vrB], 3));
+	VECT_H(r, 4) = PACK_PIXEL(VECT_W(aCPU.vr[vrB], 0));
+	VECT_H(r, 5) = PACK_PIXEL(VECT_W(aCPU.vr[vrB], 1));
+	VECT_H(r, 6) = PACK_PIXEL(VECT_W(aCPU.vr[vrB], 2));
+	VECT_H(r, 7) = PACK_PIXEL(VECT_W(aCPU.vr[vrB], 3));
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vpkpx()
+JITCFlow ppc_opc_gen_vpkpx(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vpkpx);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-	NativeReg reg3 = jitcAllocRegister();
-
-	if((vrA == vrB)) {
-		for (int i=0; i<8; i += 2) {
-			vec_getWord(reg1, vrB, i<<1);
-			ppc_opc_gen_helper_vpkpx(reg1, reg2, reg3);
-			vec_setHalf(vrD, i, (NativeReg16)reg1);
-
-			if (vrD != vrA)
-				vec_setHalf(vrD, i+8, (NativeReg16)reg1);
-		}
-
-		if (vrD == vrB) {
-			vec_getWord(reg1, vrD, 0);
-			vec_getWord(reg2, vrD, 4);
-
-			vec_setWord(vrD, 8, reg1);
-			vec_setWord(vrD,12, reg2);
-		}
-	} else if (vrB == vrD) {
-		for (int i=0; i<8; i += 2) {
-			vec_getWord(reg1, vrB, i<<1);
-			ppc_opc_gen_helper_vpkpx(reg1, reg2, reg3);
-			vec_setHalf(vrD, i, (NativeReg16)reg1);
-		}
-
-		for (int i=0; i<8; i += 2) {
-			vec_getWord(reg1, vrA, i<<1);
-			ppc_opc_gen_helper_vpkpx(reg1, reg2, reg3);
-			vec_setHalf(vrD, i+8, (NativeReg16)reg1);
-		}
-	} else {
-		for (int i=0; i<8; i += 2) {
-			vec_getWord(reg1, vrA, 12-(i<<1));
-			ppc_opc_gen_helper_vpkpx(reg1, reg2, reg3);
-			vec_setHalf(vrD, 14-i, (NativeReg16)reg1);
-		}
-
-		for (int i=0; i<8; i += 2) {
-			vec_getWord(reg1, vrB, i<<1);
-			ppc_opc_gen_helper_vpkpx(reg1, reg2, reg3);
-			vec_setHalf(vrD, i, (NativeReg16)reg1);
-		}
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkpx);
 	return flowContinue;
-#endif
 }
 
-
 /*	vpkuhus		Vector Pack Unsigned Half Word Unsigned Saturate
  *	v.225
  */
-void ppc_opc_vpkuhus()
+void ppc_opc_vpkuhus(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
-
-	VECT_B(r, 0) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 0));
-	VECT_B(r, 1) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 1));
-	VECT_B(r, 2) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 2));
-	VECT_B(r, 3) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 3));
-	VECT_B(r, 4) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 4));
-	VECT_B(r, 5) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 5));
-	VECT_B(r, 6) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 6));
-	VECT_B(r, 7) = SATURATE_UB(VECT_H(gCPU.vr[vrA], 7));
-
-	VECT_B(r, 8) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 0));
-	VECT_B(r, 9) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 1));
-	VECT_B(r,10) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 2));
-	VECT_B(r,11) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 3));
-	VECT_B(r,12) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 4));
-	VECT_B(r,13) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 5));
-	VECT_B(r,14) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 6));
-	VECT_B(r,15) = SATURATE_UB(VECT_H(gCPU.vr[vrB], 7));
-
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vpkuhus()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vpkuhus);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg8 reg1 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	if (vrB == vrD && vrA == vrD) {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfZ((NativeReg)reg1, vrA, i);
-
-			vec_saturateUB(reg1);
-
-			vec_setByte(vrT, REG_NO, (i >> 1), reg1);
-			vec_setByte(vrT, REG_NO, 8+(i >> 1), reg1);
-		}
-
-		vec_Copy(vrD, vrT);
-	} else if (vrA == vrD) {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfZ((NativeReg)reg1, vrA, 14 - i);
-
-			vec_saturateUB(reg1);
-
-			vec_setByte(vrD, REG_NO, 15 - (i >> 1), reg1);
-		}
-
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfZ((NativeReg)reg1, vrB, i);
-
-			vec_saturateUB(reg1);
-
-			vec_setByte(vrD, REG_NO, (i >> 1), reg1);
-		}
-	} else {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfZ((NativeReg)reg1, vrB, i);
-
-			vec_saturateUB(reg1);
-
-			vec_setByte(vrD, REG_NO, (i >> 1), reg1);
-		}
-
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfZ((NativeReg)reg1, vrA, i);
-
-			vec_saturateUB(reg1);
-
-			vec_setByte(vrD, REG_NO, 8 + (i >> 1), reg1);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
+
+	VECT_B(r, 0) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 0));
+	VECT_B(r, 1) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 1));
+	VECT_B(r, 2) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 2));
+	VECT_B(r, 3) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 3));
+	VECT_B(r, 4) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 4));
+	VECT_B(r, 5) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 5));
+	VECT_B(r, 6) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 6));
+	VECT_B(r, 7) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrA], 7));
+
+	VECT_B(r, 8) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 0));
+	VECT_B(r, 9) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 1));
+	VECT_B(r,10) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 2));
+	VECT_B(r,11) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 3));
+	VECT_B(r,12) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 4));
+	VECT_B(r,13) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 5));
+	VECT_B(r,14) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 6));
+	VECT_B(r,15) = SATURATE_UB(aCPU, VECT_H(aCPU.vr[vrB], 7));
+
+	aCPU.vr[vrD] = r;
+}
+JITCFlow ppc_opc_gen_vpkuhus(JITC &jitc)
+{
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkuhus);
 	return flowContinue;
-#endif
 }
 
 /*	vpkshss		Vector Pack Signed Half Word Signed Saturate
  *	v.220
  */
-void ppc_opc_vpkshss()
+void ppc_opc_vpkshss(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
-
-	VECT_B(r, 0) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 0));
-	VECT_B(r, 1) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 1));
-	VECT_B(r, 2) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 2));
-	VECT_B(r, 3) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 3));
-	VECT_B(r, 4) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 4));
-	VECT_B(r, 5) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 5));
-	VECT_B(r, 6) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 6));
-	VECT_B(r, 7) = SATURATE_SB(VECT_H(gCPU.vr[vrA], 7));
-
-	VECT_B(r, 8) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 0));
-	VECT_B(r, 9) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 1));
-	VECT_B(r,10) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 2));
-	VECT_B(r,11) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 3));
-	VECT_B(r,12) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 4));
-	VECT_B(r,13) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 5));
-	VECT_B(r,14) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 6));
-	VECT_B(r,15) = SATURATE_SB(VECT_H(gCPU.vr[vrB], 7));
-
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vpkshss()
-{
-	ppc_opc_gen_interpret(ppc_opc_vpkshss);
-	return flowEndBlock;
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
+
+	VECT_B(r, 0) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 0));
+	VECT_B(r, 1) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 1));
+	VECT_B(r, 2) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 2));
+	VECT_B(r, 3) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 3));
+	VECT_B(r, 4) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 4));
+	VECT_B(r, 5) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 5));
+	VECT_B(r, 6) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 6));
+	VECT_B(r, 7) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrA], 7));
+
+	VECT_B(r, 8) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 0));
+	VECT_B(r, 9) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 1));
+	VECT_B(r,10) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 2));
+	VECT_B(r,11) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 3));
+	VECT_B(r,12) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 4));
+	VECT_B(r,13) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 5));
+	VECT_B(r,14) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 6));
+	VECT_B(r,15) = SATURATE_SB(aCPU, VECT_H(aCPU.vr[vrB], 7));
+
+	aCPU.vr[vrD] = r;
+}
+JITCFlow ppc_opc_gen_vpkshss(JITC &jitc)
+{
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkshss);
+	return flowContinue;
 }
 
 /*	vpkuwus		Vector Pack Unsigned Word Unsigned Saturate
  *	v.227
  */
-void ppc_opc_vpkuwus()
+void ppc_opc_vpkuwus(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = SATURATE_UH(VECT_W(gCPU.vr[vrA], 0));
-	VECT_H(r, 1) = SATURATE_UH(VECT_W(gCPU.vr[vrA], 1));
-	VECT_H(r, 2) = SATURATE_UH(VECT_W(gCPU.vr[vrA], 2));
-	VECT_H(r, 3) = SATURATE_UH(VECT_W(gCPU.vr[vrA], 3));
+	VECT_H(r, 0) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrA], 0));
+	VECT_H(r, 1) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrA], 1));
+	VECT_H(r, 2) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrA], 2));
+	VECT_H(r, 3) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrA], 3));
 
-	VECT_H(r, 4) = SATURATE_UH(VECT_W(gCPU.vr[vrB], 0));
-	VECT_H(r, 5) = SATURATE_UH(VECT_W(gCPU.vr[vrB], 1));
-	VECT_H(r, 6) = SATURATE_UH(VECT_W(gCPU.vr[vrB], 2));
-	VECT_H(r, 7) = SATURATE_UH(VECT_W(gCPU.vr[vrB], 3));
+	VECT_H(r, 4) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrB], 0));
+	VECT_H(r, 5) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrB], 1));
+	VECT_H(r, 6) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrB], 2));
+	VECT_H(r, 7) = SATURATE_UH(aCPU, VECT_W(aCPU.vr[vrB], 3));
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vpkuwus()
+JITCFlow ppc_opc_gen_vpkuwus(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vpkuwus);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkuwus);
+	return flowContinue;
 }
 
 /*	vpkswss		Vector Pack Signed Word Signed Saturate
  *	v.222
  */
-void ppc_opc_vpkswss()
+void ppc_opc_vpkswss(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = SATURATE_SH(VECT_W(gCPU.vr[vrA], 0));
-	VECT_H(r, 1) = SATURATE_SH(VECT_W(gCPU.vr[vrA], 1));
-	VECT_H(r, 2) = SATURATE_SH(VECT_W(gCPU.vr[vrA], 2));
-	VECT_H(r, 3) = SATURATE_SH(VECT_W(gCPU.vr[vrA], 3));
+	VECT_H(r, 0) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrA], 0));
+	VECT_H(r, 1) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrA], 1));
+	VECT_H(r, 2) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrA], 2));
+	VECT_H(r, 3) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrA], 3));
 
-	VECT_H(r, 4) = SATURATE_SH(VECT_W(gCPU.vr[vrB], 0));
-	VECT_H(r, 5) = SATURATE_SH(VECT_W(gCPU.vr[vrB], 1));
-	VECT_H(r, 6) = SATURATE_SH(VECT_W(gCPU.vr[vrB], 2));
-	VECT_H(r, 7) = SATURATE_SH(VECT_W(gCPU.vr[vrB], 3));
+	VECT_H(r, 4) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrB], 0));
+	VECT_H(r, 5) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrB], 1));
+	VECT_H(r, 6) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrB], 2));
+	VECT_H(r, 7) = SATURATE_SH(aCPU, VECT_W(aCPU.vr[vrB], 3));
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vpkswss()
+JITCFlow ppc_opc_gen_vpkswss(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vpkswss);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(X86_PACKSSDW, vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if (vrB == vrD && vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg1, vrA, i);
-
-			vec_saturateSH(reg1, reg2);
-
-			vec_setHalf(vrT, (i >> 1), (NativeReg16)reg1);
-			vec_setHalf(vrT, 8+(i >> 1), (NativeReg16)reg1);
-		}
-
-		vec_Copy(vrD, vrT);
-	} else if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg1, vrA, 12 - i);
-
-			vec_saturateSH(reg1, reg2);
-
-			vec_setHalf(vrD, 14 - (i >> 1), (NativeReg16)reg1);
-		}
-
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg1, vrB, i);
-
-			vec_saturateSH(reg1, reg2);
-
-			vec_setHalf(vrD, (i >> 1), (NativeReg16)reg1);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg1, vrB, i);
-
-			vec_saturateSH(reg1, reg2);
-
-			vec_setHalf(vrD, (i >> 1), (NativeReg16)reg1);
-		}
-
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg1, vrA, i);
-
-			vec_saturateSH(reg1, reg2);
-
-			vec_setHalf(vrD, 8 + (i >> 1), (NativeReg16)reg1);
-		}
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkswss);
 	return flowContinue;
-#endif
 }
 
 /*	vpkshus		Vector Pack Signed Half Word Unsigned Saturate
  *	v.221
  */
-void ppc_opc_vpkshus()
+void ppc_opc_vpkshus(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
-
-	VECT_B(r, 0) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 0));
-	VECT_B(r, 1) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 1));
-	VECT_B(r, 2) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 2));
-	VECT_B(r, 3) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 3));
-	VECT_B(r, 4) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 4));
-	VECT_B(r, 5) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 5));
-	VECT_B(r, 6) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 6));
-	VECT_B(r, 7) = SATURATE_USB(VECT_H(gCPU.vr[vrA], 7));
-
-	VECT_B(r, 8) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 0));
-	VECT_B(r, 9) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 1));
-	VECT_B(r,10) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 2));
-	VECT_B(r,11) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 3));
-	VECT_B(r,12) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 4));
-	VECT_B(r,13) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 5));
-	VECT_B(r,14) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 6));
-	VECT_B(r,15) = SATURATE_USB(VECT_H(gCPU.vr[vrB], 7));
-
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vpkshus()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vpkshus);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(X86_PACKUSWB, vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	NativeReg reg1 = jitcAllocRegister(NATIVE_REG_8);
-	NativeReg reg2 = jitcAllocRegister();
-
-	if (vrB == vrD && vrA == vrD) {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfS(reg1, vrA, i);
-
-			vec_saturateSUB(reg1, reg2);
-
-			vec_setByte(vrT, REG_NO, (i >> 1), (NativeReg8)reg1);
-			vec_setByte(vrT, REG_NO, 8+(i >> 1), (NativeReg8)reg1);
-		}
-
-		vec_Copy(vrD, vrT);
-	} else if (vrA == vrD) {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfS(reg1, vrA, 14 - i);
-
-			vec_saturateSUB(reg1, reg2);
-
-			vec_setByte(vrD, REG_NO, 15 - (i >> 1), (NativeReg8)reg1);
-		}
-
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfS(reg1, vrB, i);
-
-			vec_saturateSUB(reg1, reg2);
-
-			vec_setByte(vrD, REG_NO, (i >> 1), (NativeReg8)reg1);
-		}
-	} else {
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfS(reg1, vrB, i);
-
-			vec_saturateSUB(reg1, reg2);
-
-			vec_setByte(vrD, REG_NO, (i >> 1), (NativeReg8)reg1);
-		}
-
-		for (int i=0; i<16; i += 2) {
-			vec_getHalfS(reg1, vrA, i);
-
-			vec_saturateSUB(reg1, reg2);
-
-			vec_setByte(vrD, REG_NO, 8 + (i >> 1), (NativeReg8)reg1);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
+
+	VECT_B(r, 0) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 0));
+	VECT_B(r, 1) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 1));
+	VECT_B(r, 2) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 2));
+	VECT_B(r, 3) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 3));
+	VECT_B(r, 4) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 4));
+	VECT_B(r, 5) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 5));
+	VECT_B(r, 6) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 6));
+	VECT_B(r, 7) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrA], 7));
+
+	VECT_B(r, 8) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 0));
+	VECT_B(r, 9) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 1));
+	VECT_B(r,10) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 2));
+	VECT_B(r,11) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 3));
+	VECT_B(r,12) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 4));
+	VECT_B(r,13) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 5));
+	VECT_B(r,14) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 6));
+	VECT_B(r,15) = SATURATE_USB(aCPU, VECT_H(aCPU.vr[vrB], 7));
+
+	aCPU.vr[vrD] = r;
+}
+JITCFlow ppc_opc_gen_vpkshus(JITC &jitc)
+{
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkshus);
 	return flowContinue;
-#endif
 }
 
 /*	vpkswus		Vector Pack Signed Word Unsigned Saturate
  *	v.223
  */
-void ppc_opc_vpkswus()
+void ppc_opc_vpkswus(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	VECT_H(r, 0) = SATURATE_USH(VECT_W(gCPU.vr[vrA], 0));
-	VECT_H(r, 1) = SATURATE_USH(VECT_W(gCPU.vr[vrA], 1));
-	VECT_H(r, 2) = SATURATE_USH(VECT_W(gCPU.vr[vrA], 2));
-	VECT_H(r, 3) = SATURATE_USH(VECT_W(gCPU.vr[vrA], 3));
+	VECT_H(r, 0) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrA], 0));
+	VECT_H(r, 1) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrA], 1));
+	VECT_H(r, 2) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrA], 2));
+	VECT_H(r, 3) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrA], 3));
 
-	VECT_H(r, 4) = SATURATE_USH(VECT_W(gCPU.vr[vrB], 0));
-	VECT_H(r, 5) = SATURATE_USH(VECT_W(gCPU.vr[vrB], 1));
-	VECT_H(r, 6) = SATURATE_USH(VECT_W(gCPU.vr[vrB], 2));
-	VECT_H(r, 7) = SATURATE_USH(VECT_W(gCPU.vr[vrB], 3));
+	VECT_H(r, 4) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrB], 0));
+	VECT_H(r, 5) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrB], 1));
+	VECT_H(r, 6) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrB], 2));
+	VECT_H(r, 7) = SATURATE_USH(aCPU, VECT_W(aCPU.vr[vrB], 3));
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vpkswus()
+JITCFlow ppc_opc_gen_vpkswus(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vpkswus);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vpkswus);
+	return flowContinue;
 }
 
 /*	vupkhsb		Vector Unpack High Signed Byte
  *	v.277
  */
-void ppc_opc_vupkhsb()
+void ppc_opc_vupkhsb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
-	VECT_SH(r, 0) = VECT_SB(gCPU.vr[vrB], 0);
-	VECT_SH(r, 1) = VECT_SB(gCPU.vr[vrB], 1);
-	VECT_SH(r, 2) = VECT_SB(gCPU.vr[vrB], 2);
-	VECT_SH(r, 3) = VECT_SB(gCPU.vr[vrB], 3);
-	VECT_SH(r, 4) = VECT_SB(gCPU.vr[vrB], 4);
-	VECT_SH(r, 5) = VECT_SB(gCPU.vr[vrB], 5);
-	VECT_SH(r, 6) = VECT_SB(gCPU.vr[vrB], 6);
-	VECT_SH(r, 7) = VECT_SB(gCPU.vr[vrB], 7);
+	VECT_SH(r, 0) = VECT_SB(aCPU.vr[vrB], 0);
+	VECT_SH(r, 1) = VECT_SB(aCPU.vr[vrB], 1);
+	VECT_SH(r, 2) = VECT_SB(aCPU.vr[vrB], 2);
+	VECT_SH(r, 3) = VECT_SB(aCPU.vr[vrB], 3);
+	VECT_SH(r, 4) = VECT_SB(aCPU.vr[vrB], 4);
+	VECT_SH(r, 5) = VECT_SB(aCPU.vr[vrB], 5);
+	VECT_SH(r, 6) = VECT_SB(aCPU.vr[vrB], 6);
+	VECT_SH(r, 7) = VECT_SB(aCPU.vr[vrB], 7);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vupkhsb()
+JITCFlow ppc_opc_gen_vupkhsb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vupkhsb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 2) {
-		vec_getByteS(reg, vrB, 8 + (i >> 1));
-
-		vec_setHalf(vrD, i, (NativeReg16)reg);
-	}
-
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
+	vec_unpack_signed(jitc, PALUB(X86_PUNPCKH), X86_PSRAW, 8, vrD, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vupkhpx		Vector Unpack High Pixel32
  *	v.279
  */
-void ppc_opc_vupkhpx()
+void ppc_opc_vupkhpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
-	VECT_W(r, 0) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 0));
-	VECT_W(r, 1) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 1));
-	VECT_W(r, 2) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 2));
-	VECT_W(r, 3) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 3));
+	VECT_W(r, 0) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 0));
+	VECT_W(r, 1) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 1));
+	VECT_W(r, 2) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 2));
+	VECT_W(r, 3) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 3));
 	
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vupkhpx()
+JITCFlow ppc_opc_gen_vupkhpx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vupkhpx);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vupkhpx);
+	return flowContinue;
 }
 
 /*	vupkhsh		Vector Unpack High Signed Half Word
  *	v.278
  */
-void ppc_opc_vupkhsh()
+void ppc_opc_vupkhsh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
-	VECT_SW(r, 0) = VECT_SH(gCPU.vr[vrB], 0);
-	VECT_SW(r, 1) = VECT_SH(gCPU.vr[vrB], 1);
-	VECT_SW(r, 2) = VECT_SH(gCPU.vr[vrB], 2);
-	VECT_SW(r, 3) = VECT_SH(gCPU.vr[vrB], 3);
+	VECT_SW(r, 0) = VECT_SH(aCPU.vr[vrB], 0);
+	VECT_SW(r, 1) = VECT_SH(aCPU.vr[vrB], 1);
+	VECT_SW(r, 2) = VECT_SH(aCPU.vr[vrB], 2);
+	VECT_SW(r, 3) = VECT_SH(aCPU.vr[vrB], 3);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vupkhsh()
+JITCFlow ppc_opc_gen_vupkhsh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vupkhsh);
-	return flowEndBlock;
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
+	vec_unpack_signed(jitc, PALUW(X86_PUNPCKH), X86_PSRAD, 16, vrD, vrB);
+	return flowContinue;
 }
 
 /*	vupklsb		Vector Unpack Low Signed Byte
  *	v.280
  */
-void ppc_opc_vupklsb()
+void ppc_opc_vupklsb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
-	VECT_SH(r, 0) = VECT_SB(gCPU.vr[vrB], 8);
-	VECT_SH(r, 1) = VECT_SB(gCPU.vr[vrB], 9);
-	VECT_SH(r, 2) = VECT_SB(gCPU.vr[vrB],10);
-	VECT_SH(r, 3) = VECT_SB(gCPU.vr[vrB],11);
-	VECT_SH(r, 4) = VECT_SB(gCPU.vr[vrB],12);
-	VECT_SH(r, 5) = VECT_SB(gCPU.vr[vrB],13);
-	VECT_SH(r, 6) = VECT_SB(gCPU.vr[vrB],14);
-	VECT_SH(r, 7) = VECT_SB(gCPU.vr[vrB],15);
+	VECT_SH(r, 0) = VECT_SB(aCPU.vr[vrB], 8);
+	VECT_SH(r, 1) = VECT_SB(aCPU.vr[vrB], 9);
+	VECT_SH(r, 2) = VECT_SB(aCPU.vr[vrB],10);
+	VECT_SH(r, 3) = VECT_SB(aCPU.vr[vrB],11);
+	VECT_SH(r, 4) = VECT_SB(aCPU.vr[vrB],12);
+	VECT_SH(r, 5) = VECT_SB(aCPU.vr[vrB],13);
+	VECT_SH(r, 6) = VECT_SB(aCPU.vr[vrB],14);
+	VECT_SH(r, 7) = VECT_SB(aCPU.vr[vrB],15);
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vupklsb()
+JITCFlow ppc_opc_gen_vupklsb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vupklsb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 2) {
-		vec_getByteS(reg, vrB, 7 - (i >> 1));
-
-		vec_setHalf(vrD, 14 - i, (NativeReg16)reg);
-	}
-
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
+	vec_unpack_signed(jitc, PALUB(X86_PUNPCKL), X86_PSRAW, 8, vrD, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vupklpx		Vector Unpack Low Pixel32
  *	v.279
  */
-void ppc_opc_vupklpx()
+void ppc_opc_vupklpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
-	VECT_W(r, 0) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 4));
-	VECT_W(r, 1) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 5));
-	VECT_W(r, 2) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 6));
-	VECT_W(r, 3) = UNPACK_PIXEL(VECT_H(gCPU.vr[vrB], 7));
+	VECT_W(r, 0) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 4));
+	VECT_W(r, 1) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 5));
+	VECT_W(r, 2) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 6));
+	VECT_W(r, 3) = UNPACK_PIXEL(VECT_H(aCPU.vr[vrB], 7));
 
-	gCPU.vr[vrD] = r;
+	aCPU.vr[vrD] = r;
 }
-JITCFlow ppc_opc_gen_vupklpx()
+JITCFlow ppc_opc_gen_vupklpx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vupklpx);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vupklpx);
+	return flowContinue;
 }
 
 /*	vupklsh		Vector Unpack Low Signed Half Word
  *	v.281
  */
-void ppc_opc_vupklsh()
+void ppc_opc_vupklsh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	Vector_t r;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
-	VECT_SW(r, 0) = VECT_SH(gCPU.vr[vrB], 4);
-	VECT_SW(r, 1) = VECT_SH(gCPU.vr[vrB], 5);
-	VECT_SW(r, 2) = VECT_SH(gCPU.vr[vrB], 6);
-	VECT_SW(r, 3) = VECT_SH(gCPU.vr[vrB], 7);
+	VECT_SW(r, 0) = VECT_SH(aCPU.vr[vrB], 4);
+	VECT_SW(r, 1) = VECT_SH(aCPU.vr[vrB], 5);
+	VECT_SW(r, 2) = VECT_SH(aCPU.vr[vrB], 6);
+	VECT_SW(r, 3) = VECT_SH(aCPU.vr[vrB], 7);
 
-	gCPU.vr[vrD] = r;
-}
-JITCFlow ppc_opc_gen_vupklsh()
-{
-	ppc_opc_gen_interpret(ppc_opc_vupklsh);
-	return flowEndBlock;
+	aCPU.vr[vrD] = r;
 }
-
-static inline void helper_gen_vaddubm(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
+JITCFlow ppc_opc_gen_vupklsh(JITC &jitc)
 {
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_AND, reg, modrmb);
-	asmALU(X86_XOR, reg2, modrmb);
-
-	asmShift(X86_SHL, reg, 1);
-	asmALU(X86_AND, reg2, 0xfefefefe);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x01010100);
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
+	vec_unpack_signed(jitc, PALUW(X86_PUNPCKL), X86_PSRAD, 16, vrD, vrB);
+	return flowContinue;
 }
 
 /*	vaddubm		Vector Add Unsigned Byte Modulo
  *	v.141
  */
-void ppc_opc_vaddubm()
+void ppc_opc_vaddubm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint8 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = gCPU.vr[vrA].b[i] + gCPU.vr[vrB].b[i];
-		gCPU.vr[vrD].b[i] = res;
+		res = aCPU.vr[vrA].b[i] + aCPU.vr[vrB].b[i];
+		aCPU.vr[vrD].b[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vaddubm()
+JITCFlow ppc_opc_gen_vaddubm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vaddubm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(PALUB(X86_PADD), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if ((vrA == vrD) || (vrB == vrD)) {
-		int vrS = vrB;
-
-		if (vrD == vrB) {
-			vrS = vrA;
-		}
-
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrD].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrS].b[i]));
-
-			helper_gen_vaddubm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_SUB, reg2, modrmb);
-			asmALU(X86_SUB, modrma, reg2);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vaddubm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_SUB, reg, reg2);
-			asmALU(X86_ADD, reg, modrma);
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, PALUB(X86_PADD), vrD, vrA, vrB);
 	return flowContinue;
-#endif
-}
-
-static inline void helper_gen_vadduhm(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
-{
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_AND, reg, modrmb);
-	asmALU(X86_XOR, reg2, modrmb);
-
-	asmShift(X86_SHL, reg, 1);
-	asmALU(X86_AND, reg2, 0xfffefffe);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x00010000);
 }
 
 /*	vadduhm		Vector Add Unsigned Half Word Modulo
  *	v.143
  */
-void ppc_opc_vadduhm()
+void ppc_opc_vadduhm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = gCPU.vr[vrA].h[i] + gCPU.vr[vrB].h[i];
-		gCPU.vr[vrD].h[i] = res;
+		res = aCPU.vr[vrA].h[i] + aCPU.vr[vrB].h[i];
+		aCPU.vr[vrD].h[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vadduhm()
+JITCFlow ppc_opc_gen_vadduhm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vadduhm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(PALUW(X86_PADD), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if ((vrA == vrD) || (vrB == vrD)) {
-		int vrS = vrB;
-
-		if (vrD == vrB) {
-			vrS = vrA;
-		}
-
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrD].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrS].b[i]));
-
-			helper_gen_vadduhm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_SUB, reg2, modrmb);
-			asmALU(X86_SUB, modrma, reg2);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vadduhm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_SUB, reg, reg2);
-			asmALU(X86_ADD, reg, modrma);
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, PALUW(X86_PADD), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vadduwm		Vector Add Unsigned Word Modulo
  *	v.145
  */
-void ppc_opc_vadduwm()
+void ppc_opc_vadduwm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] + gCPU.vr[vrB].w[i];
-		gCPU.vr[vrD].w[i] = res;
+		res = aCPU.vr[vrA].w[i] + aCPU.vr[vrB].w[i];
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vadduwm()
+JITCFlow ppc_opc_gen_vadduwm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vadduwm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-	NativeReg reg = jitcAllocRegister();
-
-	if (SSE2_AVAIL) {
-		commutative_operation(PALUD(X86_PADD), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	if ((vrA == vrD) || (vrB == vrD)) {
-		int vrS = vrB;
-
-		if (vrD == vrB) {
-			vrS = vrA;
-		}
-
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg, vrS, i);
-
-			asmALU(X86_ADD,
-				x86_mem2(modrm, &(gCPU.vr[vrD].b[i])), reg);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg, vrA, i);
-
-			asmALU(X86_ADD, reg,
-				x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, PALUD(X86_PADD), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vaddfp		Vector Add Float Point
  *	v.137
  */
-void ppc_opc_vaddfp()
+void ppc_opc_vaddfp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	float res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		res = gCPU.vr[vrA].f[i] + gCPU.vr[vrB].f[i];
-		gCPU.vr[vrD].f[i] = res;
+		res = aCPU.vr[vrA].f[i] + aCPU.vr[vrB].f[i];
+		aCPU.vr[vrD].f[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vaddfp()
+JITCFlow ppc_opc_gen_vaddfp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vaddfp);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_ADDPS, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	ppc_opc_gen_interpret(ppc_opc_vaddfp);
-	return flowEndBlock;
-#endif
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_ADDPS, vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vaddcuw		Vector Add Carryout Unsigned Word
  *	v.136
  */
-void ppc_opc_vaddcuw()
+void ppc_opc_vaddcuw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] + gCPU.vr[vrB].w[i];
-		gCPU.vr[vrD].w[i] = (res < gCPU.vr[vrA].w[i]) ? 1 : 0;
+		res = aCPU.vr[vrA].w[i] + aCPU.vr[vrB].w[i];
+		aCPU.vr[vrD].w[i] = (res < aCPU.vr[vrA].w[i]) ? 1 : 0;
 	}
 }
-JITCFlow ppc_opc_gen_vaddcuw()
-{
-	ppc_opc_gen_interpret(ppc_opc_vaddcuw);
-	return flowEndBlock;
-}
-
-static inline void helper_gen_vaddubs(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
+JITCFlow ppc_opc_gen_vaddcuw(JITC &jitc)
 {
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_XOR, reg, modrmb);
-	asmALU(X86_AND, reg2, modrmb);
-
-	asmShift(X86_SHR, reg, 1);
-	asmALU(X86_AND, reg, 0x7f7f7f7f);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x80808080);
-
-	asmShift(X86_SHR, reg2, 7);
-	asmALU(X86_ADD, reg2, 0x7f7f7f7f);
-	asmALU(X86_XOR, reg2, 0x7f7f7f7f);
-	NativeAddress skip = asmJxxFixup(X86_Z);
-
-	vec_raise_saturate();
-
-	asmResolveFixup(skip);
+	ppc_opc_gen_interpret(jitc, ppc_opc_vaddcuw);
+	return flowContinue;
 }
 
 /*	vaddubs		Vector Add Unsigned Byte Saturate
  *	v.142
  */
-void ppc_opc_vaddubs()
+void ppc_opc_vaddubs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = (uint16)gCPU.vr[vrA].b[i] + (uint16)gCPU.vr[vrB].b[i];
-		gCPU.vr[vrD].b[i] = SATURATE_UB(res);
+		res = (uint16)aCPU.vr[vrA].b[i] + (uint16)aCPU.vr[vrB].b[i];
+		aCPU.vr[vrD].b[i] = SATURATE_UB(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vaddubs()
+JITCFlow ppc_opc_gen_vaddubs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vaddubs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(PALUB(X86_PADDUS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if ((vrA == vrD) || (vrB == vrD)) {
-		int vrS = vrB;
-
-		if (vrD == vrB) {
-			vrS = vrA;
-		}
-
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrD].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrS].b[i]));
-
-			helper_gen_vaddubs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_SUB, reg, reg2);
-			asmALU(X86_ADD, modrma, reg);
-			asmALU(X86_OR, modrma, reg2);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vaddubs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_SUB, reg, reg2);
-			asmALU(X86_ADD, reg, modrma);
-			asmALU(X86_OR, reg, reg2);
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUB(X86_PADDUS), PALUB(X86_PADD), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vaddsbs		Vector Add Signed Byte Saturate
  *	v.138
  */
-void ppc_opc_vaddsbs()
+void ppc_opc_vaddsbs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = (sint16)gCPU.vr[vrA].sb[i] + (sint16)gCPU.vr[vrB].sb[i];
-		gCPU.vr[vrD].b[i] = SATURATE_SB(res);
+		res = (sint16)aCPU.vr[vrA].sb[i] + (sint16)aCPU.vr[vrB].sb[i];
+		aCPU.vr[vrD].b[i] = SATURATE_SB(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vaddsbs()
+JITCFlow ppc_opc_gen_vaddsbs(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vaddsbs);
-	return flowEndBlock;
-}
-
-static inline void helper_gen_vadduhs(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
-{
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_XOR, reg, modrmb);
-	asmALU(X86_AND, reg2, modrmb);
-
-	asmShift(X86_SHR, reg, 1);
-	asmALU(X86_AND, reg, 0x7fff7fff);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x80008000);
-
-	asmShift(X86_SHR, reg2, 15);
-	asmALU(X86_ADD, reg2, 0x7fff7fff);
-	asmALU(X86_XOR, reg2, 0x7fff7fff);
-	NativeAddress skip = asmJxxFixup(X86_Z);
-
-	vec_raise_saturate();
-
-	asmResolveFixup(skip);
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUB(X86_PADDS), PALUB(X86_PADD), vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vadduhs		Vector Add Unsigned Half Word Saturate
  *	v.144
  */
-void ppc_opc_vadduhs()
+void ppc_opc_vadduhs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (uint32)gCPU.vr[vrA].h[i] + (uint32)gCPU.vr[vrB].h[i];
-		gCPU.vr[vrD].h[i] = SATURATE_UH(res);
+		res = (uint32)aCPU.vr[vrA].h[i] + (uint32)aCPU.vr[vrB].h[i];
+		aCPU.vr[vrD].h[i] = SATURATE_UH(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vadduhs()
+JITCFlow ppc_opc_gen_vadduhs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vadduhs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(PALUW(X86_PADDUS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if ((vrA == vrD) || (vrB == vrD)) {
-		int vrS = vrB;
-
-		if (vrD == vrB) {
-			vrS = vrA;
-		}
-
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrD].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrS].b[i]));
-
-			helper_gen_vadduhs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_SUB, reg, reg2);
-			asmALU(X86_ADD, modrma, reg);
-			asmALU(X86_OR, modrma, reg2);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vadduhs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_SUB, reg, reg2);
-			asmALU(X86_ADD, reg, modrma);
-			asmALU(X86_OR, reg, reg2);
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUW(X86_PADDUS), PALUW(X86_PADD), vrD, vrA, vrB);
 	return flowContinue;
-
-#endif
 }
 
 /*	vaddshs		Vector Add Signed Half Word Saturate
  *	v.139
  */
-void ppc_opc_vaddshs()
+void ppc_opc_vaddshs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (sint32)gCPU.vr[vrA].sh[i] + (sint32)gCPU.vr[vrB].sh[i];
-		gCPU.vr[vrD].h[i] = SATURATE_SH(res);
+		res = (sint32)aCPU.vr[vrA].sh[i] + (sint32)aCPU.vr[vrB].sh[i];
+		aCPU.vr[vrD].h[i] = SATURATE_SH(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vaddshs()
+JITCFlow ppc_opc_gen_vaddshs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vaddshs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(PALUW(X86_PADDS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 2) {
-		vec_getHalfS(reg, vrA, i);
-		vec_getHalfS(reg2, vrB, i);
-
-		asmALU(X86_ADD, reg, reg2);
-		vec_saturateSH(reg, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUW(X86_PADDS), PALUW(X86_PADD), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vadduws		Vector Add Unsigned Word Saturate
  *	v.146
  */
-void ppc_opc_vadduws()
+void ppc_opc_vadduws(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] + gCPU.vr[vrB].w[i];
+		res = aCPU.vr[vrA].w[i] + aCPU.vr[vrB].w[i];
 
 		// We do this to prevent us from having to do 64-bit math
-		if (res < gCPU.vr[vrA].w[i]) {
+		if (res < aCPU.vr[vrA].w[i]) {
 			res = 0xFFFFFFFF;
-			gCPU.vscr |= VSCR_SAT;
+			aCPU.vscr |= VSCR_SAT;
 		}
 
 	/*	64-bit math		|	32-bit hack
@@ -3920,38 +2052,38 @@ void ppc_opc_vadduws()
 	 *	sub, subb 	(r>ub)	|	sub		(r<a)
 	 */
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vadduws()
+JITCFlow ppc_opc_gen_vadduws(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vadduws);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vadduws);
+	return flowContinue;
 }
 
 /*	vaddsws		Vector Add Signed Word Saturate
  *	v.140
  */
-void ppc_opc_vaddsws()
+void ppc_opc_vaddsws(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] + gCPU.vr[vrB].w[i];
+		res = aCPU.vr[vrA].w[i] + aCPU.vr[vrB].w[i];
 
 		// We do this to prevent us from having to do 64-bit math
-		if (((gCPU.vr[vrA].w[i] ^ gCPU.vr[vrB].w[i]) & SIGN32) == 0) {
+		if (((aCPU.vr[vrA].w[i] ^ aCPU.vr[vrB].w[i]) & SIGN32) == 0) {
 			// the signs of both operands are the same
 
-			if (((res ^ gCPU.vr[vrA].w[i]) & SIGN32) != 0) {
+			if (((res ^ aCPU.vr[vrA].w[i]) & SIGN32) != 0) {
 				// sign of result != sign of operands
 
 				// if res is negative, should have been positive
 				res = (res & SIGN32) ? (SIGN32 - 1) : SIGN32;
-				gCPU.vscr |= VSCR_SAT;
+				aCPU.vscr |= VSCR_SAT;
 			}
 		}
 
@@ -3963,648 +2095,241 @@ void ppc_opc_vaddsws()
 	 *				|	and		(which)
 	 */
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vaddsws()
-{
-	ppc_opc_gen_interpret(ppc_opc_vaddsws);
-	return flowEndBlock;
-}
-
-static inline void helper_gen_vsububm(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
+JITCFlow ppc_opc_gen_vaddsws(JITC &jitc)
 {
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_AND, reg, modrmb);
-	asmALU(X86_XOR, reg2, modrmb);
-
-	asmShift(X86_SHL, reg, 1);
-	asmALU(X86_AND, reg2, 0xfefefefe);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x01010100);
+	ppc_opc_gen_interpret(jitc, ppc_opc_vaddsws);
+	return flowContinue;
 }
 
 /*	vsububm		Vector Subtract Unsigned Byte Modulo
  *	v.265
  */
-void ppc_opc_vsububm()
+void ppc_opc_vsububm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint8 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = gCPU.vr[vrA].b[i] - gCPU.vr[vrB].b[i];
-		gCPU.vr[vrD].b[i] = res;
+		res = aCPU.vr[vrA].b[i] - aCPU.vr[vrB].b[i];
+		aCPU.vr[vrD].b[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vsububm()
+JITCFlow ppc_opc_gen_vsububm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsububm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUB(X86_PSUB), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsububm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_SUB, reg2, modrmb);
-			asmALU(X86_ADD, modrma, reg2);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsububm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_SUB, reg2, modrmb);
-			asmALU(X86_ADD, reg2, modrma);
-
-			vec_setWord(vrD, i, reg2);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUB(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
-}
-
-static inline void helper_gen_vsubuhm(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
-{
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_AND, reg, modrmb);
-	asmALU(X86_XOR, reg2, modrmb);
-
-	asmShift(X86_SHL, reg, 1);
-	asmALU(X86_AND, reg2, 0xfffefffe);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x00010000);
 }
 
-
 /*	vsubuhm		Vector Subtract Unsigned Half Word Modulo
  *	v.267
  */
-void ppc_opc_vsubuhm()
+void ppc_opc_vsubuhm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = gCPU.vr[vrA].h[i] - gCPU.vr[vrB].h[i];
-		gCPU.vr[vrD].h[i] = res;
+		res = aCPU.vr[vrA].h[i] - aCPU.vr[vrB].h[i];
+		aCPU.vr[vrD].h[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vsubuhm()
+JITCFlow ppc_opc_gen_vsubuhm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubuhm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUW(X86_PSUB), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsubuhm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_SUB, reg2, modrmb);
-			asmALU(X86_ADD, modrma, reg2);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsubuhm(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_SUB, reg2, modrmb);
-			asmALU(X86_ADD, reg2, modrma);
-
-			vec_setWord(vrD, i, reg2);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUW(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vsubuwm		Vector Subtract Unsigned Word Modulo
  *	v.269
  */
-void ppc_opc_vsubuwm()
+void ppc_opc_vsubuwm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] - gCPU.vr[vrB].w[i];
-		gCPU.vr[vrD].w[i] = res;
+		res = aCPU.vr[vrA].w[i] - aCPU.vr[vrB].w[i];
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vsubuwm()
+JITCFlow ppc_opc_gen_vsubuwm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubuwm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUD(X86_PSUB), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-	NativeReg reg = jitcAllocRegister();
-
-	if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg, vrB, i);
-
-			asmALU(X86_SUB,
-				x86_mem2(modrm, &(gCPU.vr[vrD].b[i])), reg);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg, vrA, i);
-
-			asmALU(X86_SUB, reg,
-				x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUD(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vsubfp		Vector Subtract Float Point
  *	v.261
  */
-void ppc_opc_vsubfp()
+void ppc_opc_vsubfp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	float res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		res = gCPU.vr[vrA].f[i] - gCPU.vr[vrB].f[i];
-		gCPU.vr[vrD].f[i] = res;
+		res = aCPU.vr[vrA].f[i] - aCPU.vr[vrB].f[i];
+		aCPU.vr[vrD].f[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vsubfp()
+JITCFlow ppc_opc_gen_vsubfp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubfp);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE_AVAIL) {
-		noncommutative_operation(X86_SUBPS, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	ppc_opc_gen_interpret(ppc_opc_vsubfp);
-	return flowEndBlock;
-#endif
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, X86_SUBPS, vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vsubcuw		Vector Subtract Carryout Unsigned Word
  *	v.260
  */
-void ppc_opc_vsubcuw()
+void ppc_opc_vsubcuw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] - gCPU.vr[vrB].w[i];
-		gCPU.vr[vrD].w[i] = (res <= gCPU.vr[vrA].w[i]) ? 1 : 0;
+		res = aCPU.vr[vrA].w[i] - aCPU.vr[vrB].w[i];
+		aCPU.vr[vrD].w[i] = (res <= aCPU.vr[vrA].w[i]) ? 1 : 0;
 	}
 }
-JITCFlow ppc_opc_gen_vsubcuw()
+JITCFlow ppc_opc_gen_vsubcuw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubcuw);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		// no need to flush vrA, vrB, their values are irrelevant here
-		jitcDropClientVectorRegister(vrD);
-
-		NativeReg reg = jitcAllocRegister();
-		asmMOV_NoFlags(reg, 1);	// avoid flag clobber
-
-		vec_setWord(vrD, 0, reg);
-		vec_setWord(vrD, 4, reg);
-		vec_setWord(vrD, 8, reg);
-		vec_setWord(vrD,12, reg);
-	} else {
-		jitcFlushClientVectorRegister(vrA);
-		jitcFlushClientVectorRegister(vrB);
-		jitcFlushClientVectorRegister(vrD);
-
-		NativeReg reg = jitcAllocRegister(NATIVE_REG_8);
-
-		for (int i=0; i<16; i += 4) {
-			vec_getWord(reg, vrA, i);
-
-			asmALU(X86_SUB, reg, 
-				x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-			asmSET(X86_NC, (NativeReg8)reg);
-
-			asmMOVxx(X86_MOVZX, reg, (NativeReg8)reg);
-
-			vec_setWord(vrD, i, reg);
-		}
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsubcuw);
 	return flowContinue;
-#endif
-}
-
-static inline void helper_gen_vsububs(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
-{
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_XOR, reg, modrmb);
-	asmALU(X86_AND, reg2, modrmb);
-
-	asmShift(X86_SHR, reg, 1);
-	asmALU(X86_AND, reg, 0x7f7f7f7f);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x80808080);
-
-	asmShift(X86_SHR, reg2, 7);
-	asmALU(X86_ADD, reg2, 0x7f7f7f7f);
-	asmALU(X86_XOR, reg2, 0x7f7f7f7f);
-	NativeAddress skip = asmJxxFixup(X86_Z);
-
-	vec_raise_saturate();
-
-	asmResolveFixup(skip);
 }
 
 /*	vsububs		Vector Subtract Unsigned Byte Saturate
  *	v.266
  */
-void ppc_opc_vsububs()
+void ppc_opc_vsububs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = (uint16)gCPU.vr[vrA].b[i] - (uint16)gCPU.vr[vrB].b[i];
+		res = (uint16)aCPU.vr[vrA].b[i] - (uint16)aCPU.vr[vrB].b[i];
 
-		gCPU.vr[vrD].b[i] = SATURATE_0B(res);
+		aCPU.vr[vrD].b[i] = SATURATE_0B(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsububs()
+JITCFlow ppc_opc_gen_vsububs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsububs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUB(X86_PSUBUS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrD].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsububs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_OR, reg, reg2);
-
-			asmALU(X86_OR, modrma, reg2);
-			asmALU(X86_SUB, modrma, reg);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsububs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_OR, reg, reg2);
-
-			asmALU(X86_OR, reg2, modrma);
-			asmALU(X86_SUB, reg2, reg);
-
-			vec_setWord(vrD, i, reg2);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUB(X86_PSUBUS), PALUB(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vsubsbs		Vector Subtract Signed Byte Saturate
  *	v.262
  */
-void ppc_opc_vsubsbs()
+void ppc_opc_vsubsbs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = (sint16)gCPU.vr[vrA].sb[i] - (sint16)gCPU.vr[vrB].sb[i];
+		res = (sint16)aCPU.vr[vrA].sb[i] - (sint16)aCPU.vr[vrB].sb[i];
 
-		gCPU.vr[vrD].sb[i] = SATURATE_SB(res);
+		aCPU.vr[vrD].sb[i] = SATURATE_SB(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsubsbs()
+JITCFlow ppc_opc_gen_vsubsbs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubsbs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUB(X86_PSUBS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister(NATIVE_REG_8);
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i++) {
-		vec_getByteS(reg, vrA, i);
-		vec_getByteS(reg2, vrB, i);
-
-		asmALU(X86_SUB, reg, reg2);
-		vec_saturateSB(reg, reg2);
-
-		vec_setByte(vrD, REG_NO, i, (NativeReg8)reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUB(X86_PSUBS), PALUB(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
-}
-
-static inline void helper_gen_vsubuhs(NativeReg reg, NativeReg reg2, modrm_p modrma, modrm_p modrmb)
-{
-	asmALU(X86_MOV, reg, modrma);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_MOV, reg2, reg);
-
-	asmALU(X86_XOR, reg, modrmb);
-	asmALU(X86_AND, reg2, modrmb);
-
-	asmShift(X86_SHR, reg, 1);
-	asmALU(X86_AND, reg, 0x7fff7fff);
-
-	asmALU(X86_ADD, reg2, reg);
-	asmALU(X86_AND, reg2, 0x80008000);
-
-	asmShift(X86_SHR, reg2, 15);
-	asmALU(X86_ADD, reg2, 0x7fff7fff);
-	asmALU(X86_XOR, reg2, 0x7fff7fff);
-	NativeAddress skip = asmJxxFixup(X86_Z);
-
-	vec_raise_saturate();
-
-	asmResolveFixup(skip);
 }
 
 /*	vsubuhs		Vector Subtract Unsigned Half Word Saturate
  *	v.268
  */
-void ppc_opc_vsubuhs()
+void ppc_opc_vsubuhs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (uint32)gCPU.vr[vrA].h[i] - (uint32)gCPU.vr[vrB].h[i];
+		res = (uint32)aCPU.vr[vrA].h[i] - (uint32)aCPU.vr[vrB].h[i];
 
-		gCPU.vr[vrD].h[i] = SATURATE_0H(res);
+		aCPU.vr[vrD].h[i] = SATURATE_0H(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsubuhs()
+JITCFlow ppc_opc_gen_vsubuhs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubuhs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUW(X86_PSUBUS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	if (vrA == vrD) {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrD].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsubuhs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_OR, reg, reg2);
-
-			asmALU(X86_OR, modrma, reg2);
-			asmALU(X86_SUB, modrma, reg);
-		}
-	} else {
-		for (int i=0; i<16; i += 4) {
-			x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-			x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-			helper_gen_vsubuhs(reg, reg2, modrma, modrmb);
-
-			asmALU(X86_MOV, reg, modrmb);
-			asmALU(X86_OR, reg, reg2);
-
-			asmALU(X86_OR, reg2, modrma);
-			asmALU(X86_SUB, reg2, reg);
-
-			vec_setWord(vrD, i, reg2);
-		}
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUW(X86_PSUBUS), PALUW(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vsubshs		Vector Subtract Signed Half Word Saturate
  *	v.263
  */
-void ppc_opc_vsubshs()
+void ppc_opc_vsubshs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (sint32)gCPU.vr[vrA].sh[i] - (sint32)gCPU.vr[vrB].sh[i];
+		res = (sint32)aCPU.vr[vrA].sh[i] - (sint32)aCPU.vr[vrB].sh[i];
 
-		gCPU.vr[vrD].sh[i] = SATURATE_SH(res);
+		aCPU.vr[vrD].sh[i] = SATURATE_SH(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsubshs()
+JITCFlow ppc_opc_gen_vsubshs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubshs);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		noncommutative_operation(PALUW(X86_PSUBS), vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 2) {
-		vec_getHalfS(reg, vrA, i);
-		vec_getHalfS(reg2, vrB, i);
-
-		asmALU(X86_SUB, reg, reg2);
-		vec_saturateSH(reg, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_saturating_operation(jitc, PALUW(X86_PSUBS), PALUW(X86_PSUB), vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vsubuws		Vector Subtract Unsigned Word Saturate
  *	v.270
  */
-void ppc_opc_vsubuws()
+void ppc_opc_vsubuws(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i] - gCPU.vr[vrB].w[i];
+		res = aCPU.vr[vrA].w[i] - aCPU.vr[vrB].w[i];
 
 		// We do this to prevent us from having to do 64-bit math
-		if (res > gCPU.vr[vrA].w[i]) {
+		if (res > aCPU.vr[vrA].w[i]) {
 			res = 0;
-			gCPU.vscr |= VSCR_SAT;
+			aCPU.vscr |= VSCR_SAT;
 		}
 
 	/*	64-bit math		|	32-bit hack
@@ -4613,61 +2338,31 @@ void ppc_opc_vsubuws()
 	 *	sub, subb 	(r>ub)	|	sub		(r<a)
 	 */
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vsubuws()
+JITCFlow ppc_opc_gen_vsubuws(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubuws);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 4) {
-		vec_getWord(reg, vrA, i);
-
-		asmALU(X86_SUB, reg,
-			x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		NativeAddress skip = asmJxxFixup(X86_NC);
-
-		asmALU(X86_XOR, reg, reg);
-
-		asmResolveFixup(skip);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsubuws);
 	return flowContinue;
-#endif
 }
 
 /*	vsubsws		Vector Subtract Signed Word Saturate
  *	v.264
  */
-void ppc_opc_vsubsws()
+void ppc_opc_vsubsws(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res, tmp;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		tmp = -gCPU.vr[vrB].w[i];
-		res = gCPU.vr[vrA].w[i] + tmp;
+		tmp = -aCPU.vr[vrB].w[i];
+		res = aCPU.vr[vrA].w[i] + tmp;
 
 		// We do this to prevent us from having to do 64-bit math
-		if (((gCPU.vr[vrA].w[i] ^ tmp) & SIGN32) == 0) {
+		if (((aCPU.vr[vrA].w[i] ^ tmp) & SIGN32) == 0) {
 			// the signs of both operands are the same
 
 			if (((res ^ tmp) & SIGN32) != 0) {
@@ -4675,7 +2370,7 @@ void ppc_opc_vsubsws()
 
 				// if res is negative, should have been positive
 				res = (res & SIGN32) ? (SIGN32 - 1) : SIGN32;
-				gCPU.vscr |= VSCR_SAT;
+				aCPU.vscr |= VSCR_SAT;
 			}
 		}
 
@@ -4687,826 +2382,472 @@ void ppc_opc_vsubsws()
 	 *				|	and		(which)
 	 */
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vsubsws()
+JITCFlow ppc_opc_gen_vsubsws(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vsubsws);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 4) {
-		vec_getWord(reg, vrA, i);
-
-		asmALU(X86_SUB, reg,
-			x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		NativeAddress skip = asmJxxFixup(X86_NO);
-
-		asmMOV_NoFlags(reg, 0x80000000);
-
-		asmResolveFixup(skip);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsubsws);
 	return flowContinue;
-#endif
 }
 
 /*	vmuleub		Vector Multiply Even Unsigned Byte
  *	v.209
  */
-void ppc_opc_vmuleub()
+void ppc_opc_vmuleub(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (uint16)gCPU.vr[vrA].b[VECT_EVEN(i)] *
-			 (uint16)gCPU.vr[vrB].b[VECT_EVEN(i)];
+		res = (uint16)aCPU.vr[vrA].b[VECT_EVEN(i)] *
+			 (uint16)aCPU.vr[vrB].b[VECT_EVEN(i)];
 
-		gCPU.vr[vrD].h[i] = res;
+		aCPU.vr[vrD].h[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmuleub()
+JITCFlow ppc_opc_gen_vmuleub(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmuleub);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getByteZ(reg1, vrA, i+1);
-		vec_getByteZ(reg2, vrB, i+1);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmuleub);
 	return flowContinue;
-#endif
 }
 
 /*	vmulesb		Vector Multiply Even Signed Byte
  *	v.207
  */
-void ppc_opc_vmulesb()
+void ppc_opc_vmulesb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (sint16)gCPU.vr[vrA].sb[VECT_EVEN(i)] *
-			 (sint16)gCPU.vr[vrB].sb[VECT_EVEN(i)];
+		res = (sint16)aCPU.vr[vrA].sb[VECT_EVEN(i)] *
+			 (sint16)aCPU.vr[vrB].sb[VECT_EVEN(i)];
 
-		gCPU.vr[vrD].sh[i] = res;
+		aCPU.vr[vrD].sh[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmulesb()
+JITCFlow ppc_opc_gen_vmulesb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmulesb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getByteS(reg1, vrA, i+1);
-		vec_getByteS(reg2, vrB, i+1);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmulesb);
 	return flowContinue;
-#endif
 }
 
 /*	vmuleuh		Vector Multiply Even Unsigned Half Word
  *	v.210
  */
-void ppc_opc_vmuleuh()
+void ppc_opc_vmuleuh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (uint32)gCPU.vr[vrA].h[VECT_EVEN(i)] *
-			 (uint32)gCPU.vr[vrB].h[VECT_EVEN(i)];
+		res = (uint32)aCPU.vr[vrA].h[VECT_EVEN(i)] *
+			 (uint32)aCPU.vr[vrB].h[VECT_EVEN(i)];
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmuleuh()
+JITCFlow ppc_opc_gen_vmuleuh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmuleuh);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getHalfZ(reg1, vrA, i+2);
-		vec_getHalfZ(reg2, vrB, i+2);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setWord(vrD, i, reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmuleuh);
 	return flowContinue;
-#endif
 }
 
 /*	vmulesh		Vector Multiply Even Signed Half Word
  *	v.208
  */
-void ppc_opc_vmulesh()
+void ppc_opc_vmulesh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (sint32)gCPU.vr[vrA].sh[VECT_EVEN(i)] *
-			 (sint32)gCPU.vr[vrB].sh[VECT_EVEN(i)];
+		res = (sint32)aCPU.vr[vrA].sh[VECT_EVEN(i)] *
+			 (sint32)aCPU.vr[vrB].sh[VECT_EVEN(i)];
 
-		gCPU.vr[vrD].sw[i] = res;
+		aCPU.vr[vrD].sw[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmulesh()
+JITCFlow ppc_opc_gen_vmulesh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmulesh);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getHalfS(reg1, vrA, i+2);
-		vec_getHalfS(reg2, vrB, i+2);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setWord(vrD, i, reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmulesh);
 	return flowContinue;
-#endif
 }
 
 /*	vmuloub		Vector Multiply Odd Unsigned Byte
  *	v.213
  */
-void ppc_opc_vmuloub()
+void ppc_opc_vmuloub(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (uint16)gCPU.vr[vrA].b[VECT_ODD(i)] *
-			 (uint16)gCPU.vr[vrB].b[VECT_ODD(i)];
+		res = (uint16)aCPU.vr[vrA].b[VECT_ODD(i)] *
+			 (uint16)aCPU.vr[vrB].b[VECT_ODD(i)];
 
-		gCPU.vr[vrD].h[i] = res;
+		aCPU.vr[vrD].h[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmuloub()
+JITCFlow ppc_opc_gen_vmuloub(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmuloub);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getByteZ(reg1, vrA, i);
-		vec_getByteZ(reg2, vrB, i);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmuloub);
 	return flowContinue;
-#endif
 }
 
 /*	vmulosb		Vector Multiply Odd Signed Byte
  *	v.211
  */
-void ppc_opc_vmulosb()
+void ppc_opc_vmulosb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (sint16)gCPU.vr[vrA].sb[VECT_ODD(i)] *
-			 (sint16)gCPU.vr[vrB].sb[VECT_ODD(i)];
+		res = (sint16)aCPU.vr[vrA].sb[VECT_ODD(i)] *
+			 (sint16)aCPU.vr[vrB].sb[VECT_ODD(i)];
 
-		gCPU.vr[vrD].sh[i] = res;
+		aCPU.vr[vrD].sh[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmulosb()
+JITCFlow ppc_opc_gen_vmulosb(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmulosb);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getByteS(reg1, vrA, i);
-		vec_getByteS(reg2, vrB, i);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmulosb);
 	return flowContinue;
-#endif
 }
 
 /*	vmulouh		Vector Multiply Odd Unsigned Half Word
  *	v.214
  */
-void ppc_opc_vmulouh()
+void ppc_opc_vmulouh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (uint32)gCPU.vr[vrA].h[VECT_ODD(i)] *
-			 (uint32)gCPU.vr[vrB].h[VECT_ODD(i)];
+		res = (uint32)aCPU.vr[vrA].h[VECT_ODD(i)] *
+			 (uint32)aCPU.vr[vrB].h[VECT_ODD(i)];
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmulouh()
+JITCFlow ppc_opc_gen_vmulouh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmulouh);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getHalfZ(reg1, vrA, i);
-		vec_getHalfZ(reg2, vrB, i);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setWord(vrD, i, reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmulouh);
 	return flowContinue;
-#endif
 }
 
 /*	vmulosh		Vector Multiply Odd Signed Half Word
  *	v.212
  */
-void ppc_opc_vmulosh()
+void ppc_opc_vmulosh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (sint32)gCPU.vr[vrA].sh[VECT_ODD(i)] *
-			 (sint32)gCPU.vr[vrB].sh[VECT_ODD(i)];
+		res = (sint32)aCPU.vr[vrA].sh[VECT_ODD(i)] *
+			 (sint32)aCPU.vr[vrB].sh[VECT_ODD(i)];
 
-		gCPU.vr[vrD].sw[i] = res;
+		aCPU.vr[vrD].sw[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmulosh()
+JITCFlow ppc_opc_gen_vmulosh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmulosh);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getHalfS(reg1, vrA, i);
-		vec_getHalfS(reg2, vrB, i);
-
-		asmIMUL(reg1, reg2);
-
-		vec_setWord(vrD, i, reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmulosh);
 	return flowContinue;
-#endif
 }
 
 /*	vmaddfp		Vector Multiply Add Floating Point
  *	v.177
  */
-void ppc_opc_vmaddfp()
+void ppc_opc_vmaddfp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	double res;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		res = (double)gCPU.vr[vrA].f[i] * (double)gCPU.vr[vrC].f[i];
+		res = (double)aCPU.vr[vrA].f[i] * (double)aCPU.vr[vrC].f[i];
 
-		res = (double)gCPU.vr[vrB].f[i] + res;
+		res = (double)aCPU.vr[vrB].f[i] + res;
 
-		gCPU.vr[vrD].f[i] = (float)res;
+		aCPU.vr[vrD].f[i] = (float)res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaddfp()
+JITCFlow ppc_opc_gen_vmaddfp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmaddfp);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB, vrC;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_MULPS, vrT, vrA, vrC);
-		commutative_operation(X86_ADDPS, vrD, vrB, vrT);
-		return flowContinue;
-	}
-
-	ppc_opc_gen_interpret(ppc_opc_vmaddfp);
-	return flowEndBlock;
-#endif
+	PPC_OPC_TEMPL_A(jitc.current_opc, vrD, vrA, vrB, vrC);
+
+	NativeVectorReg t = vec_temp_copy(jitc, vrA);
+	NativeVectorReg c = jitc.getClientVectorRegister(vrC);
+	jitc.asmALUPS(X86_MULPS, t, c);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	jitc.asmALUPS(X86_ADDPS, t, b);
+	jitc.renameVectorRegisterDirty(t, vrD);
+	return flowContinue;
 }
 
 /*	vmhaddshs	Vector Multiply High and Add Signed Half Word Saturate
  *	v.185
  */
-void ppc_opc_vmhaddshs()
+void ppc_opc_vmhaddshs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	sint32 prod;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<8; i++) {
-		prod = (sint32)gCPU.vr[vrA].sh[i] * (sint32)gCPU.vr[vrB].sh[i];
+		prod = (sint32)aCPU.vr[vrA].sh[i] * (sint32)aCPU.vr[vrB].sh[i];
 
-		prod = (prod >> 15) + (sint32)gCPU.vr[vrC].sh[i];
+		prod = (prod >> 15) + (sint32)aCPU.vr[vrC].sh[i];
 
-		gCPU.vr[vrD].sh[i] = SATURATE_SH(prod);
+		aCPU.vr[vrD].sh[i] = SATURATE_SH(aCPU, prod);
 	}
 }
-JITCFlow ppc_opc_gen_vmhaddshs()
+JITCFlow ppc_opc_gen_vmhaddshs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmhaddshs);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB, vrC;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcFlushClientVectorRegister(vrC);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getHalfS(reg1, vrA, i);
-		vec_getHalfS(reg2, vrB, i);
-
-		asmIMUL(reg1, reg2);
-		asmShift(X86_SAR, reg1, 15);
-
-		vec_getHalfS(reg2, vrC, i);
-		asmALU(X86_ADD, reg1, reg2);
-
-		vec_saturateSH(reg1, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmhaddshs);
 	return flowContinue;
-#endif
 }
 
 /*	vmladduhm	Vector Multiply Low and Add Unsigned Half Word Modulo
  *	v.194
  */
-void ppc_opc_vmladduhm()
+void ppc_opc_vmladduhm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	uint32 prod;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<8; i++) {
-		prod = (uint32)gCPU.vr[vrA].h[i] * (uint32)gCPU.vr[vrB].h[i];
+		prod = (uint32)aCPU.vr[vrA].h[i] * (uint32)aCPU.vr[vrB].h[i];
 
-		prod = prod + (uint32)gCPU.vr[vrC].h[i];
+		prod = prod + (uint32)aCPU.vr[vrC].h[i];
 
-		gCPU.vr[vrD].h[i] = prod;
+		aCPU.vr[vrD].h[i] = prod;
 	}
 }
-JITCFlow ppc_opc_gen_vmladduhm()
+JITCFlow ppc_opc_gen_vmladduhm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmladduhm);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB, vrC;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(X86_PMULLW, vrT, vrA, vrB);
-		commutative_operation(PALUW(X86_PADD), vrD, vrT, vrC);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcFlushClientVectorRegister(vrC);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg16 reg1 = (NativeReg16)jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getHalfZ((NativeReg)reg1, vrA, i);
-		vec_getHalfZ(reg2, vrB, i);
-
-		asmIMUL((NativeReg)reg1, reg2);
-
-		if (vrC == vrD) {
-			asmALU(X86_ADD,
-				x86_mem2(modrm, &(gCPU.vr[vrD].b[i])), reg1);
-		} else {
-			asmALU(X86_ADD, reg1,
-				x86_mem2(modrm, &(gCPU.vr[vrC].b[i])));
-
-			vec_setHalf(vrD, i, reg1);
-		}
-	}
-
+	PPC_OPC_TEMPL_A(jitc.current_opc, vrD, vrA, vrB, vrC);
+
+	NativeVectorReg t = vec_temp_copy(jitc, vrA);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	jitc.asmPALU(X86_PMULLW, t, b);
+	NativeVectorReg c = jitc.getClientVectorRegister(vrC);
+	jitc.asmPALU(PALUW(X86_PADD), t, c);
+	jitc.renameVectorRegisterDirty(t, vrD);
 	return flowContinue;
-#endif
 }
 
 /*	vmhraddshs	Vector Multiply High Round and Add Signed Half Word Saturate
  *	v.186
  */
-void ppc_opc_vmhraddshs()
+void ppc_opc_vmhraddshs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	sint32 prod;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<8; i++) {
-		prod = (sint32)gCPU.vr[vrA].sh[i] * (sint32)gCPU.vr[vrB].sh[i];
+		prod = (sint32)aCPU.vr[vrA].sh[i] * (sint32)aCPU.vr[vrB].sh[i];
 
 		prod += 0x4000;
-		prod = (prod >> 15) + (sint32)gCPU.vr[vrC].sh[i];
+		prod = (prod >> 15) + (sint32)aCPU.vr[vrC].sh[i];
 
-		gCPU.vr[vrD].sh[i] = SATURATE_SH(prod);
+		aCPU.vr[vrD].sh[i] = SATURATE_SH(aCPU, prod);
 	}
 }
-JITCFlow ppc_opc_gen_vmhraddshs()
+JITCFlow ppc_opc_gen_vmhraddshs(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmhraddshs);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB, vrC;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcFlushClientVectorRegister(vrC);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=2) {
-		vec_getHalfS(reg1, vrA, i);
-		vec_getHalfS(reg2, vrB, i);
-
-		asmIMUL(reg1, reg2);
-		asmALU(X86_ADD, reg1, 0x4000);
-		asmShift(X86_SAR, reg1, 15);
-
-		vec_getHalfS(reg2, vrC, i);
-		asmALU(X86_ADD, reg1, reg2);
-
-		vec_saturateSH(reg1, reg2);
-
-		vec_setHalf(vrD, i, (NativeReg16)reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmhraddshs);
 	return flowContinue;
-#endif
 }
 
 /*	vmsumubm	Vector Multiply Sum Unsigned Byte Modulo
  *	v.204
  */
-void ppc_opc_vmsumubm()
+void ppc_opc_vmsumubm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	uint32 temp;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<4; i++) {
-		temp = gCPU.vr[vrC].w[i];
+		temp = aCPU.vr[vrC].w[i];
 
-		temp += (uint16)gCPU.vr[vrA].b[i<<2] *
-			(uint16)gCPU.vr[vrB].b[i<<2];
+		temp += (uint16)aCPU.vr[vrA].b[i<<2] *
+			(uint16)aCPU.vr[vrB].b[i<<2];
 
-		temp += (uint16)gCPU.vr[vrA].b[(i<<2)+1] *
-			(uint16)gCPU.vr[vrB].b[(i<<2)+1];
+		temp += (uint16)aCPU.vr[vrA].b[(i<<2)+1] *
+			(uint16)aCPU.vr[vrB].b[(i<<2)+1];
 
-		temp += (uint16)gCPU.vr[vrA].b[(i<<2)+2] *
-			(uint16)gCPU.vr[vrB].b[(i<<2)+2];
+		temp += (uint16)aCPU.vr[vrA].b[(i<<2)+2] *
+			(uint16)aCPU.vr[vrB].b[(i<<2)+2];
 
-		temp += (uint16)gCPU.vr[vrA].b[(i<<2)+3] *
-			(uint16)gCPU.vr[vrB].b[(i<<2)+3];
+		temp += (uint16)aCPU.vr[vrA].b[(i<<2)+3] *
+			(uint16)aCPU.vr[vrB].b[(i<<2)+3];
 
-		gCPU.vr[vrD].w[i] = temp;
+		aCPU.vr[vrD].w[i] = temp;
 	}
 }
-JITCFlow ppc_opc_gen_vmsumubm()
+JITCFlow ppc_opc_gen_vmsumubm(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmsumubm);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmsumubm);
+	return flowContinue;
 }
 
 /*	vmsumuhm	Vector Multiply Sum Unsigned Half Word Modulo
  *	v.205
  */
-void ppc_opc_vmsumuhm()
+void ppc_opc_vmsumuhm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	uint32 temp;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<4; i++) {
-		temp = gCPU.vr[vrC].w[i];
+		temp = aCPU.vr[vrC].w[i];
 
-		temp += (uint32)gCPU.vr[vrA].h[i<<1] *
-			(uint32)gCPU.vr[vrB].h[i<<1];
-		temp += (uint32)gCPU.vr[vrA].h[(i<<1)+1] *
-			(uint32)gCPU.vr[vrB].h[(i<<1)+1];
+		temp += (uint32)aCPU.vr[vrA].h[i<<1] *
+			(uint32)aCPU.vr[vrB].h[i<<1];
+		temp += (uint32)aCPU.vr[vrA].h[(i<<1)+1] *
+			(uint32)aCPU.vr[vrB].h[(i<<1)+1];
 
-		gCPU.vr[vrD].w[i] = temp;
+		aCPU.vr[vrD].w[i] = temp;
 	}
 }
-JITCFlow ppc_opc_gen_vmsumuhm()
+JITCFlow ppc_opc_gen_vmsumuhm(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmsumuhm);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmsumuhm);
+	return flowContinue;
 }
 
 /*	vmsummbm	Vector Multiply Sum Mixed-Sign Byte Modulo
  *	v.201
  */
-void ppc_opc_vmsummbm()
+void ppc_opc_vmsummbm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	sint32 temp;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<4; i++) {
-		temp = gCPU.vr[vrC].sw[i];
+		temp = aCPU.vr[vrC].sw[i];
 
-		temp += (sint16)gCPU.vr[vrA].sb[i<<2] *
-			(uint16)gCPU.vr[vrB].b[i<<2];
-		temp += (sint16)gCPU.vr[vrA].sb[(i<<2)+1] *
-			(uint16)gCPU.vr[vrB].b[(i<<2)+1];
-		temp += (sint16)gCPU.vr[vrA].sb[(i<<2)+2] *
-			(uint16)gCPU.vr[vrB].b[(i<<2)+2];
-		temp += (sint16)gCPU.vr[vrA].sb[(i<<2)+3] *
-			(uint16)gCPU.vr[vrB].b[(i<<2)+3];
+		temp += (sint16)aCPU.vr[vrA].sb[i<<2] *
+			(uint16)aCPU.vr[vrB].b[i<<2];
+		temp += (sint16)aCPU.vr[vrA].sb[(i<<2)+1] *
+			(uint16)aCPU.vr[vrB].b[(i<<2)+1];
+		temp += (sint16)aCPU.vr[vrA].sb[(i<<2)+2] *
+			(uint16)aCPU.vr[vrB].b[(i<<2)+2];
+		temp += (sint16)aCPU.vr[vrA].sb[(i<<2)+3] *
+			(uint16)aCPU.vr[vrB].b[(i<<2)+3];
 
-		gCPU.vr[vrD].sw[i] = temp;
+		aCPU.vr[vrD].sw[i] = temp;
 	}
 }
-JITCFlow ppc_opc_gen_vmsummbm()
+JITCFlow ppc_opc_gen_vmsummbm(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmsummbm);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB, vrC;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcFlushClientVectorRegister(vrC);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg1 = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-	NativeReg reg3 = jitcAllocRegister();
-
-	for (int i=0; i<16; i+=4) {
-		vec_getWord(reg1, vrC, i);
-
-		for (int j=0; j<4; j++) {
-			vec_getByteS(reg2, vrA, i+j);
-			vec_getByteZ(reg3, vrB, i+j);
-
-			asmIMUL(reg2, reg3);
-			asmALU(X86_ADD, reg1, reg2);
-		}
-
-		vec_setWord(vrD, i, reg1);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmsummbm);
 	return flowContinue;
-#endif
 }
 
 /*	vmsumshm	Vector Multiply Sum Signed Half Word Modulo
  *	v.202
  */
-void ppc_opc_vmsumshm()
+void ppc_opc_vmsumshm(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	sint32 temp;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<4; i++) {
-		temp = gCPU.vr[vrC].sw[i];
+		temp = aCPU.vr[vrC].sw[i];
 
-		temp += (sint32)gCPU.vr[vrA].sh[i<<1] *
-			(sint32)gCPU.vr[vrB].sh[i<<1];
-		temp += (sint32)gCPU.vr[vrA].sh[(i<<1)+1] *
-			(sint32)gCPU.vr[vrB].sh[(i<<1)+1];
+		temp += (sint32)aCPU.vr[vrA].sh[i<<1] *
+			(sint32)aCPU.vr[vrB].sh[i<<1];
+		temp += (sint32)aCPU.vr[vrA].sh[(i<<1)+1] *
+			(sint32)aCPU.vr[vrB].sh[(i<<1)+1];
 
-		gCPU.vr[vrD].sw[i] = temp;
+		aCPU.vr[vrD].sw[i] = temp;
 	}
 }
-JITCFlow ppc_opc_gen_vmsumshm()
+JITCFlow ppc_opc_gen_vmsumshm(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmsumshm);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmsumshm);
+	return flowContinue;
 }
 
 /*	vmsumuhs	Vector Multiply Sum Unsigned Half Word Saturate
  *	v.206
  */
-void ppc_opc_vmsumuhs()
+void ppc_opc_vmsumuhs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	uint64 temp;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	/* For this, there's no way to get around 64-bit math.  If we use
 	 *   the hacks used before, then we have to do it so often, that
 	 *   we'll outpace the 64-bit math in execution time.
 	 */
 	for (int i=0; i<4; i++) {
-		temp = gCPU.vr[vrC].w[i];
+		temp = aCPU.vr[vrC].w[i];
 
-		temp += (uint32)gCPU.vr[vrA].h[i<<1] *
-			(uint32)gCPU.vr[vrB].h[i<<1];
+		temp += (uint32)aCPU.vr[vrA].h[i<<1] *
+			(uint32)aCPU.vr[vrB].h[i<<1];
 
-		temp += (uint32)gCPU.vr[vrA].h[(i<<1)+1] *
-			(uint32)gCPU.vr[vrB].h[(i<<1)+1];
+		temp += (uint32)aCPU.vr[vrA].h[(i<<1)+1] *
+			(uint32)aCPU.vr[vrB].h[(i<<1)+1];
 
-		gCPU.vr[vrD].w[i] = SATURATE_UW(temp);
+		aCPU.vr[vrD].w[i] = SATURATE_UW(aCPU, temp);
 	}
 }
-JITCFlow ppc_opc_gen_vmsumuhs()
+JITCFlow ppc_opc_gen_vmsumuhs(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmsumuhs);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmsumuhs);
+	return flowContinue;
 }
 
 /*	vmsumshs	Vector Multiply Sum Signed Half Word Saturate
  *	v.203
  */
-void ppc_opc_vmsumshs()
+void ppc_opc_vmsumshs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	sint64 temp;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	/* For this, there's no way to get around 64-bit math.  If we use
 	 *   the hacks used before, then we have to do it so often, that
@@ -5514,31 +2855,31 @@ void ppc_opc_vmsumshs()
 	 */
 
 	for (int i=0; i<4; i++) {
-		temp = gCPU.vr[vrC].sw[i];
+		temp = aCPU.vr[vrC].sw[i];
 
-		temp += (sint32)gCPU.vr[vrA].sh[i<<1] *
-			(sint32)gCPU.vr[vrB].sh[i<<1];
-		temp += (sint32)gCPU.vr[vrA].sh[(i<<1)+1] *
-			(sint32)gCPU.vr[vrB].sh[(i<<1)+1];
+		temp += (sint32)aCPU.vr[vrA].sh[i<<1] *
+			(sint32)aCPU.vr[vrB].sh[i<<1];
+		temp += (sint32)aCPU.vr[vrA].sh[(i<<1)+1] *
+			(sint32)aCPU.vr[vrB].sh[(i<<1)+1];
 
-		gCPU.vr[vrD].sw[i] = SATURATE_SW(temp);
+		aCPU.vr[vrD].sw[i] = SATURATE_SW(aCPU, temp);
 	}
 }
-JITCFlow ppc_opc_gen_vmsumshs()
+JITCFlow ppc_opc_gen_vmsumshs(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmsumshs);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmsumshs);
+	return flowContinue;
 }
 
 /*	vsum4ubs	Vector Sum Across Partial (1/4) Unsigned Byte Saturate
  *	v.275
  */
-void ppc_opc_vsum4ubs()
+void ppc_opc_vsum4ubs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	/* For this, there's no way to get around 64-bit math.  If we use
 	 *   the hacks used before, then we have to do it so often, that
@@ -5546,946 +2887,672 @@ void ppc_opc_vsum4ubs()
 	 */
 
 	for (int i=0; i<4; i++) {
-		res = (uint64)gCPU.vr[vrB].w[i];
+		res = (uint64)aCPU.vr[vrB].w[i];
 
-		res += (uint64)gCPU.vr[vrA].b[(i<<2)];
-		res += (uint64)gCPU.vr[vrA].b[(i<<2)+1];
-		res += (uint64)gCPU.vr[vrA].b[(i<<2)+2];
-		res += (uint64)gCPU.vr[vrA].b[(i<<2)+3];
+		res += (uint64)aCPU.vr[vrA].b[(i<<2)];
+		res += (uint64)aCPU.vr[vrA].b[(i<<2)+1];
+		res += (uint64)aCPU.vr[vrA].b[(i<<2)+2];
+		res += (uint64)aCPU.vr[vrA].b[(i<<2)+3];
 
-		gCPU.vr[vrD].w[i] = SATURATE_UW(res);
+		aCPU.vr[vrD].w[i] = SATURATE_UW(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsum4ubs()
+JITCFlow ppc_opc_gen_vsum4ubs(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsum4ubs);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsum4ubs);
+	return flowContinue;
 }
 
 /*	vsum4sbs	Vector Sum Across Partial (1/4) Signed Byte Saturate
  *	v.273
  */
-void ppc_opc_vsum4sbs()
+void ppc_opc_vsum4sbs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (sint64)gCPU.vr[vrB].sw[i];
+		res = (sint64)aCPU.vr[vrB].sw[i];
 
-		res += (sint64)gCPU.vr[vrA].sb[(i<<2)];
-		res += (sint64)gCPU.vr[vrA].sb[(i<<2)+1];
-		res += (sint64)gCPU.vr[vrA].sb[(i<<2)+2];
-		res += (sint64)gCPU.vr[vrA].sb[(i<<2)+3];
+		res += (sint64)aCPU.vr[vrA].sb[(i<<2)];
+		res += (sint64)aCPU.vr[vrA].sb[(i<<2)+1];
+		res += (sint64)aCPU.vr[vrA].sb[(i<<2)+2];
+		res += (sint64)aCPU.vr[vrA].sb[(i<<2)+3];
 
-		gCPU.vr[vrD].sw[i] = SATURATE_SW(res);
+		aCPU.vr[vrD].sw[i] = SATURATE_SW(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsum4sbs()
+JITCFlow ppc_opc_gen_vsum4sbs(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsum4sbs);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsum4sbs);
+	return flowContinue;
 }
 
 /*	vsum4shs	Vector Sum Across Partial (1/4) Signed Half Word Saturate
  *	v.274
  */
-void ppc_opc_vsum4shs()
+void ppc_opc_vsum4shs(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (sint64)gCPU.vr[vrB].sw[i];
+		res = (sint64)aCPU.vr[vrB].sw[i];
 
-		res += (sint64)gCPU.vr[vrA].sh[(i<<1)];
-		res += (sint64)gCPU.vr[vrA].sh[(i<<1)+1];
+		res += (sint64)aCPU.vr[vrA].sh[(i<<1)];
+		res += (sint64)aCPU.vr[vrA].sh[(i<<1)+1];
 
-		gCPU.vr[vrD].sw[i] = SATURATE_SW(res);
+		aCPU.vr[vrD].sw[i] = SATURATE_SW(aCPU, res);
 	}
 }
-JITCFlow ppc_opc_gen_vsum4shs()
+JITCFlow ppc_opc_gen_vsum4shs(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsum4shs);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsum4shs);
+	return flowContinue;
 }
 
 /*	vsum2sws	Vector Sum Across Partial (1/2) Signed Word Saturate
  *	v.272
  */
-void ppc_opc_vsum2sws()
+void ppc_opc_vsum2sws(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	res = (sint64)gCPU.vr[vrA].sw[0] + (sint64)gCPU.vr[vrA].sw[1];
-	res += (sint64)gCPU.vr[vrB].sw[VECT_ODD(0)];
+	res = (sint64)aCPU.vr[vrA].sw[0] + (sint64)aCPU.vr[vrA].sw[1];
+	res += (sint64)aCPU.vr[vrB].sw[VECT_ODD(0)];
 
-	gCPU.vr[vrD].w[VECT_ODD(0)] = SATURATE_SW(res);
-	gCPU.vr[vrD].w[VECT_EVEN(0)] = 0;
+	aCPU.vr[vrD].w[VECT_ODD(0)] = SATURATE_SW(aCPU, res);
+	aCPU.vr[vrD].w[VECT_EVEN(0)] = 0;
 
-	res = (sint64)gCPU.vr[vrA].sw[2] + (sint64)gCPU.vr[vrA].sw[3];
-	res += (sint64)gCPU.vr[vrB].sw[VECT_ODD(1)];
+	res = (sint64)aCPU.vr[vrA].sw[2] + (sint64)aCPU.vr[vrA].sw[3];
+	res += (sint64)aCPU.vr[vrB].sw[VECT_ODD(1)];
 
-	gCPU.vr[vrD].w[VECT_ODD(1)] = SATURATE_SW(res);
-	gCPU.vr[vrD].w[VECT_EVEN(1)] = 0;
+	aCPU.vr[vrD].w[VECT_ODD(1)] = SATURATE_SW(aCPU, res);
+	aCPU.vr[vrD].w[VECT_EVEN(1)] = 0;
 }
-JITCFlow ppc_opc_gen_vsum2sws()
+JITCFlow ppc_opc_gen_vsum2sws(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsum2sws);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsum2sws);
+	return flowContinue;
 }
 
 /*	vsumsws		Vector Sum Across Signed Word Saturate
  *	v.271
  */
-void ppc_opc_vsumsws()
+void ppc_opc_vsumsws(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	res = (sint64)gCPU.vr[vrA].sw[0] + (sint64)gCPU.vr[vrA].sw[1];
-	res += (sint64)gCPU.vr[vrA].sw[2] + (sint64)gCPU.vr[vrA].sw[3];
+	res = (sint64)aCPU.vr[vrA].sw[0] + (sint64)aCPU.vr[vrA].sw[1];
+	res += (sint64)aCPU.vr[vrA].sw[2] + (sint64)aCPU.vr[vrA].sw[3];
 
-	res += (sint64)VECT_W(gCPU.vr[vrB], 3);
+	res += (sint64)VECT_W(aCPU.vr[vrB], 3);
 
-	VECT_W(gCPU.vr[vrD], 3) = SATURATE_SW(res);
-	VECT_W(gCPU.vr[vrD], 2) = 0;
-	VECT_W(gCPU.vr[vrD], 1) = 0;
-	VECT_W(gCPU.vr[vrD], 0) = 0;
+	VECT_W(aCPU.vr[vrD], 3) = SATURATE_SW(aCPU, res);
+	VECT_W(aCPU.vr[vrD], 2) = 0;
+	VECT_W(aCPU.vr[vrD], 1) = 0;
+	VECT_W(aCPU.vr[vrD], 0) = 0;
 }
-JITCFlow ppc_opc_gen_vsumsws()
+JITCFlow ppc_opc_gen_vsumsws(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vsumsws);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vsumsws);
+	return flowContinue;
 }
 
 /*	vnmsubfp	Vector Negative Multiply-Subtract Floating Point
  *	v.215
  */
-void ppc_opc_vnmsubfp()
+void ppc_opc_vnmsubfp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB, vrC;
 	double res;
-	PPC_OPC_TEMPL_A(gCPU.current_opc, vrD, vrA, vrB, vrC);
+	PPC_OPC_TEMPL_A(aCPU.current_opc, vrD, vrA, vrB, vrC);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		res = (double)gCPU.vr[vrA].f[i] * (double)gCPU.vr[vrC].f[i];
+		res = (double)aCPU.vr[vrA].f[i] * (double)aCPU.vr[vrC].f[i];
 
-		res = (double)gCPU.vr[vrB].f[i] - res;
+		res = (double)aCPU.vr[vrB].f[i] - res;
 
-		gCPU.vr[vrD].f[i] = (float)res;
+		aCPU.vr[vrD].f[i] = (float)res;
 	}
 }
-JITCFlow ppc_opc_gen_vnmsubfp()
+JITCFlow ppc_opc_gen_vnmsubfp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vnmsubfp);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB, vrC;
-	PPC_OPC_TEMPL_A(gJITC.current_opc, vrD, vrA, vrB, vrC);
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_MULPS, vrT, vrA, vrC);
-		noncommutative_operation(X86_SUBPS, vrD, vrB, vrT);
-		return flowContinue;
-	}
-
-	ppc_opc_gen_interpret(ppc_opc_vnmsubfp);
-	return flowEndBlock;
-#endif
+	PPC_OPC_TEMPL_A(jitc.current_opc, vrD, vrA, vrB, vrC);
+
+	NativeVectorReg t = vec_temp_copy(jitc, vrA);
+	NativeVectorReg c = jitc.getClientVectorRegister(vrC);
+	jitc.asmALUPS(X86_MULPS, t, c);
+	NativeVectorReg d = vec_temp_copy(jitc, vrB);
+	jitc.asmALUPS(X86_SUBPS, d, t);
+	jitc.renameVectorRegisterDirty(d, vrD);
+	return flowContinue;
 }
 
 /*	vavgub		Vector Average Unsigned Byte
  *	v.152
  */
-void ppc_opc_vavgub()
+void ppc_opc_vavgub(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = (uint16)gCPU.vr[vrA].b[i] +
-			(uint16)gCPU.vr[vrB].b[i] + 1;
+		res = (uint16)aCPU.vr[vrA].b[i] +
+			(uint16)aCPU.vr[vrB].b[i] + 1;
 
-		gCPU.vr[vrD].b[i] = (res >> 1);
+		aCPU.vr[vrD].b[i] = (res >> 1);
 	}
 }
-JITCFlow ppc_opc_gen_vavgub()
+JITCFlow ppc_opc_gen_vavgub(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vavgub);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(X86_PAVGB, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-	NativeReg reg3 = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 4) {
-		x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-		x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-		asmALU(X86_MOV, reg, modrma);
-		asmALU(X86_MOV, reg2, modrmb);
-		asmALU(X86_MOV, reg3, reg);
-
-		asmALU(X86_OR, reg3, reg2);
-		asmALU(X86_AND, reg3, 0x01010101);
-
-		asmShift(X86_SHR, reg, 1);
-		asmShift(X86_SHR, reg2, 1);
-
-		asmALU(X86_AND, reg, 0x7f7f7f7f);
-		asmALU(X86_AND, reg2, 0x7f7f7f7f);
-
-		asmALU(X86_ADD, reg, reg2);
-		asmALU(X86_ADD, reg, reg3);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PAVGB, vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vavguh		Vector Average Unsigned Half Word
  *	v.153
  */
-void ppc_opc_vavguh()
+void ppc_opc_vavguh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (uint32)gCPU.vr[vrA].h[i] +
-			(uint32)gCPU.vr[vrB].h[i] + 1;
+		res = (uint32)aCPU.vr[vrA].h[i] +
+			(uint32)aCPU.vr[vrB].h[i] + 1;
 
-		gCPU.vr[vrD].h[i] = (res >> 1);
+		aCPU.vr[vrD].h[i] = (res >> 1);
 	}
 }
-JITCFlow ppc_opc_gen_vavguh()
+JITCFlow ppc_opc_gen_vavguh(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vavguh);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (SSE2_AVAIL) {
-		commutative_operation(X86_PAVGW, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-	NativeReg reg3 = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 4) {
-		x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-		x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-		asmALU(X86_MOV, reg, modrma);
-		asmALU(X86_MOV, reg2, modrmb);
-		asmALU(X86_MOV, reg3, reg);
-
-		asmALU(X86_OR, reg3, reg2);
-		asmALU(X86_AND, reg3, 0x00010001);
-
-		asmShift(X86_SHR, reg, 1);
-		asmShift(X86_SHR, reg2, 1);
-
-		asmALU(X86_AND, reg, 0x7fff7fff);
-		asmALU(X86_AND, reg2, 0x7fff7fff);
-
-		asmALU(X86_ADD, reg, reg2);
-		asmALU(X86_ADD, reg, reg3);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PAVGW, vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vavguw		Vector Average Unsigned Word
  *	v.154
  */
-void ppc_opc_vavguw()
+void ppc_opc_vavguw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (uint64)gCPU.vr[vrA].w[i] +
-			(uint64)gCPU.vr[vrB].w[i] + 1;
+		res = (uint64)aCPU.vr[vrA].w[i] +
+			(uint64)aCPU.vr[vrB].w[i] + 1;
 
-		gCPU.vr[vrD].w[i] = (res >> 1);
+		aCPU.vr[vrD].w[i] = (res >> 1);
 	}
 }
-JITCFlow ppc_opc_gen_vavguw()
+JITCFlow ppc_opc_gen_vavguw(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vavguw);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrma, modrmb;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-	NativeReg reg2 = jitcAllocRegister();
-	NativeReg reg3 = jitcAllocRegister();
-
-	for (int i=0; i<16; i += 4) {
-		x86_mem2(modrma, &(gCPU.vr[vrA].b[i]));
-		x86_mem2(modrmb, &(gCPU.vr[vrB].b[i]));
-
-		asmALU(X86_MOV, reg, modrma);
-		asmALU(X86_MOV, reg2, modrmb);
-		asmALU(X86_MOV, reg3, reg);
-
-		asmALU(X86_OR, reg3, reg2);
-		asmALU(X86_AND, reg3, 0x00000001);
-
-		asmShift(X86_SHR, reg, 1);
-		asmShift(X86_SHR, reg2, 1);
-
-		asmALU(X86_ADD, reg, reg2);
-		asmALU(X86_ADD, reg, reg3);
-
-		vec_setWord(vrD, i, reg);
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vavguw);
 	return flowContinue;
-#endif
 }
 
 /*	vavgsb		Vector Average Signed Byte
  *	v.149
  */
-void ppc_opc_vavgsb()
+void ppc_opc_vavgsb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = (sint16)gCPU.vr[vrA].sb[i] +
-			(sint16)gCPU.vr[vrB].sb[i] + 1;
+		res = (sint16)aCPU.vr[vrA].sb[i] +
+			(sint16)aCPU.vr[vrB].sb[i] + 1;
 
-		gCPU.vr[vrD].sb[i] = (res >> 1);
+		aCPU.vr[vrD].sb[i] = (res >> 1);
 	}
 }
-JITCFlow ppc_opc_gen_vavgsb()
+JITCFlow ppc_opc_gen_vavgsb(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vavgsb);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vavgsb);
+	return flowContinue;
 }
 
 /*	vavgsh		Vector Average Signed Half Word
  *	v.150
  */
-void ppc_opc_vavgsh()
+void ppc_opc_vavgsh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = (sint32)gCPU.vr[vrA].sh[i] +
-			(sint32)gCPU.vr[vrB].sh[i] + 1;
+		res = (sint32)aCPU.vr[vrA].sh[i] +
+			(sint32)aCPU.vr[vrB].sh[i] + 1;
 
-		gCPU.vr[vrD].sh[i] = (res >> 1);
+		aCPU.vr[vrD].sh[i] = (res >> 1);
 	}
 }
-JITCFlow ppc_opc_gen_vavgsh()
+JITCFlow ppc_opc_gen_vavgsh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vavgsh);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vavgsh);
+	return flowContinue;
 }
 
 /*	vavgsw		Vector Average Signed Word
  *	v.151
  */
-void ppc_opc_vavgsw()
+void ppc_opc_vavgsw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint64 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = (sint64)gCPU.vr[vrA].sw[i] +
-			(sint64)gCPU.vr[vrB].sw[i] + 1;
+		res = (sint64)aCPU.vr[vrA].sw[i] +
+			(sint64)aCPU.vr[vrB].sw[i] + 1;
 
-		gCPU.vr[vrD].sw[i] = (res >> 1);
+		aCPU.vr[vrD].sw[i] = (res >> 1);
 	}
 }
-JITCFlow ppc_opc_gen_vavgsw()
+JITCFlow ppc_opc_gen_vavgsw(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vavgsw);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vavgsw);
+	return flowContinue;
 }
 
 /*	vmaxub		Vector Maximum Unsigned Byte
  *	v.182
  */
-void ppc_opc_vmaxub()
+void ppc_opc_vmaxub(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint8 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = gCPU.vr[vrA].b[i];
+		res = aCPU.vr[vrA].b[i];
 
-		if (res < gCPU.vr[vrB].b[i])
-			res = gCPU.vr[vrB].b[i];
+		if (res < aCPU.vr[vrB].b[i])
+			res = aCPU.vr[vrB].b[i];
 
-		gCPU.vr[vrD].b[i] = res;
+		aCPU.vr[vrD].b[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxub()
+JITCFlow ppc_opc_gen_vmaxub(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmaxub);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrD && vrB == vrD) {
-		return flowContinue;
-	} else if (vrA == vrB) {
-		vec_Copy(vrD, vrA);
-
-		return flowContinue;
-	}
-
-	if (SSE2_AVAIL) {
-		commutative_operation(X86_PMAXUB, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg8 reg = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg, vrA, REG_NO, i);
-
-		x86_mem2(modrm, &(gCPU.vr[vrB].b[i]));
-
-		asmALU(X86_CMP, reg, modrm);
-		asmCMOV(X86_B, (NativeReg)reg, modrm);
-
-		vec_setByte(vrD, REG_NO, i, reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PMAXUB, vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vmaxuh		Vector Maximum Unsigned Half Word
  *	v.183
  */
-void ppc_opc_vmaxuh()
+void ppc_opc_vmaxuh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = gCPU.vr[vrA].h[i];
+		res = aCPU.vr[vrA].h[i];
 
-		if (res < gCPU.vr[vrB].h[i])
-			res = gCPU.vr[vrB].h[i];
+		if (res < aCPU.vr[vrB].h[i])
+			res = aCPU.vr[vrB].h[i];
 
-		gCPU.vr[vrD].h[i] = res;
+		aCPU.vr[vrD].h[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxuh()
+JITCFlow ppc_opc_gen_vmaxuh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmaxuh);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmaxuh);
+	return flowContinue;
 }
 
 /*	vmaxuw		Vector Maximum Unsigned Word
  *	v.184
  */
-void ppc_opc_vmaxuw()
+void ppc_opc_vmaxuw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i];
+		res = aCPU.vr[vrA].w[i];
 
-		if (res < gCPU.vr[vrB].w[i])
-			res = gCPU.vr[vrB].w[i];
+		if (res < aCPU.vr[vrB].w[i])
+			res = aCPU.vr[vrB].w[i];
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxuw()
+JITCFlow ppc_opc_gen_vmaxuw(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmaxuw);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmaxuw);
+	return flowContinue;
 }
 
 /*	vmaxsb		Vector Maximum Signed Byte
  *	v.179
  */
-void ppc_opc_vmaxsb()
+void ppc_opc_vmaxsb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint8 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = gCPU.vr[vrA].sb[i];
+		res = aCPU.vr[vrA].sb[i];
 
-		if (res < gCPU.vr[vrB].sb[i])
-			res = gCPU.vr[vrB].sb[i];
+		if (res < aCPU.vr[vrB].sb[i])
+			res = aCPU.vr[vrB].sb[i];
 
-		gCPU.vr[vrD].sb[i] = res;
+		aCPU.vr[vrD].sb[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxsb()
+JITCFlow ppc_opc_gen_vmaxsb(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmaxsb);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmaxsb);
+	return flowContinue;
 }
 
 /*	vmaxsh		Vector Maximum Signed Half Word
  *	v.180
  */
-void ppc_opc_vmaxsh()
+void ppc_opc_vmaxsh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = gCPU.vr[vrA].sh[i];
+		res = aCPU.vr[vrA].sh[i];
 
-		if (res < gCPU.vr[vrB].sh[i])
-			res = gCPU.vr[vrB].sh[i];
+		if (res < aCPU.vr[vrB].sh[i])
+			res = aCPU.vr[vrB].sh[i];
 
-		gCPU.vr[vrD].sh[i] = res;
+		aCPU.vr[vrD].sh[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxsh()
+JITCFlow ppc_opc_gen_vmaxsh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmaxsh);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PMAXSW, vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vmaxsw		Vector Maximum Signed Word
  *	v.181
  */
-void ppc_opc_vmaxsw()
+void ppc_opc_vmaxsw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].sw[i];
+		res = aCPU.vr[vrA].sw[i];
 
-		if (res < gCPU.vr[vrB].sw[i])
-			res = gCPU.vr[vrB].sw[i];
+		if (res < aCPU.vr[vrB].sw[i])
+			res = aCPU.vr[vrB].sw[i];
 
-		gCPU.vr[vrD].sw[i] = res;
+		aCPU.vr[vrD].sw[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxsw()
+JITCFlow ppc_opc_gen_vmaxsw(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vmaxsw);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vmaxsw);
+	return flowContinue;
 }
 
 /*	vmaxfp		Vector Maximum Floating Point
  *	v.178
  */
-void ppc_opc_vmaxfp()
+void ppc_opc_vmaxfp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	float res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		res = gCPU.vr[vrA].f[i];
+		res = aCPU.vr[vrA].f[i];
 
-		if (res < gCPU.vr[vrB].f[i])
-			res = gCPU.vr[vrB].f[i];
+		if (res < aCPU.vr[vrB].f[i])
+			res = aCPU.vr[vrB].f[i];
 
-		gCPU.vr[vrD].f[i] = res;
+		aCPU.vr[vrD].f[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vmaxfp()
+JITCFlow ppc_opc_gen_vmaxfp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vmaxfp);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrD && vrB == vrD) {
-		return flowContinue;
-	} else if (vrA == vrB) {
-		vec_Copy(vrD, vrA);
-
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_MAXPS, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	ppc_opc_gen_interpret(ppc_opc_vmaxfp);
-	return flowEndBlock;
-#endif
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_MAXPS, vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vminub		Vector Minimum Unsigned Byte
  *	v.191
  */
-void ppc_opc_vminub()
+void ppc_opc_vminub(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint8 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = gCPU.vr[vrA].b[i];
+		res = aCPU.vr[vrA].b[i];
 
-		if (res > gCPU.vr[vrB].b[i])
-			res = gCPU.vr[vrB].b[i];
+		if (res > aCPU.vr[vrB].b[i])
+			res = aCPU.vr[vrB].b[i];
 
-		gCPU.vr[vrD].b[i] = res;
+		aCPU.vr[vrD].b[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminub()
+JITCFlow ppc_opc_gen_vminub(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vminub);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrD && vrB == vrD) {
-		return flowContinue;
-	} else if (vrA == vrB) {
-		vec_Copy(vrD, vrA);
-
-		return flowContinue;
-	}
-
-	if (SSE2_AVAIL) {
-		commutative_operation(X86_PMINUB, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg8 reg = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-	NativeReg8 reg2 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg, vrA, REG_NO, i);
-		vec_getByte(reg2, vrB, REG_NO, i);
-
-		asmALU(X86_CMP, reg, reg2);
-		asmCMOV(X86_A, (NativeReg)reg, (NativeReg)reg2);
-
-		vec_setByte(vrD, REG_NO, i, reg);
-	}
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PMINUB, vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vminuh		Vector Minimum Unsigned Half Word
  *	v.192
  */
-void ppc_opc_vminuh()
+void ppc_opc_vminuh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = gCPU.vr[vrA].h[i];
+		res = aCPU.vr[vrA].h[i];
 
-		if (res > gCPU.vr[vrB].h[i])
-			res = gCPU.vr[vrB].h[i];
+		if (res > aCPU.vr[vrB].h[i])
+			res = aCPU.vr[vrB].h[i];
 
-		gCPU.vr[vrD].h[i] = res;
+		aCPU.vr[vrD].h[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminuh()
+JITCFlow ppc_opc_gen_vminuh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vminuh);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vminuh);
+	return flowContinue;
 }
 
 /*	vminuw		Vector Minimum Unsigned Word
  *	v.193
  */
-void ppc_opc_vminuw()
+void ppc_opc_vminuw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	uint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].w[i];
+		res = aCPU.vr[vrA].w[i];
 
-		if (res > gCPU.vr[vrB].w[i])
-			res = gCPU.vr[vrB].w[i];
+		if (res > aCPU.vr[vrB].w[i])
+			res = aCPU.vr[vrB].w[i];
 
-		gCPU.vr[vrD].w[i] = res;
+		aCPU.vr[vrD].w[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminuw()
+JITCFlow ppc_opc_gen_vminuw(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vminuw);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vminuw);
+	return flowContinue;
 }
 
 /*	vminsb		Vector Minimum Signed Byte
  *	v.188
  */
-void ppc_opc_vminsb()
+void ppc_opc_vminsb(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint8 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		res = gCPU.vr[vrA].sb[i];
+		res = aCPU.vr[vrA].sb[i];
 
-		if (res > gCPU.vr[vrB].sb[i])
-			res = gCPU.vr[vrB].sb[i];
+		if (res > aCPU.vr[vrB].sb[i])
+			res = aCPU.vr[vrB].sb[i];
 
-		gCPU.vr[vrD].sb[i] = res;
+		aCPU.vr[vrD].sb[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminsb()
+JITCFlow ppc_opc_gen_vminsb(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vminsb);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vminsb);
+	return flowContinue;
 }
 
 /*	vminsh		Vector Minimum Signed Half Word
  *	v.189
  */
-void ppc_opc_vminsh()
+void ppc_opc_vminsh(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint16 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		res = gCPU.vr[vrA].sh[i];
+		res = aCPU.vr[vrA].sh[i];
 
-		if (res > gCPU.vr[vrB].sh[i])
-			res = gCPU.vr[vrB].sh[i];
+		if (res > aCPU.vr[vrB].sh[i])
+			res = aCPU.vr[vrB].sh[i];
 
-		gCPU.vr[vrD].sh[i] = res;
+		aCPU.vr[vrD].sh[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminsh()
+JITCFlow ppc_opc_gen_vminsh(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vminsh);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PMINSW, vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vminsw		Vector Minimum Signed Word
  *	v.190
  */
-void ppc_opc_vminsw()
+void ppc_opc_vminsw(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	sint32 res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		res = gCPU.vr[vrA].sw[i];
+		res = aCPU.vr[vrA].sw[i];
 
-		if (res > gCPU.vr[vrB].sw[i])
-			res = gCPU.vr[vrB].sw[i];
+		if (res > aCPU.vr[vrB].sw[i])
+			res = aCPU.vr[vrB].sw[i];
 
-		gCPU.vr[vrD].sw[i] = res;
+		aCPU.vr[vrD].sw[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminsw()
+JITCFlow ppc_opc_gen_vminsw(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vminsw);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vminsw);
+	return flowContinue;
 }
 
 /*	vminfp		Vector Minimum Floating Point
  *	v.187
  */
-void ppc_opc_vminfp()
+void ppc_opc_vminfp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	float res;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		res = gCPU.vr[vrA].f[i];
+		res = aCPU.vr[vrA].f[i];
 
-		if (res > gCPU.vr[vrB].f[i])
-			res = gCPU.vr[vrB].f[i];
+		if (res > aCPU.vr[vrB].f[i])
+			res = aCPU.vr[vrB].f[i];
 
-		gCPU.vr[vrD].f[i] = res;
+		aCPU.vr[vrD].f[i] = res;
 	}
 }
-JITCFlow ppc_opc_gen_vminfp()
+JITCFlow ppc_opc_gen_vminfp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vminfp);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrD && vrB == vrD) {
-		return flowContinue;
-	} else if (vrA == vrB) {
-		vec_Copy(vrD, vrA);
-
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_MINPS, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	ppc_opc_gen_interpret(ppc_opc_vminfp);
-	return flowEndBlock;
-#endif
-}
-
-#define RND_NEAREST	0x0000	// round to nearest
-#define RND_ZERO	0x0c00  // round to zero
-#define RND_PINF	0x0800	// round to +INF
-#define RND_MINF	0x0400	// round to -INF
-
-/* This functionality was borrowed from glibc 2.3.3 */
-static inline void set_roundmode(int mode)
-{
-	modrm_o modrm;
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	x86_mem2(modrm, &gCPU.vfcw_save);
-
-	asmFSTCW(x86_mem2(modrm, &gCPU.vfcw_save));
-
-	asmMOV_NoFlags(reg, mode);	// avoid flag clobber
-	asmALU(X86_OR, reg, modrm);
-
-	if (mode != RND_ZERO) {
-		asmALU(X86_AND, reg, (0xffff ^ (~mode & 0x0c00)));
-	}
-
-	x86_mem2(modrm, &gCPU.vfcw);
-
-	asmALU(X86_MOV, modrm, reg);
-
-	asmFLDCW(modrm);
-}
-
-static inline void restore_roundmode(void)
-{
-	modrm_o modrm;
-
-	asmFLDCW(x86_mem2(modrm, &gCPU.vfcw_save));
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_MINPS, vrD, vrA, vrB);
+	return flowContinue;
 }
 
 /*	vrfin		Vector Round to Floating-Point Integer Nearest
  *	v.231
  */
-void ppc_opc_vrfin()
+void ppc_opc_vrfin(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	/* Documentation doesn't dictate how this instruction should
@@ -6495,179 +3562,83 @@ void ppc_opc_vrfin()
 	 * This is covered by the function rint()
 	 */
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = rintf(gCPU.vr[vrB].f[i]);
+		aCPU.vr[vrD].f[i] = rintf(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vrfin()
+JITCFlow ppc_opc_gen_vrfin(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrfin);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcFloatRegisterClobberAll();
-	set_roundmode(RND_NEAREST);
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmFSimple(FRNDINT);
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrD].b[i])));
-	}
-
-	restore_roundmode();
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrfin);
 	return flowContinue;
-#endif
 }
 
 /*	vrfip		Vector Round to Floating-Point Integer toward Plus Infinity
  *	v.232
  */
-void ppc_opc_vrfip()
+void ppc_opc_vrfip(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = ceilf(gCPU.vr[vrB].f[i]);
+		aCPU.vr[vrD].f[i] = ceilf(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vrfip()
+JITCFlow ppc_opc_gen_vrfip(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrfip);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcFloatRegisterClobberAll();
-	set_roundmode(RND_PINF);
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmFSimple(FRNDINT);
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrD].b[i])));
-	}
-
-	restore_roundmode();
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrfip);
 	return flowContinue;
-#endif
 }
 
 /*	vrfim		Vector Round to Floating-Point Integer toward Minus Infinity
  *	v.230
  */
-void ppc_opc_vrfim()
+void ppc_opc_vrfim(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = floorf(gCPU.vr[vrB].f[i]);
+		aCPU.vr[vrD].f[i] = floorf(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vrfim()
+JITCFlow ppc_opc_gen_vrfim(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrfim);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcFloatRegisterClobberAll();
-	set_roundmode(RND_MINF);
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmFSimple(FRNDINT);
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrD].b[i])));
-	}
-
-	restore_roundmode();
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrfim);
 	return flowContinue;
-#endif
 }
 
 /*	vrfiz	Vector Round to Floating-Point Integer toward Zero
  *	v.233
  */
-void ppc_opc_vrfiz()
+void ppc_opc_vrfiz(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = rintf(gCPU.vr[vrD].f[i]);
+		aCPU.vr[vrD].f[i] = truncf(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vrfiz()
+JITCFlow ppc_opc_gen_vrfiz(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrfiz);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcFloatRegisterClobberAll();
-	set_roundmode(RND_ZERO);
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmFSimple(FRNDINT);
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrD].b[i])));
-	}
-
-	restore_roundmode();
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vrfiz);
 	return flowContinue;
-#endif
 }
 
 /*	vrefp		Vector Reciprocal Estimate Floating Point
  *	v.228
  */
-void ppc_opc_vrefp()
+void ppc_opc_vrefp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	/* This emulation generates an exact value, instead of an estimate.
@@ -6677,55 +3648,28 @@ void ppc_opc_vrefp()
 	 */
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = 1 / gCPU.vr[vrB].f[i];
+		aCPU.vr[vrD].f[i] = 1 / aCPU.vr[vrB].f[i];
 	}
 }
-JITCFlow ppc_opc_gen_vrefp()
+JITCFlow ppc_opc_gen_vrefp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrefp);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (!(SSE_AVAIL)) {
-		ppc_opc_gen_interpret(ppc_opc_vrefp);
-		return flowEndBlock;
-	}
-
-	if (vrB == vrD) {
-		NativeVectorReg reg = jitcGetClientVectorRegisterDirty(vrB);
-
-		asmALUPS(X86_RCPPS, reg, reg);
-
-		return flowContinue;
-	}
-
-	NativeVectorReg reg1 = jitcAllocVectorRegister();
-	NativeVectorReg reg2 = jitcGetClientVectorRegisterMapping(vrB);
-
-	if (reg2 == VECTREG_NO) {
-		asmALUPS(X86_RCPPS, reg1, x86_mem2(modrm, &gCPU.vr[vrB]));
-	} else {
-		asmALUPS(X86_RCPPS, reg1, reg2);
-	}
-
-	jitcRenameVectorRegisterDirty(reg1, vrD);
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
 
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmALUPS(X86_RCPPS, d, b);
 	return flowContinue;
-#endif
 }
 
 /*	vrsqrtefp	Vector Reciprocal Square Root Estimate Floating Point
  *	v.237
  */
-void ppc_opc_vrsqrtefp()
+void ppc_opc_vrsqrtefp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	/* This emulation generates an exact value, instead of an estimate.
@@ -6735,57 +3679,28 @@ void ppc_opc_vrsqrtefp()
 	 */
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = 1 / sqrt(gCPU.vr[vrB].f[i]);
+		aCPU.vr[vrD].f[i] = 1 / sqrt(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vrsqrtefp()
+JITCFlow ppc_opc_gen_vrsqrtefp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vrsqrtefp);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (!(SSE_AVAIL)) {
-		ppc_opc_gen_interpret(ppc_opc_vrsqrtefp);
-		return flowEndBlock;
-	}
-
-	if (vrB == vrD) {
-		NativeVectorReg reg = jitcGetClientVectorRegisterDirty(vrB);
-
-		asmALUPS(X86_SQRTPS, reg, reg);
-		asmALUPS(X86_RCPPS, reg, reg);
-
-		return flowContinue;
-	}
-
-	NativeVectorReg reg1 = jitcAllocVectorRegister();
-	NativeVectorReg reg2 = jitcGetClientVectorRegisterMapping(vrB);
-
-	if (reg2 == VECTREG_NO) {
-		asmALUPS(X86_SQRTPS, reg1, x86_mem2(modrm, &gCPU.vr[vrB]));
-	} else {
-		asmALUPS(X86_SQRTPS, reg1, reg2);
-	}
-	asmALUPS(X86_RCPPS, reg1, reg1);
-
-	jitcRenameVectorRegisterDirty(reg1, vrD);
+	int vrD = (jitc.current_opc >> 21) & 0x1f;
+	int vrB = (jitc.current_opc >> 11) & 0x1f;
 
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmALUPS(X86_RSQRTPS, d, b);
 	return flowContinue;
-#endif
 }
 
 /*	vlogefp		Vector Log2 Estimate Floating Point
  *	v.175
  */
-void ppc_opc_vlogefp()
+void ppc_opc_vlogefp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	/* This emulation generates an exact value, instead of an estimate.
@@ -6795,46 +3710,23 @@ void ppc_opc_vlogefp()
 	 */
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = log2(gCPU.vr[vrB].f[i]);
+		aCPU.vr[vrD].f[i] = log2(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vlogefp()
+JITCFlow ppc_opc_gen_vlogefp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vlogefp);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcFloatRegisterClobberAll();
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFSimple(FLD1);
-
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmFSimple(FYL2X);
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vlogefp);
 	return flowContinue;
-#endif
 }
 
 /*	vexptefp	Vector 2 Raised to the Exponent Estimate Floating Point
  *	v.173
  */
-void ppc_opc_vexptefp()
+void ppc_opc_vexptefp(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 	PPC_OPC_ASSERT(vrA==0);
 
 	/* This emulation generates an exact value, instead of an estimate.
@@ -6844,1390 +3736,730 @@ void ppc_opc_vexptefp()
 	 */
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = exp2(gCPU.vr[vrB].f[i]);
+		aCPU.vr[vrD].f[i] = exp2(aCPU.vr[vrB].f[i]);
 	}
 }
-JITCFlow ppc_opc_gen_vexptefp()
+JITCFlow ppc_opc_gen_vexptefp(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vexptefp);
-	return flowEndBlock;
-#else
-	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcFloatRegisterClobberAll();
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFSimple(FLD1);
-
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		asmFSimple(F2XM1);
-		asmFArithP_STi(X86_FADD, Float_ST1);
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrD].b[i])));
-	}
-
+	ppc_opc_gen_interpret(jitc, ppc_opc_vexptefp);
 	return flowContinue;
-#endif
 }
 
 /*	vcfux		Vector Convert from Unsigned Fixed-Point Word
  *	v.156
  */
-void ppc_opc_vcfux()
+void ppc_opc_vcfux(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrB;
 	uint32 uimm;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = ((float)gCPU.vr[vrB].w[i]) / (1 << uimm);
+		aCPU.vr[vrD].f[i] = ((float)aCPU.vr[vrB].w[i]) / (1 << uimm);
  	}
 }
-JITCFlow ppc_opc_gen_vcfux()
+JITCFlow ppc_opc_gen_vcfux(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcfux);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vcfux);
+	return flowContinue;
 }
 
 /*	vcfsx		Vector Convert from Signed Fixed-Point Word
  *	v.155
  */
-void ppc_opc_vcfsx()
-{
-	VECTOR_DEBUG;
-	int vrD, vrB;
-	uint32 uimm;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
-
-	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		gCPU.vr[vrD].f[i] = ((float)gCPU.vr[vrB].sw[i]) / (1 << uimm);
- 	}
-}
-JITCFlow ppc_opc_gen_vcfsx()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vcfsx);
-	return flowEndBlock;
-#else
-	int vrD, vrB;
-	uint32 uimm;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, uimm, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcClobberRegister(NATIVE_REG | EAX);
-
-	jitcFloatRegisterClobberAll();
-
-	if (uimm == 1) {
-		asmFSimple(FLD1);
-	} else if (uimm > 1) {
-		asmALU_D(X86_MOV, x86_mem2(modrm, &gCPU.vtemp), uimm);
-		asmFILD_D(modrm);
-	}
-
-	if (uimm)	asmFSimple(FCHS);
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFILD_D(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		if (uimm) {
-			asmFSimple(FSCALE);
-	 	}
-
-		asmFSTP_Single(x86_mem2(modrm, &(gCPU.vr[vrD].b[i])));
-	}
-
-	if (uimm)	asmFSTP(Float_ST0);
-
-	return flowContinue;
-#endif
-}
-
-/*	vctsxs		Vector Convert To Signed Fixed-Point Word Saturate
- *	v.171
- */
-void ppc_opc_vctsxs()
+void ppc_opc_vcfsx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrB;
 	uint32 uimm;
-	float ftmp;
-	sint32 tmp;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
-
-	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		ftmp = gCPU.vr[vrB].f[i] * (float)(1 << uimm);
-		ftmp = rintf(ftmp);
-
-		tmp = (sint32)ftmp;
-
-		if (ftmp > 2147483647.0) {
-			tmp = 2147483647;		// 0x7fffffff
-			gCPU.vscr |= VSCR_SAT;
-		} else if (ftmp < -2147483648.0) {
-			tmp = -2147483648LL;		// 0x80000000
-			gCPU.vscr |= VSCR_SAT;
-		}
-
-		gCPU.vr[vrD].sw[i] = tmp;
- 	}
-}
-JITCFlow ppc_opc_gen_vctsxs()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vctsxs);
-	return flowEndBlock;
-#else
-	int vrD, vrB;
-	uint32 uimm;
-	modrm_o modrm, dest_modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, uimm, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcClobberRegister(NATIVE_REG | EAX);
-
-	jitcFloatRegisterClobberAll();
-	set_roundmode(RND_ZERO);
-
-	if (uimm == 1) {
-		asmFSimple(FLD1);
-	} else if (uimm > 1) {
-		asmALU_D(X86_MOV, x86_mem2(modrm, &gCPU.vtemp), uimm);
-		asmFILD_D(modrm);
-	}
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		if (uimm) {
-			asmFSimple(FSCALE);
-		}
-
-		asmFSimple(FRNDINT);
-
-		asmFIComp(X86_FICOM32, x86_mem2(modrm, &sint32_max));
-		asmFSTSW_EAX();
-		asmALU(X86_TEST, EAX, 0x4100);
-		NativeAddress of_high = asmJxxFixup(X86_Z);
-
-		asmFIComp(X86_FICOM32, x86_mem2(modrm, &sint32_min));
-		asmFSTSW_EAX();
-		asmALU(X86_TEST, EAX, 0x0100);
-		NativeAddress of_low = asmJxxFixup(X86_NZ);
-
-		asmFISTP_D(x86_mem2(dest_modrm, &(gCPU.vr[vrD].b[i])));
-		NativeAddress skip_end = asmJMPFixup();
-
-		asmResolveFixup(of_high);
-		asmALU_D(X86_MOV, dest_modrm, 2147483647);
-		NativeAddress skip1 = asmJMPFixup();
-
-		asmResolveFixup(of_low);
-		asmALU_D(X86_MOV, dest_modrm, -2147483648);
-
-		asmResolveFixup(skip1);
-		vec_raise_saturate();
-
-		asmResolveFixup(skip_end);
- 	}
-
-	if (uimm)	asmFSTP(Float_ST0);
-
-	restore_roundmode();
-
-	return flowContinue;
-#endif
-}
-
-/*	vctuxs		Vector Convert to Unsigned Fixed-Point Word Saturate
- *	v.172
- */
-void ppc_opc_vctuxs()
-{
-	VECTOR_DEBUG;
-	int vrD, vrB;
-	uint32 tmp, uimm;
-	float ftmp;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, uimm, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		ftmp = gCPU.vr[vrB].f[i] * (float)(1 << uimm);
-		ftmp = rintf(ftmp);
-
-		tmp = (uint32)ftmp;
-
-		if (ftmp > 4294967295.0) {
-			tmp = 0xffffffff;
-			gCPU.vscr |= VSCR_SAT;
-		} else if (ftmp < 0) {
-			tmp = 0;
-			gCPU.vscr |= VSCR_SAT;
-		}
-
-		gCPU.vr[vrD].w[i] = tmp;
- 	}
-}
-JITCFlow ppc_opc_gen_vctuxs()
-{
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vctuxs);
-	return flowEndBlock;
-#else
-	int vrD, vrB;
-	uint32 uimm;
-	modrm_o modrm, dest_modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, uimm, vrB);
-
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	jitcClobberRegister(NATIVE_REG | EAX);
-
-	jitcFloatRegisterClobberAll();
-	set_roundmode(RND_ZERO);
-
-	NativeReg reg = jitcAllocRegister();
-
-	if (uimm == 1) {
-		asmFSimple(FLD1);
-	} else if (uimm > 1) {
-		asmALU_D(X86_MOV, x86_mem2(modrm, &gCPU.vtemp), uimm);
-		asmFILD_D(modrm);
-	}
-
-	for (int i=0; i<16; i+=4) { //FIXME: This might not comply with Java FP
-		asmFLD_Single(x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		if (uimm) {
-			asmFSimple(FSCALE);
-		}
-
-		asmFSimple(FRNDINT);
-
-		asmFISTP_Q(x86_mem2(modrm, &gCPU.vtemp64));
-
-		asmMOV(reg, (byte *)&gCPU.vtemp64+4);
-
-		asmALU(X86_TEST, reg, 0x80000000);
-		NativeAddress of_low = asmJxxFixup(X86_NZ);
-
-		asmALU(X86_TEST, reg, 0xffffffff);
-		NativeAddress of_high = asmJxxFixup(X86_NZ);
-
-		asmMOV(reg, &gCPU.vtemp64);
-
-		x86_mem2(dest_modrm, &(gCPU.vr[vrD].b[i]));
-
-		asmALU(X86_MOV, dest_modrm, reg);
-		NativeAddress skip_end = asmJMPFixup();
-
-		asmResolveFixup(of_high);
-		asmALU_D(X86_MOV, dest_modrm, 0xffffffff);
-		NativeAddress skip1 = asmJMPFixup();
-
-		asmResolveFixup(of_low);
-		asmALU_D(X86_MOV, dest_modrm, 0);
-
-		asmResolveFixup(skip1);
-		vec_raise_saturate();
-
-		asmResolveFixup(skip_end);
+		aCPU.vr[vrD].f[i] = ((float)aCPU.vr[vrB].sw[i]) / (1 << uimm);
  	}
-
-	if (uimm)	asmFSTP(Float_ST0);
-
-	restore_roundmode();
-
-	return flowContinue;
-#endif
 }
+JITCFlow ppc_opc_gen_vcfsx(JITC &jitc)
+{
+	int vrD, vrB;
+	uint32 uimm;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, uimm, vrB);
 
-static inline void commutative_operation(X86ALUPSopc opc, int vrD, int vrA, int vrB)
-{
-	NativeVectorReg d, s;
-	modrm_o modrm;
-	int vrS;
-
-	if (vrA == vrD) {
-		d = jitcGetClientVectorRegisterDirty(vrD);
-		s = jitcGetClientVectorRegisterMapping(vrB);
-		vrS = vrB;
-	} else if (vrB == vrD) {
-		d = jitcGetClientVectorRegisterDirty(vrD);
-		s = jitcGetClientVectorRegisterMapping(vrA);
-		vrS = vrA;
-	} else {
-		d = jitcMapClientVectorRegisterDirty(vrD);
-		NativeVectorReg a = jitcGetClientVectorRegisterMapping(vrA);
-		s = jitcGetClientVectorRegisterMapping(vrB);
-		vrS = vrB;
-
-		if (a == VECTREG_NO)
-			asmMOVAPS(d, &gCPU.vr[vrA]);
-		else
-			asmALUPS(X86_MOVAPS, d, a);
-	}
-
-	if (s == VECTREG_NO) {
-		asmALUPS(opc, d, x86_mem2(modrm, &gCPU.vr[vrS]));
-	} else
-		asmALUPS(opc, d, s);
-}
-
-static inline void commutative_operation(X86PALUopc opc, int vrD, int vrA, int vrB)
-{
-	NativeVectorReg d, s;
-	modrm_o modrm;
-	int vrS;
-
-	if (vrA == vrD) {
-		d = jitcGetClientVectorRegisterDirty(vrD);
-		s = jitcGetClientVectorRegisterMapping(vrB);
-		vrS = vrB;
-	} else if (vrB == vrD) {
-		d = jitcGetClientVectorRegisterDirty(vrD);
-		s = jitcGetClientVectorRegisterMapping(vrA);
-		vrS = vrA;
-	} else {
-		d = jitcMapClientVectorRegisterDirty(vrD);
-		NativeVectorReg a = jitcGetClientVectorRegisterMapping(vrA);
-		s = jitcGetClientVectorRegisterMapping(vrB);
-		vrS = vrB;
-
-		if (a == VECTREG_NO)
-			asmMOVAPS(d, &gCPU.vr[vrA]);
-		else
-			asmALUPS(X86_MOVAPS, d, a);
+	NativeVectorReg b = jitc.getClientVectorRegister(vrB);
+	NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+	jitc.asmALUPS(X86_CVTDQ2PS, d, b);
+	if (uimm) {
+		/* multiply by 2^-uimm, which is exact */
+		NativeVectorReg t = jitc.allocVectorRegister();
+		vec_load_constant(jitc, t, (127 - uimm) << 23);
+		jitc.asmALUPS(X86_MULPS, d, t);
 	}
-
-	if (s == VECTREG_NO) {
-		asmPALU(opc, d, x86_mem2(modrm, &gCPU.vr[vrS]));
-	} else
-		asmPALU(opc, d, s);
+	return flowContinue;
 }
 
-static inline void noncommutative_operation(X86ALUPSopc opc, int vrD, int vrA, int vrB)
+/*	vctsxs		Vector Convert To Signed Fixed-Point Word Saturate
+ *	v.171
+ */
+void ppc_opc_vctsxs(PPC_CPU_State &aCPU)
 {
-	NativeVectorReg d, s;
-	modrm_o modrm;
-
-	if (vrA == vrD) {
-		d = jitcGetClientVectorRegisterDirty(vrA);
-		s = jitcGetClientVectorRegisterMapping(vrB);
-	} else {
-		if (vrB == vrD)
-			d = jitcAllocVectorRegister();
-		else
-			d = jitcMapClientVectorRegisterDirty(vrD);
+	VECTOR_DEBUG;
+	int vrD, vrB;
+	uint32 uimm;
+	float ftmp;
+	sint32 tmp;
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
-		NativeVectorReg a = jitcGetClientVectorRegisterMapping(vrA);
-		s = jitcGetClientVectorRegisterMapping(vrB);
+	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
+		ftmp = aCPU.vr[vrB].f[i] * (float)(1 << uimm);
+		ftmp = rintf(ftmp);
 
-		if (a == VECTREG_NO)
-			asmMOVAPS(d, &gCPU.vr[vrA]);
-		else
-			asmALUPS(X86_MOVAPS, d, a);
-	}
+		tmp = (sint32)ftmp;
 
-	if (s == VECTREG_NO) {
-		asmALUPS(opc, d, x86_mem2(modrm, &gCPU.vr[vrB]));
-	} else
-		asmALUPS(opc, d, s);
+		if (ftmp > 2147483647.0) {
+			tmp = 2147483647;		// 0x7fffffff
+			aCPU.vscr |= VSCR_SAT;
+		} else if (ftmp < -2147483648.0) {
+			tmp = -2147483648LL;		// 0x80000000
+			aCPU.vscr |= VSCR_SAT;
+		}
 
-	if (vrB == vrD)
-		jitcRenameVectorRegisterDirty(d, vrD);
+		aCPU.vr[vrD].sw[i] = tmp;
+ 	}
 }
-
-static inline void noncommutative_operation(X86PALUopc opc, int vrD, int vrA, int vrB)
+JITCFlow ppc_opc_gen_vctsxs(JITC &jitc)
 {
-	NativeVectorReg d, s;
-	modrm_o modrm;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vctsxs);
+	return flowContinue;
+}
 
-	if (vrA == vrD) {
-		d = jitcGetClientVectorRegisterDirty(vrA);
-		s = jitcGetClientVectorRegisterMapping(vrB);
-	} else {
-		if (vrB == vrD)
-			d = jitcAllocVectorRegister();
-		else
-			d = jitcMapClientVectorRegisterDirty(vrD);
+/*	vctuxs		Vector Convert to Unsigned Fixed-Point Word Saturate
+ *	v.172
+ */
+void ppc_opc_vctuxs(PPC_CPU_State &aCPU)
+{
+	VECTOR_DEBUG;
+	int vrD, vrB;
+	uint32 tmp, uimm;
+	float ftmp;
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, uimm, vrB);
 
-		NativeVectorReg a = jitcGetClientVectorRegisterMapping(vrA);
-		s = jitcGetClientVectorRegisterMapping(vrB);
+	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
+		ftmp = aCPU.vr[vrB].f[i] * (float)(1 << uimm);
+		ftmp = rintf(ftmp);
 
-		if (a == VECTREG_NO)
-			asmMOVAPS(d, &gCPU.vr[vrA]);
-		else
-			asmALUPS(X86_MOVAPS, d, a);
-	}
+		tmp = (uint32)ftmp;
 
-	if (s == VECTREG_NO) {
-		asmPALU(opc, d, x86_mem2(modrm, &gCPU.vr[vrB]));
-	} else
-		asmPALU(opc, d, s);
+		if (ftmp > 4294967295.0) {
+			tmp = 0xffffffff;
+			aCPU.vscr |= VSCR_SAT;
+		} else if (ftmp < 0) {
+			tmp = 0;
+			aCPU.vscr |= VSCR_SAT;
+		}
 
-	if (vrB == vrD)
-		jitcRenameVectorRegisterDirty(d, vrD);
+		aCPU.vr[vrD].w[i] = tmp;
+ 	}
+}
+JITCFlow ppc_opc_gen_vctuxs(JITC &jitc)
+{
+	ppc_opc_gen_interpret(jitc, ppc_opc_vctuxs);
+	return flowContinue;
 }
 
 /*	vand		Vector Logical AND
  *	v.147
  */
-void ppc_opc_vand()
+void ppc_opc_vand(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] & gCPU.vr[vrB].d[0];
-	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] & gCPU.vr[vrB].d[1];
+	aCPU.vr[vrD].d[0] = aCPU.vr[vrA].d[0] & aCPU.vr[vrB].d[0];
+	aCPU.vr[vrD].d[1] = aCPU.vr[vrA].d[1] & aCPU.vr[vrB].d[1];
 }
-JITCFlow ppc_opc_gen_vand()
+JITCFlow ppc_opc_gen_vand(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vand);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		vec_Copy(vrD, vrA);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_ANDPS, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	vec_getWord(reg, vrA, 0);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB])));
-	vec_setWord(vrD, 0, reg);
-
-	vec_getWord(reg, vrA, 4);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[4])));
-	vec_setWord(vrD, 4, reg);
-
-	vec_getWord(reg, vrA, 8);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[8])));
-	vec_setWord(vrD, 8, reg);
-
-	vec_getWord(reg, vrA,12);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[12])));
-	vec_setWord(vrD,12, reg);
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_PAND, vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vandc		Vector Logical AND with Complement
  *	v.148
  */
-void ppc_opc_vandc()
+void ppc_opc_vandc(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] & ~gCPU.vr[vrB].d[0];
-	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] & ~gCPU.vr[vrB].d[1];
+	aCPU.vr[vrD].d[0] = aCPU.vr[vrA].d[0] & ~aCPU.vr[vrB].d[0];
+	aCPU.vr[vrD].d[1] = aCPU.vr[vrA].d[1] & ~aCPU.vr[vrB].d[1];
 }
-JITCFlow ppc_opc_gen_vandc()
+JITCFlow ppc_opc_gen_vandc(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vandc);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		vec_Zero(vrD);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		noncommutative_operation(X86_ANDNPS, vrD, vrB, vrA);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	vec_getWord(reg, vrB, 0);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &gCPU.vr[vrB]));
-	vec_setWord(vrD, 0, reg);
-
-	vec_getWord(reg, vrB, 4);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[4])));
-	vec_setWord(vrD, 4, reg);
-
-	vec_getWord(reg, vrB, 8);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[8])));
-	vec_setWord(vrD, 8, reg);
-
-	vec_getWord(reg, vrB,12);
-	asmALU(X86_NOT, reg);
-	asmALU(X86_AND, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[12])));
-	vec_setWord(vrD,12, reg);
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	/* PANDN inverts the destination, so this is vD = ~vB & vA */
+	noncommutative_operation(jitc, X86_PANDN, vrD, vrB, vrA);
 	return flowContinue;
-#endif
 }
 
 /*	vor		Vector Logical OR
  *	v.217
  */
-void ppc_opc_vor()
+void ppc_opc_vor(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] | gCPU.vr[vrB].d[0];
-	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] | gCPU.vr[vrB].d[1];
+	aCPU.vr[vrD].d[0] = aCPU.vr[vrA].d[0] | aCPU.vr[vrB].d[0];
+	aCPU.vr[vrD].d[1] = aCPU.vr[vrA].d[1] | aCPU.vr[vrB].d[1];
 }
-JITCFlow ppc_opc_gen_vor()
+JITCFlow ppc_opc_gen_vor(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vor);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		vec_Copy(vrD, vrA);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_ORPS, vrD, vrA, vrB);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	vec_getWord(reg, vrA, 0);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &gCPU.vr[vrB]));
-	vec_setWord(vrD, 0, reg);
-
-	vec_getWord(reg, vrA, 4);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[4])));
-	vec_setWord(vrD, 4, reg);
-
-	vec_getWord(reg, vrA, 8);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[8])));
-	vec_setWord(vrD, 8, reg);
-
-	vec_getWord(reg, vrA,12);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[12])));
-	vec_setWord(vrD,12, reg);
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_POR, vrD, vrA, vrB);
 	return flowContinue;
-#endif
 }
 
 /*	vnor		Vector Logical NOR
  *	v.216
  */
-void ppc_opc_vnor()
+void ppc_opc_vnor(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	gCPU.vr[vrD].d[0] = ~(gCPU.vr[vrA].d[0] | gCPU.vr[vrB].d[0]);
-	gCPU.vr[vrD].d[1] = ~(gCPU.vr[vrA].d[1] | gCPU.vr[vrB].d[1]);
+	aCPU.vr[vrD].d[0] = ~(aCPU.vr[vrA].d[0] | aCPU.vr[vrB].d[0]);
+	aCPU.vr[vrD].d[1] = ~(aCPU.vr[vrA].d[1] | aCPU.vr[vrB].d[1]);
 }
-JITCFlow ppc_opc_gen_vnor()
+JITCFlow ppc_opc_gen_vnor(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vnor);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		vec_Not(vrD, vrA);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_ORPS, vrD, vrA, vrB);
-		vec_Not(vrD, vrD);
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	vec_getWord(reg, vrA, 0);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &gCPU.vr[vrB]));
-	asmALU(X86_NOT, reg);
-	vec_setWord(vrD, 0, reg);
-
-	vec_getWord(reg, vrA, 4);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[4])));
-	asmALU(X86_NOT, reg);
-	vec_setWord(vrD, 4, reg);
-
-	vec_getWord(reg, vrA, 8);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[8])));
-	asmALU(X86_NOT, reg);
-	vec_setWord(vrD, 8, reg);
-
-	vec_getWord(reg, vrA,12);
-	asmALU(X86_OR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[12])));
-	asmALU(X86_NOT, reg);
-	vec_setWord(vrD,12, reg);
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, X86_POR, vrD, vrA, vrB);
+	NativeVectorReg d = jitc.getClientVectorRegisterDirty(vrD);
+	NativeVectorReg t = jitc.allocVectorRegister();
+	vec_load_constant(jitc, t, 0xffffffff);
+	jitc.asmPALU(X86_PXOR, d, t);
 	return flowContinue;
-#endif
 }
 
 /*	vxor		Vector Logical XOR
  *	v.282
  */
-void ppc_opc_vxor()
+void ppc_opc_vxor(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG_COMMON;
 	int vrD, vrA, vrB;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
-	gCPU.vr[vrD].d[0] = gCPU.vr[vrA].d[0] ^ gCPU.vr[vrB].d[0];
-	gCPU.vr[vrD].d[1] = gCPU.vr[vrA].d[1] ^ gCPU.vr[vrB].d[1];
+	aCPU.vr[vrD].d[0] = aCPU.vr[vrA].d[0] ^ aCPU.vr[vrB].d[0];
+	aCPU.vr[vrD].d[1] = aCPU.vr[vrA].d[1] ^ aCPU.vr[vrB].d[1];
 }
-JITCFlow ppc_opc_gen_vxor()
+JITCFlow ppc_opc_gen_vxor(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vxor);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
 	if (vrA == vrB) {
-		vec_Zero(vrD);
-		return flowContinue;
-	}
-
-	if (SSE_AVAIL) {
-		commutative_operation(X86_XORPS, vrD, vrA, vrB);
-		return flowContinue;
+		NativeVectorReg d = jitc.mapClientVectorRegisterDirty(vrD);
+		vec_load_constant(jitc, d, 0);
+	} else {
+		commutative_operation(jitc, X86_PXOR, vrD, vrA, vrB);
 	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = jitcAllocRegister();
-
-	vec_getWord(reg, vrA, 0);
-	asmALU(X86_XOR, reg, x86_mem2(modrm, &gCPU.vr[vrB]));
-	vec_setWord(vrD, 0, reg);
-
-	vec_getWord(reg, vrA, 4);
-	asmALU(X86_XOR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[4])));
-	vec_setWord(vrD, 4, reg);
-
-	vec_getWord(reg, vrA, 8);
-	asmALU(X86_XOR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[8])));
-	vec_setWord(vrD, 8, reg);
-
-	vec_getWord(reg, vrA,12);
-	asmALU(X86_XOR, reg, x86_mem2(modrm, &(gCPU.vr[vrB].b[12])));
-	vec_setWord(vrD,12, reg);
-
 	return flowContinue;
-#endif
 }
 
-
-#define CR_CR6		(0x00f0)
-#define CR_CR6_EQ	(1<<7)
-#define CR_CR6_NE_SOME	(1<<6)
-#define CR_CR6_NE	(1<<5)
-#define CR_CR6_EQ_SOME	(1<<4)
-
 /*	vcmpequbx	Vector Compare Equal-to Unsigned Byte
  *	v.160
  */
-void ppc_opc_vcmpequbx()
+void ppc_opc_vcmpequbx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		if (gCPU.vr[vrA].b[i] == gCPU.vr[vrB].b[i]) {
-			gCPU.vr[vrD].b[i] = 0xff;
+		if (aCPU.vr[vrA].b[i] == aCPU.vr[vrB].b[i]) {
+			aCPU.vr[vrD].b[i] = 0xff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].b[i] = 0;
+			aCPU.vr[vrD].b[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpequbx()
+JITCFlow ppc_opc_gen_vcmpequbx(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vcmpequbx);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (0 && vrA == vrB) {
-		vec_Neg1(vrD);
-
-		if (PPC_OPC_VRc & gJITC.current_opc) {
-			jitcClobberCarryAndFlags();
-
-			asmAND(&gCPU.cr, ~CR_CR6);
-			asmOR(&gCPU.cr, CR_CR6_EQ | CR_CR6_EQ_SOME);
-		}
-
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = REG_NO;
-	NativeReg8 reg2 = (NativeReg8)jitcAllocRegister(NATIVE_REG_8);
-
-	if (PPC_OPC_VRc & gJITC.current_opc) {
-		reg = jitcAllocRegister();
-
-		asmMOV_NoFlags(reg, CR_CR6_EQ | CR_CR6_NE);
-	}
-
-	for (int i=0; i<16; i++) {
-		vec_getByte(reg2, vrA, REG_NO, i);
-
-		asmALU(X86_CMP, reg2, x86_mem2(modrm, &gCPU.vr[vrB]+i));
-
-		if (PPC_OPC_VRc & gJITC.current_opc) {
-			NativeAddress skip1 = asmJxxFixup(X86_NE);
-
-			asmMOV_NoFlags((NativeReg)reg2, 0xff);
-			asmALU(X86_AND, reg, ~CR_CR6_NE);
-			asmALU(X86_OR, reg, CR_CR6_EQ_SOME);
-			NativeAddress skip2 = asmJMPFixup();
-
-			asmResolveFixup(skip1);
-			asmALU(X86_XOR, reg2, reg2);
-			asmALU(X86_AND, reg, ~CR_CR6_EQ);
-			asmALU(X86_OR, reg, CR_CR6_NE_SOME);
-
-			asmResolveFixup(skip2);
-		} else {
-			asmSET(X86_NE, reg2);
-
-			asmALU(X86_SUB, reg2, 1);
-		}
-
-		vec_setByte(vrD, REG_NO, i, reg2);
-	}
-
-	if (PPC_OPC_VRc & gJITC.current_opc) {
-		asmAND(&gCPU.cr, ~CR_CR6);
-		asmALU(X86_OR, x86_mem2(modrm, &gCPU.cr), reg);
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, PALUB(X86_PCMPEQ), vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
 	}
-
 	return flowContinue;
-#endif
 }
 
 /*	vcmpequhx	Vector Compare Equal-to Unsigned Half Word
  *	v.161
  */
-void ppc_opc_vcmpequhx()
+void ppc_opc_vcmpequhx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		if (gCPU.vr[vrA].h[i] == gCPU.vr[vrB].h[i]) {
-			gCPU.vr[vrD].h[i] = 0xffff;
+		if (aCPU.vr[vrA].h[i] == aCPU.vr[vrB].h[i]) {
+			aCPU.vr[vrD].h[i] = 0xffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].h[i] = 0;
+			aCPU.vr[vrD].h[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpequhx()
+JITCFlow ppc_opc_gen_vcmpequhx(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vcmpequhx);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		vec_Neg1(vrD);
-
-		if (PPC_OPC_VRc & gJITC.current_opc) {
-			jitcClobberCarryAndFlags();
-
-			asmAND(&gCPU.cr, ~CR_CR6);
-			asmOR(&gCPU.cr, CR_CR6_EQ | CR_CR6_EQ_SOME);
-		}
-
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = REG_NO;
-	NativeReg16 reg2 = (NativeReg16)jitcAllocRegister(NATIVE_REG_8);
-
-	if (PPC_OPC_VRc & gJITC.current_opc) {
-		reg = jitcAllocRegister();
-
-		asmMOV_NoFlags(reg, CR_CR6_EQ | CR_CR6_NE);
-	}
-
-	for (int i=0; i<16; i += 2) {
-		vec_getHalf(reg2, vrA, i);
-
-		asmALU(X86_CMP, reg2, x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		if (PPC_OPC_VRc & gJITC.current_opc) {
-			NativeAddress skip1 = asmJxxFixup(X86_NE);
-
-			asmMOV_NoFlags(reg2, 0xffff);
-			asmALU(X86_AND, reg, ~CR_CR6_NE);
-			asmALU(X86_OR, reg, CR_CR6_EQ_SOME);
-			NativeAddress skip2 = asmJMPFixup();
-
-			asmResolveFixup(skip1);
-			asmALU(X86_XOR, reg2, reg2);
-			asmALU(X86_AND, reg, ~CR_CR6_EQ);
-			asmALU(X86_OR, reg, CR_CR6_NE_SOME);
-
-			asmResolveFixup(skip2, asmHERE());
-		} else {
-			asmSET(X86_NE, (NativeReg8)reg2);
-			asmMOVxx(X86_MOVZX, (NativeReg)reg2, (NativeReg8)reg2);
-
-			asmALU(X86_SUB, reg2, 1);
-		}
-
-		vec_setHalf(vrD, i, reg2);
-	}
-
-	if (PPC_OPC_VRc & gJITC.current_opc) {
-		asmAND(&gCPU.cr, ~CR_CR6);
-		asmALU(X86_OR, x86_mem2(modrm, &gCPU.cr), reg);
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, PALUW(X86_PCMPEQ), vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
 	}
-
 	return flowContinue;
-#endif
 }
 
 /*	vcmpequwx	Vector Compare Equal-to Unsigned Word
  *	v.162
  */
-void ppc_opc_vcmpequwx()
+void ppc_opc_vcmpequwx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		if (gCPU.vr[vrA].w[i] == gCPU.vr[vrB].w[i]) {
-			gCPU.vr[vrD].w[i] = 0xffffffff;
+		if (aCPU.vr[vrA].w[i] == aCPU.vr[vrB].w[i]) {
+			aCPU.vr[vrD].w[i] = 0xffffffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].w[i] = 0;
+			aCPU.vr[vrD].w[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpequwx()
+JITCFlow ppc_opc_gen_vcmpequwx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpequwx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	commutative_operation(jitc, PALUD(X86_PCMPEQ), vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpeqfpx	Vector Compare Equal-to-Floating Point
  *	v.159
  */
-void ppc_opc_vcmpeqfpx()
+void ppc_opc_vcmpeqfpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		if (gCPU.vr[vrA].f[i] == gCPU.vr[vrB].f[i]) {
-			gCPU.vr[vrD].w[i] = 0xffffffff;
+		if (aCPU.vr[vrA].f[i] == aCPU.vr[vrB].f[i]) {
+			aCPU.vr[vrD].w[i] = 0xffffffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].w[i] = 0;
+			aCPU.vr[vrD].w[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpeqfpx()
+JITCFlow ppc_opc_gen_vcmpeqfpx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpeqfpx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_compare_fp(jitc, X86_CMPEQPS, vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgtubx	Vector Compare Greater-Than Unsigned Byte
  *	v.168
  */
-void ppc_opc_vcmpgtubx()
+void ppc_opc_vcmpgtubx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		if (gCPU.vr[vrA].b[i] > gCPU.vr[vrB].b[i]) {
-			gCPU.vr[vrD].b[i] = 0xff;
+		if (aCPU.vr[vrA].b[i] > aCPU.vr[vrB].b[i]) {
+			aCPU.vr[vrD].b[i] = 0xff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].b[i] = 0;
+			aCPU.vr[vrD].b[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtubx()
+JITCFlow ppc_opc_gen_vcmpgtubx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtubx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_compare_unsigned(jitc, PALUB(X86_PCMPGT), 0x80808080, vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgtsbx	Vector Compare Greater-Than Signed Byte
  *	v.165
  */
-void ppc_opc_vcmpgtsbx()
+void ppc_opc_vcmpgtsbx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<16; i++) {
-		if (gCPU.vr[vrA].sb[i] > gCPU.vr[vrB].sb[i]) {
-			gCPU.vr[vrD].b[i] = 0xff;
+		if (aCPU.vr[vrA].sb[i] > aCPU.vr[vrB].sb[i]) {
+			aCPU.vr[vrD].b[i] = 0xff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].b[i] = 0;
+			aCPU.vr[vrD].b[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtsbx()
+JITCFlow ppc_opc_gen_vcmpgtsbx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtsbx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUB(X86_PCMPGT), vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgtuhx	Vector Compare Greater-Than Unsigned Half Word
  *	v.169
  */
-void ppc_opc_vcmpgtuhx()
+void ppc_opc_vcmpgtuhx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		if (gCPU.vr[vrA].h[i] > gCPU.vr[vrB].h[i]) {
-			gCPU.vr[vrD].h[i] = 0xffff;
+		if (aCPU.vr[vrA].h[i] > aCPU.vr[vrB].h[i]) {
+			aCPU.vr[vrD].h[i] = 0xffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].h[i] = 0;
+			aCPU.vr[vrD].h[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtuhx()
+JITCFlow ppc_opc_gen_vcmpgtuhx(JITC &jitc)
 {
-#if 0
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtuhx);
-	return flowEndBlock;
-#else
 	int vrD, vrA, vrB;
-	modrm_o modrm;
-	PPC_OPC_TEMPL_X(gJITC.current_opc, vrD, vrA, vrB);
-
-	if (vrA == vrB) {
-		vec_Zero(vrD);
-
-		if (PPC_OPC_VRc & gJITC.current_opc) {
-			jitcClobberCarryAndFlags();
-
-			asmAND(&gCPU.cr, ~CR_CR6);
-			asmOR(&gCPU.cr, CR_CR6_NE | CR_CR6_NE_SOME);
-		}
-
-		return flowContinue;
-	}
-
-	jitcFlushClientVectorRegister(vrA);
-	jitcFlushClientVectorRegister(vrB);
-	jitcDropClientVectorRegister(vrD);
-
-	jitcClobberCarryAndFlags();
-	NativeReg reg = REG_NO;
-	NativeReg16 reg2 = (NativeReg16)jitcAllocRegister(NATIVE_REG_8);
-
-	if (PPC_OPC_VRc & gJITC.current_opc) {
-		reg = jitcAllocRegister();
-
-		asmMOV_NoFlags(reg, CR_CR6_EQ | CR_CR6_NE);
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_compare_unsigned(jitc, PALUW(X86_PCMPGT), 0x80008000, vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
 	}
-
-	for (int i=0; i<16; i += 2) {
-		vec_getHalf(reg2, vrA, i);
-
-		asmALU(X86_CMP, reg2, x86_mem2(modrm, &(gCPU.vr[vrB].b[i])));
-
-		if (PPC_OPC_VRc & gJITC.current_opc) {
-			NativeAddress skip1 = asmJxxFixup(X86_BE);
-
-			asmMOV_NoFlags(reg2, 0xffff);
-			asmALU(X86_AND, reg, ~CR_CR6_NE);
-			asmALU(X86_OR, reg, CR_CR6_EQ_SOME);
-			NativeAddress skip2 = asmJMPFixup();
-
-			asmResolveFixup(skip1);
-			asmALU(X86_XOR, reg2, reg2);
-			asmALU(X86_AND, reg, ~CR_CR6_EQ);
-			asmALU(X86_OR, reg, CR_CR6_NE_SOME);
-
-			asmResolveFixup(skip2);
-		} else {
-			asmSET(X86_BE, (NativeReg8)reg2);
-			asmMOVxx(X86_MOVZX, (NativeReg)reg2, (NativeReg8)reg2);
-
-			asmALU(X86_SUB, reg2, 1);
-		}
-
-		vec_setHalf(vrD, i, reg2);
-	}
-
-	if (PPC_OPC_VRc & gJITC.current_opc) {
-		asmAND(&gCPU.cr, ~CR_CR6);
-		asmALU(X86_OR, x86_mem2(modrm, &gCPU.cr), reg);
-	}
-
 	return flowContinue;
-#endif
 }
 
 /*	vcmpgtshx	Vector Compare Greater-Than Signed Half Word
  *	v.166
  */
-void ppc_opc_vcmpgtshx()
+void ppc_opc_vcmpgtshx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<8; i++) {
-		if (gCPU.vr[vrA].sh[i] > gCPU.vr[vrB].sh[i]) {
-			gCPU.vr[vrD].h[i] = 0xffff;
+		if (aCPU.vr[vrA].sh[i] > aCPU.vr[vrB].sh[i]) {
+			aCPU.vr[vrD].h[i] = 0xffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].h[i] = 0;
+			aCPU.vr[vrD].h[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtshx()
+JITCFlow ppc_opc_gen_vcmpgtshx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtshx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUW(X86_PCMPGT), vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgtuwx	Vector Compare Greater-Than Unsigned Word
  *	v.170
  */
-void ppc_opc_vcmpgtuwx()
+void ppc_opc_vcmpgtuwx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		if (gCPU.vr[vrA].w[i] > gCPU.vr[vrB].w[i]) {
-			gCPU.vr[vrD].w[i] = 0xffffffff;
+		if (aCPU.vr[vrA].w[i] > aCPU.vr[vrB].w[i]) {
+			aCPU.vr[vrD].w[i] = 0xffffffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].w[i] = 0;
+			aCPU.vr[vrD].w[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtuwx()
+JITCFlow ppc_opc_gen_vcmpgtuwx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtuwx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_compare_unsigned(jitc, PALUD(X86_PCMPGT), 0x80000000, vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgtswx	Vector Compare Greater-Than Signed Word
  *	v.167
  */
-void ppc_opc_vcmpgtswx()
+void ppc_opc_vcmpgtswx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) {
-		if (gCPU.vr[vrA].sw[i] > gCPU.vr[vrB].sw[i]) {
-			gCPU.vr[vrD].w[i] = 0xffffffff;
+		if (aCPU.vr[vrA].sw[i] > aCPU.vr[vrB].sw[i]) {
+			aCPU.vr[vrD].w[i] = 0xffffffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].w[i] = 0;
+			aCPU.vr[vrD].w[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtswx()
+JITCFlow ppc_opc_gen_vcmpgtswx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtswx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	noncommutative_operation(jitc, PALUD(X86_PCMPGT), vrD, vrA, vrB);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgtfpx	Vector Compare Greater-Than Floating-Point
  *	v.164
  */
-void ppc_opc_vcmpgtfpx()
+void ppc_opc_vcmpgtfpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		if (gCPU.vr[vrA].f[i] > gCPU.vr[vrB].f[i]) {
-			gCPU.vr[vrD].w[i] = 0xffffffff;
+		if (aCPU.vr[vrA].f[i] > aCPU.vr[vrB].f[i]) {
+			aCPU.vr[vrD].w[i] = 0xffffffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].w[i] = 0;
+			aCPU.vr[vrD].w[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgtfpx()
+JITCFlow ppc_opc_gen_vcmpgtfpx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgtfpx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_compare_fp(jitc, X86_CMPLTPS, vrD, vrB, vrA);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpgefpx	Vector Compare Greater-Than-or-Equal-to Floating Point
  *	v.163
  */
-void ppc_opc_vcmpgefpx()
+void ppc_opc_vcmpgefpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int tf=CR_CR6_EQ | CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		if (gCPU.vr[vrA].f[i] >= gCPU.vr[vrB].f[i]) {
-			gCPU.vr[vrD].w[i] = 0xffffffff;
+		if (aCPU.vr[vrA].f[i] >= aCPU.vr[vrB].f[i]) {
+			aCPU.vr[vrD].w[i] = 0xffffffff;
 			tf &= ~CR_CR6_NE;
 			tf |= CR_CR6_EQ_SOME;
 		} else {
-			gCPU.vr[vrD].w[i] = 0;
+			aCPU.vr[vrD].w[i] = 0;
 			tf &= ~CR_CR6_EQ;
 			tf |= CR_CR6_NE_SOME;
 		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= tf;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= tf;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpgefpx()
+JITCFlow ppc_opc_gen_vcmpgefpx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpgefpx);
-	return flowEndBlock;
+	int vrD, vrA, vrB;
+	PPC_OPC_TEMPL_X(jitc.current_opc, vrD, vrA, vrB);
+	vec_compare_fp(jitc, X86_CMPLEPS, vrD, vrB, vrA);
+	if (jitc.current_opc & PPC_OPC_VRc) {
+		vec_update_cr6(jitc, vrD);
+	}
+	return flowContinue;
 }
 
 /*	vcmpbfpx	Vector Compare Bounds Floating Point
  *	v.157
  */
-void ppc_opc_vcmpbfpx()
+void ppc_opc_vcmpbfpx(PPC_CPU_State &aCPU)
 {
 	VECTOR_DEBUG;
 	int vrD, vrA, vrB;
 	int le, ge;
 	int ib=CR_CR6_NE;
-	PPC_OPC_TEMPL_X(gCPU.current_opc, vrD, vrA, vrB);
+	PPC_OPC_TEMPL_X(aCPU.current_opc, vrD, vrA, vrB);
 
 	for (int i=0; i<4; i++) { //FIXME: This might not comply with Java FP
-		le = (gCPU.vr[vrA].f[i] <= gCPU.vr[vrB].f[i]) ? 0 : 0x80000000;
-		ge = (gCPU.vr[vrA].f[i] >= -gCPU.vr[vrB].f[i]) ? 0 : 0x40000000;
+		le = (aCPU.vr[vrA].f[i] <= aCPU.vr[vrB].f[i]) ? 0 : 0x80000000;
+		ge = (aCPU.vr[vrA].f[i] >= -aCPU.vr[vrB].f[i]) ? 0 : 0x40000000;
 
-		gCPU.vr[vrD].w[i] = le | ge;
+		aCPU.vr[vrD].w[i] = le | ge;
 		if (le | ge) {
 			ib = 0;
  		}
 	}
 
-	if (PPC_OPC_VRc & gCPU.current_opc) {
-		gCPU.cr &= ~CR_CR6;
-		gCPU.cr |= ib;
+	if (PPC_OPC_VRc & aCPU.current_opc) {
+		aCPU.cr &= ~CR_CR6;
+		aCPU.cr |= ib;
 	}
 }
-JITCFlow ppc_opc_gen_vcmpbfpx()
+JITCFlow ppc_opc_gen_vcmpbfpx(JITC &jitc)
 {
-	ppc_opc_gen_interpret(ppc_opc_vcmpbfpx);
-	return flowEndBlock;
+	ppc_opc_gen_interpret(jitc, ppc_opc_vcmpbfpx);
+	return flowContinue;
 }
-#endif
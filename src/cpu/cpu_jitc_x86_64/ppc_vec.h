@@ -88,7 +88,7 @@ static UNUSED void ppc_opc_gen_check_vec(JITC &jitc)
 {
 	if (!jitc.checkedVector) {
 //		jitcFloatRegisterClobberAll(); FIXME64
-//		jitc.flushVectorRegister();
+		jitc.flushVectorRegister();
 		jitc.clobberCarryAndFlags();
 
 		NativeReg r1 = jitc.getClientRegister(PPC_MSR);
@@ -104,7 +104,6 @@ static UNUSED void ppc_opc_gen_check_vec(JITC &jitc)
 	}
 }
 
-#if 0
 void ppc_opc_vperm(PPC_CPU_State &aCPU);
 void ppc_opc_vsel(PPC_CPU_State &aCPU);
 void ppc_opc_vsrb(PPC_CPU_State &aCPU);
@@ -400,4 +399,3 @@ JITCFlow ppc_opc_gen_vcmpgefpx(JITC &aJITC);
 JITCFlow ppc_opc_gen_vcmpbfpx(JITC &aJITC);
 
 #endif
-#endif
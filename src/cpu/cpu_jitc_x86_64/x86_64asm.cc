@@ -61,6 +61,20 @@ void x86GetCaps(X86CPUCaps &caps)
 	caps._3dnow2 = id2.features & (1<<30);
 	caps.sse3 = id2.features2 & (1<<0);
 	caps.ssse3 = id2.features2 & (1<<9);
+	caps.movbe = id2.features2 & (1<<22);
+	caps.popcnt = id2.features2 & (1<<23);
+	// the OS has to save the YMM state (XCR0 bits 1 and 2)
+	if ((id2.features2 & (1<<27)) && (id2.features2 & (1<<28))) {
+		caps.avx = (ppc_xgetbv_asm(0) & 6) == 6;
+	}
+	caps.fma = caps.avx && (id2.features2 & (1<<12));
+
+	if (id.level >= 7) {
+		ppc_cpuid_asm(7, &id2);
+		caps.bmi1 = id2.b & (1<<3);
+		caps.avx2 = caps.avx && (id2.b & (1<<5));
+		caps.bmi2 = id2.b & (1<<8);
+	}
 	
 	ppc_cpuid_asm(0x80000000, &id);
 	if (id.level >= 0x80000001) {
@@ -70,16 +84,29 @@ void x86GetCaps(X86CPUCaps &caps)
 		
 		caps._3dnow = id2.features & (1<<31);
 		caps._3dnow2 = id2.features & (1<<30);
+		caps.lzcnt = id2.features2 & (1<<5);
 	}
-	
-/*	ht_printf("%s%s%s%s%s%s%s\n",
+	if (id.level >= 0x80000007) {
+		ppc_cpuid_asm(0x80000007, &id2);
+		caps.invariant_tsc = id2.features & (1<<8);
+	}
+
+/*	ht_printf("%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s\n",
 		caps.cmov?" CMOV":"",
 		caps.mmx?" MMX":"",
 		caps._3dnow?" 3DNOW":"",
 		caps._3dnow2?" 3DNOW+":"",
 		caps.sse?" SSE":"",
 		caps.sse2?" SSE2":"",
-		caps.sse3?" SSE3":"");*/
+		caps.sse3?" SSE3":"",
+		caps.popcnt?" POPCNT":"",
+		caps.lzcnt?" LZCNT":"",
+		caps.movbe?" MOVBE":"",
+		caps.bmi1?" BMI1":"",
+		caps.bmi2?" BMI2":"",
+		caps.avx?" AVX":"",
+		caps.avx2?" AVX2":"",
+		caps.fma?" FMA":"");*/
 }
 
 /*
@@ -98,11 +125,81 @@ void JITC::unmapRegister(NativeReg reg)
 	nativeReg[reg] = PPC_REG_NO;
 }
 
+/*
+ *	Peephole: true if the last instruction emitted stored
+ *	lastStoreReg to creg, so that it's still in lastStoreReg
+ */
+bool JITC::lastInsnStores(PPC_Register creg)
+{
+	return peephole && lastStoreEnd == currentPage->tcp && lastStoreSlot == creg;
+}
+
+/*
+ *	Peephole: true if the last instruction emitted ends at end
+ *	and may be taken back. Not while tracing, the trace already
+ *	has it.
+ */
+bool JITC::peepholeMayDrop(NativeAddress end)
+{
+	return peephole && !gJITCTrace && end == currentPage->tcp;
+}
+
+/*
+ *	Peephole: takes back the last instruction emitted,
+ *	which starts at start
+ */
+void JITC::dropLastInsn(NativeAddress start)
+{
+	uint size = currentPage->tcp - start;
+	currentPage->tcp = start;
+	currentPage->bytesLeft += size;
+	code_bytes -= size;
+	peephole_saved += size;
+	lastStoreEnd = NULL;
+	lastMoveEnd = NULL;
+}
+
+/*
+ *	Peephole: called before an instruction which overwrites all
+ *	of nreg without reading it, a move to nreg right before is dead
+ */
+void JITC::overwriteRegister(NativeReg nreg)
+{
+	if (lastMoveReg == nreg && peepholeMayDrop(lastMoveEnd)) {
+		dropLastInsn(lastMoveStart);
+	}
+}
+
+/*
+ *	Peephole: the instruction emitted since code_bytes was
+ *	code_bytes_before only moved something to nreg
+ */
+void JITC::movedRegister(NativeReg nreg, uint64 code_bytes_before)
+{
+	lastMoveEnd = currentPage->tcp;
+	lastMoveStart = lastMoveEnd - (code_bytes - code_bytes_before);
+	lastMoveReg = nreg;
+}
+
 void JITC::loadRegister(NativeReg nreg, PPC_Register creg)
 {
-	if (creg >= PPC_FPR(0) && creg <= PPC_FPR(31)) {
+	bool fpr = creg >= PPC_FPR(0) && creg <= PPC_FPR(31);
+	if (lastInsnStores(creg)) {
+		// just stored, take it from the register
+		NativeAddress start = currentPage->tcp;
+		if (lastStoreReg != nreg) {
+			if (fpr) {
+				asmALU64(X86_MOV, nreg, lastStoreReg);
+			} else {
+				asmALU32(X86_MOV, nreg, lastStoreReg);
+			}
+		}
+		peephole_saved += 8 - (currentPage->tcp - start);
+	} else if (fpr) {
+		overwriteRegister(nreg);
 		asmALU64(X86_MOV, nreg, curCPUreg(creg));
 	} else {
+		overwriteRegister(nreg);
 		asmALU32(X86_MOV, nreg, curCPUreg(creg));
 	}
 	mapRegister(nreg, creg);
@@ -111,11 +208,25 @@ void JITC::loadRegister(NativeReg nreg, PPC_Register creg)
 
 void JITC::storeRegister(NativeReg nreg, PPC_Register creg)
 {
+	if (lastInsnStores(creg)) {
+		if (lastStoreReg == nreg) {
+			// the same store again
+			peephole_saved += 8;
+			return;
+		}
+		// the last store is dead
+		if (peepholeMayDrop(lastStoreEnd)) dropLastInsn(lastStoreStart);
+	}
+	uint64 before = code_bytes;
 	if (creg >= PPC_FPR(0) && creg <= PPC_FPR(31)) {
 		asmALU64(X86_MOV, curCPUreg(creg), nreg);
 	} else {
 		asmALU32(X86_MOV, curCPUreg(creg), nreg);
 	}
+	lastStoreEnd = currentPage->tcp;
+	lastStoreStart = lastStoreEnd - (code_bytes - before);
+	lastStoreSlot = creg;
+	lastStoreReg = nreg;
 }
 
 void JITC::storeRegisterUndirty(NativeReg nreg, PPC_Register creg)
@@ -450,6 +561,31 @@ void JITC::flushRegisterDirty(int options)
 		flushSingleRegisterDirty(reg);
 	}
 }
+/*
+ *	Reloads all mapped native registers from the client state
+ *	which don't survive a call into the MMU helpers.
+ *	Mappings and dirty flags are not changed, so this is
+ *	only valid after flushRegisterDirty().
+ *	Will produce a load for every such mapped register.
+ *
+ *	Note: RBP and R13-R15 are callee-saved and not used by
+ *	the MMU helpers, so they are left alone.
+ */
+void JITC::reloadRegister()
+{
+	for (NativeReg i = RAX; i <= R12; i = (NativeReg)(i+1)) {
+		if (i == RSP || i == RBP) continue;
+		PPC_Register creg = getRegisterMapping(i);
+		if (creg != PPC_REG_NO && nativeRegState[i] != rsUnused) {
+			if (creg >= PPC_FPR(0) && creg <= PPC_FPR(31)) {
+				asmALU64(X86_MOV, i, curCPUreg(creg));
+			} else {
+				asmALU32(X86_MOV, i, curCPUreg(creg));
+			}
+		}
+	}
+}
+
 /*
  *	Clobbers native register(s).
  *	Register is unused afterwards.
@@ -477,7 +613,7 @@ void JITC::flushAll()
 {
 	clobberCarryAndFlags();
 	flushRegister();
-//	flushVectorRegister(); FIX64
+	flushVectorRegister();
 }
 
 /*
@@ -488,7 +624,7 @@ void JITC::clobberAll()
 	clobberCarryAndFlags();
 	clobberRegister();
 	floatRegisterClobberAll();
-//	trashVectorRegister(); FIX64
+	trashVectorRegister();
 }
 
 /*
@@ -521,13 +657,13 @@ void JITC::invalidateAll()
 			printf("!!! Unflushed vector register invalidated! (XMM%u)\n", i);
 		}
 	}
+#endif
 
 	memset(n2cVectorReg, PPC_VECTREG_NO, sizeof n2cVectorReg);
 	memset(c2nVectorReg, VECTREG_NO, sizeof c2nVectorReg);
 	memset(nativeVectorRegState, rsUnused, sizeof nativeVectorRegState);
 
 	nativeVectorReg = VECTREG_NO;
-#endif
 }
 
 /*
@@ -544,9 +680,10 @@ void JITC::getClientCarry()
 	}
 }
 
-void JITC::mapFlagsDirty(PPC_CRx cr)
+void JITC::mapFlagsDirty(PPC_CRx cr, JITCFlagsType type)
 {
 	nativeFlags = cr;
+	nativeFlagsType = type;
 	nativeFlagsState = rsDirty;
 }
 
@@ -555,6 +692,11 @@ PPC_CRx JITC::getFlagsMapping()
 	return nativeFlags;
 }
 
+JITCFlagsType JITC::getFlagsType()
+{
+	return nativeFlagsType;
+}
+
 bool JITC::flagsMapped()
 {
 	return nativeFlagsState != rsUnused;
@@ -577,9 +719,35 @@ void JITC::flushCarry()
 
 #if 1
 
+static const NativeAddress gFlushFlagsCmp[2][8] = {
+	{
+		(NativeAddress)ppc_flush_flags_signed_0_asm,
+		(NativeAddress)ppc_flush_flags_signed_1_asm,
+		(NativeAddress)ppc_flush_flags_signed_2_asm,
+		(NativeAddress)ppc_flush_flags_signed_3_asm,
+		(NativeAddress)ppc_flush_flags_signed_4_asm,
+		(NativeAddress)ppc_flush_flags_signed_5_asm,
+		(NativeAddress)ppc_flush_flags_signed_6_asm,
+		(NativeAddress)ppc_flush_flags_signed_7_asm,
+	}, {
+		(NativeAddress)ppc_flush_flags_unsigned_0_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_1_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_2_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_3_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_4_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_5_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_6_asm,
+		(NativeAddress)ppc_flush_flags_unsigned_7_asm,
+	},
+};
+
 void JITC::flushFlags()
 {
-	asmCALL((NativeAddress)ppc_flush_flags_asm);
+	if (nativeFlagsType == flagsResult) {
+		asmCALL((NativeAddress)ppc_flush_flags_asm);
+	} else {
+		asmCALL(gFlushFlagsCmp[nativeFlagsType == flagsCmpUnsigned][nativeFlags]);
+	}
 }
 
 #else
@@ -663,6 +831,28 @@ void JITC::flushFlagsAfterCMP_L(int disp)
 }
 #endif
 
+/*
+ *	Writes mapped flags to the CR, but keeps the mapping.
+ *	Clobbers the x86 flags, so it's only useful on a path
+ *	which leaves the block.
+ */
+void JITC::flushFlagsDirty()
+{
+	if (nativeFlagsState == rsDirty) {
+		flushFlags();
+	}
+}
+
+/*
+ *	Forgets mapped flags without writing them
+ *	(only valid if the CR field is dead)
+ *	Will never produce code
+ */
+void JITC::discardFlags()
+{
+	nativeFlagsState = rsUnused;
+}
+
 void JITC::clobberFlags()
 {
 	if (nativeFlagsState == rsDirty) {
@@ -986,9 +1176,13 @@ void JITC::asmSimpleMODRM8(uint8 opc, NativeReg reg1, NativeReg reg2)
 void JITC::asmALU64(X86ALUopc opc, NativeReg reg1, NativeReg reg2)
 {
 	switch (opc) {
-	case X86_MOV: 
+	case X86_MOV: {
+		if (reg1 != reg2) overwriteRegister(reg1);
+		uint64 before = code_bytes;
 		asmSimpleMODRM64(0x8b, reg1, reg2);
+		movedRegister(reg1, before);
 	        break;
+	}
 	case X86_TEST:
 		asmSimpleMODRM64(0x85, reg1, reg2);
 	        break;
@@ -1003,9 +1197,13 @@ void JITC::asmALU64(X86ALUopc opc, NativeReg reg1, NativeReg reg2)
 void JITC::asmALU32(X86ALUopc opc, NativeReg reg1, NativeReg reg2)
 {
 	switch (opc) {
-	case X86_MOV: 
+	case X86_MOV: {
+		if (reg1 != reg2) overwriteRegister(reg1);
+		uint64 before = code_bytes;
 		asmSimpleMODRM32(0x8b, reg1, reg2);
+		movedRegister(reg1, before);
 	        break;
+	}
 	case X86_TEST:
 		asmSimpleMODRM32(0x85, reg1, reg2);
 	        break;
@@ -1042,9 +1240,12 @@ void JITC::asmALU8(X86ALUopc opc, NativeReg reg1, NativeReg reg2)
 
 void JITC::asmMOVABS(NativeReg reg, uint64 value)
 {
+	overwriteRegister(reg);
 	byte instr[10] = {byte(0x48 + (reg>>3)), byte(0xb8 + (reg&7))};
 	U64(instr + 2) = value;
+	uint64 before = code_bytes;
 	emit(instr, sizeof instr);
+	movedRegister(reg, before);
 }
 
 void JITC::asmSimpleALU32(X86ALUopc opc, NativeReg reg, uint32 imm)
@@ -1112,6 +1313,7 @@ void JITC::asmALU32(X86ALUopc opc, NativeReg reg, uint32 imm)
 	switch (opc) {
 	case X86_MOV:
 		if (imm == 0) {
+			overwriteRegister(reg);
 			asmALU32(X86_XOR, reg, reg);
 		} else {
 			asmMOV32_NoFlags(reg, imm);
@@ -1137,6 +1339,8 @@ void JITC::asmALU32(X86ALUopc opc, NativeReg reg, uint32 imm)
 
 void JITC::asmMOV32_NoFlags(NativeReg reg1, uint32 imm)
 {
+	overwriteRegister(reg1);
+	uint64 before = code_bytes;
 	if (reg1 > 7) {
 		byte instr[6];
 		instr[0] = 0x41;
@@ -1149,6 +1353,7 @@ void JITC::asmMOV32_NoFlags(NativeReg reg1, uint32 imm)
 		U32(instr + 1) = imm;
 		emit(instr, sizeof(instr));
 	}
+	movedRegister(reg1, before);
 }
 
 void JITC::asmALU32(X86ALUopc1 opc, NativeReg reg)
@@ -1162,6 +1367,12 @@ void JITC::asmALU32(X86ALUopc1 opc, NativeReg reg)
 	}
 }
 
+void JITC::asmALU64(X86ALUopc1 opc, NativeReg reg)
+{
+	byte instr[3] = {byte(0x48 + (reg>>3)), 0xf7, byte(opc+(reg&7))};
+	emit(instr, 3);
+}
+
 void JITC::asmALU64(X86ALUopc opc, NativeReg reg, NativeReg base, uint32 disp)
 {	
 	byte instr[15];
@@ -1353,6 +1564,33 @@ void JITC::asmALU8(X86ALUopc opc, NativeReg base, uint32 disp, NativeReg reg)
 	emit(instr, len);
 }
 
+void JITC::asmALU16(X86ALUopc opc, NativeReg base, uint32 disp, NativeReg reg)
+{
+	byte instr[15];
+	uint len=0;
+	instr[len++] = 0x66;
+	if ((reg | base) > 7) {
+		instr[len++] = 0x40+((reg>>3)<<2)+(base>>3);
+	}
+	switch (opc) {
+	case X86_MOV:
+		instr[len] = 0x89;
+		break;
+	case X86_XCHG:
+		instr[len] = 0x87;
+		break;
+	case X86_TEST:
+		instr[len] = 0x85;
+		break;
+	default:
+		instr[len] = 0x01+(opc<<3);
+	}
+	len++;
+	instr[len] = (reg&7)<<3;
+	len += mkmodrm(instr+len, base, disp);
+	emit(instr, len);
+}
+
 void JITC::asmALU32(X86ALUopc opc, NativeReg reg, NativeReg base, int scale, NativeReg index, uint32 disp)
 {
 	byte instr[15];
@@ -1511,6 +1749,21 @@ void JITC::asmMOVxx32_16(X86MOVxx opc, NativeReg reg1, NativeReg reg2)
 	}	
 }
 
+void JITC::asmMOVxx32_16(X86MOVxx opc, NativeReg reg, NativeReg base, uint32 disp)
+{
+	byte instr[15];
+	uint len=0;
+	if (reg > 7 || base > 7) {
+		instr[0] = byte(0x40+((reg>>3)<<2)+(base>>3));
+		len++;
+	}
+	instr[len++] = 0x0f;
+	instr[len++] = opc+1;
+	instr[len] = (reg & 7) << 3;
+	len += mkmodrm(instr+len, base, disp);
+	emit(instr, len);
+}
+
 void JITC::asmMOVxx32_8(X86MOVxx opc, NativeReg reg1, NativeReg reg2)
 {
 	if (reg1 > 7 || reg2 > 3) {
@@ -1655,6 +1908,16 @@ void JITC::asmShift32CL(X86ShiftOpc opc, NativeReg reg)
 	}
 }
 
+/*
+ *	reg1 = reg1 >> imm with the bits of reg2 shifted in
+ */
+void JITC::asmSHRD64(NativeReg reg1, NativeReg reg2, uint imm)
+{
+	byte instr[5] = {byte(0x48 + ((reg2>>3)<<2) + (reg1>>3)), 0x0f, 0xac,
+	                 byte(0xc0 + ((reg2&7)<<3) + (reg1&7)), byte(imm)};
+	emit(instr, sizeof instr);
+}
+
 void JITC::asmIMUL32(NativeReg reg1, NativeReg reg2, uint32 imm)
 {
 	if (imm <= 0x7f || imm >= 0xffffff80) {	
@@ -1763,6 +2026,66 @@ void JITC::asmBSx32(X86BitSearch opc, NativeReg reg1, NativeReg reg2)
 	}
 }
 
+void JITC::asmLZCNT32(NativeReg reg1, NativeReg reg2)
+{
+	byte instr[5];
+	uint len = 0;
+	instr[len++] = 0xf3;
+	if ((reg1 | reg2) > 7) {
+		instr[len++] = 0x40 + ((reg1 & 8) >> 1) + ((reg2 & 8) >> 3);
+	}
+	instr[len++] = 0x0f;
+	instr[len++] = 0xbd;
+	instr[len++] = 0xc0 + ((reg1 & 7) << 3) + (reg2 & 7);
+	emit(instr, len);
+}
+
+void JITC::asmMOVBE32(NativeReg reg, NativeReg base, uint32 disp)
+{
+	byte instr[15];
+	uint len = 0;
+	if ((reg | base) > 7) {
+		instr[len++] = 0x40 + ((reg & 8) >> 1) + ((base & 8) >> 3);
+	}
+	instr[len++] = 0x0f;
+	instr[len++] = 0x38;
+	instr[len++] = 0xf0;
+	instr[len] = (reg & 7) << 3;
+	len += mkmodrm(instr+len, base, disp);
+	emit(instr, len);
+}
+
+void JITC::asmMOVBE32(NativeReg base, uint32 disp, NativeReg reg)
+{
+	byte instr[15];
+	uint len = 0;
+	if ((reg | base) > 7) {
+		instr[len++] = 0x40 + ((reg & 8) >> 1) + ((base & 8) >> 3);
+	}
+	instr[len++] = 0x0f;
+	instr[len++] = 0x38;
+	instr[len++] = 0xf1;
+	instr[len] = (reg & 7) << 3;
+	len += mkmodrm(instr+len, base, disp);
+	emit(instr, len);
+}
+
+/*
+ *	reg1 = ~reg2 & reg3
+ */
+void JITC::asmANDN32(NativeReg reg1, NativeReg reg2, NativeReg reg3)
+{
+	asmVEX(0, 2, false, 0xf2, reg1, reg2, reg3);
+}
+
+/*
+ *	reg1 = reg2 rotated right by imm, flags are unchanged
+ */
+void JITC::asmRORX32(NativeReg reg1, NativeReg reg2, uint imm)
+{
+	asmVEX(3, 3, false, 0xf0, reg1, 0, reg2, imm);
+}
+
 void JITC::asmBSWAP64(NativeReg reg)
 {
 	byte instr[3];
@@ -1789,6 +2112,13 @@ void JITC::asmBSWAP32(NativeReg reg)
 
 void JITC::asmJMP(NativeAddress to)
 {
+	if (currentProfile && (to == (NativeAddress)ppc_new_pc_asm
+	 || to == (NativeAddress)ppc_new_pc_rel_asm
+	 || to == (NativeAddress)ppc_new_pc_cached_asm
+	 || to == (NativeAddress)ppc_new_pc_return_asm)) {
+		// leaving the block through the dispatcher
+		jitcProfileExit(*this, false);
+	}
 	/*
 	 *	We use emitAssure here, since
 	 *	we have to know the exact address of the jump
@@ -1871,35 +2201,41 @@ void JITC::asmSimple(X86SimpleOpc simple)
 }
 
 
-#if 0
+/*
+ *	Vector registers
+ *
+ *	Client vector registers are kept in XMM0-XMM15. All XMM registers
+ *	are volatile in the host ABI, so every call into C code must be
+ *	preceded by a flush (see clobberAll() and reloadVectorRegister()).
+ *	The client vector registers are stored byte reversed, so the
+ *	element wise operations need no shuffling.
+ */
+
 /*
  *	Maps one client vector register to one native vector register
  *	Will never emit any code.
  */
-static inline void jitcMapVectorRegister(NativeVectorReg nreg, JitcVectorReg creg)
+void JITC::mapVectorRegister(NativeVectorReg nreg, JitcVectorReg creg)
 {
-	//printf("*** map: XMM%u (vr%u)\n", nreg, creg);
-	jitc.n2cVectorReg[nreg] = creg;
-	jitc.c2nVectorReg[creg] = nreg;
+	n2cVectorReg[nreg] = creg;
+	c2nVectorReg[creg] = nreg;
 
-	jitc.nativeVectorRegState[nreg] = rsMapped;
+	nativeVectorRegState[nreg] = rsMapped;
 }
 
 /*
  *	Unmaps the native vector register from any client vector register
  *	Will never emit any code.
  */
-static inline void jitcUnmapVectorRegister(NativeVectorReg nreg)
+void JITC::unmapVectorRegister(NativeVectorReg nreg)
 {
-	JitcVectorReg creg = jitc.n2cVectorReg[nreg];
-
-	if (nreg != VECTREG_NO && creg != PPC_VECTREG_NO) {
-		//printf("*** unmap: XMM%u (vr%u)\n", nreg, jitc.n2cVectorReg[nreg]);
+	JitcVectorReg creg = n2cVectorReg[nreg];
 
-		jitc.n2cVectorReg[nreg] = PPC_VECTREG_NO;
-		jitc.c2nVectorReg[creg] = VECTREG_NO;
+	if (nreg != VECTREG_NO && creg != (JitcVectorReg)PPC_VECTREG_NO) {
+		n2cVectorReg[nreg] = PPC_VECTREG_NO;
+		c2nVectorReg[creg] = VECTREG_NO;
 
-		jitc.nativeVectorRegState[nreg] = rsUnused;
+		nativeVectorRegState[nreg] = rsUnused;
 	}
 }
 
@@ -1908,27 +2244,23 @@ static inline void jitcUnmapVectorRegister(NativeVectorReg nreg)
  *	Does *not* touch native vector register.
  *	Will not produce code.
  */
-void jitcDirtyVectorRegister(NativeVectorReg nreg)
+void JITC::dirtyVectorRegister(NativeVectorReg nreg)
 {
-	JitcVectorReg creg = jitc.n2cVectorReg[nreg];
+	JitcVectorReg creg = n2cVectorReg[nreg];
 
-	//printf("*** dirty(%u) with creg = %u\n", nreg, creg);
-
-	if (creg == JITC_VECTOR_NEG1 || creg == PPC_VECTREG_NO) {
-		//printf("*** dirty: %u = %u or %u\n", creg, JITC_VECTOR_NEG1, PPC_REG_NO);
+	if (creg == JITC_VECTOR_NEG1 || creg == (JitcVectorReg)PPC_VECTREG_NO) {
 		return;
 	}
 
-	if (jitc.nativeVectorRegState[nreg] == rsUnused) {
-		printf("!!! Attemped dirty of an anonymous vector register!\n");
+	if (nativeVectorRegState[nreg] == rsUnused) {
 		return;
 	}
 
-	if (creg == jitc.nativeVectorReg) {
-		jitc.nativeVectorReg = VECTREG_NO;
+	if (creg == nativeVectorReg) {
+		nativeVectorReg = VECTREG_NO;
 	}
 
-	jitc.nativeVectorRegState[nreg] = rsDirty;
+	nativeVectorRegState[nreg] = rsDirty;
 }
 
 /*
@@ -1936,12 +2268,10 @@ void jitcDirtyVectorRegister(NativeVectorReg nreg)
  *	Does *not* flush native vector register.
  *	Will not produce code.
  */
-static inline void jitcUndirtyVectorRegister(NativeVectorReg nreg)
+void JITC::undirtyVectorRegister(NativeVectorReg nreg)
 {
-	if (jitc.nativeVectorRegState[nreg] > rsMapped) {
-		//printf("*** undirty: XMM%u (vr%u)\n", nreg, jitc.n2cVectorReg[nreg]);
-
-		jitc.nativeVectorRegState[nreg] = rsMapped;
+	if (nativeVectorRegState[nreg] > rsMapped) {
+		nativeVectorRegState[nreg] = rsMapped;
 	}
 }
 
@@ -1950,20 +2280,16 @@ static inline void jitcUndirtyVectorRegister(NativeVectorReg nreg)
  *	Does not alter the native vector register's markings.
  *	Will always emit an load.
  */
-static inline void jitcLoadVectorRegister(NativeVectorReg nreg)
+void JITC::loadVectorRegister(NativeVectorReg nreg)
 {
-	JitcVectorReg creg = jitc.n2cVectorReg[nreg];
+	JitcVectorReg creg = n2cVectorReg[nreg];
 
-	if (creg == JITC_VECTOR_NEG1 && jitc.hostCPUCaps.sse2) {
-		//printf("*** load neg1: XMM%u\n", nreg);
-
-		/* On a P4, we can load -1 far faster with logic */
+	if (creg == JITC_VECTOR_NEG1) {
 		asmPALU(PALUD(X86_PCMPEQ), nreg, nreg);
 		return;
 	}
 
-	//printf("*** load: XMM%u (vr%u)\n", nreg, creg);
-	asmMOVAPS(nreg, &gCPU.vr[creg]);
+	asmMOVUPS(nreg, curCPUvr(creg));
 }
 
 /*
@@ -1971,16 +2297,15 @@ static inline void jitcLoadVectorRegister(NativeVectorReg nreg)
  *	Does not alter the native vector register's markings.
  *	Will always emit a store.
  */
-static inline void jitcStoreVectorRegister(NativeVectorReg nreg)
+void JITC::storeVectorRegister(NativeVectorReg nreg)
 {
-	JitcVectorReg creg = jitc.n2cVectorReg[nreg];
+	JitcVectorReg creg = n2cVectorReg[nreg];
 
-	if (creg == JITC_VECTOR_NEG1 || creg == PPC_VECTREG_NO)
+	if (creg == JITC_VECTOR_NEG1 || creg == (JitcVectorReg)PPC_VECTREG_NO) {
 		return;
+	}
 
-	//printf("*** store: XMM%u (vr%u)\n", nreg, creg);
-
-	asmMOVAPS(&gCPU.vr[creg], nreg);
+	asmMOVUPS(curCPUvr(creg), nreg);
 }
 
 /*
@@ -1988,112 +2313,90 @@ static inline void jitcStoreVectorRegister(NativeVectorReg nreg)
  *		vector register.
  *	Will never emit any code.
  */
-NativeVectorReg jitcGetClientVectorRegisterMapping(JitcVectorReg creg)
+NativeVectorReg JITC::getClientVectorRegisterMapping(JitcVectorReg creg)
 {
-	return jitc.c2nVectorReg[creg];
+	return c2nVectorReg[creg];
 }
 
 /*
  *	Makes the vector register the least recently used vector register.
  *	Will never emit any code.
  */
-static inline void jitcDiscardVectorRegister(NativeVectorReg nreg)
+void JITC::discardVectorRegister(NativeVectorReg nreg)
 {
 	NativeVectorReg lreg, mreg;
 
-	mreg = jitc.MRUvregs[nreg];
-	lreg = jitc.LRUvregs[nreg];
+	mreg = MRUvregs[nreg];
+	lreg = LRUvregs[nreg];
 
 	// remove from the list
-	jitc.MRUvregs[lreg] = mreg;
-	jitc.LRUvregs[mreg] = lreg;
+	MRUvregs[lreg] = mreg;
+	LRUvregs[mreg] = lreg;
 
-	mreg = jitc.MRUvregs[XMM_SENTINEL];
+	mreg = MRUvregs[XMM_SENTINEL];
 
 	// insert into the list in the LRU spot
-	jitc.LRUvregs[nreg] = XMM_SENTINEL;
-	jitc.MRUvregs[nreg] = mreg;
+	LRUvregs[nreg] = XMM_SENTINEL;
+	MRUvregs[nreg] = mreg;
 
-	jitc.LRUvregs[mreg] = nreg;
-	jitc.MRUvregs[XMM_SENTINEL] = nreg;
+	LRUvregs[mreg] = nreg;
+	MRUvregs[XMM_SENTINEL] = nreg;
 }
 
 /*
  *	Makes the vector register the most recently used vector register.
  *	Will never emit any code.
  */
-void jitcTouchVectorRegister(NativeVectorReg nreg)
+void JITC::touchVectorRegister(NativeVectorReg nreg)
 {
 	NativeVectorReg lreg, mreg;
 
-	mreg = jitc.MRUvregs[nreg];
-	lreg = jitc.LRUvregs[nreg];
+	mreg = MRUvregs[nreg];
+	lreg = LRUvregs[nreg];
 
 	// remove from the list
-	jitc.MRUvregs[lreg] = mreg;
-	jitc.LRUvregs[mreg] = lreg;
+	MRUvregs[lreg] = mreg;
+	LRUvregs[mreg] = lreg;
 
-	lreg = jitc.LRUvregs[XMM_SENTINEL];
+	lreg = LRUvregs[XMM_SENTINEL];
 
-	// insert into the list in the LRU spot
-	jitc.MRUvregs[nreg] = XMM_SENTINEL;
-	jitc.LRUvregs[nreg] = lreg;
+	// insert into the list in the MRU spot
+	MRUvregs[nreg] = XMM_SENTINEL;
+	LRUvregs[nreg] = lreg;
 
-	jitc.MRUvregs[lreg] = nreg;
-	jitc.LRUvregs[XMM_SENTINEL] = nreg;
+	MRUvregs[lreg] = nreg;
+	LRUvregs[XMM_SENTINEL] = nreg;
 }
 
 /*
  *	Unmaps a native vector register, and marks it least recently used.
  *	Will not emit any code.
  */
-void jitcDropSingleVectorRegister(NativeVectorReg nreg)
+void JITC::dropSingleVectorRegister(NativeVectorReg nreg)
 {
-	jitcDiscardVectorRegister(nreg);
-	jitcUnmapVectorRegister(nreg);
+	discardVectorRegister(nreg);
+	unmapVectorRegister(nreg);
 }
 
-int jitcAssertFlushedVectorRegister(JitcVectorReg creg)
+int JITC::assertFlushedVectorRegister(JitcVectorReg creg)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
-	if (nreg != VECTREG_NO && jitc.nativeVectorRegState[nreg] == rsDirty) {
-		printf("!!! Unflushed vector XMM%u (vr%u)!\n", nreg, creg);
+	if (nreg != VECTREG_NO && nativeVectorRegState[nreg] == rsDirty) {
+		ht_printf("!!! Unflushed vector XMM%u (vr%u)!\n", nreg, creg);
 		return 1;
 	}
 	return 0;
 }
-int jitcAssertFlushedVectorRegisters()
-{
-	int ret = 0;
-
-	for (JitcVectorReg i=0; i<32; i++)
-		ret |= jitcAssertFlushedVectorRegister(i);
 
-	return ret;
-}
-
-void jitcShowVectorRegisterStatus(JitcVectorReg creg)
+int JITC::assertFlushedVectorRegisters()
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	int ret = 0;
 
-	if (nreg != VECTREG_NO) {
-		int status = jitc.nativeVectorRegState[nreg];
-		char *text;
-
-		if (status == rsUnused)
-			text = "unused";
-		else if (status == rsMapped)
-			text = "mapped";
-		else if (status == rsDirty)
-			text = "dirty";
-		else
-			text = "unknown";
-
-		//printf("*** vr%u => XMM%u (%s)\n", creg, nreg, text);
-	} else {
-		//printf("*** vr%u => memory\n", creg);
+	for (JitcVectorReg i=0; i<32; i++) {
+		ret |= assertFlushedVectorRegister(i);
 	}
+	return ret;
 }
 
 /*
@@ -2101,11 +2404,10 @@ void jitcShowVectorRegisterStatus(JitcVectorReg creg)
  *		value out to the client vector register store.
  *	Will produce a store, if the native vector register is dirty.
  */
-static inline void jitcFlushSingleVectorRegister(NativeVectorReg nreg)
+void JITC::flushSingleVectorRegister(NativeVectorReg nreg)
 {
-	if (jitc.nativeVectorRegState[nreg] == rsDirty) {
-		//printf("*** flush: XMM%u (vr%u)\n", nreg, jitc.n2cVectorReg[nreg]);
-		jitcStoreVectorRegister(nreg);
+	if (nativeVectorRegState[nreg] == rsDirty) {
+		storeVectorRegister(nreg);
 	}
 }
 
@@ -2113,29 +2415,21 @@ static inline void jitcFlushSingleVectorRegister(NativeVectorReg nreg)
  *	Flushes the register, frees it, and makes it least recently used.
  *	Will produce a store, if the native vector register was dirty.
  */
-static inline void jitcTrashSingleVectorRegister(NativeVectorReg nreg)
+void JITC::trashSingleVectorRegister(NativeVectorReg nreg)
 {
-	if (jitc.nativeVectorRegState[nreg] > rsUnused) {
-		//printf("*** trash: XMM%u (vr%u)\n", nreg, jitc.n2cVectorReg[nreg]);
-	}
-
-	jitcFlushSingleVectorRegister(nreg);
-	jitcDropSingleVectorRegister(nreg);
+	flushSingleVectorRegister(nreg);
+	dropSingleVectorRegister(nreg);
 }
 
 /*
  *	Flushes the register, frees it, and makes it most recently used.
  *	Will produce a store, if the native vector register was dirty.
  */
-static inline void jitcClobberSingleVectorRegister(NativeVectorReg nreg)
+void JITC::clobberSingleVectorRegister(NativeVectorReg nreg)
 {
-	if (jitc.nativeVectorRegState[nreg] > rsUnused) {
-		//printf("*** clobber: XMM%u (vr%u)\n", nreg, jitc.n2cVectorReg[nreg]);
-	}
-
-	jitcFlushSingleVectorRegister(nreg);
-	jitcTouchVectorRegister(nreg);
-	jitcUnmapVectorRegister(nreg);
+	flushSingleVectorRegister(nreg);
+	touchVectorRegister(nreg);
+	unmapVectorRegister(nreg);
 }
 
 /*
@@ -2145,22 +2439,22 @@ static inline void jitcClobberSingleVectorRegister(NativeVectorReg nreg)
  *	To use hints, pass hint == the number of temporary registers
  *	May produce a store, if no native vector registers are available.
  */
-NativeVectorReg jitcAllocVectorRegister(int hint)
+NativeVectorReg JITC::allocVectorRegister(int hint)
 {
-	NativeVectorReg nreg = jitc.MRUvregs[XMM_SENTINEL];
+	NativeVectorReg nreg = MRUvregs[XMM_SENTINEL];
 
-	if (hint >= XMM_SENTINEL) {
-		nreg = jitc.LRUvregs[nreg];
+	if (hint >= int(XMM_SENTINEL)) {
+		nreg = LRUvregs[nreg];
 
-		jitcTrashSingleVectorRegister(nreg);
+		trashSingleVectorRegister(nreg);
 	} else if (hint) {
 		for (int i=1; i<hint; i++) {
-			nreg = jitc.MRUvregs[nreg];
+			nreg = MRUvregs[nreg];
 		}
 
-		jitcTrashSingleVectorRegister(nreg);
+		trashSingleVectorRegister(nreg);
 	} else {
-		jitcClobberSingleVectorRegister(nreg);
+		clobberSingleVectorRegister(nreg);
 	}
 
 	return nreg;
@@ -2175,21 +2469,21 @@ NativeVectorReg jitcAllocVectorRegister(int hint)
  *	May produce a store, if no registers are available.
  *	Will never produce a load.
  */
-NativeVectorReg jitcMapClientVectorRegisterDirty(JitcVectorReg creg, int hint)
+NativeVectorReg JITC::mapClientVectorRegisterDirty(JitcVectorReg creg, int hint)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg == VECTREG_NO) {
-		nreg = jitcAllocVectorRegister(hint);
+		nreg = allocVectorRegister(hint);
 
-		jitcMapVectorRegister(nreg, creg);
+		mapVectorRegister(nreg, creg);
 	} else if (hint) {
-		jitcDiscardVectorRegister(nreg);
+		discardVectorRegister(nreg);
 	} else {
-		jitcTouchVectorRegister(nreg);
+		touchVectorRegister(nreg);
 	}
 
-	jitcDirtyVectorRegister(nreg);
+	dirtyVectorRegister(nreg);
 
 	return nreg;
 }
@@ -2202,19 +2496,19 @@ NativeVectorReg jitcMapClientVectorRegisterDirty(JitcVectorReg creg, int hint)
  *	May produce a store, if no register are available.
  *	May produce a load, if client vector register isn't mapped.
  */
-NativeVectorReg jitcGetClientVectorRegister(JitcVectorReg creg, int hint)
+NativeVectorReg JITC::getClientVectorRegister(JitcVectorReg creg, int hint)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg == VECTREG_NO) {
-		nreg = jitcAllocVectorRegister(hint);
-		jitcMapVectorRegister(nreg, creg);
+		nreg = allocVectorRegister(hint);
+		mapVectorRegister(nreg, creg);
 
-		jitcLoadVectorRegister(nreg);
+		loadVectorRegister(nreg);
 	} else if (hint) {
-		jitcDiscardVectorRegister(nreg);
+		discardVectorRegister(nreg);
 	} else {
-		jitcTouchVectorRegister(nreg);
+		touchVectorRegister(nreg);
 	}
 
 	return nreg;
@@ -2229,11 +2523,11 @@ NativeVectorReg jitcGetClientVectorRegister(JitcVectorReg creg, int hint)
  *	May produce a store, if no register are available.
  *	May produce a load, if client vector register isn't mapped.
  */
-NativeVectorReg jitcGetClientVectorRegisterDirty(JitcVectorReg creg, int hint)
+NativeVectorReg JITC::getClientVectorRegisterDirty(JitcVectorReg creg, int hint)
 {
-	NativeVectorReg nreg = jitcGetClientVectorRegister(creg, hint);
+	NativeVectorReg nreg = getClientVectorRegister(creg, hint);
 
-	jitcDirtyVectorRegister(nreg);
+	dirtyVectorRegister(nreg);
 
 	return nreg;
 }
@@ -2243,18 +2537,18 @@ NativeVectorReg jitcGetClientVectorRegisterDirty(JitcVectorReg creg, int hint)
  *	Resets dirty flags.
  *	Will produce stores, if vector registers are dirty.
  */
-void jitcFlushVectorRegister(int options)
+void JITC::flushVectorRegister(int options)
 {
 	if (options == JITC_VECTOR_REGS_ALL) {
-		for (unsigned int i = XMM0; i <= XMM7; i++) {
-			jitcFlushSingleVectorRegister((NativeVectorReg)i);
-			jitcUndirtyVectorRegister((NativeVectorReg)i);
+		for (NativeVectorReg i = XMM0; i <= XMM15; i = (NativeVectorReg)(i+1)) {
+			flushSingleVectorRegister(i);
+			undirtyVectorRegister(i);
 		}
 	} else if (options & NATIVE_REG) {
 		NativeVectorReg nreg = (NativeVectorReg)(options & 0xf);
 
-		jitcFlushSingleVectorRegister(nreg);
-		jitcUndirtyVectorRegister(nreg);
+		flushSingleVectorRegister(nreg);
+		undirtyVectorRegister(nreg);
 	}
 }
 
@@ -2263,16 +2557,31 @@ void jitcFlushVectorRegister(int options)
  *	Doesn't reset dirty flags.
  *	Will produce stores, if vector registers are dirty.
  */
-void jitcFlushVectorRegisterDirty(int options)
+void JITC::flushVectorRegisterDirty(int options)
 {
 	if (options == JITC_VECTOR_REGS_ALL) {
-		for (unsigned int i = XMM0; i <= XMM7; i++) {
-			jitcFlushSingleVectorRegister((NativeVectorReg)i);
+		for (NativeVectorReg i = XMM0; i <= XMM15; i = (NativeVectorReg)(i+1)) {
+			flushSingleVectorRegister(i);
 		}
 	} else if (options & NATIVE_REG) {
 		NativeVectorReg nreg = (NativeVectorReg)(options & 0xf);
 
-		jitcFlushSingleVectorRegister(nreg);
+		flushSingleVectorRegister(nreg);
+	}
+}
+
+/*
+ *	Reloads all mapped native vector registers from the client state.
+ *	Mappings and dirty flags are not changed, so this is
+ *	only valid after flushVectorRegisterDirty().
+ *	Will produce a load for every mapped vector register.
+ */
+void JITC::reloadVectorRegister()
+{
+	for (NativeVectorReg i = XMM0; i <= XMM15; i = (NativeVectorReg)(i+1)) {
+		if (nativeVectorRegState[i] != rsUnused) {
+			loadVectorRegister(i);
+		}
 	}
 }
 
@@ -2280,16 +2589,16 @@ void jitcFlushVectorRegisterDirty(int options)
  *	Clobbers native vector register(s).
  *	Will produce stores, if vector registers are dirty.
  */
-void jitcClobberVectorRegister(int options)
+void JITC::clobberVectorRegister(int options)
 {
 	if (options == JITC_VECTOR_REGS_ALL) {
-		for (unsigned int i = XMM0; i <= XMM7; i++) {
-			jitcClobberSingleVectorRegister((NativeVectorReg)i);
+		for (NativeVectorReg i = XMM0; i <= XMM15; i = (NativeVectorReg)(i+1)) {
+			clobberSingleVectorRegister(i);
 		}
 	} else if (options & NATIVE_REG) {
 		NativeVectorReg nreg = (NativeVectorReg)(options & 0xf);
 
-		jitcClobberSingleVectorRegister(nreg);
+		clobberSingleVectorRegister(nreg);
 	}
 }
 
@@ -2297,16 +2606,16 @@ void jitcClobberVectorRegister(int options)
  *	Trashes native vector register(s).
  *	Will produce stores, if vector registers are dirty.
  */
-void jitcTrashVectorRegister(int options)
+void JITC::trashVectorRegister(int options)
 {
 	if (options == JITC_VECTOR_REGS_ALL) {
-		for (unsigned int i = XMM0; i <= XMM7; i++) {
-			jitcTrashSingleVectorRegister((NativeVectorReg)i);
+		for (NativeVectorReg i = XMM0; i <= XMM15; i = (NativeVectorReg)(i+1)) {
+			trashSingleVectorRegister(i);
 		}
 	} else if (options & NATIVE_REG) {
 		NativeVectorReg nreg = (NativeVectorReg)(options & 0xf);
 
-		jitcTrashSingleVectorRegister(nreg);
+		trashSingleVectorRegister(nreg);
 	}
 }
 
@@ -2314,53 +2623,53 @@ void jitcTrashVectorRegister(int options)
  *	Drops native vector register(s).
  *	Will not produce any code.
  */
-void jitcDropVectorRegister(int options)
+void JITC::dropVectorRegister(int options)
 {
 	if (options == JITC_VECTOR_REGS_ALL) {
-		for (unsigned int i = XMM0; i <= XMM7; i++) {
-			jitcDropSingleVectorRegister((NativeVectorReg)i);
+		for (NativeVectorReg i = XMM0; i <= XMM15; i = (NativeVectorReg)(i+1)) {
+			dropSingleVectorRegister(i);
 		}
 	} else if (options & NATIVE_REG) {
 		NativeVectorReg nreg = (NativeVectorReg)(options & 0xf);
 
-		jitcDropSingleVectorRegister(nreg);
+		dropSingleVectorRegister(nreg);
 	}
 }
 
-void jitcFlushClientVectorRegister(JitcVectorReg creg)
+void JITC::flushClientVectorRegister(JitcVectorReg creg)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg != VECTREG_NO) {
-		jitcFlushSingleVectorRegister(nreg);
-		jitcUndirtyVectorRegister(nreg);
+		flushSingleVectorRegister(nreg);
+		undirtyVectorRegister(nreg);
 	}
 }
 
-void jitcTrashClientVectorRegister(JitcVectorReg creg)
+void JITC::trashClientVectorRegister(JitcVectorReg creg)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg != VECTREG_NO) {
-		jitcTrashSingleVectorRegister(nreg);
+		trashSingleVectorRegister(nreg);
 	}
 }
 
-void jitcClobberClientVectorRegister(JitcVectorReg creg)
+void JITC::clobberClientVectorRegister(JitcVectorReg creg)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg != VECTREG_NO) {
-		jitcClobberSingleVectorRegister(nreg);
+		clobberSingleVectorRegister(nreg);
 	}
 }
 
-void jitcDropClientVectorRegister(JitcVectorReg creg)
+void JITC::dropClientVectorRegister(JitcVectorReg creg)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg != VECTREG_NO) {
-		jitcDropSingleVectorRegister(nreg);
+		dropSingleVectorRegister(nreg);
 	}
 }
 
@@ -2370,9 +2679,9 @@ void jitcDropClientVectorRegister(JitcVectorReg creg)
  *	May emit a reg->reg move, if the vector register was in memory.
  *	May emit a store, if the vector register was dirty
  */
-NativeVectorReg jitcRenameVectorRegisterDirty(NativeVectorReg reg, JitcVectorReg creg, int hint)
+NativeVectorReg JITC::renameVectorRegisterDirty(NativeVectorReg reg, JitcVectorReg creg, int hint)
 {
-	NativeVectorReg nreg = jitc.c2nVectorReg[creg];
+	NativeVectorReg nreg = c2nVectorReg[creg];
 
 	if (nreg == reg) {
 		/*	That's weird... it's already mapped...	*/
@@ -2384,165 +2693,236 @@ NativeVectorReg jitcRenameVectorRegisterDirty(NativeVectorReg reg, JitcVectorReg
 	} else {
 		/*	Otherwise, only the source register is in the reg
 		 *	pool, so flush it, then remap it.
-	 	*/
-		JitcVectorReg reg2 = jitc.n2cVectorReg[reg];
-
-		if (reg2 != VECTREG_NO) {
-			jitcFlushSingleVectorRegister(reg);
-			jitcUnmapVectorRegister(reg);
+		 */
+		if (n2cVectorReg[reg] != (JitcVectorReg)PPC_VECTREG_NO) {
+			flushSingleVectorRegister(reg);
+			unmapVectorRegister(reg);
 		}
 
 		nreg = reg;
-		jitcMapVectorRegister(nreg, creg);
+		mapVectorRegister(nreg, creg);
 	}
 
-	if (hint) jitcDiscardVectorRegister(nreg);
-	else      jitcTouchVectorRegister(nreg);
+	if (hint) {
+		discardVectorRegister(nreg);
+	} else {
+		touchVectorRegister(nreg);
+	}
 
-	jitcDirtyVectorRegister(nreg);
+	dirtyVectorRegister(nreg);
 
 	return nreg;
 }
 
-void asmMOVAPS(NativeVectorReg reg, const void *disp)
+/*
+ *	SSE instructions
+ *
+ *	prefix is 0x66, 0xf2, 0xf3 or 0 for none, opc is what follows
+ *	the 0x0f escape (two bytes for 0x0f 0x38 xx).
+ *	If imm is not negative it is appended as an imm8.
+ */
+void JITC::asmSSE(uint8 prefix, uint opc, int reg1, int reg2, int imm)
 {
-	byte instr[8] = { 0x0f, 0x28 };
-
-	instr[2] = 0x05 | (reg << 3);
-	U32(instr + 3) = uint32(disp);
-
-	emit(instr, 7);
+	byte instr[8];
+	uint len = 0;
+	if (prefix) instr[len++] = prefix;
+	if ((reg1 | reg2) > 7) {
+		instr[len++] = 0x40 + ((reg1 & 8) >> 1) + ((reg2 & 8) >> 3);
+	}
+	instr[len++] = 0x0f;
+	if (opc > 0xff) instr[len++] = opc >> 8;
+	instr[len++] = opc;
+	instr[len++] = 0xc0 + ((reg1 & 7) << 3) + (reg2 & 7);
+	if (imm >= 0) instr[len++] = imm;
+	emit(instr, len);
 }
 
-void asmMOVAPS(const void *disp, NativeVectorReg reg)
+void JITC::asmSSE(uint8 prefix, uint opc, int reg, NativeReg base, uint32 disp)
 {
-	byte instr[8] = { 0x0f, 0x29 };
-
-	instr[2] = 0x05 | (reg << 3);
-	U32(instr + 3) = uint32(disp);
-
-	emit(instr, 7);
+	byte instr[15];
+	uint len = 0;
+	if (prefix) instr[len++] = prefix;
+	if ((reg | base) > 7) {
+		instr[len++] = 0x40 + ((reg & 8) >> 1) + ((base & 8) >> 3);
+	}
+	instr[len++] = 0x0f;
+	if (opc > 0xff) instr[len++] = opc >> 8;
+	instr[len++] = opc;
+	instr[len] = (reg & 7) << 3;
+	len += mkmodrm(instr+len, base, disp);
+	emit(instr, len);
 }
 
-void asmMOVUPS(NativeVectorReg reg, const void *disp)
+void JITC::asmMOVUPS(NativeVectorReg reg, NativeReg base, uint32 disp)
 {
-	byte instr[8] = { 0x0f, 0x10 };
-
-	instr[2] = 0x05 | (reg << 3);
-	U32(instr + 3) = uint32(disp);
-
-	emit(instr, 7);
+	asmSSE(0, 0x10, reg, base, disp);
 }
 
-void asmMOVUPS(const void *disp, NativeVectorReg reg)
+/*
+ *	3 byte VEX prefix, pp: 0 = none, 1 = 66, 2 = F3, 3 = F2,
+ *	map: 1 = 0F, 2 = 0F38, 3 = 0F3A. reg2 goes to VEX.vvvv,
+ *	reg3 to the r/m operand.
+ */
+void JITC::asmVEX(uint pp, uint map, bool w, uint opc, int reg1, int reg2, int reg3, int imm)
 {
-	byte instr[8] = { 0x0f, 0x11 };
-
-	instr[2] = 0x05 | (reg << 3);
-	U32(instr + 3) = uint32(disp);
-
-	emit(instr, 7);
+	byte instr[6];
+	uint len = 0;
+	instr[len++] = 0xc4;
+	instr[len++] = ((~reg1 & 8) << 4) + 0x40 + ((~reg3 & 8) << 2) + map;
+	instr[len++] = (w ? 0x80 : 0) + ((~reg2 & 15) << 3) + pp;
+	instr[len++] = opc;
+	instr[len++] = 0xc0 + ((reg1 & 7) << 3) + (reg3 & 7);
+	if (imm >= 0) instr[len++] = imm;
+	emit(instr, len);
 }
 
-void asmMOVSS(NativeVectorReg reg, const void *disp)
+void JITC::asmMOVUPS(NativeReg base, uint32 disp, NativeVectorReg reg)
 {
-	byte instr[10] = { 0xf3, 0x0f, 0x10 };
-
-	instr[3] = 0x05 | (reg << 3);
-	U32(instr + 4) = uint32(disp);
+	asmSSE(0, 0x11, reg, base, disp);
+}
 
-	emit(instr, 8);
+void JITC::asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, NativeVectorReg reg2)
+{
+	asmSSE(0, opc, reg1, reg2);
 }
 
-void asmMOVSS(const void *disp, NativeVectorReg reg)
+void JITC::asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, NativeReg base, uint32 disp)
 {
-	byte instr[10] = { 0xf3, 0x0f, 0x11 };
+	asmSSE(0, opc, reg1, base, disp);
+}
 
-	instr[3] = 0x05 | (reg << 3);
-	U32(instr + 4) = uint32(disp);
- 
-	emit(instr, 8);
+void JITC::asmPALU(X86PALUopc opc, NativeVectorReg reg1, NativeVectorReg reg2)
+{
+	asmSSE(0x66, opc, reg1, reg2);
 }
 
-void asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, NativeVectorReg reg2)
+void JITC::asmPALU(X86PALUopc opc, NativeVectorReg reg1, NativeReg base, uint32 disp)
 {
-	byte instr[4] = { 0x0f };
+	asmSSE(0x66, opc, reg1, base, disp);
+}
 
-	instr[1] = opc;
-	instr[2] = 0xc0 + (reg1 << 3) + reg2;
+void JITC::asmPShift(X86PShiftOpc opc, NativeVectorReg reg, int imm)
+{
+	asmSSE(0x66, opc >> 8, opc & 7, reg, imm);
+}
 
-	emit(instr, 3);
+void JITC::asmSHUFPS(NativeVectorReg reg1, NativeVectorReg reg2, int order)
+{
+	asmSSE(0, 0xc6, reg1, reg2, order);
 }
 
-void asmALUPS(X86ALUPSopc opc, NativeVectorReg reg1, modrm_p modrm)
+void JITC::asmCMPPS(X86CMPPSPredicate pred, NativeVectorReg reg1, NativeVectorReg reg2)
 {
-	byte instr[16] = { 0x0f };
-	int len = modrm++[0];
+	asmSSE(0, 0xc2, reg1, reg2, pred);
+}
 
-	instr[1] = opc;
-	memcpy(&instr[2], modrm, len);
-	instr[2] |= (reg1 << 3);
+void JITC::asmPSHUFD(NativeVectorReg reg1, NativeVectorReg reg2, int order)
+{
+	asmSSE(0x66, 0x70, reg1, reg2, order);
+}
 
-	emit(instr, len+2);
+void JITC::asmPSHUFLW(NativeVectorReg reg1, NativeVectorReg reg2, int order)
+{
+	asmSSE(0xf2, 0x70, reg1, reg2, order);
 }
 
-void asmPALU(X86PALUopc opc, NativeVectorReg reg1, NativeVectorReg reg2)
+void JITC::asmPSHUFHW(NativeVectorReg reg1, NativeVectorReg reg2, int order)
 {
-	byte instr[5] = { 0x66, 0x0f };
+	asmSSE(0xf3, 0x70, reg1, reg2, order);
+}
 
-	instr[2] = opc;
-	instr[3] = 0xc0 + (reg1 << 3) + reg2;
+/*
+ *	SSSE3
+ */
+void JITC::asmPSHUFB(NativeVectorReg reg1, NativeVectorReg reg2)
+{
+	asmSSE(0x66, 0x3800, reg1, reg2);
+}
 
-	emit(instr, 4);
+void JITC::asmMOVD(NativeVectorReg reg1, NativeReg reg2)
+{
+	asmSSE(0x66, 0x6e, reg1, reg2);
 }
 
-void asmPALU(X86PALUopc opc, NativeVectorReg reg1, modrm_p modrm)
+void JITC::asmMOVD(NativeReg reg1, NativeVectorReg reg2)
 {
-	byte instr[5] = { 0x66, 0x0f };
-	int len = modrm++[0];
+	asmSSE(0x66, 0x7e, reg2, reg1);
+}
 
-	instr[2] = opc;
-	memcpy(&instr[3], modrm, len);
-	instr[3] |= (reg1 << 3);
+void JITC::asmPMOVMSKB(NativeReg reg1, NativeVectorReg reg2)
+{
+	asmSSE(0x66, 0xd7, reg1, reg2);
+}
 
-	emit(instr, len+3);
+/*
+ *	SSE2 scalar double
+ */
+void JITC::asmALUSD(X86ALUSDopc opc, NativeVectorReg reg1, NativeVectorReg reg2)
+{
+	asmSSE(0xf2, opc, reg1, reg2);
 }
 
-void asmSHUFPS(NativeVectorReg reg1, NativeVectorReg reg2, int order)
+void JITC::asmCMPSD(X86CMPPSPredicate pred, NativeVectorReg reg1, NativeVectorReg reg2)
 {
-	byte instr[5] = { 0x0f, 0xc6, 0xc0+(reg1<<3)+reg2, order };
+	asmSSE(0xf2, 0xc2, reg1, reg2, pred);
+}
 
-	emit(instr, 4);
+/*
+ *	reg1 = reg2 * reg1 +/- reg3, rounded once
+ */
+void JITC::asmVFMASD(X86VFMAopc opc, NativeVectorReg reg1, NativeVectorReg reg2, NativeVectorReg reg3)
+{
+	asmVEX(1, 2, true, opc, reg1, reg2, reg3);
 }
 
-void asmSHUFPS(NativeVectorReg reg1, modrm_p modrm, int order)
+void JITC::asmUCOMISD(NativeVectorReg reg1, NativeVectorReg reg2)
 {
-	byte instr[16] = { 0x0f, 0xc6 };
-	int len = modrm++[0];
+	asmSSE(0x66, 0x2e, reg1, reg2);
+}
 
-	memcpy(&instr[2], modrm, len);
-	instr[2] |= (reg1 << 3);
-	instr[len+2] = order;
+void JITC::asmLDMXCSR(NativeReg base, uint32 disp)
+{
+	asmSSE(0, 0xae, 2, base, disp);
+}
 
-	emit(instr, len+3);
+void JITC::asmSTMXCSR(NativeReg base, uint32 disp)
+{
+	asmSSE(0, 0xae, 3, base, disp);
 }
 
-void asmPSHUFD(NativeVectorReg reg1, NativeVectorReg reg2, int order)
+void JITC::asmCVTSS2SD(NativeVectorReg reg1, NativeVectorReg reg2)
 {
-	byte instr[6] = { 0x66, 0x0f, 0x70, 0xc0+(reg1<<3)+reg2, order };
+	asmSSE(0xf3, 0x5a, reg1, reg2);
+}
 
-	emit(instr, 5);
+void JITC::asmCVTSD2SI(NativeReg reg1, NativeVectorReg reg2)
+{
+	asmSSE(0xf2, 0x2d, reg1, reg2);
 }
 
-void asmPSHUFD(NativeVectorReg reg1, modrm_p modrm, int order)
+void JITC::asmCVTTSD2SI(NativeReg reg1, NativeVectorReg reg2)
 {
-	byte instr[5] = { 0x66, 0x0f, 0x70 };
-	int len = modrm++[0];
+	asmSSE(0xf2, 0x2c, reg1, reg2);
+}
 
-	memcpy(&instr[3], modrm, len);
-	instr[3] |= (reg1 << 3);
-	instr[len+3] = order;
+void JITC::asmMOVQ(NativeVectorReg reg1, NativeReg reg2)
+{
+	byte instr[5];
+	instr[0] = 0x66;
+	instr[1] = 0x48 + ((reg1 & 8) >> 1) + ((reg2 & 8) >> 3);
+	instr[2] = 0x0f;
+	instr[3] = 0x6e;
+	instr[4] = 0xc0 + ((reg1 & 7) << 3) + (reg2 & 7);
+	emit(instr, sizeof instr);
+}
 
-	emit(instr, len+4);
+void JITC::asmMOVQ(NativeReg reg1, NativeVectorReg reg2)
+{
+	byte instr[5];
+	instr[0] = 0x66;
+	instr[1] = 0x48 + ((reg2 & 8) >> 1) + ((reg1 & 8) >> 3);
+	instr[2] = 0x0f;
+	instr[3] = 0x7e;
+	instr[4] = 0xc0 + ((reg2 & 7) << 3) + (reg1 & 7);
+	emit(instr, sizeof instr);
 }
-#endif
@@ -26,8 +26,198 @@
 #include <sys/time.h>
 
 #include "system/systimer.h"
+#include "system/systhread.h"
 #include "tools/snprintf.h"
 
+#if defined(HAVE_SYS_TIMERFD_H) && defined(HAVE_SYS_EVENTFD_H)
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+/*
+ *	All timers are kept in one list sorted by expiry and served by a
+ *	single thread. It sleeps in poll() on a timerfd armed for the first
+ *	expiry and on an eventfd which tells it that the list has changed.
+ *	Callbacks run on this thread, so unlike with signal timers nothing
+ *	interrupts the thread which set the timer (e.g. translated code
+ *	or a syscall of the CPU thread).
+ */
+struct sys_timer_struct
+{
+	sys_timer_callback callback;
+	uint64 expiry;		// CLOCK_MONOTONIC ns, 0 if not armed
+	uint64 period;		// ns, 0 if one-shot
+	sys_timer_struct *next;
+
+	sys_timer_struct(sys_timer_callback cb)
+			: callback(cb), expiry(0), period(0), next(NULL)
+	{
+	}
+};
+
+static sys_mutex gTimerLock;
+static sys_thread gTimerThread;
+static sys_timer_struct *gTimers = NULL;	// armed timers, sorted by expiry
+static int gTimerFD = -1;
+static int gTimerEventFD = -1;
+static uint64 gTimerRes;
+
+static uint64 timer_now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return uint64(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// gTimerLock must be held
+static void timer_unlink(sys_timer_struct *timer)
+{
+	for (sys_timer_struct **p = &gTimers; *p; p = &(*p)->next) {
+		if (*p == timer) {
+			*p = timer->next;
+			break;
+		}
+	}
+	timer->next = NULL;
+	timer->expiry = 0;
+}
+
+// gTimerLock must be held
+static void timer_insert(sys_timer_struct *timer, uint64 expiry)
+{
+	sys_timer_struct **p = &gTimers;
+	while (*p && (*p)->expiry <= expiry) p = &(*p)->next;
+	timer->expiry = expiry;
+	timer->next = *p;
+	*p = timer;
+}
+
+static void *timer_thread(void *arg)
+{
+	struct pollfd fds[2];
+	fds[0].fd = gTimerFD;
+	fds[0].events = POLLIN;
+	fds[1].fd = gTimerEventFD;
+	fds[1].events = POLLIN;
+	while (1) {
+		struct itimerspec itime;
+		memset(&itime, 0, sizeof itime);
+		sys_lock_mutex(gTimerLock);
+		if (gTimers) {
+			itime.it_value.tv_sec = gTimers->expiry / 1000000000ULL;
+			itime.it_value.tv_nsec = gTimers->expiry % 1000000000ULL;
+		}
+		sys_unlock_mutex(gTimerLock);
+		timerfd_settime(gTimerFD, TFD_TIMER_ABSTIME, &itime, NULL);
+
+		if (poll(fds, 2, -1) < 0) continue;
+		uint64 count;
+		if (fds[0].revents & POLLIN) {
+			if (read(gTimerFD, &count, sizeof count) < 0) {}
+		}
+		if (fds[1].revents & POLLIN) {
+			if (read(gTimerEventFD, &count, sizeof count) < 0) {}
+		}
+
+		uint64 now = timer_now();
+		sys_lock_mutex(gTimerLock);
+		while (gTimers && gTimers->expiry <= now) {
+			sys_timer_struct *timer = gTimers;
+			uint64 expiry = timer->expiry;
+			timer_unlink(timer);
+			if (timer->period) {
+				// don't try to catch up with missed periods
+				expiry += timer->period;
+				if (expiry <= now) expiry = now + timer->period;
+				timer_insert(timer, expiry);
+			}
+			sys_unlock_mutex(gTimerLock);
+			timer->callback(reinterpret_cast<sys_timer>(timer));
+			sys_lock_mutex(gTimerLock);
+		}
+		sys_unlock_mutex(gTimerLock);
+	}
+	return NULL;
+}
+
+static bool timer_thread_init()
+{
+	if (gTimerFD >= 0) return true;
+	struct timespec clockRes;
+	if (clock_getres(CLOCK_MONOTONIC, &clockRes) != 0) {
+		perror("Timer create error");
+		return false;
+	}
+	gTimerRes = uint64(clockRes.tv_sec) * 1000 * 1000 * 1000;
+	gTimerRes += uint64(clockRes.tv_nsec);
+	gTimerFD = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	gTimerEventFD = eventfd(0, EFD_CLOEXEC);
+	if (gTimerFD < 0 || gTimerEventFD < 0) {
+		perror("Timer create error");
+		return false;
+	}
+	if (sys_create_mutex(&gTimerLock)
+	 || sys_create_thread(&gTimerThread, 0, timer_thread, NULL)) {
+		ht_printf("Unable to create timer thread\n");
+		return false;
+	}
+	return true;
+}
+
+bool sys_create_timer(sys_timer *t, sys_timer_callback cb_func)
+{
+	*t = 0;
+	if (!timer_thread_init()) return false;
+	*t = reinterpret_cast<sys_timer>(new sys_timer_struct(cb_func));
+	return true;
+}
+
+void sys_delete_timer(sys_timer t)
+{
+	sys_timer_struct *timer = reinterpret_cast<sys_timer_struct *>(t);
+
+	sys_lock_mutex(gTimerLock);
+	timer_unlink(timer);
+	sys_unlock_mutex(gTimerLock);
+
+	delete timer;
+}
+
+void sys_set_timer(sys_timer t, time_t secs, long int nanosecs, bool periodic)
+{
+	sys_timer_struct *timer = reinterpret_cast<sys_timer_struct *>(t);
+	uint64 ns = uint64(secs) * 1000000000ULL + nanosecs;
+
+	sys_lock_mutex(gTimerLock);
+	timer_unlink(timer);
+	if (!ns) {
+		sys_unlock_mutex(gTimerLock);
+		timer->callback(t);
+		return;
+	}
+	timer->period = periodic ? ns : 0;
+	timer_insert(timer, timer_now() + ns);
+	bool first = (gTimers == timer);
+	sys_unlock_mutex(gTimerLock);
+
+	if (first) {
+		// the timer thread has to re-arm the timerfd
+		uint64 one = 1;
+		if (write(gTimerEventFD, &one, sizeof one) < 0) {
+			perror(__FUNCTION__);
+		}
+	}
+}
+
+uint64 sys_get_timer_resolution(sys_timer t)
+{
+	return gTimerRes;
+}
+
+#else
+
 static const int kTimerSignal = SYSTIMER_SIGNAL;
 #ifdef USE_POSIX_REALTIME_CLOCK
 static void signal_handler(int signo, siginfo_t *extra, void *junk);
@@ -236,6 +426,8 @@ uint64 sys_get_timer_resolution(sys_timer t)
 	return timer->timer_res;
 }
 
+#endif
+
 uint64 sys_get_hiresclk_ticks()
 {
 #if HAVE_GETTIMEOFDAY
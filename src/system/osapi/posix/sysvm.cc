@@ -25,7 +25,9 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
+#include <signal.h>
 
 #include <limits.h>    /* for PAGESIZE */
 #ifndef PAGESIZE
@@ -40,6 +42,10 @@
 #define MAP_32BIT 0
 #endif
 
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
 void *sys_alloc_read_write_execute(size_t size)
 {
 	void *p = mmap(0, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_32BIT | MAP_ANON | MAP_PRIVATE, -1, 0);
@@ -180,6 +186,19 @@ void sys_unmap_area(void *base, size_t size)
 	munmap(base, size);
 }
 
+void *sys_reserve_area(void *va, size_t size)
+{
+	void *ret = mmap(va, size, PROT_NONE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE | (va ? MAP_FIXED : 0), -1, 0);
+	return (ret == (void *)-1) ? NULL : ret;
+}
+
+void *sys_map_area_fixed(sys_mapping_area area, size_t ofs, void *va, size_t size, int protection)
+{
+	posix_mapping_area *a = (posix_mapping_area *)area;
+	void *ret = mmap(va, size, sys_prot_to_posix_prot[protection], MAP_SHARED | MAP_FIXED, a->fd, ofs);
+	return (ret == (void *)-1) ? NULL : ret;
+}
+
 void sys_free_mapping_area(sys_mapping_area area)
 {
 	posix_mapping_area *a = (posix_mapping_area *)area;
@@ -196,3 +215,37 @@ bool sys_support_vm()
 {
 	return true;
 }
+
+#if defined(__linux__) && defined(__x86_64__)
+
+static sys_access_fault_handler gAccessFaultHandler;
+
+static void sys_access_fault(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = (ucontext_t *)context;
+	void **pc = (void **)&uc->uc_mcontext.gregs[REG_RIP];
+	if (!gAccessFaultHandler(info->si_addr, pc)) {
+		// not ours, so let the fault happen again and crash
+		signal(sig, SIG_DFL);
+	}
+}
+
+bool sys_set_access_fault_handler(sys_access_fault_handler handler)
+{
+	struct sigaction act;
+	memset(&act, 0, sizeof act);
+	sigemptyset(&act.sa_mask);
+	act.sa_sigaction = sys_access_fault;
+	act.sa_flags = SA_SIGINFO;
+	gAccessFaultHandler = handler;
+	return sigaction(SIGSEGV, &act, NULL) == 0;
+}
+
+#else
+
+bool sys_set_access_fault_handler(sys_access_fault_handler handler)
+{
+	return false;
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "system/file.h"
 #include "system/sys.h"
+#include "system/sysvm.h"
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -426,3 +427,69 @@ void sys_free_read_write_execute(void *p)
 {
 	VirtualFree(p, 0, MEM_DECOMMIT | MEM_RELEASE);
 }
+
+/*
+ *	Translated code addresses this memory with 32 bit absolute
+ *	displacements, so it has to lie below 2 GiB. Windows has no
+ *	MAP_32BIT, so we probe for a free place.
+ */
+void *sys_malloc32(size_t size)
+{
+	for (uint64 a = 0x10000000; a + size <= 0x80000000; a += 0x100000) {
+		void *p = VirtualAlloc((void *)a, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if (p) return p;
+	}
+	return NULL;
+}
+
+void sys_free32(void *p, size_t size)
+{
+	VirtualFree(p, 0, MEM_RELEASE);
+}
+
+static DWORD sys_prot_to_win32_prot[] = {
+	PAGE_NOACCESS,
+	PAGE_READONLY,
+	PAGE_READWRITE,		// there is no write-only
+	PAGE_READWRITE,
+};
+
+void sys_mprotect(void *va, size_t size, int protection)
+{
+	DWORD old;
+	VirtualProtect(va, size, sys_prot_to_win32_prot[protection], &old);
+}
+
+/*
+ *	Mapping areas aren't implemented (yet), so sys_support_vm()
+ *	is false and the rest are just stubs.
+ */
+bool sys_support_vm()
+{
+	return false;
+}
+
+bool sys_alloc_mapping_area(sys_mapping_area *area, size_t size)
+{
+	return false;
+}
+
+void *sys_mapping_area_ptr(sys_mapping_area area)
+{
+	return NULL;
+}
+
+void *sys_reserve_area(void *va, size_t size)
+{
+	return NULL;
+}
+
+void *sys_map_area_fixed(sys_mapping_area area, size_t ofs, void *va, size_t size, int protection)
+{
+	return NULL;
+}
+
+bool sys_set_access_fault_handler(sys_access_fault_handler handler)
+{
+	return false;
+}
@@ -49,4 +49,25 @@ void *sys_map_area(sys_mapping_area area, size_t ofs, size_t size, int protectio
 void sys_unmap_area(void *base, size_t size);
 void sys_free_mapping_area(sys_mapping_area area);
 
+/*
+ *	Reserves size bytes of inaccessible address space. If va isn't
+ *	NULL, the reservation replaces everything mapped at [va, va+size).
+ */
+void *sys_reserve_area(void *va, size_t size);
+/*
+ *	Like sys_map_area(), but maps exactly at va (which usually is
+ *	part of a reservation of sys_reserve_area())
+ */
+void *sys_map_area_fixed(sys_mapping_area area, size_t ofs, void *va, size_t size, int protection);
+
+/*
+ *	Called on an access violation with the faulting address and a
+ *	pointer to the instruction pointer of the faulting thread.
+ *	Returns true if the fault was handled, execution then continues
+ *	at *pc (which the handler may have changed).
+ */
+typedef bool (*sys_access_fault_handler)(void *addr, void **pc);
+
+bool sys_set_access_fault_handler(sys_access_fault_handler handler);
+
 #endif /* _SYSVM_H_ */